@@ -0,0 +1,119 @@
+﻿// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Coap.ino" company="DTV-Online">
+//  Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//  Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// <summary>
+//  All functions relating to the CoAP server resources. Note that this file is merged with all other '.ino' files.
+// </summary>
+// --------------------------------------------------------------------------------------------------------------------
+
+// The CoAP resource ids (the soil and temperature sensors use consecutive ids).
+const uint8_t COAP_DATA = 0;
+const uint8_t COAP_SYSTEM = 1;
+const uint8_t COAP_SOIL = 2;
+const uint8_t COAP_TEMP = COAP_SOIL + SoilSensors::MAX_SENSORS;
+
+// The notification interval (msec) of the system info (changes continuously).
+const uint32_t COAP_SYSTEM_INTERVAL = 10000;
+
+/// <summary>
+///  Returns the sensor index of a resource path segment (a single digit below the number of sensors).
+/// </summary>
+/// <param name="segment">The path segment</param>
+/// <param name="count">The number of sensors</param>
+/// <returns>The sensor index (-1: invalid)</returns>
+int getCoapIndex(const char* segment, unsigned short count)
+{
+	if ((segment[0] >= '0') && (segment[0] < '0' + count) && (segment[1] == '\0'))
+	{
+		return segment[0] - '0';
+	}
+
+	return -1;
+}
+
+/// <summary>
+///  Returns the resource id of a CoAP resource path (same paths as the HTTP API: data, system, soil/{i}, temp/{i}).
+/// </summary>
+/// <param name="path">The resource path (without leading slash)</param>
+/// <returns>The resource id (-1: not found)</returns>
+int findCoapResource(const char* path)
+{
+	if (strcmp(path, "data") == 0)
+	{
+		return COAP_DATA;
+	}
+
+	if (strcmp(path, "system") == 0)
+	{
+		return COAP_SYSTEM;
+	}
+
+	if (strncmp(path, "soil/", 5) == 0)
+	{
+		int index = getCoapIndex(path + 5, SoilSensors::MAX_SENSORS);
+		return (index < 0) ? -1 : COAP_SOIL + index;
+	}
+
+	if (strncmp(path, "temp/", 5) == 0)
+	{
+		int index = getCoapIndex(path + 5, TempSensors::MAX_SENSORS);
+		return (index < 0) ? -1 : COAP_TEMP + index;
+	}
+
+	return -1;
+}
+
+/// <summary>
+///  Returns the version of a CoAP resource, the observers are notified if the version changes (the sensor
+///  resources use the reported version, see report by exception).
+/// </summary>
+/// <param name="resource">The resource id</param>
+/// <returns>The version</returns>
+uint32_t getCoapVersion(uint8_t resource)
+{
+	if (resource == COAP_DATA)
+	{
+		return sensors.getVersion();
+	}
+
+	if (resource == COAP_SYSTEM)
+	{
+		return millis() / COAP_SYSTEM_INTERVAL;
+	}
+
+	if (resource < COAP_TEMP)
+	{
+		return sensors.SoilSensors.getVersionByIndex(resource - COAP_SOIL);
+	}
+
+	return sensors.TempSensors.getVersionByIndex(resource - COAP_TEMP);
+}
+
+/// <summary>
+///  Writes a CoAP resource (same structure as the HTTP JSON documents).
+/// </summary>
+/// <param name="resource">The resource id</param>
+/// <param name="writer">The CBOR writer</param>
+void writeCoapResource(uint8_t resource, WireFormat& writer)
+{
+	if (resource == COAP_DATA)
+	{
+		sensors.serialize(writer);
+	}
+	else if (resource == COAP_SYSTEM)
+	{
+		sysInfo.serialize(writer);
+	}
+	else if (resource < COAP_TEMP)
+	{
+		sensors.SoilSensors.serializeByIndex(resource - COAP_SOIL, writer);
+	}
+	else
+	{
+		sensors.TempSensors.serializeByIndex(resource - COAP_TEMP, writer);
+	}
+}
@@ -17,7 +17,7 @@
 /// <returns>Boolean</returns>
 bool apHandler(Commander& cmdr)
 {
-	Log.trace("apHandler()" CR);
+	LOG_TRACE("apHandler()" CR);
 	ApInfo info(WiFi);
 
 	cmdr.println("WiFi Accesspoint Info:");
@@ -40,7 +40,7 @@ bool apHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool staHandler(Commander& cmdr)
 {
-	Log.trace("staHandler()" CR);
+	LOG_TRACE("staHandler()" CR);
 	StaInfo info(WiFi);
 
 	cmdr.println("WiFi Connection Info:");
@@ -67,7 +67,7 @@ bool staHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool apiHandler(Commander& cmdr)
 {
-	Log.trace("apiHandler()" CR);
+	LOG_TRACE("apiHandler()" CR);
 
 	cmdr.println("HTTP Web API:");
 	cmdr.println("    GET:");
@@ -76,14 +76,25 @@ bool apiHandler(Commander& cmdr)
 	cmdr.println("        /err             ");
 	cmdr.println("        /server          ");
 	cmdr.println("        /system          ");
+	cmdr.println("        /system/trend    ");
 	cmdr.println("        /soil            ");
 	cmdr.println("        /temp            ");
 	cmdr.println("        /data            ");
+	cmdr.println("        /data?since={v}  ");
+	cmdr.println("        /meta            ");
+	cmdr.println("        /batch?r={list}  ");
+	cmdr.println("        /metrics         ");
+	cmdr.println("        /log             ");
+	cmdr.println("        /capture         ");
+	cmdr.println("        /scan            ");
+	cmdr.println("        /perf            ");
 	cmdr.println("        /settings        ");
 	cmdr.println("        /settings/ap     ");
 	cmdr.println("        /settings/sta    ");
 	cmdr.println("        /settings/log    ");
 	cmdr.println("        /settings/cmd    ");
+	cmdr.println("        /settings/mqtt   ");
+	cmdr.println("        /settings/influx ");
 	cmdr.println("        /settings/soil   ");
 	cmdr.println("        /settings/temp   ");
 	cmdr.println("    POST:");
@@ -91,27 +102,45 @@ bool apiHandler(Commander& cmdr)
 	cmdr.println("        /save            ");
 	cmdr.println("        /reset           ");
 	cmdr.println("        /reboot          ");
+	cmdr.println("        /perf            ");
+	cmdr.println("        /capture/start   ");
+	cmdr.println("        /capture/stop    ");
 	cmdr.println("        /settings        ");
 	cmdr.println("        /settings/ap     ");
 	cmdr.println("        /settings/sta    ");
 	cmdr.println("        /settings/log    ");
 	cmdr.println("        /settings/cmd    ");
+	cmdr.println("        /settings/mqtt   ");
+	cmdr.println("        /settings/influx ");
 	cmdr.println("        /settings/soil   ");
 	cmdr.println("        /settings/temp   ");
 	return 0;
 }
 
 /// <summary>
-///  Command Handler Function initiating a WiFi scan. and printing results.
+///  Command Handler Function printing the cached WiFi scan results.
+///  A new async scan is started if the results are stale ('scan force' always starts a scan).
 /// </summary>
 /// <param name="cmdr">Reference to Commander instance</param>
 /// <returns>Boolean</returns>
 bool scanHandler(Commander& cmdr)
 {
-	Log.trace("scanHandler()" CR);
-	unsigned short networks = manager.scan();
+	LOG_TRACE("scanHandler()" CR);
+	String option;
 
-	cmdr.println("WiFi:");
+	if (cmdr.hasPayload())
+	{
+		cmdr.getString(option);
+	}
+
+	if (manager.scan(option == "force") || manager.isScanning())
+	{
+		cmdr.println("Scanning (try again)...");
+	}
+
+	unsigned short networks = manager.getNumberAP();
+
+	cmdr.print("WiFi: (age "); cmdr.print(manager.getScanAge() / 1000); cmdr.println(" sec)");
 
 	for (unsigned short i = 0; i < networks; i++)
 	{
@@ -133,23 +162,32 @@ bool scanHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool wifiHandler(Commander& cmdr)
 {
-	Log.trace("wifiHandler()" CR);
-	manager.disconnect();
-	manager.connect();
+	LOG_TRACE("wifiHandler()" CR);
 
-	if (ApInfo::Active)
-	{
-		cmdr.println("AP running");
-	}
-	else if (WiFi.isConnected())
+	// Restart the connection (non-blocking), 'wifi state' only prints the actual state.
+	if (cmdr.hasPayload())
 	{
-		cmdr.println("Connected to AP");
+		String option;
+		cmdr.getString(option);
+
+		if (option != "state")
+		{
+			cmdr.println("Invalid option");
+			return 0;
+		}
 	}
 	else
 	{
-		cmdr.println("No WiFi");
+		manager.disconnect();
+		manager.connect();
 	}
 
+	cmdr.print("WiFi State: "); cmdr.println(manager.getStateName());
+	cmdr.print("Attempts:   "); cmdr.println(manager.getAttempts());
+	cmdr.print("Reason:     "); cmdr.println(manager.getReason());
+	cmdr.print("Connect:    "); cmdr.print(manager.getConnectTime()); cmdr.println(manager.isFastConnect() ? " msec (fast)" : " msec");
+	cmdr.print("AP running: "); cmdr.println(ApInfo::Active ? "true" : "false");
+
 	return 0;
 }
 
@@ -160,19 +198,19 @@ bool wifiHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool pingHandler(Commander& cmdr)
 {
-	Log.trace("pingHandler()" CR);
+	LOG_TRACE("pingHandler()" CR);
 	String address("127.0.0.1");
 
 	if (cmdr.hasPayload())
 	{
 		if (!cmdr.getString(address))
 		{
-			Log.error("    No address found");
+			LOG_ERROR("    No address found");
 			return 0;
 		}
 	}
 
-	Log.trace("    Address: %s" CR, address);
+	LOG_TRACE("    Address: %s" CR, address.c_str());
 
 	if (Ping.ping(address.c_str(), 3))
 	{
@@ -193,7 +231,7 @@ bool pingHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool initHandler(Commander& cmdr)
 {
-	Log.trace("initHandler()" CR);
+	LOG_TRACE("initHandler()" CR);
 	settings.init(sysInfo);
 	return 0;
 }
@@ -205,23 +243,236 @@ bool initHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool saveHandler(Commander& cmdr)
 {
-	Log.trace("saveHandler()" CR);
+	LOG_TRACE("saveHandler()" CR);
 	settings.save();
 	return 0;
 }
 
 /// <summary>
 ///  Command Handler Function showing all current sensor data.
+///  Only the sensors changed after a version are shown if specified ('data 1234').
 /// </summary>
 /// <param name="cmdr">Reference to Commander instance</param>
 /// <returns>Boolean</returns>
 bool dataHandler(Commander& cmdr)
 {
-	Log.trace("dataHandler()" CR);
+	LOG_TRACE("dataHandler()" CR);
+
+	if (cmdr.hasPayload())
+	{
+		int since = 0;
+
+		if (!cmdr.getInt(since) || (since < 0))
+		{
+			cmdr.println("Invalid version");
+			return 0;
+		}
+
+		cmdr.println(sensors.serialize((uint32_t)since));
+		return 0;
+	}
+
 	cmdr.println(sensors.serialize());
 	return 0;
 }
 
+/// <summary>
+///  Command Handler Function measuring the cost of the /data serialization.
+///  Compare the results of a build using the default LOG_MIN_LEVEL with a build using
+///  -DLOG_MIN_LEVEL=LOG_LEVEL_VERBOSE to see the cost of the compiled in log statements.
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool benchHandler(Commander& cmdr)
+{
+	LOG_TRACE("benchHandler()" CR);
+	int count = 100;
+
+	if (cmdr.hasPayload())
+	{
+		if (!cmdr.getInt(count) || (count <= 0))
+		{
+			cmdr.println("Invalid count");
+			return 0;
+		}
+	}
+
+	size_t length = 0;
+	unsigned long start = micros();
+
+	for (int i = 0; i < count; i++)
+	{
+		length += sensors.serialize().length();
+	}
+
+	unsigned long elapsed = micros() - start;
+
+	cmdr.println("Benchmark /data:");
+	cmdr.print("    Iterations:   "); cmdr.println(count);
+	cmdr.print("    Bytes:        "); cmdr.println(length / count);
+	cmdr.print("    Time (us/op): "); cmdr.println(elapsed / count);
+	cmdr.print("    Min Level:    "); cmdr.println(LOG_MIN_LEVEL);
+	cmdr.print("    Log Level:    "); cmdr.println(settings.LogSettings.getLogLevelApp());
+
+	return 0;
+}
+
+/// <summary>
+///  Command Handler Function showing the loop and HTTP handler latencies ('perf reset' clears the data).
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool perfHandler(Commander& cmdr)
+{
+	LOG_TRACE("perfHandler()" CR);
+
+	if (cmdr.hasPayload())
+	{
+		String option;
+		cmdr.getString(option);
+
+		if (option == "reset")
+		{
+			Profiler::reset();
+			cmdr.println("Profiler reset");
+		}
+		else
+		{
+			cmdr.println("Invalid option");
+		}
+
+		return 0;
+	}
+
+	cmdr.println("Latency (us):");
+	Profiler::printTable(cmdr);
+	return 0;
+}
+
+/// <summary>
+///  Command Handler Function showing the MQTT publisher state ('mqtt clear' removes the queued messages).
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool mqttHandler(Commander& cmdr)
+{
+	LOG_TRACE("mqttHandler()" CR);
+
+	if (cmdr.hasPayload())
+	{
+		String option;
+		cmdr.getString(option);
+
+		if (option == "clear")
+		{
+			mqttQueue.clear();
+			cmdr.println("MQTT queue cleared");
+		}
+		else
+		{
+			cmdr.println("Invalid option");
+		}
+
+		return 0;
+	}
+
+	const char* states[] = { "disconnected", "connecting", "connected" };
+
+	cmdr.println("MQTT:");
+	cmdr.print("    Server:       "); cmdr.println(mqttClient.isActive() ? settings.MqttSettings.Server : "(disabled)");
+	cmdr.print("    State:        "); cmdr.println(states[mqttClient.getState()]);
+	cmdr.print("    Connects:     "); cmdr.println(mqttClient.getConnects());
+	cmdr.print("    Frames:       "); cmdr.println(mqttPublisher.getFrames());
+	cmdr.print("    Direct:       "); cmdr.println(mqttPublisher.getDirect());
+	cmdr.print("    Queued:       "); cmdr.println(mqttPublisher.getQueued());
+	cmdr.print("    Acknowledged: "); cmdr.println(mqttClient.getAcknowledged());
+	cmdr.print("    In Queue:     "); cmdr.println(mqttQueue.getCount());
+	cmdr.print("    Dropped:      "); cmdr.println(mqttQueue.getDropped());
+
+	return 0;
+}
+
+/// <summary>
+///  Command Handler Function showing the InfluxDB uploader state ('influx clear' removes the spooled batches).
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool influxHandler(Commander& cmdr)
+{
+	LOG_TRACE("influxHandler()" CR);
+
+	if (cmdr.hasPayload())
+	{
+		String option;
+		cmdr.getString(option);
+
+		if (option == "clear")
+		{
+			influxSpool.clear();
+			cmdr.println("InfluxDB spool cleared");
+		}
+		else
+		{
+			cmdr.println("Invalid option");
+		}
+
+		return 0;
+	}
+
+	cmdr.println("InfluxDB:");
+	cmdr.print("    Server:       "); cmdr.println(influxUploader.isActive() ? settings.InfluxSettings.Server : "(disabled)");
+	cmdr.print("    Busy:         "); cmdr.println(influxUploader.isBusy() ? "true" : "false");
+	cmdr.print("    Lines:        "); cmdr.println(influxUploader.getLines());
+	cmdr.print("    Uploaded:     "); cmdr.println(influxUploader.getUploaded());
+	cmdr.print("    Failed:       "); cmdr.println(influxUploader.getFailed());
+	cmdr.print("    Rejected:     "); cmdr.println(influxUploader.getRejected());
+	cmdr.print("    Bytes In:     "); cmdr.println(influxUploader.getBytesIn());
+	cmdr.print("    Bytes Out:    "); cmdr.println(influxUploader.getBytesOut());
+	cmdr.print("    Spooled:      "); cmdr.println(influxSpool.getCount());
+	cmdr.print("    Dropped:      "); cmdr.println(influxSpool.getDropped());
+	cmdr.print("    Dropped Lines:"); cmdr.println(influxUploader.getDroppedLines());
+
+	return 0;
+}
+
+/// <summary>
+///  Command Handler Function showing the CoAP server state ('coap clear' removes the observers).
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool coapHandler(Commander& cmdr)
+{
+	LOG_TRACE("coapHandler()" CR);
+
+	if (cmdr.hasPayload())
+	{
+		String option;
+		cmdr.getString(option);
+
+		if (option == "clear")
+		{
+			coapServer.clear();
+			cmdr.println("CoAP observers removed");
+		}
+		else
+		{
+			cmdr.println("Invalid option");
+		}
+
+		return 0;
+	}
+
+	cmdr.println("CoAP:");
+	cmdr.print("    Port:         "); cmdr.println((unsigned int)CoapServer::PORT);
+	cmdr.print("    Started:      "); cmdr.println(coapServer.isStarted() ? "true" : "false");
+	cmdr.print("    Observers:    "); cmdr.println(coapServer.getObservers());
+	cmdr.print("    Requests:     "); cmdr.println(coapServer.getRequests());
+	cmdr.print("    Notifications:"); cmdr.println(coapServer.getNotifications());
+	cmdr.print("    Errors:       "); cmdr.println(coapServer.getErrors());
+
+	return 0;
+}
+
 /// <summary>
 ///  Command Handler Function showing current soil sensor data.
 /// </summary>
@@ -229,7 +480,7 @@ bool dataHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool soilHandler(Commander& cmdr)
 {
-	Log.trace("soilHandler()" CR);
+	LOG_TRACE("soilHandler()" CR);
 	int index;
 
 	if (cmdr.getInt(index))
@@ -277,7 +528,7 @@ bool soilHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool tempHandler(Commander& cmdr)
 {
-	Log.trace("tempHandler()" CR);
+	LOG_TRACE("tempHandler()" CR);
 	int index;
 
 	if (cmdr.getInt(index))
@@ -323,7 +574,7 @@ bool tempHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool resetHandler(Commander& cmdr)
 {
-	Log.trace("resetHandler()" CR);
+	LOG_TRACE("resetHandler()" CR);
 	settings.ApSettings.reset();
 	settings.StaSettings.reset();
 	settings.save();
@@ -337,18 +588,18 @@ bool resetHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool levelHandler(Commander& cmdr)
 {
-	Log.trace("levelHandler()" CR);
+	LOG_TRACE("levelHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
 		String level;
 		cmdr.getString(level);
 
-		Log.trace("    Level: %s" CR, level);
+		LOG_TRACE("    Level: %s" CR, level.c_str());
 
 		if (settings.LogSettings.setLogLevelApp(level))
 		{
-			Log.begin(settings.LogSettings.getArduinoLogLevelApp(), &Serial);
+			Logger::setLevel(settings.LogSettings.getArduinoLogLevelApp());
 		}
 		else
 		{
@@ -359,11 +610,107 @@ bool levelHandler(Commander& cmdr)
 	{
 		cmdr.print("Log Level: ");
 		cmdr.println(settings.LogSettings.getLogLevelApp());
+		cmdr.print("Dropped:   ");
+		cmdr.println(Logger::getDropped());
+		cmdr.print("Syslog:    ");
+		cmdr.print(syslogSink.getSent());
+		cmdr.print(" sent, ");
+		cmdr.print(syslogSink.getDropped());
+		cmdr.println(" dropped");
 	}
 
 	return 0;
 }
 
+/// <summary>
+///  Command Handler Function showing the tail of the log file, or clearing the log files.
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool logHandler(Commander& cmdr)
+{
+	LOG_TRACE("logHandler()" CR);
+	int count = 1024;
+
+	if (cmdr.hasPayload())
+	{
+		String payload = cmdr.getPayloadString();
+		payload.trim();
+
+		if (payload == "clear")
+		{
+			logFile.clear();
+			cmdr.println("Log cleared");
+			return 0;
+		}
+
+		count = payload.toInt();
+
+		if (count <= 0)
+		{
+			cmdr.println("Invalid count (or clear)");
+			return 0;
+		}
+	}
+
+	cmdr.print("Log (");
+	cmdr.print(logFile.size());
+	cmdr.println(" bytes):");
+	logFile.tail(cmdr, count);
+	cmdr.println();
+
+	return 0;
+}
+
+/// <summary>
+///  Command Handler Function controlling the raw sensor input capture (capture start|stop|clear|dump).
+///  Without option the capture state is shown, 'capture dump' prints the capture file as hex lines.
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool captureHandler(Commander& cmdr)
+{
+	LOG_TRACE("captureHandler()" CR);
+
+	if (cmdr.hasPayload())
+	{
+		String option;
+		cmdr.getString(option);
+
+		if (option == "start")
+		{
+			cmdr.println(capture.start() ? "Capture started" : "Unable to create capture file");
+		}
+		else if (option == "stop")
+		{
+			capture.stop();
+			cmdr.println("Capture stopped");
+		}
+		else if (option == "clear")
+		{
+			capture.clear();
+			cmdr.println("Capture cleared");
+		}
+		else if (option == "dump")
+		{
+			capture.dump(cmdr, true);
+		}
+		else
+		{
+			cmdr.println("Invalid option (start|stop|clear|dump)");
+		}
+
+		return 0;
+	}
+
+	cmdr.println("Sensor Capture:");
+	cmdr.print("    Running: "); cmdr.println(capture.isRunning() ? "true" : "false");
+	cmdr.print("    Records: "); cmdr.println(capture.getRecords());
+	cmdr.print("    Bytes:   "); cmdr.println(capture.size());
+
+	return 0;
+}
+
 /// <summary>
 ///  Command Handler Function showing SPIFFS info.
 /// </summary>
@@ -371,7 +718,7 @@ bool levelHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool spiffsHandler(Commander& cmdr)
 {
-	Log.trace("spiffsHandler()" CR);
+	LOG_TRACE("spiffsHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -379,7 +726,7 @@ bool spiffsHandler(Commander& cmdr)
 
 		if (cmdr.getString(name))
 		{
-			Log.trace("    File: %s" CR, name.c_str());
+			LOG_TRACE("    File: %s" CR, name.c_str());
 
 			if (!name.startsWith("/")) name = "/" + name;
 
@@ -412,7 +759,7 @@ bool spiffsHandler(Commander& cmdr)
 		}
 		else
 		{
-			Log.error("    No file name found");
+			LOG_ERROR("    No file name found");
 			return 0;
 		}
 	}
@@ -445,7 +792,7 @@ bool spiffsHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool formatHandler(Commander& cmdr)
 {
-	Log.trace("formatHandler()" CR);
+	LOG_TRACE("formatHandler()" CR);
 
 	bool formatted = SPIFFS.format();
 
@@ -470,7 +817,7 @@ bool formatHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool serverHandler(Commander& cmdr)
 {
-	Log.trace("serverHandler()" CR);
+	LOG_TRACE("serverHandler()" CR);
 	ServerInfo info(WiFi);
 
 	cmdr.println("Web Server Info:");
@@ -490,7 +837,7 @@ bool serverHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool systemHandler(Commander& cmdr)
 {
-	Log.trace("systemHandler()" CR);
+	LOG_TRACE("systemHandler()" CR);
 
 	cmdr.println("System Info:");
 	cmdr.print("    ChipRevision:    "); cmdr.println(sysInfo.ChipRevision);
@@ -499,12 +846,49 @@ bool systemHandler(Commander& cmdr)
 	cmdr.print("    FlashChipSize:   "); cmdr.println(sysInfo.FlashChipSize);
 	cmdr.print("    HeapSize:        "); cmdr.println(sysInfo.HeapSize);
 	cmdr.print("    FreeHeap:        "); cmdr.println(sysInfo.FreeHeap);
+	cmdr.print("    MinFreeHeap:     "); cmdr.println(sysInfo.MinFreeHeap);
+	cmdr.print("    MaxAllocHeap:    "); cmdr.println(sysInfo.MaxAllocHeap);
+	cmdr.print("    Fragmentation:   "); cmdr.println(sysInfo.Fragmentation);
 	cmdr.print("    SketchSize:      "); cmdr.println(sysInfo.SketchSize);
 	cmdr.print("    FreeSketchSpace: "); cmdr.println(sysInfo.FreeSketchSpace);
 	cmdr.print("    SketchMD5:       "); cmdr.println(sysInfo.SketchMD5);
 	cmdr.print("    SdkVersion:      "); cmdr.println(sysInfo.SdkVersion);
 	cmdr.print("    ChipID:          "); cmdr.println(sysInfo.ChipID);
 	cmdr.print("    Software:        "); cmdr.println(sysInfo.Software);
+	cmdr.print("    FastBoot:        "); cmdr.println(sysInfo.FastBoot ? "true" : "false");
+	cmdr.println("Boot (msec since reset):");
+
+	for (uint8_t i = 0; i < sysInfo.getBootPhases(); i++)
+	{
+		const SystemInfo::BootPhase& phase = sysInfo.getBootPhase(i);
+
+		if (phase.Name != NULL)
+		{
+			cmdr.print("    "); cmdr.print(phase.Name); cmdr.print(": "); cmdr.println(phase.Time);
+		}
+	}
+	bool counting = HeapMonitor::isCounting();
+	cmdr.println(counting ? "Allocations (calls, allocs, frees, bytes, net):" : "Allocations (calls, net):");
+
+	for (uint8_t i = 0; i < HeapMonitor::SUBSYSTEM_COUNT; i++)
+	{
+		const HeapMonitor::Counters& counters = HeapMonitor::getCounters(i);
+		char line[80];
+
+		if (counting)
+		{
+			snprintf(line, sizeof(line), "    %-16s %8u %8u %8u %10u %8d", HeapMonitor::getSubsystemName(i),
+				(unsigned int)counters.Calls, (unsigned int)counters.Allocs, (unsigned int)counters.Frees,
+				(unsigned int)counters.Bytes, (int)counters.Net);
+		}
+		else
+		{
+			snprintf(line, sizeof(line), "    %-16s %8u %8d", HeapMonitor::getSubsystemName(i),
+				(unsigned int)counters.Calls, (int)counters.Net);
+		}
+
+		cmdr.println(line);
+	}
 
 	return 0;
 }
@@ -516,7 +900,8 @@ bool systemHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool rebootHandler(Commander& cmdr)
 {
-	Log.trace("rebootHandler()" CR);
+	LOG_TRACE("rebootHandler()" CR);
+	Logger::flush();
 	ESP.restart();
 	return 0;
 }
@@ -528,7 +913,7 @@ bool rebootHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool versionHandler(Commander& cmdr)
 {
-	Log.trace("versionHandler()" CR);
+	LOG_TRACE("versionHandler()" CR);
 	cmdr.printCommanderVersion();
 	return 0;
 }
@@ -540,7 +925,7 @@ bool versionHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool settingsHandler(Commander& cmdr)
 {
-	Log.trace("settingsHandler()" CR);
+	LOG_TRACE("settingsHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -548,11 +933,16 @@ bool settingsHandler(Commander& cmdr)
 
 		if (json.length() > 0)
 		{
-			settings.deserialize(json);
+			if (settings.deserialize(json))
+			{
+				applyMqttSettings();
+				applyInfluxSettings();
+				applyLogSettings();
+			}
 		}
 		else
 		{
-			Log.error("    No JSON found");
+			LOG_ERROR("    No JSON found");
 		}
 	}
 	else
@@ -570,7 +960,7 @@ bool settingsHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool settingsApHandler(Commander& cmdr)
 {
-	Log.trace("settingsApHandler()" CR);
+	LOG_TRACE("settingsApHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -582,7 +972,7 @@ bool settingsApHandler(Commander& cmdr)
 		}
 		else
 		{
-			Log.error("    No JSON found");
+			LOG_ERROR("    No JSON found");
 		}
 	}
 	else
@@ -600,7 +990,7 @@ bool settingsApHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool settingsStaHandler(Commander& cmdr)
 {
-	Log.trace("settingsStaHandler()" CR);
+	LOG_TRACE("settingsStaHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -612,7 +1002,7 @@ bool settingsStaHandler(Commander& cmdr)
 		}
 		else
 		{
-			Log.error("    No JSON found");
+			LOG_ERROR("    No JSON found");
 		}
 	}
 	else
@@ -630,7 +1020,7 @@ bool settingsStaHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool settingsLogHandler(Commander& cmdr)
 {
-	Log.trace("settingsLogHandler()" CR);
+	LOG_TRACE("settingsLogHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -639,10 +1029,11 @@ bool settingsLogHandler(Commander& cmdr)
 		if (json.length() > 0)
 		{
 			settings.LogSettings.deserialize(json);
+			applyLogSettings();
 		}
 		else
 		{
-			Log.error("    No JSON found");
+			LOG_ERROR("    No JSON found");
 		}
 	}
 	else
@@ -660,7 +1051,7 @@ bool settingsLogHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool settingsCmdHandler(Commander& cmdr)
 {
-	Log.trace("settingsCmdHandler()" CR);
+	LOG_TRACE("settingsCmdHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -672,7 +1063,7 @@ bool settingsCmdHandler(Commander& cmdr)
 		}
 		else
 		{
-			Log.error("    No JSON found");
+			LOG_ERROR("    No JSON found");
 		}
 	}
 	else
@@ -683,6 +1074,74 @@ bool settingsCmdHandler(Commander& cmdr)
 	return 0;
 }
 
+/// <summary>
+///  Command Handler Function showing current MQTT settings.
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool settingsMqttHandler(Commander& cmdr)
+{
+	LOG_TRACE("settingsMqttHandler()" CR);
+
+	if (cmdr.hasPayload())
+	{
+		String json = cmdr.getPayloadString();
+
+		if (json.length() > 0)
+		{
+			if (settings.MqttSettings.deserialize(json))
+			{
+				applyMqttSettings();
+			}
+			else
+			{
+				cmdr.println("Invalid MQTT settings");
+			}
+		}
+		else
+		{
+			LOG_ERROR("    No JSON found");
+		}
+	}
+	else
+	{
+		cmdr.println(settings.MqttSettings.serialize());
+	}
+
+	return 0;
+}
+
+/// <summary>
+///  Command Handler Function showing current InfluxDB settings.
+/// </summary>
+/// <param name="cmdr">Reference to Commander instance</param>
+/// <returns>Boolean</returns>
+bool settingsInfluxHandler(Commander& cmdr)
+{
+	LOG_TRACE("settingsInfluxHandler()" CR);
+
+	if (cmdr.hasPayload())
+	{
+		String json = cmdr.getPayloadString();
+
+		if (json.length() > 0)
+		{
+			settings.InfluxSettings.deserialize(json);
+			applyInfluxSettings();
+		}
+		else
+		{
+			LOG_ERROR("    No JSON found");
+		}
+	}
+	else
+	{
+		cmdr.println(settings.InfluxSettings.serialize());
+	}
+
+	return 0;
+}
+
 /// <summary>
 ///  Command Handler Function showing current soil sensor settings.
 /// </summary>
@@ -690,7 +1149,7 @@ bool settingsCmdHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool settingsSoilHandler(Commander& cmdr)
 {
-	Log.trace("settingsSoilHandler()" CR);
+	LOG_TRACE("settingsSoilHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -702,7 +1161,7 @@ bool settingsSoilHandler(Commander& cmdr)
 		}
 		else
 		{
-			Log.error("    No JSON found");
+			LOG_ERROR("    No JSON found");
 		}
 	}
 	else
@@ -720,7 +1179,7 @@ bool settingsSoilHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool settingsTempHandler(Commander& cmdr)
 {
-	Log.trace("settingsTempHandler()" CR);
+	LOG_TRACE("settingsTempHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -732,7 +1191,7 @@ bool settingsTempHandler(Commander& cmdr)
 		}
 		else
 		{
-			Log.error("    No JSON found");
+			LOG_ERROR("    No JSON found");
 		}
 	}
 	else
@@ -750,7 +1209,7 @@ bool settingsTempHandler(Commander& cmdr)
 /// <returns>Boolean</returns>
 bool bluetoothHandler(Commander& cmdr)
 {
-	Log.trace("bluetoothHandler()" CR);
+	LOG_TRACE("bluetoothHandler()" CR);
 
 	if (cmdr.hasPayload())
 	{
@@ -767,20 +1226,7 @@ bool bluetoothHandler(Commander& cmdr)
 			cmdr.println("Invalid boolean value (On|Off|True|False)");
 		}
 
-		if (settings.CmdSettings.UseBluetooth)
-		{
-			cmd.attachInputPort(&SerialBT);
-			cmd.attachOutputPort(&SerialBT);
-			cmd.attachAltPort(&Serial);
-			cmd.echoToAlt(true);
-		}
-		else
-		{
-			cmd.attachInputPort(&Serial);
-			cmd.attachOutputPort(&Serial);
-			cmd.echoToAlt(false);
-			cmd.deleteAltPort();
-		}
+		attachCommander();
 	}
 	else
 	{
@@ -798,16 +1244,22 @@ const commandList_t commands[] = {
 	{"ap",		      apHandler,		   "show AP info"},
 	{"sta",		      staHandler,		   "show STA info"},
 	{"api",		      apiHandler,		   "show REST API"},
-	{"scan",	      scanHandler,		   "scan WiFi network"},
-	{"wifi",	      wifiHandler,		   "restart WiFi"},
+	{"scan",	      scanHandler,		   "scan WiFi network (scan force)"},
+	{"wifi",	      wifiHandler,		   "restart WiFi (wifi state)"},
 	{"ping",	      pingHandler,		   "pinging IP address"},
 	{"init",	      initHandler,		   "intialize settings"},
 	{"save",	      saveHandler,		   "save settings"},
-	{"data",	      dataHandler,		   "show sensor data"},
+	{"data",	      dataHandler,		   "show sensor data (data version)"},
 	{"soil",	      soilHandler,		   "show soil sensor data"},
 	{"temp",	      tempHandler,		   "show temp sensor data"},
 	{"reset",	      resetHandler,		   "reset WiFi settings"},
 	{"level",	      levelHandler,		   "get/set log level"},
+	{"log",		      logHandler,		   "show/clear log file"},
+	{"perf",	      perfHandler,		   "show loop latency (perf reset)"},
+	{"mqtt",	      mqttHandler,		   "show MQTT publisher (mqtt clear)"},
+	{"influx",	      influxHandler,	   "show InfluxDB uploader (influx clear)"},
+	{"coap",	      coapHandler,		   "show CoAP server (coap clear)"},
+	{"capture",	      captureHandler,	   "raw sensor capture (start|stop|dump)"},
 	{"spiffs",	      spiffsHandler,       "show SPIFFS info"},
 	{"server",	      serverHandler,	   "show server info"},
 	{"system",	      systemHandler,	   "show system info"},
@@ -821,8 +1273,11 @@ const commandList_t commands[] = {
 	{"settings-sta",  settingsStaHandler,  "-get/set Sta settings"},
 	{"settings-log",  settingsLogHandler,  "-get/set Log settings"},
 	{"settings-cmd",  settingsCmdHandler,  "-get/set Cmd settings"},
+	{"settings-mqtt", settingsMqttHandler, "-get/set Mqtt settings"},
+	{"settings-influx", settingsInfluxHandler, "-get/set Influx settings"},
 	{"settings-soil", settingsSoilHandler, "-get/set Soil settings"},
 	{"settings-temp", settingsTempHandler, "-get/set Temp settings"},
+	{"bench",	      benchHandler,	       "-benchmark /data serialization"},
 };
 
 /// <summary>
@@ -830,9 +1285,9 @@ const commandList_t commands[] = {
 /// </summary>
 void initCommander()
 {
-	Log.trace("initCommander()" CR);
+	LOG_TRACE("initCommander()" CR);
 
-	if (settings.CmdSettings.UseBluetooth)
+	if (settings.CmdSettings.UseBluetooth && bluetoothStarted)
 	{
 		cmd.begin(&SerialBT, commands, sizeof(commands));
 		cmd.attachAltPort(&Serial);
@@ -856,3 +1311,25 @@ void initCommander()
 	cmd.errorMessages(settings.CmdSettings.ErrorMessages);
 	cmd.printCommandPrompt();
 }
+
+/// <summary>
+///  Attach the command ports: the Bluetooth serial (serial port as alternate port) if enabled and started,
+///  the serial port otherwise.
+/// </summary>
+void attachCommander()
+{
+	if (settings.CmdSettings.UseBluetooth && bluetoothStarted)
+	{
+		cmd.attachInputPort(&SerialBT);
+		cmd.attachOutputPort(&SerialBT);
+		cmd.attachAltPort(&Serial);
+		cmd.echoToAlt(true);
+	}
+	else
+	{
+		cmd.attachInputPort(&Serial);
+		cmd.attachOutputPort(&Serial);
+		cmd.echoToAlt(false);
+		cmd.deleteAltPort();
+	}
+}
@@ -0,0 +1,118 @@
+﻿// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Influx.ino" company="DTV-Online">
+//  Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//  Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// <summary>
+//  All functions relating to the InfluxDB uploader. Note that this file is merged with all other '.ino' files.
+// </summary>
+// --------------------------------------------------------------------------------------------------------------------
+
+// The earliest valid time (2020-01-01), the samples are not uploaded before the time is set (NTP).
+const time_t INFLUX_VALID_TIME = 1577836800;
+
+/// <summary>
+///  Initializes the InfluxDB uploader: restores the flash spool and applies the InfluxDB settings.
+/// </summary>
+void initInflux()
+{
+	LOG_TRACE("initInflux()" CR);
+
+	influxSpool.begin();
+	applyInfluxSettings();
+}
+
+/// <summary>
+///  Applies the InfluxDB settings (server, request path, token, batch limits, compression).
+/// </summary>
+void applyInfluxSettings()
+{
+	LOG_TRACE("applyInfluxSettings()" CR);
+
+	influxUploader.configure(settings.InfluxSettings.Server.c_str(),
+		settings.InfluxSettings.Port,
+		settings.InfluxSettings.Path.c_str(),
+		settings.InfluxSettings.Token.c_str());
+	influxUploader.setBatch(settings.InfluxSettings.Lines, settings.InfluxSettings.MaxAge, settings.InfluxSettings.Gzip);
+	influxVersion = sensors.getVersion();
+}
+
+/// <summary>
+///  Runs the InfluxDB uploader from the main loop (never waits for the server): adds a line for every sensor
+///  value reported since the last call, and completes, sends, and retries the batches.
+/// </summary>
+void updateInflux()
+{
+	if (!influxUploader.isActive())
+	{
+		return;
+	}
+
+	uint32_t version = sensors.getVersion();
+
+	if (version != influxVersion)
+	{
+		addInfluxLines(influxVersion);
+		influxVersion = version;
+	}
+
+	influxUploader.update();
+}
+
+/// <summary>
+///  Adds a line for every sensor reported after the specified version (report by exception, see Sensors).
+///  Example: soil,host=soilmonitor,name=Sensor\ 1,sensor=0 humidity=45i,voltage=2.58 1600000000
+/// </summary>
+/// <param name="since">The data version of the last call</param>
+void addInfluxLines(uint32_t since)
+{
+	time_t now = time(NULL);
+	char buffer[160];
+	char index[4];
+
+	if (now < INFLUX_VALID_TIME)
+	{
+		return;
+	}
+
+	for (unsigned short i = 0; i < SoilSensors::MAX_SENSORS; i++)
+	{
+		if (sensors.SoilSensors.isEnabledByIndex(i) && sensors.SoilSensors.isChangedByIndex(i, since))
+		{
+			LineWriter line(buffer, sizeof(buffer));
+			snprintf(index, sizeof(index), "%u", i);
+			line.begin("soil");
+			line.tag("host", settings.StaSettings.Hostname.c_str());
+			line.tag("name", sensors.SoilSensors.getNameByIndex(i).c_str());
+			line.tag("sensor", index);
+			line.field("humidity", sensors.SoilSensors.getHumidityByIndex(i));
+			line.field("voltage", sensors.SoilSensors.getVoltageByIndex(i));
+
+			if (line.end((uint32_t)now))
+			{
+				influxUploader.addLine(line.getData(), line.getLength());
+			}
+		}
+	}
+
+	for (unsigned short i = 0; i < TempSensors::MAX_SENSORS; i++)
+	{
+		if (sensors.TempSensors.isConnectedByIndex(i) && sensors.TempSensors.isChangedByIndex(i, since))
+		{
+			LineWriter line(buffer, sizeof(buffer));
+			snprintf(index, sizeof(index), "%u", i);
+			line.begin("temp");
+			line.tag("host", settings.StaSettings.Hostname.c_str());
+			line.tag("name", sensors.TempSensors.getNameByIndex(i).c_str());
+			line.tag("sensor", index);
+			line.field("celsius", sensors.TempSensors.getTempCByIndex(i));
+
+			if (line.end((uint32_t)now))
+			{
+				influxUploader.addLine(line.getData(), line.getLength());
+			}
+		}
+	}
+}
@@ -11,29 +11,29 @@
 // --------------------------------------------------------------------------------------------------------------------
 
 /// <summary>
-///  Printing a timestamp when logging.
+///  Initialize custom logging using log settings.
 /// </summary>
-/// <param name="_logOutput">Pointer to print output</param>
-void printTimestamp(Print* _logOutput)
+void initLogging()
 {
-	Log.verbose("initCommander()" CR);
+	LOG_TRACE("initLogging()" CR);
 
-	unsigned long runMillis = millis();
-	unsigned long allSeconds = millis() / 1000;
-	int runHours = allSeconds / 3600;
-	int secsRemaining = allSeconds % 3600;
-	int runMinutes = secsRemaining / 60;
-	int runSeconds = secsRemaining % 60;
+	// Attach the log sinks and start the log task.
+	logFile.begin();
+	syslogSink.begin();
+	Logger::attach(&serialSink);
+	Logger::attach(&logFile);
+	Logger::attach(&syslogSink);
+	Logger::begin(settings.LogSettings.getArduinoLogLevelApp());
 
-	_logOutput->printf("%02d:%02d:%02d ", runHours, runMinutes, runSeconds);
+	applyLogSettings();
 }
 
 /// <summary>
-///  Initialize custom logging using log settings.
+///  Applies the log settings (esp log levels, application log level, syslog server).
 /// </summary>
-void initLogging()
+void applyLogSettings()
 {
-	Log.trace("initCommander()" CR);
+	LOG_TRACE("applyLogSettings()" CR);
 
 	// Set the esp log level
 	esp_log_level_set("*",     settings.LogSettings.getEspLevelAll());
@@ -41,6 +41,19 @@ void initLogging()
 	esp_log_level_set("dhcps", settings.LogSettings.getEspLevelDhcps());
 	esp_log_level_set("dhcpc", settings.LogSettings.getEspLevelDhcpc());
 
-	Log.begin(settings.LogSettings.getArduinoLogLevelApp(), &Serial);
-	Log.setPrefix(printTimestamp);
+	Logger::setLevel(settings.LogSettings.getArduinoLogLevelApp());
+
+	syslogSink.configure(settings.LogSettings.getArduinoLogLevelSyslog(),
+		settings.LogSettings.getSyslogServer().c_str(),
+		settings.LogSettings.getSyslogPort(),
+		settings.StaSettings.Hostname.c_str());
+}
+
+/// <summary>
+///  Returns true if the WiFi station is connected (used by the syslog sink).
+/// </summary>
+/// <returns>True if connected</returns>
+bool isNetworkConnected()
+{
+	return WiFi.isConnected();
 }
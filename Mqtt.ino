@@ -0,0 +1,118 @@
+﻿// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Mqtt.ino" company="DTV-Online">
+//  Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//  Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// <summary>
+//  All functions relating to the MQTT publisher. Note that this file is merged with all other '.ino' files.
+// </summary>
+// --------------------------------------------------------------------------------------------------------------------
+
+/// <summary>
+///  Initializes the MQTT publisher: restores the flash queue and applies the MQTT settings.
+/// </summary>
+void initMqtt()
+{
+	LOG_TRACE("initMqtt()" CR);
+
+	mqttQueue.begin();
+	applyMqttSettings();
+	mqttTimer.start();
+}
+
+/// <summary>
+///  Applies the MQTT settings (broker, client id, topic, frame interval, batch size, drain rate).
+///  The hostname is used as client id if no client id is set.
+/// </summary>
+void applyMqttSettings()
+{
+	LOG_TRACE("applyMqttSettings()" CR);
+
+	String clientId = settings.MqttSettings.ClientId;
+	String topic = settings.MqttSettings.Topic + "/data";
+
+	if (clientId.length() == 0)
+	{
+		clientId = settings.StaSettings.Hostname;
+	}
+
+	mqttClient.configure(settings.MqttSettings.Server.c_str(),
+		settings.MqttSettings.Port,
+		clientId.c_str(),
+		settings.MqttSettings.User.c_str(),
+		settings.MqttSettings.Pass.c_str());
+	mqttPublisher.configure(topic.c_str(), settings.MqttSettings.Batch, settings.MqttSettings.DrainRate);
+	mqttTimer.set(settings.MqttSettings.Interval * 1000UL);
+}
+
+/// <summary>
+///  Runs the MQTT publisher from the main loop (never waits for the broker): adds a sensor frame every interval,
+///  runs the client state machine, and publishes the queued messages.
+/// </summary>
+void updateMqtt()
+{
+	if (!mqttClient.isActive())
+	{
+		return;
+	}
+
+	if (mqttTimer.repeat())
+	{
+		addMqttFrame();
+	}
+
+	mqttClient.update();
+	mqttPublisher.update();
+}
+
+/// <summary>
+///  Adds a frame with the current sensor values (uptime, data version, humidity of the soil sensors, and
+///  temperature of the temperature sensors, null if disabled or not connected).
+///  Example: {"Time":3600,"Version":812,"Soil":[45,null,...],"Temp":[21.50,null,...]}
+/// </summary>
+void addMqttFrame()
+{
+	char frame[256];
+	size_t size = sizeof(frame);
+	int n = snprintf(frame, size, "{\"Time\":%lu,\"Version\":%lu,\"Soil\":[",
+		(unsigned long)(millis() / 1000), (unsigned long)sensors.getVersion());
+
+	for (unsigned short i = 0; i < SoilSensors::MAX_SENSORS; i++)
+	{
+		if (sensors.SoilSensors.isEnabledByIndex(i))
+		{
+			n += snprintf(frame + n, size - n, "%s%d", (i > 0) ? "," : "", sensors.SoilSensors.getHumidityByIndex(i));
+		}
+		else
+		{
+			n += snprintf(frame + n, size - n, "%snull", (i > 0) ? "," : "");
+		}
+	}
+
+	n += snprintf(frame + n, size - n, "],\"Temp\":[");
+
+	for (unsigned short i = 0; i < TempSensors::MAX_SENSORS; i++)
+	{
+		if (sensors.TempSensors.isConnectedByIndex(i))
+		{
+			n += snprintf(frame + n, size - n, "%s%.2f", (i > 0) ? "," : "", sensors.TempSensors.getTempCByIndex(i));
+		}
+		else
+		{
+			n += snprintf(frame + n, size - n, "%snull", (i > 0) ? "," : "");
+		}
+	}
+
+	n += snprintf(frame + n, size - n, "]}");
+
+	if ((n > 0) && ((size_t)n < size))
+	{
+		mqttPublisher.addFrame(frame, n);
+	}
+	else
+	{
+		LOG_ERROR("addMqttFrame() frame too large" CR);
+	}
+}
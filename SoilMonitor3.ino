@@ -29,6 +29,9 @@
 #include <esp_wifi.h>
 #include <nvs_flash.h>
 
+#include "src/Logger.h"
+#include "src/LogFile.h"
+#include "src/LogSyslog.h"
 #include "src/Sensors.h"
 #include "src/Settings.h"
 #include "src/ApInfo.h"
@@ -37,7 +40,22 @@
 #include "src/ServerInfo.h"
 #include "src/SystemInfo.h"
 #include "src/WiFiManager.h"
+#include "src/ScanInfo.h"
+#include "src/Profiler.h"
+#include "src/HeapMonitor.h"
 #include "src/MimeTypes.h"
+#include "src/Routes.h"
+#include "src/SensorCapture.h"
+#include "src/WireFormat.h"
+#include "src/JsonWire.h"
+#include "src/NameList.h"
+#include "src/MetricsWriter.h"
+#include "src/MqttClient.h"
+#include "src/FlashQueue.h"
+#include "src/MqttPublisher.h"
+#include "src/LineWriter.h"
+#include "src/InfluxUploader.h"
+#include "src/CoapServer.h"
 
 // Set the software version for the SystemInfoClass.
 char* SystemInfo::SOFTWARE_VERSION = "V1.0.2 2020-04-04";
@@ -46,6 +64,9 @@ char* SystemInfo::SOFTWARE_VERSION = "V1.0.2 2020-04-04";
 auto HEADER = "SoilMonitor2";
 auto COPYRIGHT = "Copyright (c) 2020 - Dr. Peter Trimmel";
 
+// The stack size of the Bluetooth start task (fast boot).
+const uint32_t BLUETOOTH_STACK_SIZE = 4096;
+
 // On board LED.
 JLed led = JLed(LED_BUILTIN).Blink(500, 500).Forever();
 
@@ -53,8 +74,16 @@ JLed led = JLed(LED_BUILTIN).Blink(500, 500).Forever();
 Neotimer updateTimer = Neotimer(1000);
 Neotimer rebootTimer = Neotimer(5000);
 
-// Bluetooth support (Serial).
+// Bluetooth support (Serial), the started flag is set by the Bluetooth start task (fast boot).
 BluetoothSerial SerialBT;
+volatile bool bluetoothStarted = false;
+bool bluetoothPending = false;
+
+// Log outputs (Serial, SPIFFS, Syslog).
+PrintSink serialSink(&Serial);
+LogFile logFile(&SPIFFS);
+WiFiUDP syslogUdp;
+LogSyslog syslogSink(&syslogUdp, &isNetworkConnected);
 
 // The command processing (Serial)
 Commander cmd;
@@ -62,6 +91,9 @@ Commander cmd;
 // Setup soil sensors using defaults.
 Sensors sensors;
 
+// The raw sensor input capture (SPIFFS).
+SensorCapture capture(&SPIFFS);
+
 // The global application settings (WiFi, sensors).
 Settings settings(&sensors);
 
@@ -72,6 +104,33 @@ WiFiManager manager(&settings);
 WiFiServer server(ServerInfo::PORT);
 Application app;
 
+// The request header buffers (entity tag validation, content negotiation).
+char ifNoneMatch[16];
+char accept[64];
+
+// The MQTT publisher (batched sensor frames, flash queue if the broker is not reachable).
+WiFiClient mqttWiFiClient;
+MqttClient mqttClient(&mqttWiFiClient, &isNetworkConnected);
+FlashQueue mqttQueue(&SPIFFS, "/mqtt");
+MqttPublisher mqttPublisher(&mqttClient, &mqttQueue);
+Neotimer mqttTimer = Neotimer(60000);
+
+// The InfluxDB uploader (line protocol batches, flash spool if the upload fails).
+WiFiClient influxWiFiClient;
+FlashQueue influxSpool(&SPIFFS, "/influx");
+InfluxUploader influxUploader(&influxWiFiClient, &isNetworkConnected, &influxSpool);
+uint32_t influxVersion = 0;
+
+// The CoAP server (read only sensor resources in CBOR, Observe), the resources are provided by Coap.ino.
+WiFiUDP coapUdp;
+CoapServer coapServer(&coapUdp, &isNetworkConnected, {
+	&findCoapResource, &getCoapVersion, &writeCoapResource,
+	"</data>;obs;ct=60,</system>;obs;ct=60,"
+	"</soil/0>;obs;ct=60,</soil/1>;obs;ct=60,</soil/2>;obs;ct=60,"
+	"</soil/3>;obs;ct=60,</soil/4>;obs;ct=60,</soil/5>;obs;ct=60,"
+	"</temp/0>;obs;ct=60,</temp/1>;obs;ct=60,</temp/2>;obs;ct=60,"
+	"</temp/3>;obs;ct=60,</temp/4>;obs;ct=60,</temp/5>;obs;ct=60" });
+
 // System infos.
 SystemInfo sysInfo;
 
@@ -95,44 +154,139 @@ void setup()
 		err = nvs_flash_init();
 	}
 
-	// Initialize serial and wait 1 second for port to open.
-	Serial.begin(115200);
-	delay(1000);
+	sysInfo.addBootPhase("NVS");
 
-	// Print application startup info.
-	Serial.println(HEADER);
-	Serial.println(COPYRIGHT);
-	Serial.println();
+	// Initialize serial (the port is opened while reading the settings).
+	Serial.begin(115200);
 
 	// Mount the SPIFFS.
 	if (!SPIFFS.begin())
 	{
-		Log.fatal("An Error has occurred while mounting SPIFFS" CR);
+		LOG_FATAL("An Error has occurred while mounting SPIFFS" CR);
 		return;
 	}
 
-	// Initialize system info and settings.
+	sysInfo.addBootPhase("SPIFFS");
+
+	// Initialize heap accounting (main loop task), system info and settings.
+	HeapMonitor::begin();
 	sysInfo.init();
 	settings.init(sysInfo);
+	sysInfo.FastBoot = settings.FastBoot;
+	sysInfo.addBootPhase("Settings");
 
-	// Initializing Bluetooth serial and wait 1 second.
-	SerialBT.begin(settings.CmdSettings.LocalName);
-	delay(1000);
+	// Fast boot: start the sensors first (no fixed delays).
+	if (settings.FastBoot)
+	{
+		initSensors();
+	}
+	// Wait 1 second for the serial port to open.
+	else
+	{
+		delay(1000);
+	}
+
+	// Print application startup info.
+	Serial.println(HEADER);
+	Serial.println(COPYRIGHT);
+	Serial.println();
+
+	// Initializing Bluetooth serial (in the background using fast boot) or wait 1 second.
+	// The commander uses the serial port until the Bluetooth serial has been started (see loop).
+	if (settings.FastBoot &&
+		(xTaskCreatePinnedToCore(&initBluetooth, "bluetooth", BLUETOOTH_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL, 0) == pdPASS))
+	{
+		bluetoothPending = true;
+	}
+	else
+	{
+		SerialBT.begin(settings.CmdSettings.LocalName);
+		bluetoothStarted = true;
+
+		if (!settings.FastBoot)
+		{
+			delay(1000);
+		}
+
+		sysInfo.addBootPhase("Bluetooth");
+	}
 
 	// Initialize logging (Serial).
 	initLogging();
+	sysInfo.addBootPhase("Logging");
 
-	// Try to connect WiFi, and start the sensors.
+	// Start to connect WiFi (completed in loop), and start the sensors.
 	manager.connect();
-	sensors.SoilSensors.begin();
-	sensors.TempSensors.begin();
+	sysInfo.addBootPhase("WiFi");
+
+	if (!settings.FastBoot)
+	{
+		initSensors();
+	}
 
 	// Initialize the commander and the web server.
 	initCommander();
 	initServer();
+	sysInfo.addBootPhase("Server");
+
+	// Initialize the MQTT publisher (connects in loop).
+	initMqtt();
+	sysInfo.addBootPhase("Mqtt");
 
-	// Start timer.
+	// Initialize the InfluxDB uploader (connects in loop).
+	initInflux();
+	sysInfo.addBootPhase("Influx");
+
+	// Start timer and profiler.
 	updateTimer.start();
+	Profiler::reset();
+}
+
+/// <summary>
+/// Initializes the sensors and takes the first soil sensor sample.
+/// </summary>
+void initSensors()
+{
+	sensors.SoilSensors.begin();
+	sensors.TempSensors.begin();
+	sensors.SoilSensors.update();
+	sysInfo.addBootPhase("Sensors");
+}
+
+/// <summary>
+/// Adds the raw inputs of the enabled soil sensors and the connected temperature sensors to the capture.
+/// </summary>
+void captureSensors()
+{
+	uint32_t time = millis();
+
+	for (unsigned short i = 0; i < SoilSensors::MAX_SENSORS; i++)
+	{
+		if (sensors.SoilSensors.isEnabledByIndex(i))
+		{
+			capture.add(time, SensorCapture::CHANNEL_SOIL, i, sensors.SoilSensors.getValueByIndex(i));
+		}
+	}
+
+	for (unsigned short i = 0; i < TempSensors::MAX_SENSORS; i++)
+	{
+		if (sensors.TempSensors.isConnectedByIndex(i))
+		{
+			capture.add(time, SensorCapture::CHANNEL_TEMP, i, (int16_t)lroundf(sensors.TempSensors.getTempCByIndex(i) * 100));
+		}
+	}
+}
+
+/// <summary>
+/// Initializes the Bluetooth serial (background task used in fast boot mode).
+/// </summary>
+/// <param name="parameter">The task parameter (not used)</param>
+void initBluetooth(void* parameter)
+{
+	SerialBT.begin(settings.CmdSettings.LocalName);
+	sysInfo.addBootPhase("Bluetooth");
+	bluetoothStarted = true;
+	vTaskDelete(NULL);
 }
 
 /// <summary>
@@ -140,25 +294,77 @@ void setup()
 /// </summary>
 void loop()
 {
+	uint32_t start = Profiler::start();
 	WiFiClient client = server.available();
+	uint32_t time = start;
 
 	led.Update();
-	cmd.update();
+	time = Profiler::lap(Profiler::PHASE_LED, time);
+
+	{
+		HeapScope scope(HeapMonitor::SUBSYSTEM_COMMANDER);
+
+		// Attach the commander to the Bluetooth serial once the start task has completed (fast boot).
+		if (bluetoothPending && bluetoothStarted)
+		{
+			bluetoothPending = false;
+			attachCommander();
+		}
+
+		cmd.update();
+	}
+
+	time = Profiler::lap(Profiler::PHASE_COMMANDS, time);
+	manager.loop();
+	time = Profiler::lap(Profiler::PHASE_WIFI, time);
 
 	if (client.connected())
 	{
-		app.process(&client);
+		{
+			HeapScope scope(HeapMonitor::SUBSYSTEM_WEB);
+			app.process(&client);
+		}
+
+		Profiler::recordRoute(micros() - time);
+		time = Profiler::lap(Profiler::PHASE_HTTP, time);
 	}
 
 	if (updateTimer.repeat())
 	{
-		sensors.SoilSensors.update();
-		sensors.TempSensors.update();
+		{
+			HeapScope scope(HeapMonitor::SUBSYSTEM_SENSORS);
+			// The capture requires all samples (the adaptive sampling is suspended).
+			sensors.SoilSensors.update(capture.isRunning());
+			sensors.TempSensors.update(capture.isRunning());
+
+			if (capture.isRunning())
+			{
+				captureSensors();
+			}
+		}
+
+		time = Profiler::lap(Profiler::PHASE_SENSORS, time);
 		sysInfo.update();
+		time = Profiler::lap(Profiler::PHASE_SYSTEM, time);
 	}
 
+	updateMqtt();
+	time = Profiler::lap(Profiler::PHASE_MQTT, time);
+	updateInflux();
+	time = Profiler::lap(Profiler::PHASE_INFLUX, time);
+
+	{
+		HeapScope scope(HeapMonitor::SUBSYSTEM_WEB);
+		coapServer.update();
+	}
+
+	time = Profiler::lap(Profiler::PHASE_COAP, time);
+
+	Profiler::lap(Profiler::PHASE_LOOP, start);
+
 	if (rebootTimer.done())
 	{
+		Logger::flush();
 		ESP.restart();
 	}
 }
@@ -59,15 +59,14 @@ String getFilePath(Request& request)
 /// <param name="message">The error message</param>
 void setError(Response& response, int code, String message)
 {
-	String str = "Error " + String(code) + String(": ") + message + CR;
-	Log.error(str.c_str());
+	LOG_ERROR("Error %d: %s" CR, code, message.c_str());
 
 	error.Code = code;
 	error.Message = message;
 	String path("/error.html");
 
 	if (!SPIFFS.exists(path.c_str())) {
-		Log.warning("getFile() file does not exist" CR);
+		LOG_WARNING("getFile() file does not exist" CR);
 		response.sendStatus(404);
 		return;
 	}
@@ -75,7 +74,7 @@ void setError(Response& response, int code, String message)
 	File file = SPIFFS.open(path);
 
 	if (file.isDirectory()) {
-		Log.warning("getFile() directory not supported" CR);
+		LOG_WARNING("getFile() directory not supported" CR);
 		response.sendStatus(400);
 		file.close();
 		return;
@@ -92,6 +91,39 @@ void setError(Response& response, int code, String message)
 	file.close();
 }
 
+/// <summary>
+///  Returns the response format requested by the client (Accept header, JSON by default).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <returns>The response format</returns>
+WireFormat::Format getFormat(Request& request)
+{
+	return WireFormat::negotiate(request.header("Accept"));
+}
+
+/// <summary>
+///  Sets the status and the content type of a response in the negotiated format.
+/// </summary>
+/// <param name="response">Reference to the Response instance</param>
+/// <param name="format">The response format</param>
+void setFormat(Response& response, WireFormat::Format format)
+{
+	response.status(200);
+	response.set("Content-Type", WireFormat::getContentType(format));
+	response.set("Vary", "Accept");
+}
+
+/// <summary>
+///  Returns the fields selected by the query parameter (e.g. ?fields=Humidity,TempC, empty: all fields).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <returns>The selected fields</returns>
+NameList getFields(Request& request)
+{
+	char fields[NameList::MAX_LENGTH];
+	return NameList(request.query("fields", fields, sizeof(fields)) ? fields : NULL);
+}
+
 /// <summary>
 ///  Middleware handler to log request infos, and redirect to error page for not found error (404).
 /// </summary>
@@ -101,74 +133,19 @@ void checkRequest(Request& request, Response& response)
 {
 	String path(request.path());
 
-	Log.trace("checkRequest() %s %s" CR, getMethod(request), request.path());
-
-	// Ignore map files.
-	if ((path == "/js/bootstrap.min.js.map") ||
-		(path == "/css/bootstrap.min.css.map") ||
-		(path == "/css/bootstrap-grid.min.css.map") ||
-		(path == "/css/bootstrap-reboot.min.css.map") ||
-		(path == "/css/soilmonitor.min.css.map") ||
-		(path == "/js/bootstrap.min.js.map") ||
-		(path == "/js/bootstrap.bundle.min.js.map") ||
-		(path == "/js/popper.min.js.map") ||
-		(path == "/js/jquery-3.4.1.min.js.map") ||
-		(path == "/js/jquery.inputmask.min.js.map") ||
-		(path == "/js/raphael-2.1.4.min.js.map") ||
-		(path == "/js/justgage.min.js.map"))
-	{
-		return;
-	}
+	Routes::Match match = Routes::match(request.path());
+
+	LOG_TRACE("checkRequest() %s %s" CR, getMethod(request).c_str(), request.path());
+	Profiler::setRoute(request.path(), match == Routes::MATCH_ACCEPTED);
 
-	// Accept files and JSON requests.
-	if ((path == "/") ||
-		(path == "/home") ||
-		(path == "/info") ||
-		(path == "/config") ||
-		(path == "/about") ||
-		(path == "/error") ||
-		(path == "/favicon.ico") ||
-		(path == "/css/bootstrap.min.css") ||
-		(path == "/css/bootstrap-grid.min.css") ||
-		(path == "/css/bootstrap-reboot.min.css") ||
-		(path == "/css/soilmonitor.min.css") ||
-		(path == "/js/bootstrap.min.js") ||
-		(path == "/js/bootstrap.bundle.min.js") ||
-		(path == "/js/popper.min.js") ||
-		(path == "/js/jquery-3.4.1.min.js") ||
-		(path == "/js/jquery.inputmask.min.js") ||
-		(path == "/js/raphael-2.1.4.min.js") ||
-		(path == "/js/justgage.min.js") ||
-		(path == "/ap") ||
-		(path == "/sta") ||
-		(path == "/err") ||
-		(path == "/server") ||
-		(path == "/system") ||
-		(path == "/data") ||
-		(path == "/soil") ||
-		(path == "/temp") ||
-		 path.startsWith("/soil/") ||
-		 path.startsWith("/temp/") ||
-		(path == "/settings") ||
-		(path == "/settings/ap") ||
-		(path == "/settings/sta") ||
-		(path == "/settings/log") ||
-		(path == "/settings/cmd") ||
-		(path == "/settings/soil") ||
-		(path == "/settings/temp") ||
-		 path.startsWith("/settings/soil/") ||
-		 path.startsWith("/settings/temp/") ||
-		(path == "/save") ||
-		(path == "/reset") ||
-		(path == "/reboot"))
+	// Accept files and JSON requests, ignore map files.
+	if (match != Routes::MATCH_NONE)
 	{
 		return;
 	}
-	else
-	{
-		// Redirect to error page.
-		setError(response, 404, "Sorry, an error has occured: The requested resource '" + path + String("' has not been found!"));
-	}
+
+	// Redirect to error page.
+	setError(response, 404, "Sorry, an error has occured: The requested resource '" + path + String("' has not been found!"));
 }
 
 /// <summary>
@@ -180,7 +157,7 @@ void getFile(Request& request, Response& response)
 {
 	if (request.method() != Request::GET)
 	{
-		Log.warning("getFile() only GET supported" CR);
+		LOG_WARNING("getFile() only GET supported" CR);
 		response.sendStatus(400);
 		return;
 	}
@@ -188,7 +165,7 @@ void getFile(Request& request, Response& response)
 	String path = getFilePath(request);
 
 	if (!SPIFFS.exists(path.c_str())) {
-		Log.warning("getFile() file does not exist" CR);
+		LOG_WARNING("getFile() file does not exist" CR);
 		response.sendStatus(404);
 		return;
 	}
@@ -196,7 +173,7 @@ void getFile(Request& request, Response& response)
 	File file = SPIFFS.open(path);
 
 	if (file.isDirectory()) {
-		Log.warning("getFile() directory not supported" CR);
+		LOG_WARNING("getFile() directory not supported" CR);
 		response.sendStatus(400);
 		file.close();
 		return;
@@ -244,6 +221,48 @@ void getStaInfo(Request& request, Response& response)
 	response.print(info.serialize());
 }
 
+/// <summary>
+///  Middleware handler to return the cached WiFi scan results (JSON).
+///  A new async scan is started if the cached results are stale (use '/scan?force=1' to start a scan).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getScan(Request& request, Response& response)
+{
+	char force[8];
+	manager.scan(request.query("force", force, sizeof(force)));
+
+	ScanInfo info(&manager);
+	response.status(200);
+	response.set("Content-Type", "application/json");
+	response.print(info.serialize());
+}
+
+/// <summary>
+///  Middleware handler to return the profiler histograms (JSON).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getPerf(Request& request, Response& response)
+{
+	response.status(200);
+	response.set("Content-Type", "application/json");
+	Profiler::print(response);
+}
+
+/// <summary>
+///  Middleware handler to reset the profiler histograms.
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void postPerf(Request& request, Response& response)
+{
+	Profiler::reset();
+	response.status(202);
+	response.set("Content-Type", "text/plain");
+	response.print("Profiler reset");
+}
+
 /// <summary>
 ///  Middleware handler to return ErrInfo (JSON).
 /// </summary>
@@ -282,43 +301,459 @@ void getSystemInfo(Request& request, Response& response)
 }
 
 /// <summary>
-///  Middleware handler to return all sensor data (JSON).
+///  Middleware handler to return the heap trend buffer (JSON, CBOR, or MessagePack).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getSystemTrend(Request& request, Response& response)
+{
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		HeapMonitor::printTrend(response);
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		HeapMonitor::writeTrend(writer);
+	}
+}
+
+/// <summary>
+///  Returns the entity tag of a response body (FNV-1a hash, quoted).
+/// </summary>
+/// <param name="body">The response body</param>
+/// <returns>The entity tag</returns>
+String getETag(const String& body)
+{
+	uint32_t hash = 2166136261UL;
+
+	for (unsigned int i = 0; i < body.length(); i++)
+	{
+		hash = (hash ^ (uint8_t)body[i]) * 16777619UL;
+	}
+
+	return String("\"") + String(hash, HEX) + String("\"");
+}
+
+/// <summary>
+///  Middleware handler to return all sensor data (JSON, CBOR, or MessagePack).
+///  Only the sensors changed after a version are returned using the query parameter (e.g. /data?since=1234),
+///  the returned version is used for the next request (report by exception, see ChangeTracker).
+///  If no sensor has changed 304 (not modified) is returned. The metadata is returned by /meta.
+///  The sensor fields can be selected using the query parameter (e.g. /data?fields=Humidity,TempC).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
 void getData(Request& request, Response& response)
+{
+	NameList fields = getFields(request);
+	char since[16];
+
+	if (request.query("since", since, sizeof(since)))
+	{
+		char* end = NULL;
+		unsigned long version = strtoul(since, &end, 10);
+
+		if ((since[0] < '0') || (since[0] > '9') || (*end != '\0'))
+		{
+			LOG_WARNING("getData() invalid version" CR);
+			response.sendStatus(400);
+			return;
+		}
+
+		if (!sensors.isChanged((uint32_t)version))
+		{
+			response.status(304);
+			response.set("Cache-Control", "no-cache");
+			response.end();
+			return;
+		}
+
+		WireFormat::Format format = getFormat(request);
+		setFormat(response, format);
+		response.set("Cache-Control", "no-cache");
+
+		if (format == WireFormat::FORMAT_JSON)
+		{
+			response.print(sensors.serialize((uint32_t)version, fields));
+		}
+		else
+		{
+			WireFormat writer(response, format);
+			sensors.serialize(writer, (uint32_t)version, fields);
+		}
+
+		return;
+	}
+
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(sensors.serialize(fields));
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		sensors.serialize(writer, fields);
+	}
+}
+
+/// <summary>
+///  Middleware handler to return the sensor metadata (names, addresses, and resolutions).
+///  The response is validated using the entity tag (If-None-Match returns 304 if the metadata is unchanged),
+///  the entity tag depends on the negotiated format.
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getMeta(Request& request, Response& response)
+{
+	WireFormat::Format format = getFormat(request);
+	String json = sensors.serializeMeta();
+	String etag = getETag(json + WireFormat::getContentType(format));
+	char* match = request.header("If-None-Match");
+
+	response.set("ETag", etag.c_str());
+	response.set("Cache-Control", "no-cache");
+
+	if ((match != NULL) && (etag == match))
+	{
+		response.status(304);
+		response.end();
+		return;
+	}
+
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(json);
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		sensors.serializeMeta(writer);
+	}
+}
+
+/// <summary>
+///  Returns true if the resource can be requested by a batch request (see getResource).
+/// </summary>
+/// <param name="name">The resource name</param>
+/// <returns>True if known</returns>
+bool isResource(const char* name)
+{
+	static const char* resources[] = {
+		"ap", "sta", "server", "err", "system", "data", "meta", "soil", "temp", "settings",
+		"settings/ap", "settings/sta", "settings/log", "settings/cmd", "settings/mqtt",
+		"settings/influx", "settings/soil", "settings/temp"
+	};
+
+	for (size_t i = 0; i < sizeof(resources) / sizeof(*resources); i++)
+	{
+		if (strcmp(resources[i], name) == 0) return true;
+	}
+
+	return false;
+}
+
+/// <summary>
+///  Returns the JSON string of a resource of a batch request (the name is the path without the leading slash).
+/// </summary>
+/// <param name="name">The resource name (e.g. "settings/soil")</param>
+/// <param name="fields">The selected sensor fields (data, soil, and temp)</param>
+/// <returns>The JSON string (empty if the resource is unknown)</returns>
+String getResource(const char* name, const NameList& fields)
+{
+	String resource(name);
+
+	if (resource == "ap")            { ApInfo info(WiFi); return info.serialize(); }
+	if (resource == "sta")           { StaInfo info(WiFi); return info.serialize(); }
+	if (resource == "server")        { ServerInfo info(WiFi); return info.serialize(); }
+	if (resource == "err")           return error.serialize();
+	if (resource == "system")        return sysInfo.serialize();
+	if (resource == "data")          return sensors.serialize(fields);
+	if (resource == "meta")          return sensors.serializeMeta();
+	if (resource == "soil")          return sensors.SoilSensors.serialize(fields);
+	if (resource == "temp")          return sensors.TempSensors.serialize(fields);
+	if (resource == "settings")      return settings.serialize();
+	if (resource == "settings/ap")   return settings.ApSettings.serialize();
+	if (resource == "settings/sta")  return settings.StaSettings.serialize();
+	if (resource == "settings/log")  return settings.LogSettings.serialize();
+	if (resource == "settings/cmd")  return settings.CmdSettings.serialize();
+	if (resource == "settings/mqtt") return settings.MqttSettings.serialize();
+	if (resource == "settings/influx") return settings.InfluxSettings.serialize();
+	if (resource == "settings/soil") return settings.SoilSettings.serialize();
+	if (resource == "settings/temp") return settings.TempSettings.serialize();
+
+	return String();
+}
+
+/// <summary>
+///  Writes a resource of a batch request in a binary format (the documents are written directly, see getResource).
+/// </summary>
+/// <param name="name">The resource name (e.g. "settings/soil")</param>
+/// <param name="fields">The selected sensor fields (data, soil, and temp)</param>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void writeResource(const char* name, const NameList& fields, WireFormat& writer)
+{
+	String resource(name);
+
+	if (resource == "ap")            { ApInfo info(WiFi); info.serialize(writer); return; }
+	if (resource == "sta")           { StaInfo info(WiFi); info.serialize(writer); return; }
+	if (resource == "server")        { ServerInfo info(WiFi); info.serialize(writer); return; }
+	if (resource == "err")           { error.serialize(writer); return; }
+	if (resource == "system")        { sysInfo.serialize(writer); return; }
+	if (resource == "data")          { sensors.serialize(writer, fields); return; }
+	if (resource == "meta")          { sensors.serializeMeta(writer); return; }
+	if (resource == "soil")          { sensors.SoilSensors.serialize(writer, fields); return; }
+	if (resource == "temp")          { sensors.TempSensors.serialize(writer, fields); return; }
+	if (resource == "settings")      { settings.serialize(writer); return; }
+	if (resource == "settings/ap")   { settings.ApSettings.serialize(writer); return; }
+	if (resource == "settings/sta")  { settings.StaSettings.serialize(writer); return; }
+	if (resource == "settings/log")  { settings.LogSettings.serialize(writer); return; }
+	if (resource == "settings/cmd")  { settings.CmdSettings.serialize(writer); return; }
+	if (resource == "settings/mqtt") { settings.MqttSettings.serialize(writer); return; }
+	if (resource == "settings/influx") { settings.InfluxSettings.serialize(writer); return; }
+	if (resource == "settings/soil") { settings.SoilSettings.serialize(writer); return; }
+	if (resource == "settings/temp") { settings.TempSettings.serialize(writer); return; }
+
+	writer.writeNull();
+}
+
+/// <summary>
+///  Middleware handler to return several resources in one response (e.g. /batch?r=server,ap,sta,settings).
+///  The resources are written one after the other as members of a single document (the resource name is the key),
+///  so only one resource is serialized at a time. The sensor fields can be selected (fields query parameter).
+///  An unknown resource returns 400 (bad request).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getBatch(Request& request, Response& response)
+{
+	char list[NameList::MAX_LENGTH];
+
+	if (!request.query("r", list, sizeof(list)))
+	{
+		LOG_WARNING("getBatch() no resources" CR);
+		response.sendStatus(400);
+		return;
+	}
+
+	NameList resources(list);
+	NameList fields = getFields(request);
+
+	if (resources.isEmpty() || !resources.isValid())
+	{
+		LOG_WARNING("getBatch() invalid resource list" CR);
+		response.sendStatus(400);
+		return;
+	}
+
+	for (uint8_t i = 0; i < resources.getCount(); i++)
+	{
+		if (!isResource(resources.getName(i)))
+		{
+			LOG_WARNING("getBatch() unknown resource %s" CR, resources.getName(i));
+			response.sendStatus(400);
+			return;
+		}
+	}
+
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+	response.set("Cache-Control", "no-cache");
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print('{');
+
+		for (uint8_t i = 0; i < resources.getCount(); i++)
+		{
+			if (i > 0) response.print(',');
+			response.print('"');
+			response.print(resources.getName(i));
+			response.print("\":");
+			response.print(getResource(resources.getName(i), fields));
+		}
+
+		response.println('}');
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		writer.writeMap(resources.getCount());
+
+		for (uint8_t i = 0; i < resources.getCount(); i++)
+		{
+			writer.writeString(resources.getName(i));
+			writeResource(resources.getName(i), fields, writer);
+		}
+	}
+}
+
+/// <summary>
+///  Middleware handler to return the metrics in the Prometheus text exposition format (uptime, sensors, heap,
+///  and WiFi signal strength). The lines are written to the response directly (no String or JSON document).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getMetrics(Request& request, Response& response)
 {
 	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(sensors.serialize());
+	response.set("Content-Type", MetricsWriter::CONTENT_TYPE);
+	response.set("Cache-Control", "no-cache");
+
+	MetricsWriter writer(response);
+	writer.writeFamily("soilmonitor_uptime_seconds", "gauge", "Time since the start.");
+	writer.writeInt("soilmonitor_uptime_seconds", millis() / 1000);
+	sensors.SoilSensors.writeMetrics(writer);
+	sensors.TempSensors.writeMetrics(writer);
+	HeapMonitor::writeMetrics(writer);
+
+	if (WiFi.isConnected())
+	{
+		writer.writeFamily("soilmonitor_wifi_rssi_dbm", "gauge", "WiFi signal strength (station).");
+		writer.writeInt("soilmonitor_wifi_rssi_dbm", WiFi.RSSI());
+	}
 }
 
 /// <summary>
-///  Middleware handler to return soil sensor data (JSON).
+///  Middleware handler to return the tail of the log file (text).
+///  The number of bytes can be specified using the query parameter (e.g. /log?tail=8192).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
-void getSoil(Request& request, Response& response)
+void getLog(Request& request, Response& response)
 {
+	char tail[16];
+	long count = 4096;
+
+	if (request.query("tail", tail, sizeof(tail)))
+	{
+		count = atol(tail);
+
+		if (count <= 0)
+		{
+			LOG_WARNING("getLog() invalid tail" CR);
+			response.sendStatus(400);
+			return;
+		}
+	}
+
 	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(sensors.SoilSensors.serialize());
+	response.set("Content-Type", "text/plain");
+	response.set("Cache-Control", "no-cache");
+	logFile.tail(response, count);
+	response.end();
 }
 
 /// <summary>
-///  Middleware handler to return temperature sensor data (JSON).
+///  Middleware handler to return the raw sensor input capture (binary file, see SensorCapture).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
-void getTemp(Request& request, Response& response)
+void getCapture(Request& request, Response& response)
 {
+	if ((capture.size() == 0) && !SPIFFS.exists(SensorCapture::PATH))
+	{
+		LOG_WARNING("getCapture() no capture available" CR);
+		response.sendStatus(404);
+		return;
+	}
+
 	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(sensors.TempSensors.serialize());
+	response.set("Content-Type", "application/octet-stream");
+	response.set("Content-Disposition", "attachment; filename=\"capture.bin\"");
+	response.set("Cache-Control", "no-cache");
+	capture.dump(response);
+	response.end();
+}
+
+/// <summary>
+///  Middleware handler to start a new raw sensor input capture.
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void postCaptureStart(Request& request, Response& response)
+{
+	if (!capture.start())
+	{
+		LOG_ERROR("postCaptureStart() unable to create capture file" CR);
+		response.sendStatus(500);
+		return;
+	}
+
+	response.status(202);
+	response.set("Content-Type", "text/plain");
+	response.print("Capture started");
+}
+
+/// <summary>
+///  Middleware handler to stop the raw sensor input capture.
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void postCaptureStop(Request& request, Response& response)
+{
+	capture.stop();
+	response.status(202);
+	response.set("Content-Type", "text/plain");
+	response.print("Capture stopped");
 }
 
 /// <summary>
-///  Middleware handler to return single soil sensor data (JSON).
+///  Middleware handler to return soil sensor data (JSON, CBOR, or MessagePack).
+///  The sensor fields can be selected using the query parameter (e.g. /soil?fields=Name,Humidity).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getSoil(Request& request, Response& response)
+{
+	NameList fields = getFields(request);
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(sensors.SoilSensors.serialize(fields));
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		sensors.SoilSensors.serialize(writer, fields);
+	}
+}
+
+/// <summary>
+///  Middleware handler to return temperature sensor data (JSON, CBOR, or MessagePack).
+///  The sensor fields can be selected using the query parameter (e.g. /temp?fields=Name,TempC).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getTemp(Request& request, Response& response)
+{
+	NameList fields = getFields(request);
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(sensors.TempSensors.serialize(fields));
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		sensors.TempSensors.serialize(writer, fields);
+	}
+}
+
+/// <summary>
+///  Middleware handler to return single soil sensor data (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
@@ -328,23 +763,32 @@ void getSoilByIndex(Request& request, Response& response)
 
 	request.route("i", index, 64);
 	short i = index[0] - 48;
-	Log.trace("getSoilByIndex() => %s" CR, index);
+	LOG_TRACE("getSoilByIndex() => %s" CR, index);
 
 	if ((i >= 0) && (i < SoilSensors::MAX_SENSORS))
 	{
-		response.status(200);
-		response.set("Content-Type", "application/json");
-		response.print(sensors.SoilSensors.serializeByIndex(i));
+		WireFormat::Format format = getFormat(request);
+		setFormat(response, format);
+
+		if (format == WireFormat::FORMAT_JSON)
+		{
+			response.print(sensors.SoilSensors.serializeByIndex(i));
+		}
+		else
+		{
+			WireFormat writer(response, format);
+			sensors.SoilSensors.serializeByIndex(i, writer);
+		}
 	}
 	else
 	{
-		Log.warning("getSoilByIndex() invalid index" CR);
+		LOG_WARNING("getSoilByIndex() invalid index" CR);
 		response.sendStatus(404);
 	}
 }
 
 /// <summary>
-///  Middleware handler to return single temperature sensor data (JSON).
+///  Middleware handler to return single temperature sensor data (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
@@ -354,107 +798,221 @@ void getTempByIndex(Request& request, Response& response)
 
 	request.route("i", index, 64);
 	short i = index[0] - 48;
-	Log.trace("getTempByIndex() => %s" CR, index);
+	LOG_TRACE("getTempByIndex() => %s" CR, index);
 
 	if ((i >= 0) && (i < TempSensors::MAX_SENSORS))
 	{
-		response.status(200);
-		response.set("Content-Type", "application/json");
-		response.print(sensors.TempSensors.serializeByIndex(i));
+		WireFormat::Format format = getFormat(request);
+		setFormat(response, format);
+
+		if (format == WireFormat::FORMAT_JSON)
+		{
+			response.print(sensors.TempSensors.serializeByIndex(i));
+		}
+		else
+		{
+			WireFormat writer(response, format);
+			sensors.TempSensors.serializeByIndex(i, writer);
+		}
 	}
 	else
 	{
-		Log.warning("getTempByIndex() invalid index" CR);
+		LOG_WARNING("getTempByIndex() invalid index" CR);
 		response.sendStatus(404);
 	}
 }
 
 /// <summary>
-///  Middleware handler to return all settings (JSON).
+///  Middleware handler to return all settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
 void getSettings(Request& request, Response& response)
 {
-	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(settings.serialize());
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.serialize(writer);
+	}
 }
 
 /// <summary>
-///  Middleware handler to return access point settings (JSON).
+///  Middleware handler to return access point settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
 void getApSettings(Request& request, Response& response)
 {
-	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(settings.ApSettings.serialize());
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.ApSettings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.ApSettings.serialize(writer);
+	}
 }
 
 /// <summary>
-///  Middleware handler to return WiFi station settings (JSON).
+///  Middleware handler to return WiFi station settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
 void getStaSettings(Request& request, Response& response)
 {
-	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(settings.StaSettings.serialize());
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.StaSettings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.StaSettings.serialize(writer);
+	}
 }
 
 /// <summary>
-///  Middleware handler to return log settings (JSON).
+///  Middleware handler to return log settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
 void getLogSettings(Request& request, Response& response)
 {
-	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(settings.LogSettings.serialize());
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.LogSettings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.LogSettings.serialize(writer);
+	}
 }
 
 /// <summary>
-///  Middleware handler to return commander settings (JSON).
+///  Middleware handler to return commander settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
 void getCmdSettings(Request& request, Response& response)
 {
-	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(settings.CmdSettings.serialize());
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.CmdSettings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.CmdSettings.serialize(writer);
+	}
+}
+
+/// <summary>
+///  Middleware handler to return MQTT settings (JSON, CBOR, or MessagePack).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getMqttSettings(Request& request, Response& response)
+{
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.MqttSettings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.MqttSettings.serialize(writer);
+	}
+}
+
+/// <summary>
+///  Middleware handler to return InfluxDB settings (JSON, CBOR, or MessagePack).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void getInfluxSettings(Request& request, Response& response)
+{
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.InfluxSettings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.InfluxSettings.serialize(writer);
+	}
 }
 
 /// <summary>
-///  Middleware handler to return soil sensor settings (JSON).
+///  Middleware handler to return soil sensor settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
 void getSoilSettings(Request& request, Response& response)
 {
-	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(settings.SoilSettings.serialize());
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.SoilSettings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.SoilSettings.serialize(writer);
+	}
 }
 
 /// <summary>
-///  Middleware handler to return temperature sensor settings (JSON).
+///  Middleware handler to return temperature sensor settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
 void getTempSettings(Request& request, Response& response)
 {
-	response.status(200);
-	response.set("Content-Type", "application/json");
-	response.print(settings.TempSettings.serialize());
+	WireFormat::Format format = getFormat(request);
+	setFormat(response, format);
+
+	if (format == WireFormat::FORMAT_JSON)
+	{
+		response.print(settings.TempSettings.serialize());
+	}
+	else
+	{
+		WireFormat writer(response, format);
+		settings.TempSettings.serialize(writer);
+	}
 }
 
 /// <summary>
-///  Middleware handler to return single soil sensor settings (JSON).
+///  Middleware handler to return single soil sensor settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
@@ -464,23 +1022,32 @@ void getSoilSettingsByIndex(Request& request, Response& response)
 
 	request.route("i", index, 64);
 	short i = index[0] - 48;
-	Log.trace("getSoilSettingsByIndex() => %s" CR, index);
+	LOG_TRACE("getSoilSettingsByIndex() => %s" CR, index);
 
 	if ((i >= 0) && (i < SoilSensors::MAX_SENSORS))
 	{
-		response.status(200);
-		response.set("Content-Type", "application/json");
-		response.print(settings.SoilSettings.serializeByIndex(i));
+		WireFormat::Format format = getFormat(request);
+		setFormat(response, format);
+
+		if (format == WireFormat::FORMAT_JSON)
+		{
+			response.print(settings.SoilSettings.serializeByIndex(i));
+		}
+		else
+		{
+			WireFormat writer(response, format);
+			settings.SoilSettings.serializeByIndex(i, writer);
+		}
 	}
 	else
 	{
-		Log.warning("getSoilSettingsByIndex() invalid index" CR);
+		LOG_WARNING("getSoilSettingsByIndex() invalid index" CR);
 		response.sendStatus(404);
 	}
 }
 
 /// <summary>
-///  Middleware handler to return single temperature sensor settings (JSON).
+///  Middleware handler to return single temperature sensor settings (JSON, CBOR, or MessagePack).
 /// </summary>
 /// <param name="request">Reference to the Request instance</param>
 /// <param name="response">Reference to the Response instance</param>
@@ -490,17 +1057,26 @@ void getTempSettingsByIndex(Request& request, Response& response)
 
 	request.route("i", index, 64);
 	short i = index[0] - 48;
-	Log.trace("getTempSettingsByIndex() => %s" CR, index);
+	LOG_TRACE("getTempSettingsByIndex() => %s" CR, index);
 
 	if ((i >= 0) && (i < TempSensors::MAX_SENSORS))
 	{
-		response.status(200);
-		response.set("Content-Type", "application/json");
-		response.print(settings.TempSettings.serializeByIndex(i));
+		WireFormat::Format format = getFormat(request);
+		setFormat(response, format);
+
+		if (format == WireFormat::FORMAT_JSON)
+		{
+			response.print(settings.TempSettings.serializeByIndex(i));
+		}
+		else
+		{
+			WireFormat writer(response, format);
+			settings.TempSettings.serializeByIndex(i, writer);
+		}
 	}
 	else
 	{
-		Log.warning("getTempSettingsByIndex() invalid index" CR);
+		LOG_WARNING("getTempSettingsByIndex() invalid index" CR);
 		response.sendStatus(404);
 	}
 }
@@ -517,7 +1093,7 @@ void postErrInfo(Request& request, Response& response)
 
 	if (!request.body(buffer, 1024))
 	{
-		Log.error("postErrInfo() error in reading body" CR);
+		LOG_ERROR("postErrInfo() error in reading body" CR);
 		return response.sendStatus(400);
 	}
 
@@ -531,7 +1107,7 @@ void postErrInfo(Request& request, Response& response)
 	}
 	else
 	{
-		Log.error("postErrInfo() error in reading JSON" CR);
+		LOG_ERROR("postErrInfo() error in reading JSON" CR);
 		return response.sendStatus(400);
 	}
 }
@@ -592,7 +1168,7 @@ void postSettings(Request& request, Response& response)
 
 	if (!request.body(buffer, 4096))
 	{
-		Log.error("postSettings() error in reading body" CR);
+		LOG_ERROR("postSettings() error in reading body" CR);
 		return response.sendStatus(400);
 	}
 
@@ -600,13 +1176,16 @@ void postSettings(Request& request, Response& response)
 
 	if (settings.deserialize(json))
 	{
+		applyMqttSettings();
+		applyInfluxSettings();
+		applyLogSettings();
 		response.status(202);
 		response.set("Content-Type", "application/json");
 		response.print(settings.serialize());
 	}
 	else
 	{
-		Log.error("postSettings() error in reading JSON" CR);
+		LOG_ERROR("postSettings() error in reading JSON" CR);
 		return response.sendStatus(400);
 	}
 }
@@ -623,7 +1202,7 @@ void postApSettings(Request& request, Response& response)
 
 	if (!request.body(buffer, 1024))
 	{
-		Log.error("postApSettings() error in reading body" CR);
+		LOG_ERROR("postApSettings() error in reading body" CR);
 		return response.sendStatus(400);
 	}
 
@@ -637,7 +1216,7 @@ void postApSettings(Request& request, Response& response)
 	}
 	else
 	{
-		Log.error("postApSettings() error in reading JSON" CR);
+		LOG_ERROR("postApSettings() error in reading JSON" CR);
 		return response.sendStatus(400);
 	}
 }
@@ -654,7 +1233,7 @@ void postStaSettings(Request& request, Response& response)
 
 	if (!request.body(buffer, 1024))
 	{
-		Log.error("postStaSettings() error in reading body" CR);
+		LOG_ERROR("postStaSettings() error in reading body" CR);
 		return response.sendStatus(400);
 	}
 
@@ -668,7 +1247,7 @@ void postStaSettings(Request& request, Response& response)
 	}
 	else
 	{
-		Log.error("postStaSettings() error in reading JSON" CR);
+		LOG_ERROR("postStaSettings() error in reading JSON" CR);
 		return response.sendStatus(400);
 	}
 }
@@ -685,7 +1264,7 @@ void postLogSettings(Request& request, Response& response)
 
 	if (!request.body(buffer, 1024))
 	{
-		Log.error("postLogSettings() error in reading body" CR);
+		LOG_ERROR("postLogSettings() error in reading body" CR);
 		return response.sendStatus(400);
 	}
 
@@ -693,13 +1272,14 @@ void postLogSettings(Request& request, Response& response)
 
 	if (settings.LogSettings.deserialize(json))
 	{
+		applyLogSettings();
 		response.status(202);
 		response.set("Content-Type", "application/json");
 		response.print(settings.LogSettings.serialize());
 	}
 	else
 	{
-		Log.error("postLogSettings() error in reading JSON" CR);
+		LOG_ERROR("postLogSettings() error in reading JSON" CR);
 		return response.sendStatus(400);
 	}
 }
@@ -716,7 +1296,7 @@ void postCmdSettings(Request& request, Response& response)
 
 	if (!request.body(buffer, 1024))
 	{
-		Log.error("postCmdSettings() error in reading body" CR);
+		LOG_ERROR("postCmdSettings() error in reading body" CR);
 		return response.sendStatus(400);
 	}
 
@@ -730,7 +1310,71 @@ void postCmdSettings(Request& request, Response& response)
 	}
 	else
 	{
-		Log.error("postCmdSettings() error in reading JSON" CR);
+		LOG_ERROR("postCmdSettings() error in reading JSON" CR);
+		return response.sendStatus(400);
+	}
+}
+
+/// <summary>
+///  Middleware handler to set MQTT settings (JSON).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void postMqttSettings(Request& request, Response& response)
+{
+	byte buffer[1024];
+	int len = request.left();
+
+	if (!request.body(buffer, 1024))
+	{
+		LOG_ERROR("postMqttSettings() error in reading body" CR);
+		return response.sendStatus(400);
+	}
+
+	String json = String((char*)buffer).substring(0, len);
+
+	if (settings.MqttSettings.deserialize(json))
+	{
+		applyMqttSettings();
+		response.status(202);
+		response.set("Content-Type", "application/json");
+		response.print(settings.MqttSettings.serialize());
+	}
+	else
+	{
+		LOG_ERROR("postMqttSettings() error in reading JSON" CR);
+		return response.sendStatus(400);
+	}
+}
+
+/// <summary>
+///  Middleware handler to set InfluxDB settings (JSON).
+/// </summary>
+/// <param name="request">Reference to the Request instance</param>
+/// <param name="response">Reference to the Response instance</param>
+void postInfluxSettings(Request& request, Response& response)
+{
+	byte buffer[1024];
+	int len = request.left();
+
+	if (!request.body(buffer, 1024))
+	{
+		LOG_ERROR("postInfluxSettings() error in reading body" CR);
+		return response.sendStatus(400);
+	}
+
+	String json = String((char*)buffer).substring(0, len);
+
+	if (settings.InfluxSettings.deserialize(json))
+	{
+		applyInfluxSettings();
+		response.status(202);
+		response.set("Content-Type", "application/json");
+		response.print(settings.InfluxSettings.serialize());
+	}
+	else
+	{
+		LOG_ERROR("postInfluxSettings() error in reading JSON" CR);
 		return response.sendStatus(400);
 	}
 }
@@ -747,7 +1391,7 @@ void postSoilSettings(Request& request, Response& response)
 
 	if (!request.body(buffer, 1024))
 	{
-		Log.error("postSoilSettings() error in reading body" CR);
+		LOG_ERROR("postSoilSettings() error in reading body" CR);
 		return response.sendStatus(400);
 	}
 
@@ -761,7 +1405,7 @@ void postSoilSettings(Request& request, Response& response)
 	}
 	else
 	{
-		Log.error("postSoilSettings() error in reading JSON" CR);
+		LOG_ERROR("postSoilSettings() error in reading JSON" CR);
 		return response.sendStatus(400);
 	}
 }
@@ -778,7 +1422,7 @@ void postTempSettings(Request& request, Response& response)
 
 	if (!request.body(buffer, 1024))
 	{
-		Log.error("postTempSettings() error in reading body" CR);
+		LOG_ERROR("postTempSettings() error in reading body" CR);
 		return response.sendStatus(400);
 	}
 
@@ -792,7 +1436,7 @@ void postTempSettings(Request& request, Response& response)
 	}
 	else
 	{
-		Log.error("postTempSettings() error in reading JSON" CR);
+		LOG_ERROR("postTempSettings() error in reading JSON" CR);
 		return response.sendStatus(400);
 	}
 }
@@ -808,7 +1452,7 @@ void postSoilSettingsByIndex(Request& request, Response& response)
 
 	request.route("i", index, 64);
 	short i = index[0] - 48;
-	Log.trace("postSoilSettingsByIndex() => %s" CR, index);
+	LOG_TRACE("postSoilSettingsByIndex() => %s" CR, index);
 
 	if ((i >= 0) && (i < SoilSensors::MAX_SENSORS))
 	{
@@ -817,7 +1461,7 @@ void postSoilSettingsByIndex(Request& request, Response& response)
 
 		if (!request.body(buffer, 1024))
 		{
-			Log.error("postSoilSettingsByIndex() error in reading body" CR);
+			LOG_ERROR("postSoilSettingsByIndex() error in reading body" CR);
 			return response.sendStatus(400);
 		}
 
@@ -831,13 +1475,13 @@ void postSoilSettingsByIndex(Request& request, Response& response)
 		}
 		else
 		{
-			Log.error("postSoilSettingsByIndex() error in reading JSON" CR);
+			LOG_ERROR("postSoilSettingsByIndex() error in reading JSON" CR);
 			return response.sendStatus(400);
 		}
 	}
 	else
 	{
-		Log.warning("postSoilSettingsByIndex() invalid index" CR);
+		LOG_WARNING("postSoilSettingsByIndex() invalid index" CR);
 		response.sendStatus(404);
 	}
 }
@@ -853,7 +1497,7 @@ void postTempSettingsByIndex(Request& request, Response& response)
 
 	request.route("iPostTemp", index, 64);
 	short i = index[0] - 48;
-	Log.trace("postTempSettingsByIndex() => %s" CR, index);
+	LOG_TRACE("postTempSettingsByIndex() => %s" CR, index);
 
 	if ((i >= 0) && (i < TempSensors::MAX_SENSORS))
 	{
@@ -862,7 +1506,7 @@ void postTempSettingsByIndex(Request& request, Response& response)
 
 		if (!request.body(buffer, 1024))
 		{
-			Log.error("postTempSettingsByIndex() error in reading body" CR);
+			LOG_ERROR("postTempSettingsByIndex() error in reading body" CR);
 			return response.sendStatus(400);
 		}
 
@@ -876,13 +1520,13 @@ void postTempSettingsByIndex(Request& request, Response& response)
 		}
 		else
 		{
-			Log.error("postTempSettingsByIndex() error in reading JSON" CR);
+			LOG_ERROR("postTempSettingsByIndex() error in reading JSON" CR);
 			return response.sendStatus(400);
 		}
 	}
 	else
 	{
-		Log.warning("postTempSettingsByIndex() invalid index" CR);
+		LOG_WARNING("postTempSettingsByIndex() invalid index" CR);
 		response.sendStatus(404);
 	}
 }
@@ -895,6 +1539,10 @@ void initServer()
 	// Setup middleware handler for logging and not found error handling.
 	app.use(&checkRequest);
 
+	// Setup the request headers read by the handlers.
+	app.header("If-None-Match", ifNoneMatch, sizeof(ifNoneMatch));
+	app.header("Accept", accept, sizeof(accept));
+
 	// Setup handlers for bootstrap Web pages.
 	app.get("/", &getFile);
 	app.get("/home", &getFile);
@@ -925,7 +1573,15 @@ void initServer()
 	app.get("/err", &getErrInfo);
 	app.get("/server", &getServerInfo);
 	app.get("/system", &getSystemInfo);
+	app.get("/system/trend", &getSystemTrend);
 	app.get("/data", &getData);
+	app.get("/meta", &getMeta);
+	app.get("/batch", &getBatch);
+	app.get("/metrics", &getMetrics);
+	app.get("/log", &getLog);
+	app.get("/capture", &getCapture);
+	app.get("/scan", &getScan);
+	app.get("/perf", &getPerf);
 	app.get("/soil", &getSoil);
 	app.get("/temp", &getTemp);
 	app.get("/soil/:i", &getSoilByIndex);
@@ -936,6 +1592,8 @@ void initServer()
 	app.get("/settings/sta", &getStaSettings);
 	app.get("/settings/log", &getLogSettings);
 	app.get("/settings/cmd", &getCmdSettings);
+	app.get("/settings/mqtt", &getMqttSettings);
+	app.get("/settings/influx", &getInfluxSettings);
 	app.get("/settings/soil", &getSoilSettings);
 	app.get("/settings/temp", &getTempSettings);
 	app.get("/settings/soil/:i", &getSoilSettingsByIndex);
@@ -946,12 +1604,17 @@ void initServer()
 	app.post("/save", &postSave);
 	app.post("/reset", &postReset);
 	app.post("/reboot", &postReboot);
+	app.post("/perf", &postPerf);
+	app.post("/capture/start", &postCaptureStart);
+	app.post("/capture/stop", &postCaptureStop);
 
 	app.post("/settings", &postSettings);
 	app.post("/settings/ap", &postApSettings);
 	app.post("/settings/sta", &postStaSettings);
 	app.post("/settings/log", &postLogSettings);
 	app.post("/settings/cmd", &postCmdSettings);
+	app.post("/settings/mqtt", &postMqttSettings);
+	app.post("/settings/influx", &postInfluxSettings);
 	app.post("/settings/soil", &postSoilSettings);
 	app.post("/settings/temp", &postTempSettings);
 	app.post("/settings/soil/:i", &postSoilSettingsByIndex);
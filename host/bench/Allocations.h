@@ -0,0 +1,50 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Allocations.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include "HeapMonitor.h"
+
+/// <summary>
+/// This class counts the heap allocations of a benchmark using the HeapMonitor hook. The benchmarks are linked
+/// with malloc / free / realloc / calloc wrapped (as on the device, see HeapHook.cpp), so operator new, String
+/// and the ArduinoJson documents are counted. The hook only counts allocations of the main thread
+/// (HeapMonitor::begin() is called in main()). Note that the host String is a std::string, short strings
+/// (up to 15 characters) are kept inline and are not counted (the device String allocates them).
+/// </summary>
+class Allocations
+{
+private:
+	uint32_t _allocs;											// The allocation count at the start
+	uint32_t _bytes;											// The allocated bytes at the start
+
+	static uint32_t count(bool bytes)
+	{
+		uint32_t total = 0;
+
+		for (uint8_t i = 0; i < HeapMonitor::SUBSYSTEM_COUNT; i++)
+		{
+			total += bytes ? HeapMonitor::getCounters(i).Bytes : HeapMonitor::getCounters(i).Allocs;
+		}
+
+		return total;
+	}
+
+public:
+	Allocations() : _allocs(count(false)), _bytes(count(true)) {}
+
+	/// <summary>
+	///  Adds the allocations per iteration (allocs/op) and the bytes per iteration (bytes/op) counters.
+	/// </summary>
+	void report(benchmark::State& state)
+	{
+		state.counters["allocs/op"] = benchmark::Counter(count(false) - _allocs, benchmark::Counter::kAvgIterations);
+		state.counters["bytes/op"] = benchmark::Counter(count(true) - _bytes, benchmark::Counter::kAvgIterations);
+	}
+};
@@ -0,0 +1,34 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="BenchMain.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+#include "HeapMonitor.h"
+
+/// <summary>
+///  Runs the benchmarks. The allocations of the main thread are counted (see Allocations.h), the counting
+///  limitation is printed with the context (stderr).
+///  Use --benchmark_format=json or --benchmark_out=results.json to get results which can be compared
+///  between commits (e.g. using the compare.py tool of the benchmark library).
+/// </summary>
+int main(int argc, char** argv)
+{
+	HeapMonitor::begin();
+	benchmark::Initialize(&argc, argv);
+
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+	{
+		return 1;
+	}
+
+	fprintf(stderr, "allocs/op: malloc level, short host String values (up to 15 characters) are not counted\n");
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,103 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="CoreBench.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <benchmark/benchmark.h>
+#include <Arduino.h>
+#include "MimeTypes.h"
+#include "Routes.h"
+#include "SensorFilter.h"
+#include "Allocations.h"
+
+/// <summary>
+/// The request paths of a page load (index and info page with resources), and some JSON requests.
+/// </summary>
+static const char* PATHS[] = {
+	"/",
+	"/css/bootstrap.min.css",
+	"/css/soilmonitor.min.css",
+	"/js/jquery-3.4.1.min.js",
+	"/js/popper.min.js",
+	"/js/bootstrap.min.js",
+	"/js/raphael-2.1.4.min.js",
+	"/js/justgage.min.js",
+	"/favicon.ico",
+	"/info",
+	"/data",
+	"/soil/3",
+	"/temp/0",
+	"/settings/soil/5",
+	"/system",
+	"/js/bootstrap.min.js.map",
+	"/unknown"
+};
+
+static const size_t PATH_COUNT = sizeof(PATHS) / sizeof(*PATHS);
+
+static void BM_MimeTypesGetType(benchmark::State& state)
+{
+	Allocations allocations;
+	size_t i = 0;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(MimeTypes::getType(PATHS[i]));
+		if (++i == PATH_COUNT) i = 0;
+	}
+
+	allocations.report(state);
+}
+
+BENCHMARK(BM_MimeTypesGetType);
+
+static void BM_RoutesMatch(benchmark::State& state)
+{
+	Allocations allocations;
+	size_t i = 0;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(Routes::match(PATHS[i]));
+		if (++i == PATH_COUNT) i = 0;
+	}
+
+	allocations.report(state);
+}
+
+BENCHMARK(BM_RoutesMatch);
+
+/// <summary>
+/// The filter chains of the per sample cost benchmark (see SensorFilter).
+/// </summary>
+static const char* CHAINS[] = {
+	"exp:10",
+	"avg:15",
+	"median:5",
+	"median:15",
+	"hampel:15",
+	"hampel:7,exp:10"
+};
+
+static void BM_SensorFilterAdd(benchmark::State& state)
+{
+	SensorFilter filter;
+	uint32_t seed = 1;
+
+	filter.setChain(CHAINS[state.range(0)]);
+	state.SetLabel(CHAINS[state.range(0)]);
+	Allocations allocations;
+
+	for (auto _ : state)
+	{
+		seed = seed * 1103515245UL + 12345UL;
+		benchmark::DoNotOptimize(filter.add(2000 + (int)((seed >> 16) % 64)));
+	}
+
+	allocations.report(state);
+}
+
+BENCHMARK(BM_SensorFilterAdd)->DenseRange(0, sizeof(CHAINS) / sizeof(*CHAINS) - 1);
@@ -0,0 +1,148 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SensorsBench.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <sstream>
+#include <Arduino.h>
+#include "Settings.h"
+#include "Allocations.h"
+
+/// <summary>
+///  Returns the content of the settings file shipped with the sketch (data/settings.json).
+/// </summary>
+static String readSettingsFile()
+{
+	std::ifstream file(SKETCH_DIR "/data/settings.json");
+	std::stringstream text;
+
+	text << file.rdbuf();
+	return String(text.str());
+}
+
+static void BM_SensorsSerialize(benchmark::State& state)
+{
+	const uint8_t address[8] = { 0x28, 0xFF, 0x64, 0x1E, 0x0F, 0x00, 0x00, 0x5A };
+	Sensors sensors;
+
+	DallasTemperature::clearDevices();
+	DallasTemperature::addDevice(address, 22.5f);
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+	sensors.SoilSensors.begin();
+	sensors.SoilSensors.update();
+
+	Allocations allocations;
+
+	for (auto _ : state)
+	{
+		String json = sensors.serialize();
+		benchmark::DoNotOptimize(json.c_str());
+	}
+
+	allocations.report(state);
+	DallasTemperature::clearDevices();
+}
+
+BENCHMARK(BM_SensorsSerialize);
+
+static void BM_SensorsSerializeChanges(benchmark::State& state)
+{
+	const uint8_t address[8] = { 0x28, 0xFF, 0x64, 0x1E, 0x0F, 0x00, 0x00, 0x5A };
+	Sensors sensors;
+
+	DallasTemperature::clearDevices();
+	DallasTemperature::addDevice(address, 22.5f);
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+	sensors.SoilSensors.begin();
+	sensors.SoilSensors.update();
+
+	// A quiet system: the consumer has seen all reported values.
+	uint32_t since = ChangeTracker::getSequence();
+	Allocations allocations;
+	size_t bytes = 0;
+
+	for (auto _ : state)
+	{
+		String json = sensors.serialize(since);
+		bytes = json.length();
+		benchmark::DoNotOptimize(json.c_str());
+	}
+
+	allocations.report(state);
+	state.counters["json_bytes"] = (double)bytes;
+	DallasTemperature::clearDevices();
+}
+
+BENCHMARK(BM_SensorsSerializeChanges);
+
+static void BM_SettingsSerialize(benchmark::State& state)
+{
+	Sensors sensors;
+	Settings settings(&sensors);
+
+	settings.deserialize(readSettingsFile());
+	Allocations allocations;
+
+	for (auto _ : state)
+	{
+		String json = settings.serialize();
+		benchmark::DoNotOptimize(json.c_str());
+	}
+
+	allocations.report(state);
+}
+
+BENCHMARK(BM_SettingsSerialize);
+
+static void BM_SettingsDeserialize(benchmark::State& state)
+{
+	Sensors sensors;
+	Settings settings(&sensors);
+	String json = readSettingsFile();
+
+	if (!settings.deserialize(json))
+	{
+		state.SkipWithError("Settings file not found or invalid");
+		return;
+	}
+
+	Allocations allocations;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(settings.deserialize(json));
+	}
+
+	allocations.report(state);
+}
+
+BENCHMARK(BM_SettingsDeserialize);
+
+static void BM_MoistureSensorUpdate(benchmark::State& state)
+{
+	MoistureSensor sensor(A0, "Sensor 1", 1.76f, 3.4f);
+	uint16_t value = 2000;
+
+	sensor.begin();
+	Allocations allocations;
+
+	for (auto _ : state)
+	{
+		Host::setAnalog(A0, value);
+		value = (value == 2000) ? 2600 : 2000;
+		sensor.update();
+		benchmark::DoNotOptimize(sensor.getHumidity());
+	}
+
+	allocations.report(state);
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_MoistureSensorUpdate);
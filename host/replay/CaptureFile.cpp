@@ -0,0 +1,141 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="CaptureFile.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <ctype.h>
+#include <string.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "CaptureFile.h"
+
+/// <summary>
+///  Loads a capture file (binary or hex dump).
+/// </summary>
+/// <param name="path">The file path</param>
+/// <param name="error">The error message</param>
+/// <returns>True if successful</returns>
+bool CaptureFile::load(const char* path, std::string& error)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file)
+	{
+		error = std::string("cannot open ") + path;
+		return false;
+	}
+
+	std::stringstream data;
+	data << file.rdbuf();
+
+	return parse(data.str(), error);
+}
+
+/// <summary>
+///  Parses the capture data. If the data does not start with the file magic, it is read as hex dump.
+/// </summary>
+/// <param name="data">The capture data</param>
+/// <param name="error">The error message</param>
+/// <returns>True if successful</returns>
+bool CaptureFile::parse(const std::string& data, std::string& error)
+{
+	std::string bytes = data;
+	SensorCapture::Header header;
+
+	if ((bytes.size() < sizeof(header)) || (memcmp(bytes.data(), "SCAP", 4) != 0))
+	{
+		bytes = fromHex(data);
+	}
+
+	if (bytes.size() < sizeof(header))
+	{
+		error = "no capture data";
+		return false;
+	}
+
+	memcpy(&header, bytes.data(), sizeof(header));
+
+	if (header.Magic != SensorCapture::MAGIC)
+	{
+		error = "invalid capture magic";
+		return false;
+	}
+
+	if ((header.Version != SensorCapture::VERSION) || (header.RecordSize != sizeof(Record)))
+	{
+		error = "unsupported capture version " + std::to_string(header.Version);
+		return false;
+	}
+
+	size_t count = (bytes.size() - sizeof(header)) / sizeof(Record);
+
+	_records.resize(count);
+	memcpy(_records.data(), bytes.data() + sizeof(header), count * sizeof(Record));
+
+	return true;
+}
+
+/// <summary>
+///  Returns the records grouped by sensor (soil sensors first, ordered by index).
+/// </summary>
+/// <returns>The sensor series</returns>
+std::vector<CaptureFile::Series> CaptureFile::series() const
+{
+	std::map<uint16_t, Series> sensors;
+
+	for (const Record& record : _records)
+	{
+		Series& series = sensors[(uint16_t)(record.Channel << 8 | record.Index)];
+
+		series.Channel = record.Channel;
+		series.Index = record.Index;
+		series.Times.push_back(record.Time);
+		series.Values.push_back(record.Value);
+	}
+
+	std::vector<Series> result;
+
+	for (auto& entry : sensors)
+	{
+		result.push_back(entry.second);
+	}
+
+	return result;
+}
+
+/// <summary>
+///  Returns the bytes of the hex lines. Lines with other characters (e.g. the command prompt) are ignored.
+/// </summary>
+/// <param name="text">The hex dump</param>
+/// <returns>The bytes</returns>
+std::string CaptureFile::fromHex(const std::string& text)
+{
+	std::istringstream lines(text);
+	std::string line;
+	std::string bytes;
+
+	while (std::getline(lines, line))
+	{
+		while (!line.empty() && isspace((unsigned char)line.back()))
+		{
+			line.pop_back();
+		}
+
+		if (line.empty() || (line.size() % 2 != 0) || (line.find_first_not_of("0123456789ABCDEFabcdef") != std::string::npos))
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < line.size(); i += 2)
+		{
+			bytes += (char)strtol(line.substr(i, 2).c_str(), nullptr, 16);
+		}
+	}
+
+	return bytes;
+}
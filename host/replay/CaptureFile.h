@@ -0,0 +1,45 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="CaptureFile.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "SensorCapture.h"
+
+/// <summary>
+/// This class reads a raw sensor input capture (see SensorCapture), either the binary file downloaded from /capture
+/// or the hex lines printed by the 'capture dump' command (other lines of a serial log are ignored).
+/// </summary>
+class CaptureFile
+{
+public:
+	typedef SensorCapture::Record Record;
+
+	struct Series
+	{
+		uint8_t Channel;										// The sensor type (SensorCapture::Channel)
+		uint8_t Index;											// The sensor index
+		std::vector<uint32_t> Times;							// The sample times (msec)
+		std::vector<int16_t> Values;							// The raw sensor values
+	};
+
+private:
+	std::vector<Record> _records;								// The captured records
+
+public:
+	bool load(const char* path, std::string& error);			// Loads a capture file (binary or hex dump)
+	bool parse(const std::string& data, std::string& error);	// Parses the capture data (binary or hex dump)
+
+	const std::vector<Record>& records() const { return _records; }	// Returns all records
+	std::vector<Series> series() const;							// Returns the records per sensor (sorted)
+
+	static std::string fromHex(const std::string& text);		// Returns the bytes of the hex lines
+};
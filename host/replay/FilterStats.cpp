@@ -0,0 +1,120 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="FilterStats.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+
+#include "FilterStats.h"
+
+/// <summary>
+///  Returns the centered moving average of the values. The values at the edges (half window) are NAN.
+/// </summary>
+/// <param name="values">The raw values</param>
+/// <param name="window">The window size (odd number of samples)</param>
+/// <returns>The reference values</returns>
+std::vector<double> FilterStats::reference(const std::vector<double>& values, size_t window)
+{
+	std::vector<double> result(values.size(), NAN);
+	size_t half = window / 2;
+
+	if ((window == 0) || (values.size() < 2 * half + 1))
+	{
+		return result;
+	}
+
+	double sum = 0;
+
+	for (size_t i = 0; i < 2 * half + 1; i++)
+	{
+		sum += values[i];
+	}
+
+	for (size_t i = half; i + half < values.size(); i++)
+	{
+		result[i] = sum / (2 * half + 1);
+
+		if (i + half + 1 < values.size())
+		{
+			sum += values[i + half + 1] - values[i - half];
+		}
+	}
+
+	return result;
+}
+
+/// <summary>
+///  Returns the RMS deviation of the output from the reference, the output is compared to the reference shift
+///  samples earlier. Reference values of NAN are skipped.
+/// </summary>
+/// <param name="output">The filter output</param>
+/// <param name="reference">The reference values</param>
+/// <param name="shift">The shift (samples)</param>
+/// <returns>The RMS deviation (NAN if there are no samples)</returns>
+double FilterStats::rms(const std::vector<double>& output, const std::vector<double>& reference, size_t shift)
+{
+	double sum = 0;
+	size_t count = 0;
+
+	for (size_t i = shift; (i < output.size()) && (i - shift < reference.size()); i++)
+	{
+		double expected = reference[i - shift];
+
+		if (!isnan(expected))
+		{
+			sum += (output[i] - expected) * (output[i] - expected);
+			count++;
+		}
+	}
+
+	return (count > 0) ? sqrt(sum / count) : NAN;
+}
+
+/// <summary>
+///  Returns the shift of the output with the smallest RMS deviation from the reference.
+/// </summary>
+/// <param name="output">The filter output</param>
+/// <param name="reference">The reference values</param>
+/// <param name="maxLag">The maximum shift (samples)</param>
+/// <returns>The lag (samples)</returns>
+size_t FilterStats::lag(const std::vector<double>& output, const std::vector<double>& reference, size_t maxLag)
+{
+	size_t best = 0;
+	double smallest = INFINITY;
+
+	for (size_t shift = 0; shift <= maxLag; shift++)
+	{
+		double deviation = rms(output, reference, shift);
+
+		if (deviation < smallest)
+		{
+			smallest = deviation;
+			best = shift;
+		}
+	}
+
+	return best;
+}
+
+/// <summary>
+///  Returns the number of value changes (e.g. flicker of the displayed humidity).
+/// </summary>
+/// <param name="values">The values</param>
+/// <returns>The number of changes</returns>
+size_t FilterStats::changes(const std::vector<int>& values)
+{
+	size_t count = 0;
+
+	for (size_t i = 1; i < values.size(); i++)
+	{
+		if (values[i] != values[i - 1])
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
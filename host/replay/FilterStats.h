@@ -0,0 +1,29 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="FilterStats.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+/// <summary>
+/// This class implements the quality measures of a smoothing filter. The filter output is compared to a reference
+/// signal, the centered (zero phase) moving average of the raw values. The lag is the shift of the output giving
+/// the smallest deviation from the reference, the noise is the RMS deviation at this shift.
+/// </summary>
+class FilterStats
+{
+public:
+	static std::vector<double> reference(						// Returns the centered moving average (edges: NAN)
+		const std::vector<double>& values, size_t window);
+	static double rms(const std::vector<double>& output,		// Returns the RMS deviation of the shifted output
+		const std::vector<double>& reference, size_t shift);
+	static size_t lag(const std::vector<double>& output,		// Returns the shift with the smallest deviation
+		const std::vector<double>& reference, size_t maxLag);
+	static size_t changes(const std::vector<int>& values);		// Returns the number of value changes
+};
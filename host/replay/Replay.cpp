@@ -0,0 +1,228 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Replay.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+
+#include "CaptureFile.h"
+#include "FilterStats.h"
+#include "MoistureSensor.h"
+
+/// <summary>
+/// The offline replay of a raw sensor input capture (see SensorCapture). The soil sensor values are fed through
+/// the MoistureSensor pipeline (analog input, filter chain, mapping) for each filter chain (see SensorFilter), and
+/// the noise, the lag, the humidity changes per hour and the CPU cost (host ns per sample) are reported.
+///
+///   soilmonitor_replay capture.bin [--filter hampel:7,exp:10]... [--window 61] [--wet 1.5] [--dry 3.4]
+/// </summary>
+namespace
+{
+	const uint8_t PIN = A0;										// The analog input used for the replay
+	const size_t MAX_LAG = 600;									// The maximum lag searched (samples)
+
+	struct Options
+	{
+		std::string Path;										// The capture file
+		std::vector<std::string> Filters;						// The filter chains
+		size_t Window = 61;										// The reference window (samples)
+		float Wet = MoistureSensor::WET_VALUE;					// The wet calibration value (V)
+		float Dry = MoistureSensor::DRY_VALUE;					// The dry calibration value (V)
+	};
+
+	/// <summary>
+	///  Prints the usage and exits.
+	/// </summary>
+	void usage(const char* name)
+	{
+		fprintf(stderr, "usage: %s capture.bin [--filter chain]... [--window samples] [--wet V] [--dry V]\n", name);
+		exit(2);
+	}
+
+	/// <summary>
+	///  Parses the command line options.
+	/// </summary>
+	Options parse(int argc, char* argv[])
+	{
+		Options options;
+
+		for (int i = 1; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (option.compare(0, 2, "--") != 0)
+			{
+				options.Path = option;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				usage(argv[0]);
+			}
+
+			std::string value = argv[++i];
+
+			if ((option == "--filter") && SensorFilter::isValid(value.c_str())) options.Filters.push_back(value);
+			else if (option == "--window") options.Window = (size_t)atoi(value.c_str()) | 1;
+			else if (option == "--wet") options.Wet = (float)atof(value.c_str());
+			else if (option == "--dry") options.Dry = (float)atof(value.c_str());
+			else usage(argv[0]);
+		}
+
+		if (options.Path.empty() || (options.Wet >= options.Dry))
+		{
+			usage(argv[0]);
+		}
+
+		if (options.Filters.empty())
+		{
+			options.Filters = { "exp:5", SensorFilter::DEFAULT_CHAIN, "exp:20", "avg:10", "median:5", "median:15",
+				"hampel:7,exp:10", "hampel:7,avg:10", "median:5,exp:5" };
+		}
+
+		return options;
+	}
+
+	/// <summary>
+	///  Returns the median sample interval (sec).
+	/// </summary>
+	double getInterval(const std::vector<uint32_t>& times)
+	{
+		std::vector<uint32_t> deltas;
+
+		for (size_t i = 1; i < times.size(); i++)
+		{
+			deltas.push_back(times[i] - times[i - 1]);
+		}
+
+		if (deltas.empty())
+		{
+			return 1.0;
+		}
+
+		std::nth_element(deltas.begin(), deltas.begin() + deltas.size() / 2, deltas.end());
+		return deltas[deltas.size() / 2] / 1000.0;
+	}
+
+	/// <summary>
+	///  Prints a result row. The lag of the unfiltered values (raw) is zero by definition.
+	/// </summary>
+	void printRow(const std::string& name, const std::vector<double>& output, const std::vector<int>& humidity,
+		const std::vector<double>& reference, double interval, double hours, double cost)
+	{
+		size_t lag = (name == "raw") ? 0 : FilterStats::lag(output, reference, std::min(MAX_LAG, output.size() / 4));
+
+		printf("    %-18s %10.1f %9.1f %10.1f %11.0f\n", name.c_str(), FilterStats::rms(output, reference, lag),
+			lag * interval, (hours > 0) ? FilterStats::changes(humidity) / hours : 0.0, cost);
+	}
+
+	/// <summary>
+	///  Replays a soil sensor series with all filter configurations.
+	/// </summary>
+	void replaySoil(const CaptureFile::Series& series, const Options& options)
+	{
+		double interval = getInterval(series.Times);
+		double hours = (series.Times.back() - series.Times.front()) / 3600000.0;
+		std::vector<double> raw(series.Values.begin(), series.Values.end());
+		std::vector<double> reference = FilterStats::reference(raw, options.Window);
+		std::vector<int> humidity;
+
+		for (double value : raw)
+		{
+			humidity.push_back((int)min(100L, max(0L, map((long)value, (long)(options.Wet * 1000), (long)(options.Dry * 1000), 100, 0))));
+		}
+
+		printf("soil %u: %zu samples, %.1f s interval, %.1f h\n", series.Index, raw.size(), interval, hours);
+		printf("    %-18s %10s %9s %10s %11s\n", "filter", "noise mV", "lag s", "changes/h", "ns/sample");
+		printRow("raw", raw, humidity, reference, interval, hours, 0);
+
+		for (const std::string& filter : options.Filters)
+		{
+			MoistureSensor sensor(PIN, "Replay", options.Wet, options.Dry);
+			std::vector<double> output;
+			double nsec = 0;
+
+			sensor.setFilter(filter.c_str());
+			sensor.begin();
+			humidity.clear();
+
+			for (int16_t value : series.Values)
+			{
+				Host::setAnalog(PIN, (uint16_t)value);
+
+				auto start = std::chrono::steady_clock::now();
+				sensor.update();
+				nsec += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+				output.push_back(sensor.getVoltage() * 1000.0);
+				humidity.push_back(sensor.getHumidity());
+			}
+
+			printRow(filter, output, humidity, reference, interval, hours, nsec / series.Values.size());
+		}
+
+		printf("\n");
+	}
+
+	/// <summary>
+	///  Prints the statistics of a temperature sensor series (no filter in the pipeline).
+	/// </summary>
+	void replayTemp(const CaptureFile::Series& series, const Options& options)
+	{
+		std::vector<double> raw;
+
+		for (int16_t value : series.Values)
+		{
+			raw.push_back(value / 100.0);
+		}
+
+		std::vector<double> reference = FilterStats::reference(raw, options.Window);
+		auto range = std::minmax_element(raw.begin(), raw.end());
+
+		printf("temp %u: %zu samples, %.1f s interval, min %.2f C, max %.2f C, noise %.3f C\n\n",
+			series.Index, raw.size(), getInterval(series.Times), *range.first, *range.second,
+			FilterStats::rms(raw, reference, 0));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options = parse(argc, argv);
+	CaptureFile capture;
+	std::string error;
+
+	if (!capture.load(options.Path.c_str(), error))
+	{
+		fprintf(stderr, "%s: %s\n", options.Path.c_str(), error.c_str());
+		return 1;
+	}
+
+	Host::setTime(0);
+	printf("%s: %zu records, reference window %zu samples\n\n", options.Path.c_str(), capture.records().size(), options.Window);
+
+	for (const CaptureFile::Series& series : capture.series())
+	{
+		if (series.Channel == SensorCapture::CHANNEL_SOIL)
+		{
+			replaySoil(series, options);
+		}
+		else if (series.Channel == SensorCapture::CHANNEL_TEMP)
+		{
+			replayTemp(series, options);
+		}
+	}
+
+	return 0;
+}
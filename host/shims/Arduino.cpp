@@ -0,0 +1,183 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Arduino.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Arduino.h"
+#include "esp_timer.h"
+
+EspClass ESP;
+
+namespace
+{
+	const std::chrono::steady_clock::time_point START = std::chrono::steady_clock::now();
+	std::atomic<bool> manual(false);
+	std::atomic<uint64_t> now(0);
+	std::atomic<uint16_t> analog[40];
+	unsigned long seed = 1;
+	std::atomic<bool> restartRequested(false);
+	Host::Heap (*heapProvider)() = nullptr;
+
+	Host::Heap getHeap()
+	{
+		if (heapProvider != nullptr)
+		{
+			return heapProvider();
+		}
+
+		return Host::Heap{ 327680, 200000, 180000, 110000 };
+	}
+}
+
+/// <summary>
+///  Returns the time (usec) since the start of the program (or the manual clock).
+/// </summary>
+static uint64_t getTime()
+{
+	if (manual)
+	{
+		return now;
+	}
+
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - START).count();
+}
+
+unsigned long millis()
+{
+	return (unsigned long)(uint32_t)(getTime() / 1000);
+}
+
+unsigned long micros()
+{
+	return (unsigned long)(uint32_t)getTime();
+}
+
+int64_t esp_timer_get_time()
+{
+	return (int64_t)getTime();
+}
+
+void delay(uint32_t ms)
+{
+	if (manual)
+	{
+		now += (uint64_t)ms * 1000;
+		return;
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us)
+{
+	if (manual)
+	{
+		now += us;
+		return;
+	}
+
+	std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+	std::this_thread::yield();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t value) {}
+int digitalRead(uint8_t pin) { return LOW; }
+
+uint16_t analogRead(uint8_t pin)
+{
+	return (pin < 40) ? analog[pin].load() : 0;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+	return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+long random(long max)
+{
+	if (max <= 0) return 0;
+
+	seed = seed * 1103515245UL + 12345UL;
+	return (long)((seed >> 16) % (unsigned long)max);
+}
+
+long random(long min, long max)
+{
+	return (min >= max) ? min : min + random(max - min);
+}
+
+void randomSeed(unsigned long value)
+{
+	seed = (value != 0) ? value : 1;
+}
+
+void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2, const char* server3)
+{
+}
+
+uint32_t EspClass::getCycleCount()
+{
+	return (uint32_t)(getTime() * 240);
+}
+
+uint32_t EspClass::getHeapSize() { return getHeap().Size; }
+uint32_t EspClass::getFreeHeap() { return getHeap().Free; }
+uint32_t EspClass::getMinFreeHeap() { return getHeap().MinFree; }
+uint32_t EspClass::getMaxAllocHeap() { return getHeap().MaxAlloc; }
+
+void EspClass::restart()
+{
+	restartRequested = true;
+}
+
+void Host::setTime(uint64_t usec)
+{
+	now = usec;
+	manual = true;
+}
+
+void Host::advanceTime(uint64_t usec)
+{
+	now += usec;
+}
+
+void Host::useSystemTime()
+{
+	manual = false;
+}
+
+bool Host::isManualTime()
+{
+	return manual;
+}
+
+void Host::setHeapProvider(Heap (*provider)())
+{
+	heapProvider = provider;
+}
+
+bool Host::isRestartRequested()
+{
+	return restartRequested;
+}
+
+void Host::clearRestart()
+{
+	restartRequested = false;
+}
+
+void Host::setAnalog(uint8_t pin, uint16_t value)
+{
+	if (pin < 40) analog[pin] = value;
+}
@@ -0,0 +1,121 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Arduino.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+#include "HardwareSerial.h"
+#include "pgmspace.h"
+#include "esp32-hal-log.h"
+
+/// <summary>
+/// Minimal Arduino core (ESP32) replacement used by the host build (Linux, g++).
+/// Only the functions used by the sketch classes are provided. The clock and the analog inputs can be
+/// controlled by the tests using the Host functions below.
+/// </summary>
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT  0x01
+#define OUTPUT 0x02
+#define A0 36
+#define A3 39
+#define A4 32
+#define A5 33
+#define A6 34
+#define A7 35
+#define LED_BUILTIN 2
+
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define IRAM_ATTR
+
+using std::min;
+using std::max;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2 = nullptr, const char* server3 = nullptr);
+
+/// <summary>
+/// This class returns fixed chip and memory information (host build only).
+/// </summary>
+class EspClass
+{
+public:
+	uint8_t getChipRevision() { return 1; }
+	uint32_t getCpuFreqMHz() { return 240; }
+	uint32_t getCycleCount();
+	const char* getSdkVersion() { return "host"; }
+	uint32_t getFlashChipSize() { return 4194304; }
+	uint32_t getFlashChipSpeed() { return 40000000; }
+	uint32_t getHeapSize();
+	uint32_t getFreeHeap();
+	uint32_t getMinFreeHeap();
+	uint32_t getMaxAllocHeap();
+	uint32_t getPsramSize() { return 0; }
+	uint32_t getFreePsram() { return 0; }
+	uint32_t getSketchSize() { return 1048576; }
+	uint32_t getFreeSketchSpace() { return 1310720; }
+	String getSketchMD5() { return String("00000000000000000000000000000000"); }
+	uint64_t getEfuseMac() { return 0x0000AABBCCDDEEFFULL; }
+	void restart();
+};
+
+extern EspClass ESP;
+
+/// <summary>
+/// Test controls for the host build (time, analog inputs, heap, restart).
+/// By default millis() and micros() follow the system clock, setTime() switches to a manual clock.
+/// The heap information returned by ESP is fixed unless a heap provider (simulator) is set.
+/// </summary>
+namespace Host
+{
+	struct Heap
+	{
+		uint32_t Size;											// The heap size (bytes)
+		uint32_t Free;											// The free heap (bytes)
+		uint32_t MinFree;										// The minimum free heap ever (bytes)
+		uint32_t MaxAlloc;										// The largest free block (bytes)
+	};
+
+	void setTime(uint64_t usec);								// Sets the manual clock (usec)
+	void advanceTime(uint64_t usec);							// Advances the manual clock (usec)
+	void useSystemTime();										// Switches back to the system clock
+	bool isManualTime();										// Returns true if the manual clock is used
+	void setAnalog(uint8_t pin, uint16_t value);				// Sets the value returned by analogRead()
+	void setHeapProvider(Heap (*provider)());					// Sets the function returning the heap information
+	bool isRestartRequested();									// Returns true if ESP.restart() has been called
+	void clearRestart();										// Clears the restart request
+}
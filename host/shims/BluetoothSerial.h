@@ -0,0 +1,29 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="BluetoothSerial.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+
+/// <summary>
+/// This class replaces the Bluetooth serial port, no data is received and the output is discarded (host build only).
+/// </summary>
+class BluetoothSerial : public Stream
+{
+public:
+	bool begin(String localName = String(), bool isMaster = false) { return true; }
+	void end() {}
+	bool hasClient() { return false; }
+
+	int available() override { return 0; }
+	int read() override { return -1; }
+	int peek() override { return -1; }
+	size_t write(uint8_t c) override { return 1; }
+	size_t write(const uint8_t* buffer, size_t size) override { return size; }
+	using Print::write;
+};
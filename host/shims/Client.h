@@ -0,0 +1,36 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Client.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "IPAddress.h"
+#include "Stream.h"
+
+/// <summary>
+/// This class is the abstract Arduino network client interface (host build only).
+/// </summary>
+class Client : public Stream
+{
+public:
+	virtual int connect(IPAddress ip, uint16_t port) = 0;
+	virtual int connect(const char* host, uint16_t port) = 0;
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size) = 0;
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int read(uint8_t* buffer, size_t size) = 0;
+	virtual int peek() = 0;
+	virtual void flush() = 0;
+	virtual void stop() = 0;
+	virtual uint8_t connected() = 0;
+	virtual operator bool() = 0;
+	using Print::write;
+};
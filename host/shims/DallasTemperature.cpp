@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="DallasTemperature.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string.h>
+#include "DallasTemperature.h"
+
+std::vector<DallasTemperature::Device> DallasTemperature::_devices;
+
+DallasTemperature::Device* DallasTemperature::find(const uint8_t* address)
+{
+	for (Device& device : _devices)
+	{
+		if (memcmp(device.Address, address, sizeof(device.Address)) == 0)
+		{
+			return &device;
+		}
+	}
+
+	return nullptr;
+}
+
+void DallasTemperature::setResolution(uint8_t resolution)
+{
+	for (Device& device : _devices)
+	{
+		device.Resolution = resolution;
+	}
+}
+
+uint8_t DallasTemperature::getResolution(const uint8_t* address)
+{
+	Device* device = find(address);
+	return ((device != nullptr) && device->Connected) ? device->Resolution : 0;
+}
+
+void DallasTemperature::requestTemperatures()
+{
+	for (Device& device : _devices)
+	{
+		device.Converted = device.Connected ? device.TempC : DEVICE_DISCONNECTED_C;
+	}
+}
+
+bool DallasTemperature::getAddress(uint8_t* address, uint8_t index)
+{
+	if ((index >= _devices.size()) || !_devices[index].Connected)
+	{
+		return false;
+	}
+
+	memcpy(address, _devices[index].Address, sizeof(_devices[index].Address));
+	return true;
+}
+
+float DallasTemperature::getTempC(const uint8_t* address)
+{
+	Device* device = find(address);
+	return ((device != nullptr) && device->Connected) ? device->Converted : DEVICE_DISCONNECTED_C;
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t index)
+{
+	if ((index >= _devices.size()) || !_devices[index].Connected)
+	{
+		return DEVICE_DISCONNECTED_C;
+	}
+
+	return _devices[index].Converted;
+}
+
+float DallasTemperature::getTempFByIndex(uint8_t index)
+{
+	float tempC = getTempCByIndex(index);
+	return (tempC == DEVICE_DISCONNECTED_C) ? (float)DEVICE_DISCONNECTED_F : toFahrenheit(tempC);
+}
+
+bool DallasTemperature::isConnected(const uint8_t* address)
+{
+	Device* device = find(address);
+	return (device != nullptr) && device->Connected;
+}
+
+void DallasTemperature::addDevice(const uint8_t* address, float tempC)
+{
+	Device device;
+	memcpy(device.Address, address, sizeof(device.Address));
+	device.TempC = tempC;
+	device.Converted = DEVICE_DISCONNECTED_C;
+	device.Resolution = 12;
+	device.Connected = true;
+	_devices.push_back(device);
+}
+
+void DallasTemperature::setTemperature(uint8_t index, float tempC)
+{
+	if (index < _devices.size()) _devices[index].TempC = tempC;
+}
+
+void DallasTemperature::setConnected(uint8_t index, bool connected)
+{
+	if (index < _devices.size()) _devices[index].Connected = connected;
+}
+
+void DallasTemperature::clearDevices()
+{
+	_devices.clear();
+}
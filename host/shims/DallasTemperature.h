@@ -0,0 +1,68 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="DallasTemperature.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+#define DEVICE_DISCONNECTED_F -196.6
+#define DEVICE_DISCONNECTED_RAW -7040
+
+typedef uint8_t DeviceAddress[8];
+
+/// <summary>
+/// This class replaces the Dallas DS18B20 driver (host build only).
+/// The simulated devices are shared by all instances, the tests add devices and set their temperatures.
+/// A temperature set after requestTemperatures() is returned after the next conversion only.
+/// </summary>
+class DallasTemperature
+{
+public:
+	struct Device
+	{
+		uint8_t Address[8];										// The device address
+		float TempC;											// The current temperature (°C)
+		float Converted;										// The temperature of the last conversion (°C)
+		uint8_t Resolution;										// The device resolution (9..12 bit)
+		bool Connected;											// The device connection state
+	};
+
+private:
+	OneWire* _wire;												// Pointer to the OneWire bus
+	static std::vector<Device> _devices;						// The simulated devices
+
+	static Device* find(const uint8_t* address);				// Returns the device with the specified address
+
+public:
+	DallasTemperature() : _wire(nullptr) {}
+	DallasTemperature(OneWire* wire) : _wire(wire) {}
+
+	void begin() {}
+	uint8_t getDeviceCount() { return (uint8_t)_devices.size(); }
+	void setResolution(uint8_t resolution);
+	uint8_t getResolution(const uint8_t* address);
+	void setWaitForConversion(bool wait) {}
+	void setCheckForConversion(bool check) {}
+	void requestTemperatures();
+	bool getAddress(uint8_t* address, uint8_t index);
+	float getTempC(const uint8_t* address);
+	float getTempCByIndex(uint8_t index);
+	float getTempFByIndex(uint8_t index);
+	bool isConnected(const uint8_t* address);
+
+	static float toFahrenheit(float celsius) { return (celsius * 1.8f) + 32.0f; }
+
+	static void addDevice(const uint8_t* address, float tempC);	// Adds a simulated device
+	static void setTemperature(uint8_t index, float tempC);		// Sets the temperature of a simulated device
+	static void setConnected(uint8_t index, bool connected);	// Sets the connection state of a simulated device
+	static void clearDevices();									// Removes all simulated devices
+};
@@ -0,0 +1,188 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="FS.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string.h>
+#include "FS.h"
+#include "SPIFFS.h"
+
+fs::SPIFFSFS SPIFFS;
+
+using namespace fs;
+
+File::File(std::shared_ptr<std::string> data, const std::string& path, bool append) :
+	_data(data),
+	_next(0),
+	_path(path),
+	_position(append ? data->size() : 0),
+	_append(append)
+{
+}
+
+File::File(std::shared_ptr<Entries> entries, const std::string& path) :
+	_entries(entries),
+	_next(0),
+	_path(path),
+	_position(0),
+	_append(false)
+{
+}
+
+File File::openNextFile(const char* mode)
+{
+	if (!_entries || (_next >= _entries->size()))
+	{
+		return File();
+	}
+
+	const auto& entry = (*_entries)[_next++];
+	return File(entry.second, entry.first, false);
+}
+
+size_t File::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size)
+{
+	if (!_data)
+	{
+		return 0;
+	}
+
+	if (_append)
+	{
+		_position = _data->size();
+	}
+
+	if (_position + size > _data->size())
+	{
+		_data->resize(_position + size);
+	}
+
+	memcpy(&(*_data)[_position], buffer, size);
+	_position += size;
+	return size;
+}
+
+int File::available()
+{
+	return (_data && (_position < _data->size())) ? (int)(_data->size() - _position) : 0;
+}
+
+int File::read()
+{
+	uint8_t c;
+	return (read(&c, 1) == 1) ? c : -1;
+}
+
+size_t File::read(uint8_t* buffer, size_t size)
+{
+	size_t n = (size_t)available();
+
+	if (n > size)
+	{
+		n = size;
+	}
+
+	if (n > 0)
+	{
+		memcpy(buffer, _data->data() + _position, n);
+		_position += n;
+	}
+
+	return n;
+}
+
+int File::peek()
+{
+	return (available() > 0) ? (uint8_t)(*_data)[_position] : -1;
+}
+
+bool File::seek(uint32_t position, SeekMode mode)
+{
+	if (!_data)
+	{
+		return false;
+	}
+
+	size_t base = (mode == SeekCur) ? _position : (mode == SeekEnd) ? _data->size() : 0;
+
+	if (base + position > _data->size())
+	{
+		return false;
+	}
+
+	_position = base + position;
+	return true;
+}
+
+String File::readString()
+{
+	if (available() == 0)
+	{
+		return String();
+	}
+
+	std::string text = _data->substr(_position);
+	_position = _data->size();
+	return String(text);
+}
+
+File FS::open(const char* path, const char* mode)
+{
+	auto it = _files.find(path);
+
+	if ((mode == NULL) || (mode[0] == 'r'))
+	{
+		if ((it == _files.end()) && (strcmp(path, "/") == 0))
+		{
+			return File(std::make_shared<Entries>(_files.begin(), _files.end()), path);
+		}
+
+		return (it == _files.end()) ? File() : File(it->second, path, false);
+	}
+
+	if (it == _files.end())
+	{
+		it = _files.emplace(path, std::make_shared<std::string>()).first;
+	}
+	else if (mode[0] == 'w')
+	{
+		it->second->clear();
+	}
+
+	return File(it->second, path, mode[0] == 'a');
+}
+
+bool FS::rename(const char* from, const char* to)
+{
+	auto it = _files.find(from);
+
+	if (it == _files.end())
+	{
+		return false;
+	}
+
+	std::shared_ptr<std::string> data = it->second;
+	_files.erase(it);
+	_files[to] = data;
+	return true;
+}
+
+size_t FS::usedBytes() const
+{
+	size_t total = 0;
+
+	for (const auto& file : _files)
+	{
+		total += file.second->size();
+	}
+
+	return total;
+}
@@ -0,0 +1,104 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="FS.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Print.h"
+#include "WString.h"
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+/// <summary>
+/// In-memory replacement of the Arduino ESP32 file system classes (host build only).
+/// The files are kept in a std::map, an open file shares the data with the file system.
+/// Opening the root directory ("/") returns a directory listing the files (openNextFile).
+/// </summary>
+namespace fs
+{
+	enum SeekMode
+	{
+		SeekSet = 0,
+		SeekCur = 1,
+		SeekEnd = 2
+	};
+
+	typedef std::vector<std::pair<std::string, std::shared_ptr<std::string>>> Entries;
+
+	class File : public Print
+	{
+	private:
+		std::shared_ptr<std::string> _data;						// The file data (NULL if not open)
+		std::shared_ptr<Entries> _entries;						// The directory entries (NULL if not a directory)
+		size_t _next;											// The next directory entry
+		std::string _path;										// The file path
+		size_t _position;										// The current read/write position
+		bool _append;											// Writes are appended at the end
+
+	public:
+		File() : _next(0), _position(0), _append(false) {}
+		File(std::shared_ptr<std::string> data, const std::string& path, bool append);
+		File(std::shared_ptr<Entries> entries, const std::string& path);
+
+		size_t write(uint8_t c) override;
+		size_t write(const uint8_t* buffer, size_t size) override;
+		using Print::write;
+
+		int available();
+		int read();
+		size_t read(uint8_t* buffer, size_t size);
+		int peek();
+		bool seek(uint32_t position, SeekMode mode = SeekSet);
+		size_t position() const { return _position; }
+		size_t size() const { return _data ? _data->size() : 0; }
+		String readString();
+		const char* name() const { return _path.c_str(); }
+		void close() { _data.reset(); _entries.reset(); }
+		bool isDirectory() const { return (bool)_entries; }
+		File openNextFile(const char* mode = FILE_READ);
+
+		operator bool() const { return _data || _entries; }
+	};
+
+	class FS
+	{
+	protected:
+		std::map<std::string, std::shared_ptr<std::string>> _files;	// The files (path, data)
+
+	public:
+		virtual ~FS() {}
+
+		File open(const char* path, const char* mode = FILE_READ);
+		File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+		bool exists(const char* path) const { return _files.count(path) > 0; }
+		bool exists(const String& path) const { return exists(path.c_str()); }
+		bool remove(const char* path) { return _files.erase(path) > 0; }
+		bool remove(const String& path) { return remove(path.c_str()); }
+		bool rename(const char* from, const char* to);
+		bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+
+		size_t usedBytes() const;								// Returns the total size of all files
+		void clear() { _files.clear(); }						// Removes all files (host only)
+	};
+}
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
@@ -0,0 +1,87 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="FreeRTOS.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <pthread.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+/// <summary>
+/// The task handle is the address of a thread local variable (unique per thread).
+/// </summary>
+static thread_local char task;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackSize,
+	void* parameter, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core)
+{
+	std::thread thread(function, parameter);
+
+	if (handle != NULL)
+	{
+		*handle = (TaskHandle_t)thread.native_handle();
+	}
+
+	thread.detach();
+	return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackSize,
+	void* parameter, UBaseType_t priority, TaskHandle_t* handle)
+{
+	return xTaskCreatePinnedToCore(function, name, stackSize, parameter, priority, handle, 0);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+	return &task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+void vTaskDelete(TaskHandle_t handle)
+{
+	if (handle == NULL)
+	{
+		pthread_exit(NULL);
+	}
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+	return new std::timed_mutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks)
+{
+	std::timed_mutex* mutex = (std::timed_mutex*)semaphore;
+
+	if (ticks == portMAX_DELAY)
+	{
+		mutex->lock();
+		return pdTRUE;
+	}
+
+	return mutex->try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+	((std::timed_mutex*)semaphore)->unlock();
+	return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+	delete (std::timed_mutex*)semaphore;
+}
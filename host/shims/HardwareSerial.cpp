@@ -0,0 +1,59 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="HardwareSerial.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include "HardwareSerial.h"
+
+HardwareSerial Serial;
+
+int HardwareSerial::available()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return (int)_input.size();
+}
+
+int HardwareSerial::read()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (_input.empty())
+	{
+		return -1;
+	}
+
+	uint8_t c = (uint8_t)_input[0];
+	_input.erase(0, 1);
+	return c;
+}
+
+int HardwareSerial::peek()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _input.empty() ? -1 : (uint8_t)_input[0];
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+	if (_echo)
+	{
+		fwrite(buffer, 1, size, stdout);
+	}
+
+	return size;
+}
+
+void HardwareSerial::inject(const char* text)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_input += text;
+}
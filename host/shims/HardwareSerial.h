@@ -0,0 +1,46 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="HardwareSerial.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+#include <string>
+
+#include "Stream.h"
+
+/// <summary>
+/// This class replaces the serial port (host build only). The input is taken from a queue filled by the
+/// tests or the simulator (Host::serialInput), the output is discarded unless echoing is enabled (stdout).
+/// </summary>
+class HardwareSerial : public Stream
+{
+private:
+	std::mutex _mutex;											// Protects the input queue
+	std::string _input;											// The pending input
+	bool _echo;													// Write the output to stdout
+
+public:
+	HardwareSerial() : _echo(false) {}
+
+	void begin(unsigned long baud) {}
+	void end() {}
+	operator bool() const { return true; }
+
+	int available() override;
+	int read() override;
+	int peek() override;
+	size_t write(uint8_t c) override;
+	size_t write(const uint8_t* buffer, size_t size) override;
+	using Print::write;
+
+	void inject(const char* text);								// Adds text to the input queue (host only)
+	void setEcho(bool echo) { _echo = echo; }					// Enables writing the output to stdout (host only)
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,52 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="IPAddress.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include "IPAddress.h"
+
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+IPAddress::IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+{
+	_address.bytes[0] = a;
+	_address.bytes[1] = b;
+	_address.bytes[2] = c;
+	_address.bytes[3] = d;
+}
+
+bool IPAddress::fromString(const char* address)
+{
+	unsigned int parts[4];
+	char end;
+
+	if ((address == NULL) ||
+		(sscanf(address, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &end) != 4))
+	{
+		return false;
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (parts[i] > 255)
+		{
+			return false;
+		}
+
+		_address.bytes[i] = (uint8_t)parts[i];
+	}
+
+	return true;
+}
+
+String IPAddress::toString() const
+{
+	char text[16];
+	snprintf(text, sizeof(text), "%u.%u.%u.%u",
+		_address.bytes[0], _address.bytes[1], _address.bytes[2], _address.bytes[3]);
+	return String(text);
+}
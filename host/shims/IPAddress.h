@@ -0,0 +1,42 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="IPAddress.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include "WString.h"
+
+/// <summary>
+/// This class implements the Arduino IPv4 address (host build only, stored in network byte order like the ESP32).
+/// </summary>
+class IPAddress
+{
+private:
+	union
+	{
+		uint8_t bytes[4];
+		uint32_t dword;
+	} _address;
+
+public:
+	IPAddress() { _address.dword = 0; }
+	IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d);
+	IPAddress(uint32_t address) { _address.dword = address; }
+
+	bool fromString(const char* address);
+	bool fromString(const String& address) { return fromString(address.c_str()); }
+	String toString() const;
+
+	operator uint32_t() const { return _address.dword; }
+	bool operator==(const IPAddress& other) const { return _address.dword == other._address.dword; }
+	bool operator!=(const IPAddress& other) const { return _address.dword != other._address.dword; }
+	uint8_t operator[](int index) const { return _address.bytes[index]; }
+	uint8_t& operator[](int index) { return _address.bytes[index]; }
+};
+
+extern const IPAddress INADDR_NONE;
@@ -0,0 +1,25 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="OneWire.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+
+/// <summary>
+/// This class replaces the OneWire bus (host build only, see DallasTemperature.h).
+/// </summary>
+class OneWire
+{
+public:
+	uint8_t Pin;												// The bus pin
+
+	OneWire() : Pin(0) {}
+	OneWire(uint8_t pin) : Pin(pin) {}
+
+	void begin(uint8_t pin) { Pin = pin; }
+};
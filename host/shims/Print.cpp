@@ -0,0 +1,76 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Print.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdarg.h>
+#include <stdio.h>
+#include "Print.h"
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+	size_t n = 0;
+
+	while (size--)
+	{
+		if (write(*buffer++) == 0) break;
+		n++;
+	}
+
+	return n;
+}
+
+size_t Print::printf(const char* format, ...)
+{
+	char buffer[256];
+	va_list args;
+
+	va_start(args, format);
+	int length = vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+
+	if (length < 0)
+	{
+		return 0;
+	}
+
+	if ((size_t)length < sizeof(buffer))
+	{
+		return write((const uint8_t*)buffer, length);
+	}
+
+	std::string text(length + 1, '\0');
+	va_start(args, format);
+	vsnprintf(&text[0], text.size(), format, args);
+	va_end(args);
+
+	return write((const uint8_t*)text.data(), length);
+}
+
+size_t Print::print(long value, int base)
+{
+	return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+	return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(long long value, int base)
+{
+	return print((long)value, base);
+}
+
+size_t Print::print(unsigned long long value, int base)
+{
+	return print((unsigned long)value, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+	return print(String(value, (unsigned int)digits));
+}
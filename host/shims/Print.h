@@ -0,0 +1,68 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Print.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+#include "WString.h"
+
+class __FlashStringHelper;
+#define F(text) (reinterpret_cast<const __FlashStringHelper*>(text))
+
+/// <summary>
+/// This class implements the Arduino Print base class (host build only).
+/// Derived classes have to implement write(uint8_t), the numbers are formatted like the Arduino core.
+/// </summary>
+class Print
+{
+public:
+	virtual ~Print() {}
+
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size);
+	virtual void flush() {}
+
+	size_t write(const char* text) { return (text == NULL) ? 0 : write((const uint8_t*)text, strlen(text)); }
+	size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+	size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+	size_t print(const char* text) { return write(text); }
+	size_t print(const __FlashStringHelper* text) { return write(reinterpret_cast<const char*>(text)); }
+	size_t print(const String& text) { return write(text.c_str(), text.length()); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+	size_t print(int value, int base = DEC) { return print((long)value, base); }
+	size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+	size_t print(long value, int base = DEC);
+	size_t print(unsigned long value, int base = DEC);
+	size_t print(long long value, int base = DEC);
+	size_t print(unsigned long long value, int base = DEC);
+	size_t print(double value, int digits = 2);
+
+	size_t println() { return write("\r\n"); }
+	template <typename T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+	template <typename T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+/// <summary>
+/// This class implements a print output collecting the text in a std::string (host build only).
+/// </summary>
+class StringPrint : public Print
+{
+public:
+	std::string Text;											// The printed text
+
+	size_t write(uint8_t c) override { Text += (char)c; return 1; }
+	size_t write(const uint8_t* buffer, size_t size) override { Text.append((const char*)buffer, size); return size; }
+	using Print::write;
+};
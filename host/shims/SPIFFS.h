@@ -0,0 +1,30 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SPIFFS.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "FS.h"
+
+namespace fs
+{
+	/// <summary>
+	/// This class replaces the SPIFFS flash file system with an in-memory file system (host build only).
+	/// </summary>
+	class SPIFFSFS : public FS
+	{
+	public:
+		static const size_t TOTAL_BYTES = 1378241;				// The size of the default SPIFFS partition
+
+		bool begin(bool formatOnFail = false, const char* basePath = "/spiffs", uint8_t maxOpenFiles = 10) { return true; }
+		bool format() { clear(); return true; }
+		size_t totalBytes() const { return TOTAL_BYTES; }
+		void end() {}
+	};
+}
+
+extern fs::SPIFFSFS SPIFFS;
@@ -0,0 +1,52 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Stream.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "Stream.h"
+
+size_t Stream::readBytes(char* buffer, size_t length)
+{
+	size_t count = 0;
+
+	while ((count < length) && (available() > 0))
+	{
+		buffer[count++] = (char)read();
+	}
+
+	return count;
+}
+
+String Stream::readString()
+{
+	std::string text;
+
+	while (available() > 0)
+	{
+		text += (char)read();
+	}
+
+	return String(text);
+}
+
+String Stream::readStringUntil(char terminator)
+{
+	std::string text;
+
+	while (available() > 0)
+	{
+		int c = read();
+
+		if (c == terminator)
+		{
+			break;
+		}
+
+		text += (char)c;
+	}
+
+	return String(text);
+}
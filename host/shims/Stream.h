@@ -0,0 +1,39 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Stream.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Print.h"
+#include "WString.h"
+
+/// <summary>
+/// This class is the Arduino Stream base class (host build only).
+/// Derived classes have to implement available(), read() and peek(), reading never blocks.
+/// </summary>
+class Stream : public Print
+{
+protected:
+	unsigned long _timeout;										// The read timeout (msec, not used)
+
+public:
+	Stream() : _timeout(1000) {}
+
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+
+	void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+	size_t readBytes(char* buffer, size_t length);
+	size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+	String readString();
+	String readStringUntil(char terminator);
+};
@@ -0,0 +1,34 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Udp.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include "IPAddress.h"
+#include "Print.h"
+
+/// <summary>
+/// This class is the abstract Arduino UDP interface (host build only). The receiving part has default
+/// implementations (no packets are received), the fakes override the methods used by the tested class.
+/// </summary>
+class UDP : public Print
+{
+public:
+	virtual uint8_t begin(uint16_t port) { return 1; }
+	virtual void stop() {}
+	virtual int beginPacket(IPAddress ip, uint16_t port) { return 0; }
+	virtual int beginPacket(const char* host, uint16_t port) = 0;
+	virtual int endPacket() = 0;
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size) = 0;
+	virtual int parsePacket() { return 0; }
+	virtual int read(unsigned char* buffer, size_t size) { return 0; }
+	virtual IPAddress remoteIP() { return IPAddress(); }
+	virtual uint16_t remotePort() { return 0; }
+	using Print::write;
+};
@@ -0,0 +1,212 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WString.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include "WString.h"
+
+/// <summary>
+///  Converts an unsigned value using the specified base (no leading zeros, like the Arduino core).
+/// </summary>
+static std::string convert(unsigned long value, unsigned char base)
+{
+	if ((base < 2) || (base > 16)) base = DEC;
+
+	char buffer[8 * sizeof(unsigned long) + 1];
+	char* p = buffer + sizeof(buffer) - 1;
+	*p = '\0';
+
+	do
+	{
+		unsigned long digit = value % base;
+		*--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+		value /= base;
+	} while (value != 0);
+
+	return std::string(p);
+}
+
+/// <summary>
+///  Converts a signed value (only decimal values get a minus sign).
+/// </summary>
+static std::string convert(long value, unsigned char base)
+{
+	if ((base == DEC) && (value < 0))
+	{
+		return "-" + convert((unsigned long)(-(value + 1)) + 1, base);
+	}
+
+	return convert((unsigned long)value, base);
+}
+
+/// <summary>
+///  Converts a floating point value with a fixed number of decimals.
+/// </summary>
+static std::string convert(double value, unsigned int decimals)
+{
+	char buffer[64];
+	snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+	return std::string(buffer);
+}
+
+String::String(const char* text) : _text(text ? text : "") {}
+String::String(const std::string& text) : _text(text) {}
+String::String(char c) : _text(1, c) {}
+String::String(unsigned char value, unsigned char base) : _text(convert((unsigned long)value, base)) {}
+String::String(int value, unsigned char base) : _text(convert((long)value, base)) {}
+String::String(unsigned int value, unsigned char base) : _text(convert((unsigned long)value, base)) {}
+String::String(long value, unsigned char base) : _text(convert(value, base)) {}
+String::String(unsigned long value, unsigned char base) : _text(convert(value, base)) {}
+String::String(float value, unsigned int decimals) : _text(convert((double)value, decimals)) {}
+String::String(double value, unsigned int decimals) : _text(convert(value, decimals)) {}
+
+bool String::equalsIgnoreCase(const String& text) const
+{
+	return (length() == text.length()) && (strcasecmp(c_str(), text.c_str()) == 0);
+}
+
+bool String::startsWith(const String& prefix) const
+{
+	return _text.compare(0, prefix._text.length(), prefix._text) == 0;
+}
+
+bool String::endsWith(const String& suffix) const
+{
+	return (_text.length() >= suffix._text.length()) &&
+		(_text.compare(_text.length() - suffix._text.length(), suffix._text.length(), suffix._text) == 0);
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+	size_t index = _text.find(c, from);
+	return (index == std::string::npos) ? -1 : (int)index;
+}
+
+int String::indexOf(const String& text, unsigned int from) const
+{
+	size_t index = _text.find(text._text, from);
+	return (index == std::string::npos) ? -1 : (int)index;
+}
+
+int String::lastIndexOf(char c) const
+{
+	size_t index = _text.rfind(c);
+	return (index == std::string::npos) ? -1 : (int)index;
+}
+
+String String::substring(unsigned int left) const
+{
+	return substring(left, length());
+}
+
+String String::substring(unsigned int left, unsigned int right) const
+{
+	if (left > right)
+	{
+		unsigned int temp = left;
+		left = right;
+		right = temp;
+	}
+
+	if (left >= _text.length()) return String();
+	if (right > _text.length()) right = length();
+
+	return String(_text.substr(left, right - left));
+}
+
+void String::replace(const String& find, const String& replacement)
+{
+	if (find._text.empty()) return;
+
+	size_t index = 0;
+
+	while ((index = _text.find(find._text, index)) != std::string::npos)
+	{
+		_text.replace(index, find._text.length(), replacement._text);
+		index += replacement._text.length();
+	}
+}
+
+void String::remove(unsigned int index)
+{
+	if (index < _text.length()) _text.erase(index);
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+	if (index < _text.length()) _text.erase(index, count);
+}
+
+void String::toLowerCase()
+{
+	for (char& c : _text) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase()
+{
+	for (char& c : _text) c = (char)toupper((unsigned char)c);
+}
+
+void String::trim()
+{
+	size_t begin = _text.find_first_not_of(" \t\r\n\f\v");
+
+	if (begin == std::string::npos)
+	{
+		_text.clear();
+		return;
+	}
+
+	size_t end = _text.find_last_not_of(" \t\r\n\f\v");
+	_text = _text.substr(begin, end - begin + 1);
+}
+
+long String::toInt() const
+{
+	return atol(_text.c_str());
+}
+
+float String::toFloat() const
+{
+	return (float)atof(_text.c_str());
+}
+
+double String::toDouble() const
+{
+	return atof(_text.c_str());
+}
+
+StringSumHelper operator + (const String& left, const String& right)
+{
+	StringSumHelper result(left);
+	result.concat(right);
+	return result;
+}
+
+StringSumHelper operator + (const String& left, const char* right)
+{
+	StringSumHelper result(left);
+	result.concat(right);
+	return result;
+}
+
+StringSumHelper operator + (const char* left, const String& right)
+{
+	StringSumHelper result(left);
+	result.concat(right);
+	return result;
+}
+
+StringSumHelper operator + (const String& left, char right)
+{
+	StringSumHelper result(left);
+	result.concat(right);
+	return result;
+}
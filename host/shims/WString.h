@@ -0,0 +1,112 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WString.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#ifndef DEC
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+#endif
+
+/// <summary>
+/// This class implements the subset of the Arduino String class used by the sketch (host build only).
+/// The characters are stored in a std::string, c_str() never returns NULL.
+/// </summary>
+class String
+{
+private:
+	std::string _text;											// The string data
+
+public:
+	String(const char* text = "");
+	String(const std::string& text);
+	explicit String(char c);
+	explicit String(unsigned char value, unsigned char base = DEC);
+	explicit String(int value, unsigned char base = DEC);
+	explicit String(unsigned int value, unsigned char base = DEC);
+	explicit String(long value, unsigned char base = DEC);
+	explicit String(unsigned long value, unsigned char base = DEC);
+	explicit String(float value, unsigned int decimals = 2);
+	explicit String(double value, unsigned int decimals = 2);
+
+	const char* c_str() const { return _text.c_str(); }
+	unsigned int length() const { return (unsigned int)_text.length(); }
+	bool isEmpty() const { return _text.empty(); }
+	bool reserve(unsigned int size) { _text.reserve(size); return true; }
+
+	bool concat(const String& text) { _text += text._text; return true; }
+	bool concat(const char* text) { if (text == NULL) return false; _text += text; return true; }
+	bool concat(const char* text, unsigned int length) { _text.append(text, length); return true; }
+	bool concat(char c) { _text += c; return true; }
+	bool concat(int value) { return concat(String(value)); }
+	bool concat(unsigned int value) { return concat(String(value)); }
+	bool concat(long value) { return concat(String(value)); }
+	bool concat(unsigned long value) { return concat(String(value)); }
+	bool concat(double value) { return concat(String(value)); }
+
+	String& operator += (const String& text) { concat(text); return *this; }
+	String& operator += (const char* text) { concat(text); return *this; }
+	String& operator += (char c) { concat(c); return *this; }
+	String& operator += (int value) { concat(value); return *this; }
+	String& operator += (unsigned int value) { concat(value); return *this; }
+	String& operator += (long value) { concat(value); return *this; }
+	String& operator += (unsigned long value) { concat(value); return *this; }
+
+	bool equals(const String& text) const { return _text == text._text; }
+	bool equals(const char* text) const { return _text == (text ? text : ""); }
+	bool equalsIgnoreCase(const String& text) const;
+	bool startsWith(const String& prefix) const;
+	bool endsWith(const String& suffix) const;
+	bool operator == (const String& text) const { return equals(text); }
+	bool operator == (const char* text) const { return equals(text); }
+	bool operator != (const String& text) const { return !equals(text); }
+	bool operator != (const char* text) const { return !equals(text); }
+	bool operator < (const String& text) const { return _text < text._text; }
+
+	char charAt(unsigned int index) const { return (index < _text.length()) ? _text[index] : 0; }
+	char operator [] (unsigned int index) const { return charAt(index); }
+	char& operator [] (unsigned int index) { return _text[index]; }
+
+	int indexOf(char c, unsigned int from = 0) const;
+	int indexOf(const String& text, unsigned int from = 0) const;
+	int lastIndexOf(char c) const;
+	String substring(unsigned int left) const;
+	String substring(unsigned int left, unsigned int right) const;
+
+	void replace(const String& find, const String& replacement);
+	void remove(unsigned int index);
+	void remove(unsigned int index, unsigned int count);
+	void toLowerCase();
+	void toUpperCase();
+	void trim();
+
+	long toInt() const;
+	float toFloat() const;
+	double toDouble() const;
+};
+
+/// <summary>
+/// This class is the return type of the Arduino string concatenation (required by ArduinoJson).
+/// </summary>
+class StringSumHelper : public String
+{
+public:
+	StringSumHelper(const String& text) : String(text) {}
+	StringSumHelper(const char* text) : String(text) {}
+};
+
+StringSumHelper operator + (const String& left, const String& right);
+StringSumHelper operator + (const String& left, const char* right);
+StringSumHelper operator + (const char* left, const String& right);
+StringSumHelper operator + (const String& left, char right);
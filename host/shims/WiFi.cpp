@@ -0,0 +1,573 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WiFi.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <mutex>
+
+#include "WiFi.h"
+#include "esp_wifi.h"
+#include "tcpip_adapter.h"
+#include "lwip/dhcp.h"
+#include "ESP32Ping.h"
+
+WiFiClass WiFi;
+PingClass Ping;
+
+namespace
+{
+	const uint32_t SCAN_TIME = 2000;							// The duration of a scan (msec)
+	const uint32_t LEASE_RENEW = 43200;							// The DHCP renewal time (T1, sec)
+	const uint8_t BSSID[6] = { 0x24, 0x0A, 0xC4, 0x12, 0x34, 0x56 };
+
+	struct Network
+	{
+		const char* SSID;
+		int8_t RSSI;
+		uint8_t Channel;
+		wifi_auth_mode_t Encryption;
+	};
+
+	const Network NETWORKS[] = {
+		{ "SoilNet", -55, 6, WIFI_AUTH_WPA2_PSK },
+		{ "Guest", -71, 11, WIFI_AUTH_OPEN },
+		{ "Neighbour", -83, 1, WIFI_AUTH_WPA_WPA2_PSK }
+	};
+
+	const int16_t NETWORK_COUNT = sizeof(NETWORKS) / sizeof(*NETWORKS);
+
+	/// <summary>
+	/// The WiFi state shared by all WiFiClass instances. Note that the state is only changed by the
+	/// loop task, other tasks (e.g. the syslog sink) only call status().
+	/// </summary>
+	struct State
+	{
+		wifi_mode_t Mode = WIFI_OFF;
+		bool Available = true;									// The access point can be reached
+		uint32_t Delay = 1500;									// The time needed to connect (msec)
+		bool Started = false;									// A station connection has been started
+		uint32_t StartTime = 0;									// The time the connection has been started
+		std::string SSID;
+		std::string PASS;
+		std::string Hostname = "espressif";
+		bool Static = false;									// A static IP configuration is used
+		IPAddress Local;
+		IPAddress Gateway;
+		IPAddress Subnet;
+		IPAddress DNS1;
+		IPAddress DNS2;
+		std::string ApSSID;
+		std::string ApPASS;
+		std::string ApHostname = "espressif";
+		IPAddress ApLocal = IPAddress(192, 168, 4, 1);
+		IPAddress ApSubnet = IPAddress(255, 255, 255, 0);
+		bool Scanning = false;
+		uint32_t ScanTime = 0;
+		int16_t ScanResult = WIFI_SCAN_FAILED;
+		WiFiEventFullCb Callback = NULL;
+	};
+
+	State state;
+	std::mutex mutex;											// Protects the connection queue
+	std::deque<std::shared_ptr<Host::Connection>> pending;		// The queued client connections
+
+	void dispatch(system_event_id_t event, uint8_t reason = 0)
+	{
+		if (state.Callback != NULL)
+		{
+			system_event_info_t info;
+			memset(&info, 0, sizeof(info));
+			info.disconnected.reason = reason;
+			state.Callback(event, info);
+		}
+	}
+
+	void copy(uint8_t* target, size_t size, const std::string& text)
+	{
+		memset(target, 0, size);
+		strncpy((char*)target, text.c_str(), size - 1);
+	}
+}
+
+wifi_mode_t WiFiClass::getMode()
+{
+	return state.Mode;
+}
+
+bool WiFiClass::mode(wifi_mode_t mode)
+{
+	if ((mode != WIFI_STA) && (mode != WIFI_AP_STA))
+	{
+		state.Started = false;
+	}
+
+	if ((mode != WIFI_AP) && (mode != WIFI_AP_STA) && !state.ApSSID.empty())
+	{
+		state.ApSSID.clear();
+		dispatch(SYSTEM_EVENT_AP_STOP);
+	}
+
+	state.Mode = mode;
+	return true;
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase, int32_t channel, const uint8_t* bssid, bool connect)
+{
+	if ((ssid == NULL) || (*ssid == '\0'))
+	{
+		return WL_CONNECT_FAILED;
+	}
+
+	if ((state.Mode != WIFI_STA) && (state.Mode != WIFI_AP_STA))
+	{
+		mode((state.Mode == WIFI_AP) ? WIFI_AP_STA : WIFI_STA);
+	}
+
+	state.SSID = ssid;
+	state.PASS = (passphrase != NULL) ? passphrase : "";
+	state.Started = connect;
+	state.StartTime = millis();
+	return status();
+}
+
+bool WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress dns2)
+{
+	state.Static = ((uint32_t)local != 0);
+	state.Local = local;
+	state.Gateway = gateway;
+	state.Subnet = subnet;
+	state.DNS1 = dns1;
+	state.DNS2 = dns2;
+	return true;
+}
+
+bool WiFiClass::disconnect(bool wifiOff)
+{
+	bool connected = isConnected();
+	state.Started = false;
+
+	if (connected)
+	{
+		dispatch(SYSTEM_EVENT_STA_DISCONNECTED, WIFI_REASON_ASSOC_LEAVE);
+	}
+
+	if (wifiOff)
+	{
+		mode(WIFI_OFF);
+	}
+
+	return true;
+}
+
+wl_status_t WiFiClass::status()
+{
+	if (!state.Started)
+	{
+		return WL_DISCONNECTED;
+	}
+
+	if (!state.Available)
+	{
+		return WL_NO_SSID_AVAIL;
+	}
+
+	return (millis() - state.StartTime >= state.Delay) ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+IPAddress WiFiClass::localIP()
+{
+	if (!isConnected()) return IPAddress();
+	return state.Static ? state.Local : IPAddress(192, 168, 1, 50);
+}
+
+IPAddress WiFiClass::gatewayIP()
+{
+	if (!isConnected()) return IPAddress();
+	return state.Static ? state.Gateway : IPAddress(192, 168, 1, 1);
+}
+
+IPAddress WiFiClass::subnetMask()
+{
+	if (!isConnected()) return IPAddress();
+	return state.Static ? state.Subnet : IPAddress(255, 255, 255, 0);
+}
+
+IPAddress WiFiClass::dnsIP(uint8_t index)
+{
+	if (!isConnected()) return IPAddress();
+	if (state.Static) return (index == 0) ? state.DNS1 : state.DNS2;
+	return (index == 0) ? IPAddress(192, 168, 1, 1) : IPAddress();
+}
+
+IPAddress WiFiClass::networkID()
+{
+	return IPAddress((uint32_t)localIP() & (uint32_t)subnetMask());
+}
+
+int8_t WiFiClass::RSSI()
+{
+	return isConnected() ? -60 : 0;
+}
+
+uint8_t* WiFiClass::BSSID()
+{
+	static uint8_t bssid[6];
+	memcpy(bssid, ::BSSID, sizeof(bssid));
+	return isConnected() ? bssid : NULL;
+}
+
+String WiFiClass::BSSIDstr()
+{
+	char text[18];
+	snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X",
+		::BSSID[0], ::BSSID[1], ::BSSID[2], ::BSSID[3], ::BSSID[4], ::BSSID[5]);
+	return isConnected() ? String(text) : String();
+}
+
+int32_t WiFiClass::channel()
+{
+	return isConnected() ? 6 : 0;
+}
+
+String WiFiClass::macAddress()
+{
+	return String("24:0A:C4:AA:BB:CC");
+}
+
+String WiFiClass::SSID()
+{
+	return isConnected() ? String(state.SSID) : String();
+}
+
+const char* WiFiClass::getHostname()
+{
+	return state.Hostname.c_str();
+}
+
+bool WiFiClass::setHostname(const char* hostname)
+{
+	state.Hostname = (hostname != NULL) ? hostname : "";
+	return true;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* passphrase, int channel, int hidden, int maxConnections)
+{
+	if ((ssid == NULL) || (*ssid == '\0'))
+	{
+		return false;
+	}
+
+	if ((state.Mode != WIFI_AP) && (state.Mode != WIFI_AP_STA))
+	{
+		mode((state.Mode == WIFI_STA) ? WIFI_AP_STA : WIFI_AP);
+	}
+
+	state.ApSSID = ssid;
+	state.ApPASS = (passphrase != NULL) ? passphrase : "";
+	dispatch(SYSTEM_EVENT_AP_START);
+	return true;
+}
+
+bool WiFiClass::softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet)
+{
+	state.ApLocal = local;
+	state.ApSubnet = subnet;
+	return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool wifiOff)
+{
+	if (wifiOff)
+	{
+		mode((state.Mode == WIFI_AP_STA) ? WIFI_STA : WIFI_OFF);
+	}
+	else
+	{
+		state.ApSSID.clear();
+	}
+
+	return true;
+}
+
+bool WiFiClass::softAPsetHostname(const char* hostname)
+{
+	state.ApHostname = (hostname != NULL) ? hostname : "";
+	return true;
+}
+
+const char* WiFiClass::softAPgetHostname()
+{
+	return state.ApHostname.c_str();
+}
+
+IPAddress WiFiClass::softAPIP()
+{
+	return state.ApSSID.empty() ? IPAddress() : state.ApLocal;
+}
+
+IPAddress WiFiClass::softAPNetworkID()
+{
+	return IPAddress((uint32_t)softAPIP() & (uint32_t)state.ApSubnet);
+}
+
+String WiFiClass::softAPmacAddress()
+{
+	return String("24:0A:C4:AA:BB:CD");
+}
+
+int WiFiClass::onEvent(WiFiEventFullCb callback, system_event_id_t event)
+{
+	state.Callback = callback;
+	return 1;
+}
+
+int16_t WiFiClass::scanNetworks(bool async)
+{
+	state.Scanning = true;
+	state.ScanTime = millis();
+
+	if (async)
+	{
+		return WIFI_SCAN_RUNNING;
+	}
+
+	delay(SCAN_TIME);
+	return scanComplete();
+}
+
+int16_t WiFiClass::scanComplete()
+{
+	if (state.Scanning)
+	{
+		if (millis() - state.ScanTime < SCAN_TIME)
+		{
+			return WIFI_SCAN_RUNNING;
+		}
+
+		state.Scanning = false;
+		state.ScanResult = NETWORK_COUNT;
+		dispatch(SYSTEM_EVENT_SCAN_DONE);
+	}
+
+	return state.ScanResult;
+}
+
+void WiFiClass::scanDelete()
+{
+	state.ScanResult = WIFI_SCAN_FAILED;
+}
+
+String WiFiClass::SSID(uint8_t index)
+{
+	return (index < state.ScanResult) ? String(NETWORKS[index].SSID) : String();
+}
+
+int32_t WiFiClass::RSSI(uint8_t index)
+{
+	return (index < state.ScanResult) ? NETWORKS[index].RSSI : 0;
+}
+
+int32_t WiFiClass::channel(uint8_t index)
+{
+	return (index < state.ScanResult) ? NETWORKS[index].Channel : 0;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t index)
+{
+	return (index < state.ScanResult) ? NETWORKS[index].Encryption : WIFI_AUTH_OPEN;
+}
+
+esp_err_t tcpip_adapter_get_netif(tcpip_adapter_if_t tcpip_if, void** netif)
+{
+	static struct dhcp dhcp;
+	static struct netif sta = { &dhcp };
+
+	if (tcpip_if != TCPIP_ADAPTER_IF_STA)
+	{
+		return ESP_FAIL;
+	}
+
+	// The lease is obtained when connected (unless a static IP configuration is used) and renewed every T1.
+	bool bound = WiFi.isConnected() && !state.Static;
+	uint32_t elapsed = (millis() - state.StartTime) / 1000 % LEASE_RENEW;
+	dhcp.state = bound ? DHCP_STATE_BOUND : DHCP_STATE_OFF;
+	dhcp.t1_renew_time = bound ? (LEASE_RENEW - elapsed) / DHCP_COARSE_TIMER_SECS : 0;
+	*netif = &sta;
+	return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t* config)
+{
+	if (interface == WIFI_IF_AP)
+	{
+		copy(config->ap.ssid, sizeof(config->ap.ssid), state.ApSSID);
+		copy(config->ap.password, sizeof(config->ap.password), state.ApPASS);
+	}
+	else
+	{
+		copy(config->sta.ssid, sizeof(config->sta.ssid), state.SSID);
+		copy(config->sta.password, sizeof(config->sta.password), state.PASS);
+	}
+
+	return ESP_OK;
+}
+
+void WiFiClient::idle()
+{
+	if (Host::isManualTime())
+	{
+		Host::advanceTime(1000);
+	}
+}
+
+size_t WiFiClient::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size)
+{
+	if (!connected())
+	{
+		return 0;
+	}
+
+	_connection->Response.append((const char*)buffer, size);
+	return size;
+}
+
+int WiFiClient::available()
+{
+	if (!connected())
+	{
+		return 0;
+	}
+
+	int count = (int)(_connection->Request.size() - _connection->Position);
+
+	if (count == 0)
+	{
+		idle();
+	}
+
+	return count;
+}
+
+int WiFiClient::read()
+{
+	return (available() > 0) ? (uint8_t)_connection->Request[_connection->Position++] : -1;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size)
+{
+	size_t count = (size_t)available();
+
+	if (count > size)
+	{
+		count = size;
+	}
+
+	if (count > 0)
+	{
+		memcpy(buffer, _connection->Request.data() + _connection->Position, count);
+		_connection->Position += count;
+	}
+
+	return (int)count;
+}
+
+int WiFiClient::peek()
+{
+	return (connected() && (_connection->Position < _connection->Request.size())) ?
+		(uint8_t)_connection->Request[_connection->Position] : -1;
+}
+
+void WiFiClient::stop()
+{
+	if (_connection)
+	{
+		_connection->Closed = true;
+		_connection.reset();
+	}
+}
+
+uint8_t WiFiClient::connected()
+{
+	return (_connection && !_connection->Closed) ? 1 : 0;
+}
+
+void WiFiServer::begin(uint16_t port)
+{
+	if (port != 0)
+	{
+		_port = port;
+	}
+
+	_listening = true;
+}
+
+WiFiClient WiFiServer::available()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (_listening)
+	{
+		for (auto it = pending.begin(); it != pending.end(); ++it)
+		{
+			if ((*it)->Port == _port)
+			{
+				std::shared_ptr<Host::Connection> connection = *it;
+				pending.erase(it);
+				return WiFiClient(connection);
+			}
+		}
+	}
+
+	return WiFiClient();
+}
+
+void Host::setWiFiAvailable(bool available)
+{
+	state.Available = available;
+}
+
+void Host::setWiFiDelay(uint32_t msec)
+{
+	state.Delay = msec;
+}
+
+void Host::dropWiFi(uint8_t reason)
+{
+	if (WiFi.isConnected())
+	{
+		state.Started = false;
+		dispatch(SYSTEM_EVENT_STA_DISCONNECTED, reason);
+	}
+}
+
+void Host::resetWiFi()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	state = State();
+	pending.clear();
+}
+
+std::shared_ptr<Host::Connection> Host::connect(uint16_t port, const std::string& request)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	std::shared_ptr<Connection> connection = std::make_shared<Connection>(port, request);
+	pending.push_back(connection);
+	return connection;
+}
+
+size_t Host::getPendingConnections()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending.size();
+}
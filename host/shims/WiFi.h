@@ -0,0 +1,92 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WiFi.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiType.h"
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+#include "WiFiUdp.h"
+
+/// <summary>
+/// This class replaces the ESP32 WiFi (host build only). The state is shared by all instances (static),
+/// the sketch classes take WiFiClass by value. A station connection completes after a virtual delay
+/// if the access point is available, the events are dispatched from the calling (loop) task.
+/// </summary>
+class WiFiClass
+{
+public:
+	wifi_mode_t getMode();
+	bool mode(wifi_mode_t mode);
+
+	wl_status_t begin(const char* ssid, const char* passphrase = NULL, int32_t channel = 0,
+		const uint8_t* bssid = NULL, bool connect = true);
+	bool config(IPAddress local, IPAddress gateway, IPAddress subnet,
+		IPAddress dns1 = (uint32_t)0, IPAddress dns2 = (uint32_t)0);
+	bool disconnect(bool wifiOff = false);
+	wl_status_t status();
+	bool isConnected() { return status() == WL_CONNECTED; }
+	bool setAutoReconnect(bool autoReconnect) { return true; }
+
+	IPAddress localIP();
+	IPAddress gatewayIP();
+	IPAddress subnetMask();
+	IPAddress dnsIP(uint8_t index = 0);
+	IPAddress networkID();
+	int8_t RSSI();
+	uint8_t* BSSID();
+	String BSSIDstr();
+	int32_t channel();
+	String macAddress();
+	String SSID();
+	const char* getHostname();
+	bool setHostname(const char* hostname);
+
+	bool softAP(const char* ssid, const char* passphrase = NULL, int channel = 1, int hidden = 0, int maxConnections = 4);
+	bool softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet);
+	bool softAPdisconnect(bool wifiOff = false);
+	bool softAPsetHostname(const char* hostname);
+	const char* softAPgetHostname();
+	IPAddress softAPIP();
+	IPAddress softAPNetworkID();
+	uint8_t softAPgetStationNum() { return 0; }
+	String softAPmacAddress();
+
+	int onEvent(WiFiEventFullCb callback, system_event_id_t event = SYSTEM_EVENT_MAX);
+
+	int16_t scanNetworks(bool async = false);
+	int16_t scanComplete();
+	void scanDelete();
+	String SSID(uint8_t index);
+	int32_t RSSI(uint8_t index);
+	int32_t channel(uint8_t index);
+	wifi_auth_mode_t encryptionType(uint8_t index);
+};
+
+extern WiFiClass WiFi;
+
+/// <summary>
+/// Simulation controls of the WiFi and the web server connections (host build only).
+/// </summary>
+namespace Host
+{
+	void setWiFiAvailable(bool available);						// Sets if the access point can be reached
+	void setWiFiDelay(uint32_t msec);							// Sets the time needed to connect (msec)
+	void dropWiFi(uint8_t reason = WIFI_REASON_BEACON_TIMEOUT);	// Drops the station connection (event)
+	void resetWiFi();											// Resets the WiFi state (tests)
+
+	std::shared_ptr<Connection> connect(uint16_t port,			// Queues a client connection to the server
+		const std::string& request);
+	size_t getPendingConnections();								// Returns the number of queued connections
+}
@@ -0,0 +1,65 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WiFiClient.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "Client.h"
+
+namespace Host
+{
+	/// <summary>
+	/// A loopback connection between a simulated HTTP client and the WiFiServer (host build only).
+	/// </summary>
+	struct Connection
+	{
+		uint16_t Port;											// The server port
+		std::string Request;									// The request data (sent by the client)
+		size_t Position;										// The read position in the request
+		std::string Response;									// The response data (written by the server)
+		bool Closed;											// True if the server has closed the connection
+
+		Connection(uint16_t port, const std::string& request) :
+			Port(port), Request(request), Position(0), Closed(false) {}
+	};
+}
+
+/// <summary>
+/// This class replaces the WiFi client using a loopback connection (host build only).
+/// Reading an empty connection advances the manual clock by 1 msec, so read timeouts expire in virtual time.
+/// </summary>
+class WiFiClient : public Client
+{
+private:
+	std::shared_ptr<Host::Connection> _connection;				// The connection (NULL if not connected)
+
+	void idle();												// Called if no data is available
+
+public:
+	WiFiClient() {}
+	WiFiClient(std::shared_ptr<Host::Connection> connection) : _connection(connection) {}
+
+	int connect(IPAddress ip, uint16_t port) override { return 0; }
+	int connect(const char* host, uint16_t port) override { return 0; }
+	size_t write(uint8_t c) override;
+	size_t write(const uint8_t* buffer, size_t size) override;
+	int available() override;
+	int read() override;
+	int read(uint8_t* buffer, size_t size) override;
+	int peek() override;
+	void flush() override {}
+	void stop() override;
+	uint8_t connected() override;
+	operator bool() override { return connected() != 0; }
+	using Print::write;
+
+	void setNoDelay(bool noDelay) {}
+};
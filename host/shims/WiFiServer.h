@@ -0,0 +1,31 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WiFiServer.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include "WiFiClient.h"
+
+/// <summary>
+/// This class replaces the WiFi server, the connections are queued by Host::connect() (host build only).
+/// </summary>
+class WiFiServer
+{
+private:
+	uint16_t _port;												// The server port
+	bool _listening;											// True if begin() has been called
+
+public:
+	WiFiServer(uint16_t port = 80, uint8_t maxClients = 4) : _port(port), _listening(false) {}
+
+	void begin(uint16_t port = 0);
+	void end() { _listening = false; }
+	void setNoDelay(bool noDelay) {}
+	WiFiClient available();
+	operator bool() { return _listening; }
+};
@@ -0,0 +1,101 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WiFiType.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+
+/// <summary>
+/// The ESP32 WiFi types and event definitions used by the sketch (host build only).
+/// </summary>
+typedef enum
+{
+	WIFI_MODE_NULL = 0,
+	WIFI_MODE_STA,
+	WIFI_MODE_AP,
+	WIFI_MODE_APSTA,
+	WIFI_MODE_MAX
+} wifi_mode_t;
+
+#define WIFI_OFF    WIFI_MODE_NULL
+#define WIFI_STA    WIFI_MODE_STA
+#define WIFI_AP     WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum
+{
+	WIFI_AUTH_OPEN = 0,
+	WIFI_AUTH_WEP,
+	WIFI_AUTH_WPA_PSK,
+	WIFI_AUTH_WPA2_PSK,
+	WIFI_AUTH_WPA_WPA2_PSK,
+	WIFI_AUTH_WPA2_ENTERPRISE,
+	WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+typedef enum
+{
+	WL_NO_SHIELD = 255,
+	WL_IDLE_STATUS = 0,
+	WL_NO_SSID_AVAIL = 1,
+	WL_SCAN_COMPLETED = 2,
+	WL_CONNECTED = 3,
+	WL_CONNECT_FAILED = 4,
+	WL_CONNECTION_LOST = 5,
+	WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum
+{
+	WIFI_REASON_UNSPECIFIED = 1,
+	WIFI_REASON_AUTH_EXPIRE = 2,
+	WIFI_REASON_AUTH_LEAVE = 3,
+	WIFI_REASON_ASSOC_EXPIRE = 4,
+	WIFI_REASON_ASSOC_LEAVE = 8,
+	WIFI_REASON_BEACON_TIMEOUT = 200,
+	WIFI_REASON_NO_AP_FOUND = 201,
+	WIFI_REASON_AUTH_FAIL = 202,
+	WIFI_REASON_ASSOC_FAIL = 203,
+	WIFI_REASON_HANDSHAKE_TIMEOUT = 204
+} wifi_err_reason_t;
+
+typedef enum
+{
+	SYSTEM_EVENT_WIFI_READY = 0,
+	SYSTEM_EVENT_SCAN_DONE,
+	SYSTEM_EVENT_STA_START,
+	SYSTEM_EVENT_STA_STOP,
+	SYSTEM_EVENT_STA_CONNECTED,
+	SYSTEM_EVENT_STA_DISCONNECTED,
+	SYSTEM_EVENT_STA_AUTHMODE_CHANGE,
+	SYSTEM_EVENT_STA_GOT_IP,
+	SYSTEM_EVENT_STA_LOST_IP,
+	SYSTEM_EVENT_AP_START,
+	SYSTEM_EVENT_AP_STOP,
+	SYSTEM_EVENT_AP_STACONNECTED,
+	SYSTEM_EVENT_AP_STADISCONNECTED,
+	SYSTEM_EVENT_MAX
+} system_event_id_t;
+
+typedef struct
+{
+	uint8_t ssid[32];
+	uint8_t ssid_len;
+	uint8_t bssid[6];
+	uint8_t reason;
+} system_event_sta_disconnected_t;
+
+typedef union
+{
+	system_event_sta_disconnected_t disconnected;
+} system_event_info_t;
+
+typedef void (*WiFiEventFullCb)(system_event_id_t event, system_event_info_t info);
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
@@ -0,0 +1,99 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WiFiUdp.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "WiFiUdp.h"
+
+// The socket headers are included after the shims (INADDR_NONE is an IPAddress constant there).
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+std::atomic<uint32_t> WiFiUDP::Packets(0);
+std::atomic<uint32_t> WiFiUDP::Bytes(0);
+
+WiFiUDP::~WiFiUDP()
+{
+	if (_socket >= 0)
+	{
+		close(_socket);
+	}
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+	_address = (ip[0] == 127) ? (uint32_t)ip : 0;
+	_port = port;
+	_packet.clear();
+	return 1;
+}
+
+int WiFiUDP::beginPacket(const char* host, uint16_t port)
+{
+	IPAddress ip;
+
+	if (strcmp(host, "localhost") == 0)
+	{
+		ip = IPAddress(127, 0, 0, 1);
+	}
+	else if (!ip.fromString(host))
+	{
+		ip = IPAddress();
+	}
+
+	return beginPacket(ip, port);
+}
+
+int WiFiUDP::endPacket()
+{
+	Packets++;
+
+	if (_address == 0)
+	{
+		return 1;
+	}
+
+	if (_socket < 0)
+	{
+		_socket = socket(AF_INET, SOCK_DGRAM, 0);
+	}
+
+	sockaddr_in target;
+	memset(&target, 0, sizeof(target));
+	target.sin_family = AF_INET;
+	target.sin_addr.s_addr = _address;
+	target.sin_port = htons(_port);
+
+	return (_socket >= 0) &&
+		(sendto(_socket, _packet.data(), _packet.size(), 0, (const sockaddr*)&target, sizeof(target)) >= 0) ? 1 : 0;
+}
+
+size_t WiFiUDP::write(uint8_t c)
+{
+	Bytes++;
+
+	if (_address != 0)
+	{
+		_packet += (char)c;
+	}
+
+	return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size)
+{
+	Bytes += size;
+
+	if (_address != 0)
+	{
+		_packet.append((const char*)buffer, size);
+	}
+
+	return size;
+}
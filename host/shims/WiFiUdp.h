@@ -0,0 +1,43 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WiFiUdp.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include "Udp.h"
+
+/// <summary>
+/// This class replaces the WiFi UDP socket (host build only). The packets are counted, packets to a loopback
+/// address (127.x.x.x, localhost) are sent as real datagrams, all other packets are discarded. No packets are
+/// received.
+/// </summary>
+class WiFiUDP : public UDP
+{
+private:
+	int _socket;												// The datagram socket (-1: not opened)
+	uint32_t _address;											// The loopback destination (0: discard the packet)
+	uint16_t _port;												// The destination port
+	std::string _packet;										// The actual packet (loopback only)
+
+public:
+	static std::atomic<uint32_t> Packets;						// The number of packets sent (all sockets)
+	static std::atomic<uint32_t> Bytes;							// The number of bytes sent (all sockets)
+
+	WiFiUDP() : _socket(-1), _address(0), _port(0) {}
+	WiFiUDP(const WiFiUDP&) = delete;
+	~WiFiUDP();
+
+	int beginPacket(IPAddress ip, uint16_t port) override;
+	int beginPacket(const char* host, uint16_t port) override;
+	int endPacket() override;
+	size_t write(uint8_t c) override;
+	size_t write(const uint8_t* buffer, size_t size) override;
+	using Print::write;
+};
@@ -0,0 +1,11 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="pgmspace.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "../pgmspace.h"
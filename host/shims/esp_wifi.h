@@ -0,0 +1,40 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="esp_wifi.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "WiFiType.h"
+
+typedef enum
+{
+	WIFI_IF_STA = 0,
+	WIFI_IF_AP
+} wifi_interface_t;
+
+typedef struct
+{
+	uint8_t ssid[32];
+	uint8_t password[64];
+} wifi_ap_config_t;
+
+typedef struct
+{
+	uint8_t ssid[32];
+	uint8_t password[64];
+} wifi_sta_config_t;
+
+typedef union
+{
+	wifi_ap_config_t ap;
+	wifi_sta_config_t sta;
+} wifi_config_t;
+
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t* config);
@@ -0,0 +1,27 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="task.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "FreeRTOS.h"
+
+/// <summary>
+/// FreeRTOS tasks mapped to detached std::thread instances (host build only, priorities and cores are ignored).
+/// </summary>
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackSize,
+	void* parameter, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackSize,
+	void* parameter, UBaseType_t priority, TaskHandle_t* handle);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+void vTaskDelay(TickType_t ticks);
+void vTaskDelete(TaskHandle_t handle);
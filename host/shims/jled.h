@@ -0,0 +1,57 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="jled.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+
+/// <summary>
+/// This class replaces the JLed library, only the blink effect is supported (host build only).
+/// </summary>
+class JLed
+{
+private:
+	uint8_t _pin;												// The LED pin
+	uint16_t _on;												// The on time (msec)
+	uint16_t _off;												// The off time (msec)
+	bool _forever;												// Repeat the effect
+	uint32_t _start;											// The start time (msec)
+	bool _state;												// The actual LED state
+
+public:
+	JLed(uint8_t pin) : _pin(pin), _on(0), _off(0), _forever(false), _start(millis()), _state(false) {}
+
+	JLed& Blink(uint16_t on, uint16_t off) { _on = on; _off = off; _start = millis(); return *this; }
+	JLed& Forever() { _forever = true; return *this; }
+	JLed& Off() { _on = 0; _off = 0; return *this; }
+
+	bool Update()
+	{
+		uint32_t period = (uint32_t)_on + _off;
+
+		if (period == 0)
+		{
+			_state = false;
+			return false;
+		}
+
+		uint32_t elapsed = millis() - _start;
+
+		if (!_forever && (elapsed >= period))
+		{
+			_state = false;
+			return false;
+		}
+
+		_state = (elapsed % period) < _on;
+		digitalWrite(_pin, _state ? HIGH : LOW);
+		return true;
+	}
+
+	bool IsOn() const { return _state; }
+};
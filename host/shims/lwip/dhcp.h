@@ -0,0 +1,31 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="dhcp.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+
+/// <summary>
+/// The lwIP DHCP client state (host build only, the fields used by the sketch).
+/// </summary>
+#define DHCP_COARSE_TIMER_SECS 60
+#define DHCP_STATE_OFF 0
+#define DHCP_STATE_BOUND 10
+
+struct dhcp
+{
+	uint8_t state;												// The DHCP client state
+	uint16_t t1_renew_time;										// The time until the renewal (coarse timer ticks)
+};
+
+struct netif
+{
+	struct dhcp* dhcp;											// The DHCP client data
+};
+
+#define netif_dhcp_data(netif) ((netif)->dhcp)
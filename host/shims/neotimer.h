@@ -0,0 +1,67 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="neotimer.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "Arduino.h"
+
+/// <summary>
+/// This class replaces the Neotimer library (host build only, same semantics).
+/// done() returns true once the time has elapsed after start(), repeat() returns true once per period.
+/// </summary>
+class Neotimer
+{
+private:
+	uint32_t _time;												// The timer period (msec)
+	uint32_t _last;												// The time the timer has been (re)started
+	bool _started;												// True if the timer is running
+	bool _done;													// True if the timer has elapsed
+
+public:
+	Neotimer(uint32_t time = 1000) : _time(time), _last(0), _started(false), _done(false) {}
+
+	void set(uint32_t time) { _time = time; }
+	uint32_t get() { return _time; }
+	void start() { reset(); _started = true; }
+	uint32_t stop() { _started = false; return millis() - _last; }
+	void reset() { stop(); _last = millis(); _done = false; }
+	bool waiting() { return _started && !done(); }
+
+	bool done()
+	{
+		if (!_started)
+		{
+			return false;
+		}
+
+		if (millis() - _last >= _time)
+		{
+			_done = true;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool repeat()
+	{
+		if (done())
+		{
+			reset();
+			return true;
+		}
+
+		if (!_started)
+		{
+			_last = millis();
+			_started = true;
+		}
+
+		return false;
+	}
+};
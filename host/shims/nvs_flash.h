@@ -0,0 +1,15 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="nvs_flash.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "esp_err.h"
+
+// The non volatile storage is not used by the sketch (host build only).
+inline esp_err_t nvs_flash_init() { return ESP_OK; }
+inline esp_err_t nvs_flash_erase() { return ESP_OK; }
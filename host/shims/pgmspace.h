@@ -0,0 +1,26 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="pgmspace.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <string.h>
+
+// The flash memory is ordinary memory on the host (and on the ESP32).
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const unsigned char*)(address))
+#define pgm_read_word(address) (*(const unsigned short*)(address))
+#define pgm_read_dword(address) (*(const unsigned long*)(address))
+#define pgm_read_ptr(address) (*(void* const*)(address))
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define memcpy_P memcpy
+#define PGM_P const char*
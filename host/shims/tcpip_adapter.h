@@ -0,0 +1,24 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="tcpip_adapter.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "esp_err.h"
+
+/// <summary>
+/// The ESP-IDF TCP/IP adapter (host build only, the station interface is provided by the WiFi shim).
+/// </summary>
+typedef enum
+{
+	TCPIP_ADAPTER_IF_STA = 0,
+	TCPIP_ADAPTER_IF_AP,
+	TCPIP_ADAPTER_IF_ETH,
+	TCPIP_ADAPTER_IF_MAX
+} tcpip_adapter_if_t;
+
+esp_err_t tcpip_adapter_get_netif(tcpip_adapter_if_t tcpip_if, void** netif);
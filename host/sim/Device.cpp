@@ -0,0 +1,142 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Device.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <sstream>
+
+#include <SPIFFS.h>
+#include <DallasTemperature.h>
+#include <esp_timer.h>
+
+#include "Device.h"
+#include "HeapWrap.h"
+
+uint64_t Device::_updated = 0;
+
+namespace
+{
+	const uint8_t SOIL_PINS[] = { A0, A3, A6, A7, A4, A5 };		// The soil sensor inputs
+	const uint8_t TEMP_ADDRESSES[][8] = {						// The temperature sensor addresses
+		{ 0x28, 0xFF, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01 },
+		{ 0x28, 0xFF, 0x02, 0x00, 0x00, 0x00, 0x00, 0x02 }
+	};
+}
+
+/// <summary>
+///  Prepares the device: manual clock, heap, SPIFFS files and sensors (call before setup()).
+/// </summary>
+void Device::begin()
+{
+	Host::setHeapProvider(&getHeap);
+	Host::setTime(0);
+
+	DallasTemperature::clearDevices();
+	DallasTemperature::addDevice(TEMP_ADDRESSES[0], 20.0f);
+	DallasTemperature::addDevice(TEMP_ADDRESSES[1], 15.0f);
+
+	SPIFFS.format();
+	loadFiles(SKETCH_DIR "/data", "/");
+
+	_updated = 0;
+	update();
+}
+
+/// <summary>
+///  Sets the sensor inputs (slow daily drift, the soil dries out and is watered every third day).
+///  The inputs are changed once per second (virtual time).
+/// </summary>
+void Device::update()
+{
+	uint64_t time = now();
+
+	if ((time != 0) && (time - _updated < 1000))
+	{
+		return;
+	}
+
+	double day = (double)time / DAY;
+	double phase = 2.0 * M_PI * day;
+	double dry = fmod(day, 3.0) / 3.0;
+
+	for (size_t i = 0; i < sizeof(SOIL_PINS); i++)
+	{
+		Host::setAnalog(SOIL_PINS[i], (uint16_t)(1500 + 1500 * dry + 100 * sin(phase + i)));
+	}
+
+	DallasTemperature::setTemperature(0, (float)(18.0 + 6.0 * sin(phase)));
+	DallasTemperature::setTemperature(1, (float)(12.0 + 8.0 * sin(phase - 0.5)));
+	_updated = time;
+}
+
+/// <summary>
+///  Returns the virtual time since the start (msec, does not wrap like millis()).
+/// </summary>
+/// <returns>The virtual time (msec)</returns>
+uint64_t Device::now()
+{
+	return (uint64_t)esp_timer_get_time() / 1000;
+}
+
+/// <summary>
+///  Copies the files of a directory (recursively) into the SPIFFS.
+/// </summary>
+/// <param name="directory">The host directory</param>
+/// <param name="prefix">The SPIFFS path prefix</param>
+void Device::loadFiles(const std::string& directory, const std::string& prefix)
+{
+	DIR* dir = opendir(directory.c_str());
+
+	if (dir == NULL)
+	{
+		fprintf(stderr, "cannot open %s\n", directory.c_str());
+		exit(1);
+	}
+
+	for (struct dirent* entry = readdir(dir); entry != NULL; entry = readdir(dir))
+	{
+		std::string name = entry->d_name;
+		std::string path = directory + "/" + name;
+		struct stat info;
+
+		if ((name[0] == '.') || (stat(path.c_str(), &info) != 0))
+		{
+			continue;
+		}
+
+		if (S_ISDIR(info.st_mode))
+		{
+			loadFiles(path, prefix + name + "/");
+			continue;
+		}
+
+		std::ifstream input(path, std::ios::binary);
+		std::stringstream data;
+		data << input.rdbuf();
+
+		File file = SPIFFS.open((prefix + name).c_str(), FILE_WRITE);
+		file.write((const uint8_t*)data.str().data(), data.str().size());
+		file.close();
+	}
+
+	closedir(dir);
+}
+
+/// <summary>
+///  Returns the simulated heap information (used by the ESP heap functions).
+/// </summary>
+/// <returns>The heap information</returns>
+Host::Heap Device::getHeap()
+{
+	SimHeap::Stats stats = getSimHeap()->getStats();
+	return Host::Heap{ stats.Size, stats.Free, stats.MinFree, stats.MaxAlloc };
+}
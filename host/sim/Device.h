@@ -0,0 +1,41 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Device.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include <Arduino.h>
+
+// The sketch functions (see Sketch.cpp).
+void setup();
+void loop();
+
+/// <summary>
+/// This class sets up the simulated device used by the simulator tools: the manual clock, the simulated
+/// heap (ESP heap functions), the SPIFFS files (data folder), the temperature sensors, and the sensor inputs.
+/// </summary>
+class Device
+{
+public:
+	static const uint16_t PORT = 80;							// The web server port
+	static const uint64_t DAY = 86400000ULL;					// One day (msec)
+
+private:
+	static uint64_t _updated;									// The time of the last sensor update (msec)
+
+	static void loadFiles(const std::string& directory,		// Copies the files of a directory into the SPIFFS
+		const std::string& prefix);
+	static Host::Heap getHeap();								// Returns the simulated heap information
+
+public:
+	static void begin();										// Prepares the device (before setup())
+	static void update();										// Updates the sensor inputs (every second)
+	static uint64_t now();										// Returns the virtual time (msec)
+};
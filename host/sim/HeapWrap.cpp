@@ -0,0 +1,114 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="HeapWrap.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#include "HeapWrap.h"
+#include "HeapMonitor.h"
+
+/// <summary>
+/// The malloc / free wrappers of the simulator (linked with -Wl,--wrap=malloc,...). All allocations of the
+/// sketch (incl. operator new) are taken from the simulated heap and counted by the heap monitor (as the
+/// allocation hook of the device, see HeapHook.cpp). The arena size is
+/// taken from the environment variable SIM_HEAP_KB, since the first allocation happens before main().
+/// Memory allocated by the C library itself is not in the arena and is passed to the real functions.
+/// </summary>
+extern "C"
+{
+	void* __real_malloc(size_t size);
+	void __real_free(void* p);
+	void* __real_realloc(void* p, size_t size);
+
+	void* __wrap_malloc(size_t size);
+	void __wrap_free(void* p);
+	void* __wrap_realloc(void* p, size_t size);
+	void* __wrap_calloc(size_t count, size_t size);
+}
+
+namespace
+{
+	const size_t DEFAULT_HEAP_KB = 192;							// The default arena size (KB)
+	alignas(SimHeap) uint8_t storage[sizeof(SimHeap)];			// The heap instance (never destroyed)
+	SimHeap* heap = NULL;
+}
+
+SimHeap* getSimHeap()
+{
+	if (heap == NULL)
+	{
+		const char* text = getenv("SIM_HEAP_KB");
+		size_t size = ((text != NULL) && (atoi(text) > 0)) ? (size_t)atoi(text) : DEFAULT_HEAP_KB;
+		void* arena = __real_malloc(size * 1024);
+		heap = new (storage) SimHeap(arena, size * 1024);
+	}
+
+	return heap;
+}
+
+void* __wrap_malloc(size_t size)
+{
+	HeapMonitor::onAlloc(size);
+	return getSimHeap()->allocate(size);
+}
+
+void __wrap_free(void* p)
+{
+	if (p != NULL)
+	{
+		HeapMonitor::onFree();
+	}
+
+	if ((p != NULL) && !getSimHeap()->contains(p))
+	{
+		__real_free(p);
+		return;
+	}
+
+	getSimHeap()->release(p);
+}
+
+void* __wrap_realloc(void* p, size_t size)
+{
+	if (p != NULL)
+	{
+		HeapMonitor::onFree();
+	}
+
+	if (size > 0)
+	{
+		HeapMonitor::onAlloc(size);
+	}
+
+	if ((p != NULL) && !getSimHeap()->contains(p))
+	{
+		return __real_realloc(p, size);
+	}
+
+	return getSimHeap()->reallocate(p, size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+	if ((size != 0) && (count > SIZE_MAX / size))
+	{
+		return NULL;
+	}
+
+	HeapMonitor::onAlloc(count * size);
+	void* p = getSimHeap()->allocate(count * size);
+
+	if (p != NULL)
+	{
+		memset(p, 0, count * size);
+	}
+
+	return p;
+}
@@ -0,0 +1,14 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="HeapWrap.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include "SimHeap.h"
+
+// Returns the simulated heap used by malloc / free (linked with --wrap, see HeapWrap.cpp).
+SimHeap* getSimHeap();
@@ -0,0 +1,108 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LoadStats.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+#include <algorithm>
+
+#include "LoadStats.h"
+
+/// <summary>
+///  Adds a completed request.
+/// </summary>
+/// <param name="route">The route (request path)</param>
+/// <param name="latency">The latency from sending the request to the end of the response (msec)</param>
+/// <param name="bytes">The response size (bytes)</param>
+/// <param name="ok">False if the request failed (status >= 400 or no response)</param>
+void LoadStats::add(const std::string& route, uint32_t latency, size_t bytes, bool ok)
+{
+	Route& stats = _routes[route];
+
+	stats.Latencies.push_back(latency);
+	stats.Bytes += bytes;
+	_total.Latencies.push_back(latency);
+	_total.Bytes += bytes;
+
+	if (!ok)
+	{
+		stats.Errors++;
+		_total.Errors++;
+	}
+}
+
+/// <summary>
+///  Adds a refused request (the connection backlog of the server is full).
+/// </summary>
+/// <param name="route">The route (request path)</param>
+void LoadStats::refuse(const std::string& route)
+{
+	_routes[route].Errors++;
+	_routes[route].Refused++;
+	_total.Errors++;
+	_total.Refused++;
+}
+
+/// <summary>
+///  Returns the statistics of a route.
+/// </summary>
+/// <param name="route">The route (request path)</param>
+/// <returns>The route statistics</returns>
+const LoadStats::Route& LoadStats::get(const std::string& route)
+{
+	return _routes[route];
+}
+
+/// <summary>
+///  Prints the statistics table (requests, errors, throughput, latency percentiles per route).
+/// </summary>
+/// <param name="out">The output file</param>
+/// <param name="seconds">The duration of the test (virtual time, sec)</param>
+void LoadStats::print(FILE* out, double seconds)
+{
+	fprintf(out, "%-32s %8s %7s %8s %9s %7s %7s %7s %7s\n",
+		"route", "requests", "errors", "req/s", "KB/s", "p50 ms", "p90 ms", "p99 ms", "max ms");
+
+	auto row = [&](const std::string& name, const Route& stats)
+	{
+		size_t requests = stats.Latencies.size() + stats.Refused;
+
+		fprintf(out, "%-32s %8zu %6.1f%% %8.2f %9.1f %7u %7u %7u %7u\n",
+			name.c_str(), requests,
+			(requests > 0) ? 100.0 * stats.Errors / requests : 0.0,
+			(seconds > 0) ? stats.Latencies.size() / seconds : 0.0,
+			(seconds > 0) ? stats.Bytes / 1024.0 / seconds : 0.0,
+			percentile(stats.Latencies, 50), percentile(stats.Latencies, 90),
+			percentile(stats.Latencies, 99), percentile(stats.Latencies, 100));
+	};
+
+	for (const auto& route : _routes)
+	{
+		row(route.first, route.second);
+	}
+
+	row("total", _total);
+}
+
+/// <summary>
+///  Returns the percentile of the values (nearest rank, 0 if there are no values).
+/// </summary>
+/// <param name="values">The values (copied, sorted)</param>
+/// <param name="percent">The percentile (0 - 100)</param>
+/// <returns>The percentile value</returns>
+uint32_t LoadStats::percentile(std::vector<uint32_t> values, double percent)
+{
+	if (values.empty())
+	{
+		return 0;
+	}
+
+	size_t rank = (size_t)ceil(percent / 100.0 * values.size());
+	rank = (rank < 1) ? 1 : (rank > values.size()) ? values.size() : rank;
+
+	std::nth_element(values.begin(), values.begin() + (rank - 1), values.end());
+	return values[rank - 1];
+}
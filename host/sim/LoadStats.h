@@ -0,0 +1,48 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LoadStats.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// This class collects the request latencies of the load test per route and prints the throughput,
+/// the latency percentiles (nearest rank) and the error rates.
+/// </summary>
+class LoadStats
+{
+public:
+	struct Route
+	{
+		std::vector<uint32_t> Latencies;						// The latencies of the completed requests (msec)
+		uint32_t Errors;										// The number of failed requests (status >= 400, refused)
+		uint32_t Refused;										// The number of refused requests (backlog full)
+		uint64_t Bytes;											// The number of response bytes
+
+		Route() : Errors(0), Refused(0), Bytes(0) {}
+	};
+
+private:
+	std::map<std::string, Route> _routes;						// The statistics per route (path)
+	Route _total;												// The statistics of all routes
+
+public:
+	void add(const std::string& route, uint32_t latency,		// Adds a completed request
+		size_t bytes, bool ok);
+	void refuse(const std::string& route);						// Adds a refused request (backlog full)
+	const Route& get(const std::string& route);					// Returns the statistics of a route
+	const Route& total() const { return _total; }				// Returns the statistics of all routes
+	void print(FILE* out, double seconds);						// Prints the statistics table
+
+	static uint32_t percentile(std::vector<uint32_t> values,	// Returns the percentile (nearest rank)
+		double percent);
+};
@@ -0,0 +1,311 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LoadTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <deque>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#include "Device.h"
+#include "LoadStats.h"
+#include "Traffic.h"
+#include "../../src/Sensors.h"
+
+extern Sensors sensors;
+
+/// <summary>
+/// The HTTP load test of the simulated device. Each client runs a traffic profile (GET and POST lines of a
+/// traffic script, relative to the client start), the clients start at random offsets. The sketch serves
+/// one connection per loop() like on the device, the requests wait in the connection backlog (refused
+/// connections are retried like TCP SYN retransmissions).
+///
+/// The ESP32 time of a loop() call is modeled from the host time: host time * slowdown, plus a fixed
+/// connection overhead and the transfer time (WiFi throughput) for each response. The slowdown can be
+/// calibrated using the result of the 'bench' command on the device (--calibrate us/op).
+///
+///   soilmonitor_load [--profile file[:count]]... [--duration 10m] [--slowdown 25] [--calibrate us]
+///                    [--bandwidth 400] [--overhead 5] [--backlog 4] [--seed 1]
+/// </summary>
+namespace
+{
+	const int CALIBRATION_COUNT = 200;							// The iterations of the calibration workload
+	const int MAX_RETRIES = 3;									// The SYN retransmissions before a request fails
+	const uint64_t RETRY_TIMEOUT = 1000;						// The initial SYN retransmission timeout (msec)
+
+	struct Profile
+	{
+		std::string Script;										// The traffic script
+		int Count;												// The number of clients
+	};
+
+	struct Options
+	{
+		std::vector<Profile> Profiles;							// The client profiles
+		uint64_t Duration = 600000;								// The test duration (virtual time, msec)
+		double Slowdown = 25.0;									// The ESP32 / host CPU time ratio
+		double Calibrate = 0.0;									// The device 'bench' result (us/op, 0: not used)
+		double Bandwidth = 400.0;								// The WiFi throughput (KB/s)
+		double Overhead = 5.0;									// The connection overhead (accept, close, msec)
+		size_t Backlog = 4;										// The connection backlog of the server (WiFiServer)
+		unsigned int Seed = 1;									// The seed of the client start offsets
+	};
+
+	struct Attempt
+	{
+		Traffic::Event Event;									// The request event
+		uint64_t Sent;											// The time the request has been issued (msec)
+		uint64_t Retry;											// The time of the next connection attempt (msec)
+		int Retries;											// The number of connection retries
+	};
+
+	struct User
+	{
+		Traffic Script;											// The client traffic
+		uint64_t Start;											// The client start time (msec)
+		std::deque<Attempt> Waiting;							// The requests waiting for a connection
+	};
+
+	struct Request
+	{
+		std::shared_ptr<Host::Connection> Connection;			// The loopback connection
+		std::string Route;										// The request path
+		uint64_t Sent;											// The time the request has been sent (msec)
+	};
+
+	/// <summary>
+	///  Prints the usage and exits.
+	/// </summary>
+	void usage(const char* name)
+	{
+		fprintf(stderr, "usage: %s [--profile file[:count]]... [--duration 10m] [--slowdown factor] [--calibrate us/op]\n"
+			"       [--bandwidth KB/s] [--overhead ms] [--backlog n] [--seed n]\n", name);
+		exit(2);
+	}
+
+	/// <summary>
+	///  Parses the command line options.
+	/// </summary>
+	Options parse(int argc, char* argv[])
+	{
+		Options options;
+
+		for (int i = 1; i < argc; i++)
+		{
+			std::string option = argv[i];
+
+			if (i + 1 >= argc)
+			{
+				usage(argv[0]);
+			}
+
+			std::string value = argv[++i];
+
+			if (option == "--profile")
+			{
+				size_t colon = value.rfind(':');
+				int count = (colon != std::string::npos) ? atoi(value.c_str() + colon + 1) : 1;
+
+				if (count <= 0)
+				{
+					usage(argv[0]);
+				}
+
+				options.Profiles.push_back(Profile{ value.substr(0, colon), count });
+			}
+			else if ((option == "--duration") && Traffic::parseDuration(value, options.Duration)) {}
+			else if (option == "--slowdown") options.Slowdown = atof(value.c_str());
+			else if (option == "--calibrate") options.Calibrate = atof(value.c_str());
+			else if (option == "--bandwidth") options.Bandwidth = atof(value.c_str());
+			else if (option == "--overhead") options.Overhead = atof(value.c_str());
+			else if (option == "--backlog") options.Backlog = (size_t)atoi(value.c_str());
+			else if (option == "--seed") options.Seed = (unsigned int)atoi(value.c_str());
+			else usage(argv[0]);
+		}
+
+		if (options.Profiles.empty())
+		{
+			options.Profiles.push_back(Profile{ SIM_DIR "/dashboard.traffic", 2 });
+			options.Profiles.push_back(Profile{ SIM_DIR "/config.traffic", 1 });
+			options.Profiles.push_back(Profile{ SIM_DIR "/scraper.traffic", 1 });
+		}
+
+		if ((options.Slowdown <= 0) || (options.Bandwidth <= 0) || (options.Backlog == 0))
+		{
+			usage(argv[0]);
+		}
+
+		return options;
+	}
+
+	/// <summary>
+	///  Returns the host time (usec) of the calibration workload (the /data serialization, see 'bench').
+	/// </summary>
+	double calibrate()
+	{
+		size_t length = 0;
+		auto start = std::chrono::steady_clock::now();
+
+		for (int i = 0; i < CALIBRATION_COUNT; i++)
+		{
+			length += sensors.serialize().length();
+		}
+
+		auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+		return (length > 0) ? elapsed.count() / CALIBRATION_COUNT : 0.0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options = parse(argc, argv);
+	std::mt19937 generator(options.Seed);
+	std::vector<User> users;
+	std::list<Request> requests;
+	LoadStats stats;
+	std::string error;
+
+	for (const Profile& profile : options.Profiles)
+	{
+		for (int i = 0; i < profile.Count; i++)
+		{
+			User user;
+
+			if (!user.Script.load(profile.Script.c_str(), error))
+			{
+				fprintf(stderr, "%s\n", error.c_str());
+				return 1;
+			}
+
+			user.Start = std::uniform_int_distribution<uint64_t>(0, 5000)(generator);
+			users.push_back(user);
+		}
+	}
+
+	Device::begin();
+	setup();
+
+	// Run the sketch for a while (WiFi connected, first sensor samples).
+	while (Device::now() < 10000)
+	{
+		Device::update();
+		loop();
+		Host::advanceTime(1000);
+	}
+
+	if (options.Calibrate > 0)
+	{
+		double host = calibrate();
+		options.Slowdown = (host > 0) ? options.Calibrate / host : options.Slowdown;
+		printf("calibration: host %.1f us/op, device %.1f us/op\n", host, options.Calibrate);
+	}
+
+	printf("slowdown %.1f, bandwidth %.0f KB/s, overhead %.1f ms, backlog %zu, %zu clients, %.0f sec\n\n",
+		options.Slowdown, options.Bandwidth, options.Overhead, options.Backlog, users.size(), options.Duration / 1000.0);
+
+	uint64_t begin = Device::now();
+	uint64_t end = begin + options.Duration;
+	double busy = 0;
+
+	while (Device::now() < end)
+	{
+		uint64_t now = Device::now();
+
+		// Send the due requests of all clients. If the backlog is full the connection is retried like a
+		// TCP client retransmitting the SYN (1, 2, 4 sec), the request fails after the last retry.
+		for (User& user : users)
+		{
+			Traffic::Event event;
+
+			while ((now - begin >= user.Start) && user.Script.next(now - begin - user.Start, event))
+			{
+				if ((event.Type == Traffic::ACTION_GET) || (event.Type == Traffic::ACTION_POST))
+				{
+					user.Waiting.push_back(Attempt{ event, now, now, 0 });
+				}
+			}
+
+			while (!user.Waiting.empty() && (user.Waiting.front().Retry <= now))
+			{
+				Attempt& attempt = user.Waiting.front();
+
+				if (Host::getPendingConnections() < options.Backlog)
+				{
+					requests.push_back(Request{ Host::connect(Device::PORT, Traffic::request(attempt.Event)), attempt.Event.Target, attempt.Sent });
+				}
+				else if (attempt.Retries < MAX_RETRIES)
+				{
+					attempt.Retry = now + (RETRY_TIMEOUT << attempt.Retries++);
+					break;
+				}
+				else
+				{
+					stats.refuse(attempt.Event.Target);
+				}
+
+				user.Waiting.pop_front();
+			}
+		}
+
+		// Run the sketch and advance the virtual time by the modeled device time.
+		size_t pending = Host::getPendingConnections();
+		auto start = std::chrono::steady_clock::now();
+
+		Device::update();
+		loop();
+
+		double msec = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() * options.Slowdown;
+
+		if (Host::getPendingConnections() < pending)
+		{
+			msec += options.Overhead;
+		}
+
+		for (const Request& request : requests)
+		{
+			if ((request.Connection->Closed || (request.Connection.use_count() == 1)) && (request.Connection->Position > 0))
+			{
+				msec += request.Connection->Response.size() / options.Bandwidth;
+			}
+		}
+
+		busy += (msec > 1.0) ? msec : 0.0;
+		Host::advanceTime((uint64_t)(((msec > 1.0) ? msec : 1.0) * 1000));
+
+		// Collect the completed requests.
+		for (auto it = requests.begin(); it != requests.end();)
+		{
+			if (it->Connection->Closed || (it->Connection.use_count() == 1))
+			{
+				int status = Traffic::getStatus(it->Connection->Response);
+				stats.add(it->Route, (uint32_t)(Device::now() - it->Sent), it->Connection->Response.size(), (status > 0) && (status < 400));
+				it = requests.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	double seconds = options.Duration / 1000.0;
+	stats.print(stdout, seconds);
+	printf("\nutilization %.1f%%, %zu requests pending\n", 100.0 * busy / options.Duration, requests.size());
+
+	// The sketch tasks are still running, skip the static destructors.
+	fflush(stdout);
+	_exit(0);
+}
@@ -0,0 +1,21 @@
+# --------------------------------------------------------------------------------------------------------------------
+# Generates the function prototypes of the sketch files (like the Arduino IDE), see Sketch.cpp.
+#
+#   cmake -DOUTPUT=Prototypes.h -DSOURCES="a.ino;b.ino" -P Prototypes.cmake
+# --------------------------------------------------------------------------------------------------------------------
+set(PROTOTYPES "// Generated by Prototypes.cmake, do not edit.\n#pragma once\n\n")
+
+foreach(SOURCE ${SOURCES})
+	file(STRINGS ${SOURCE} LINES REGEX "^[A-Za-z_][A-Za-z0-9_<>:]*[ *&]+[A-Za-z_][A-Za-z0-9_]*\\(.*\\)[ \t]*$")
+
+	foreach(LINE ${LINES})
+		string(STRIP "${LINE}" LINE)
+
+		if(NOT LINE MATCHES "^(return|else|delete|new) ")
+			string(APPEND PROTOTYPES "${LINE};\n")
+		endif()
+	endforeach()
+endforeach()
+
+file(WRITE ${OUTPUT}.tmp "${PROTOTYPES}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
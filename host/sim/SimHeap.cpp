@@ -0,0 +1,241 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SimHeap.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string.h>
+#include "SimHeap.h"
+
+/// <summary>
+///  Creates a heap in the specified memory (a single free block).
+/// </summary>
+/// <param name="arena">The memory used by the heap</param>
+/// <param name="size">The memory size (bytes)</param>
+SimHeap::SimHeap(void* arena, size_t size) :
+	_free(NULL),
+	_freeBytes(0),
+	_minFree(0),
+	_blocks(0),
+	_allocs(0),
+	_failures(0),
+	OnFailure(NULL)
+{
+	uintptr_t start = ((uintptr_t)arena + ALIGNMENT - 1) & ~(uintptr_t)(ALIGNMENT - 1);
+	size_t skipped = (size_t)(start - (uintptr_t)arena);
+
+	_arena = (uint8_t*)start;
+	_size = (size > skipped) ? (size - skipped) & ~(ALIGNMENT - 1) : 0;
+
+	if (_size >= MIN_BLOCK)
+	{
+		_free = (Block*)_arena;
+		_free->Size = _size;
+		_free->Next = NULL;
+		_freeBytes = _size;
+	}
+
+	_minFree = _freeBytes;
+}
+
+/// <summary>
+///  Allocates a block (first fit), the remainder of the free block is kept in the free list.
+/// </summary>
+/// <param name="size">The requested size (bytes)</param>
+/// <returns>The allocated memory (NULL if out of memory)</returns>
+void* SimHeap::allocate(size_t size)
+{
+	size_t needed = (size + HEADER + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+	if (needed < MIN_BLOCK)
+	{
+		needed = MIN_BLOCK;
+	}
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(_mutex);
+		Block** link = &_free;
+
+		while (*link != NULL)
+		{
+			Block* block = *link;
+
+			if (block->Size >= needed)
+			{
+				if (block->Size - needed >= MIN_BLOCK)
+				{
+					Block* rest = (Block*)((uint8_t*)block + needed);
+					rest->Size = block->Size - needed;
+					rest->Next = block->Next;
+					*link = rest;
+					block->Size = needed;
+				}
+				else
+				{
+					*link = block->Next;
+				}
+
+				_freeBytes -= block->Size;
+				_blocks++;
+				_allocs++;
+
+				if (_freeBytes < _minFree)
+				{
+					_minFree = _freeBytes;
+				}
+
+				return (uint8_t*)block + HEADER;
+			}
+
+			link = &block->Next;
+		}
+
+		_failures++;
+	}
+
+	if (OnFailure != NULL)
+	{
+		OnFailure(size);
+	}
+
+	return NULL;
+}
+
+/// <summary>
+///  Frees a block (NULL is ignored).
+/// </summary>
+/// <param name="p">The allocated memory</param>
+void SimHeap::release(void* p)
+{
+	if (p == NULL)
+	{
+		return;
+	}
+
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+	Block* block = (Block*)((uint8_t*)p - HEADER);
+
+	_freeBytes += block->Size;
+	_blocks--;
+	insert(block);
+}
+
+/// <summary>
+///  Resizes a block. The block is kept if large enough, otherwise the data is moved to a new block.
+/// </summary>
+/// <param name="p">The allocated memory (NULL allocates a new block)</param>
+/// <param name="size">The requested size (bytes)</param>
+/// <returns>The resized memory (NULL if out of memory, the old block is kept)</returns>
+void* SimHeap::reallocate(void* p, size_t size)
+{
+	if (p == NULL)
+	{
+		return allocate(size);
+	}
+
+	size_t available = usable(p);
+
+	if (size <= available)
+	{
+		return p;
+	}
+
+	void* q = allocate(size);
+
+	if (q != NULL)
+	{
+		memcpy(q, p, available);
+		release(p);
+	}
+
+	return q;
+}
+
+/// <summary>
+///  Returns the usable size of an allocated block.
+/// </summary>
+/// <param name="p">The allocated memory</param>
+/// <returns>The usable size (bytes)</returns>
+size_t SimHeap::usable(const void* p) const
+{
+	return (p == NULL) ? 0 : ((const Block*)((const uint8_t*)p - HEADER))->Size - HEADER;
+}
+
+/// <summary>
+///  Returns true if the memory has been allocated from the arena.
+/// </summary>
+/// <param name="p">The memory</param>
+/// <returns>True if in the arena</returns>
+bool SimHeap::contains(const void* p) const
+{
+	return ((const uint8_t*)p >= _arena) && ((const uint8_t*)p < _arena + _size);
+}
+
+/// <summary>
+///  Returns the heap statistics (walking the free list).
+/// </summary>
+/// <returns>The heap statistics</returns>
+SimHeap::Stats SimHeap::getStats()
+{
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+	Stats stats;
+	size_t largest = 0;
+
+	stats.FreeBlocks = 0;
+
+	for (Block* block = _free; block != NULL; block = block->Next)
+	{
+		largest = (block->Size > largest) ? block->Size : largest;
+		stats.FreeBlocks++;
+	}
+
+	stats.Size = (uint32_t)_size;
+	stats.Free = (uint32_t)_freeBytes;
+	stats.MinFree = (uint32_t)_minFree;
+	stats.MaxAlloc = (uint32_t)((largest > HEADER) ? largest - HEADER : 0);
+	stats.Blocks = _blocks;
+	stats.Allocs = _allocs;
+	stats.Failures = _failures;
+	stats.Fragmentation = (_freeBytes > 0) ? 100 - (uint8_t)((uint64_t)largest * 100 / _freeBytes) : 0;
+	return stats;
+}
+
+/// <summary>
+///  Inserts a free block in the address ordered free list and merges it with its neighbours.
+/// </summary>
+/// <param name="block">The free block</param>
+void SimHeap::insert(Block* block)
+{
+	Block* previous = NULL;
+	Block* next = _free;
+
+	while ((next != NULL) && (next < block))
+	{
+		previous = next;
+		next = next->Next;
+	}
+
+	block->Next = next;
+
+	if ((next != NULL) && ((uint8_t*)block + block->Size == (uint8_t*)next))
+	{
+		block->Size += next->Size;
+		block->Next = next->Next;
+	}
+
+	if (previous == NULL)
+	{
+		_free = block;
+	}
+	else if ((uint8_t*)previous + previous->Size == (uint8_t*)block)
+	{
+		previous->Size += block->Size;
+		previous->Next = block->Next;
+	}
+	else
+	{
+		previous->Next = block;
+	}
+}
@@ -0,0 +1,72 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SimHeap.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+
+/// <summary>
+/// This class implements a simple heap in a fixed arena (simulator only), so that the free heap, the largest
+/// free block and the fragmentation can be tracked over (virtual) time like on the ESP32.
+/// The blocks are allocated first fit from an address ordered free list, freed blocks are coalesced.
+/// Note that the numbers are an approximation: the host uses 64-bit pointers and a different STL.
+/// </summary>
+class SimHeap
+{
+public:
+	struct Stats
+	{
+		uint32_t Size;											// The arena size (bytes)
+		uint32_t Free;											// The free heap (bytes)
+		uint32_t MinFree;										// The minimum free heap ever (bytes)
+		uint32_t MaxAlloc;										// The largest allocatable block (bytes)
+		uint32_t Blocks;										// The number of allocated blocks
+		uint32_t FreeBlocks;									// The number of free blocks
+		uint32_t Allocs;										// The number of allocations
+		uint32_t Failures;										// The number of failed allocations
+		uint8_t Fragmentation;									// The fragmentation (%, 100 - largest / free block sizes)
+	};
+
+	static const size_t ALIGNMENT = 16;							// The block alignment (malloc compatible)
+
+private:
+	struct Block
+	{
+		size_t Size;											// The block size incl. header (bytes)
+		Block* Next;											// The next free block (free blocks only)
+	};
+
+	static const size_t HEADER = ALIGNMENT;						// The size of the block header
+	static const size_t MIN_BLOCK = 2 * ALIGNMENT;				// The minimum block size
+
+	uint8_t* _arena;											// The arena (aligned)
+	size_t _size;												// The arena size
+	Block* _free;												// The free list (address ordered)
+	size_t _freeBytes;											// The free bytes
+	size_t _minFree;											// The minimum free bytes
+	uint32_t _blocks;											// The number of allocated blocks
+	uint32_t _allocs;											// The number of allocations
+	uint32_t _failures;											// The number of failed allocations
+	std::recursive_mutex _mutex;								// Protects the heap (all tasks)
+
+	void insert(Block* block);									// Inserts a free block (coalescing)
+
+public:
+	void (*OnFailure)(size_t size);								// Called if an allocation fails
+
+	SimHeap(void* arena, size_t size);							// Creates a heap in the specified memory
+
+	void* allocate(size_t size);								// Allocates a block (NULL if out of memory)
+	void release(void* p);										// Frees a block
+	void* reallocate(void* p, size_t size);						// Resizes a block (may move the data)
+	size_t usable(const void* p) const;							// Returns the usable size of a block
+	bool contains(const void* p) const;							// Returns true if the block is in the arena
+	Stats getStats();											// Returns the heap statistics
+};
@@ -0,0 +1,279 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Simulator.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <list>
+#include <memory>
+#include <string>
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <DallasTemperature.h>
+
+#include "Device.h"
+#include "HeapWrap.h"
+#include "Traffic.h"
+
+/// <summary>
+/// The whole firmware simulator. The sketch runs setup() and loop() in virtual time (manual clock),
+/// the traffic script sends HTTP requests (loopback connections), serial commands and WiFi events.
+/// The heap statistics of the simulated heap are reported in regular (virtual) intervals.
+///
+///   soilmonitor_sim [--days 14] [--step 10ms] [--script file] [--report 1h] [--csv file] [--serial]
+/// </summary>
+namespace
+{
+	const uint64_t DAY = Device::DAY;
+
+	struct Options
+	{
+		uint64_t Duration = 14 * DAY;							// The simulated time (msec)
+		uint64_t Step = 10;										// The time step between loop() calls (msec)
+		uint64_t Report = 3600000;								// The report interval (msec)
+		std::string Script = SIM_DIR "/default.traffic";		// The traffic script
+		std::string Csv;										// The CSV report file (optional)
+		bool Serial = false;									// Print the serial output
+	};
+
+	struct Counters
+	{
+		uint32_t Requests = 0;									// The number of HTTP requests sent
+		uint32_t Errors = 0;									// The number of responses with status >= 400 (or none)
+		uint32_t Commands = 0;									// The number of serial commands sent
+		uint32_t Loops = 0;										// The number of loop() calls
+	};
+
+	Counters counters;
+	std::list<std::shared_ptr<Host::Connection>> connections;	// The open HTTP connections
+	FILE* csv = NULL;
+
+	/// <summary>
+	///  Prints the usage and exits.
+	/// </summary>
+	void usage(const char* name)
+	{
+		fprintf(stderr, "usage: %s [--days n] [--step duration] [--script file] [--report duration] [--csv file] [--serial]\n"
+			"  the simulated heap size is set by SIM_HEAP_KB (default 192)\n", name);
+		exit(2);
+	}
+
+	/// <summary>
+	///  Parses the command line options.
+	/// </summary>
+	Options parse(int argc, char* argv[])
+	{
+		Options options;
+
+		for (int i = 1; i < argc; i++)
+		{
+			std::string option = argv[i];
+			const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+			if (option == "--serial")
+			{
+				options.Serial = true;
+				continue;
+			}
+
+			if (value == NULL)
+			{
+				usage(argv[0]);
+			}
+
+			i++;
+
+			if (option == "--days") options.Duration = (uint64_t)(atof(value) * DAY);
+			else if (option == "--script") options.Script = value;
+			else if (option == "--csv") options.Csv = value;
+			else if ((option == "--step") && Traffic::parseDuration(value, options.Step) && (options.Step > 0)) {}
+			else if ((option == "--report") && Traffic::parseDuration(value, options.Report) && (options.Report > 0)) {}
+			else usage(argv[0]);
+		}
+
+		return options;
+	}
+
+	/// <summary>
+	///  Executes a traffic event.
+	/// </summary>
+	void execute(const Traffic::Event& event)
+	{
+		switch (event.Type)
+		{
+		case Traffic::ACTION_GET:
+		case Traffic::ACTION_POST:
+			connections.push_back(Host::connect(Device::PORT, Traffic::request(event)));
+			counters.Requests++;
+			break;
+
+		case Traffic::ACTION_COMMAND:
+			Serial.inject((event.Target + "\n").c_str());
+			counters.Commands++;
+			break;
+
+		case Traffic::ACTION_WIFI_DROP:
+			Host::dropWiFi();
+			break;
+
+		case Traffic::ACTION_WIFI_DOWN:
+			Host::setWiFiAvailable(false);
+			Host::dropWiFi(WIFI_REASON_BEACON_TIMEOUT);
+			break;
+
+		case Traffic::ACTION_WIFI_UP:
+			Host::setWiFiAvailable(true);
+			break;
+
+		case Traffic::ACTION_ADC:
+			Host::setAnalog((uint8_t)atoi(event.Target.c_str()), (uint16_t)atoi(event.Data.c_str()));
+			break;
+
+		case Traffic::ACTION_TEMP:
+			DallasTemperature::setTemperature((uint8_t)atoi(event.Target.c_str()), (float)atof(event.Data.c_str()));
+			break;
+		}
+	}
+
+	/// <summary>
+	///  Removes the completed connections (closed by the server or released by the sketch).
+	/// </summary>
+	void collect()
+	{
+		for (auto it = connections.begin(); it != connections.end();)
+		{
+			if ((*it)->Closed || (it->use_count() == 1))
+			{
+				if (Traffic::getStatus((*it)->Response) == 0 || Traffic::getStatus((*it)->Response) >= 400)
+				{
+					counters.Errors++;
+				}
+
+				it = connections.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	/// <summary>
+	///  Prints a report line (and a CSV row).
+	/// </summary>
+	void report(uint64_t time)
+	{
+		SimHeap::Stats stats = getSimHeap()->getStats();
+
+		printf("%4u d %02u:%02u  free %6u  min %6u  max alloc %6u  frag %3u%%  blocks %5u  requests %7u  errors %5u\n",
+			(unsigned int)(time / DAY), (unsigned int)(time % DAY / 3600000), (unsigned int)(time % 3600000 / 60000),
+			stats.Free, stats.MinFree, stats.MaxAlloc, stats.Fragmentation, stats.Blocks,
+			counters.Requests, counters.Errors);
+		fflush(stdout);
+
+		if (csv != NULL)
+		{
+			fprintf(csv, "%llu,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", (unsigned long long)(time / 1000),
+				stats.Free, stats.MinFree, stats.MaxAlloc, stats.Fragmentation, stats.Blocks, stats.Failures,
+				counters.Requests, counters.Errors, counters.Loops);
+			fflush(csv);
+		}
+	}
+
+	/// <summary>
+	///  Reports a failed allocation and exits (the ESP32 would abort and restart).
+	/// </summary>
+	void onFailure(size_t size)
+	{
+		fprintf(stderr, "out of memory: %u bytes requested at %llu sec\n", (unsigned int)size,
+			(unsigned long long)(Device::now() / 1000));
+		report(Device::now());
+		fflush(stdout);
+		_exit(3);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options = parse(argc, argv);
+	Traffic traffic;
+	std::string error;
+
+	if (!traffic.load(options.Script.c_str(), error))
+	{
+		fprintf(stderr, "%s\n", error.c_str());
+		return 1;
+	}
+
+	if (!options.Csv.empty())
+	{
+		csv = fopen(options.Csv.c_str(), "w");
+
+		if (csv == NULL)
+		{
+			fprintf(stderr, "cannot create %s\n", options.Csv.c_str());
+			return 1;
+		}
+
+		fprintf(csv, "time,free,min_free,max_alloc,fragmentation,blocks,failures,requests,errors,loops\n");
+	}
+
+	getSimHeap()->OnFailure = &onFailure;
+	Serial.setEcho(options.Serial);
+	Device::begin();
+	setup();
+
+	uint64_t reported = 0;
+	report(0);
+
+	while (Device::now() < options.Duration)
+	{
+		Traffic::Event event;
+		uint64_t time = Device::now();
+
+		while (traffic.next(time, event))
+		{
+			execute(event);
+		}
+
+		Device::update();
+		loop();
+		counters.Loops++;
+		collect();
+
+		if (Host::isRestartRequested())
+		{
+			printf("restart requested at %llu sec\n", (unsigned long long)(Device::now() / 1000));
+			break;
+		}
+
+		if (Device::now() - reported >= options.Report)
+		{
+			reported = Device::now() / options.Report * options.Report;
+			report(Device::now());
+		}
+
+		// Serve pending requests without delay, otherwise advance the virtual time.
+		Host::advanceTime((connections.empty() && (Host::getPendingConnections() == 0)) ? options.Step * 1000 : 1000);
+	}
+
+	report(Device::now());
+	SimHeap::Stats stats = getSimHeap()->getStats();
+	printf("simulated %.1f days, %u loops, %u requests (%u errors), %u commands, min free heap %u bytes\n",
+		(double)Device::now() / DAY, counters.Loops, counters.Requests, counters.Errors, counters.Commands, stats.MinFree);
+
+	if (csv != NULL)
+	{
+		fclose(csv);
+	}
+
+	// The sketch tasks are still running, skip the static destructors.
+	fflush(stdout);
+	_exit(0);
+}
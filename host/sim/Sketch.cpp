@@ -0,0 +1,23 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Sketch.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+// The sketch files compiled as one translation unit (like the Arduino IDE merging the '.ino' files).
+// The library headers are included first, Prototypes.h is generated from the '.ino' files (see Prototypes.cmake).
+#include <Arduino.h>
+#include <aWOT.h>
+#include <Commander.h>
+
+#include "Prototypes.h"
+
+#include "../../SoilMonitor3.ino"
+#include "../../Coap.ino"
+#include "../../Commands.ino"
+#include "../../Influx.ino"
+#include "../../Logging.ino"
+#include "../../Mqtt.ino"
+#include "../../WebServer.ino"
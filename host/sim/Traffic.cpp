@@ -0,0 +1,267 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Traffic.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+
+#include "Traffic.h"
+
+/// <summary>
+///  Loads a script file (one event per line).
+/// </summary>
+/// <param name="path">The file path</param>
+/// <param name="error">The error message (line number and reason)</param>
+/// <returns>True if successful</returns>
+bool Traffic::load(const char* path, std::string& error)
+{
+	std::ifstream file(path);
+	std::string line;
+	int number = 0;
+
+	if (!file)
+	{
+		error = std::string("cannot open ") + path;
+		return false;
+	}
+
+	while (std::getline(file, line))
+	{
+		number++;
+
+		if (!add(line, error))
+		{
+			error = std::string(path) + ":" + std::to_string(number) + ": " + error;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// <summary>
+///  Adds a script line (empty lines and comments are ignored).
+/// </summary>
+/// <param name="line">The script line</param>
+/// <param name="error">The error message</param>
+/// <returns>True if successful</returns>
+bool Traffic::add(const std::string& line, std::string& error)
+{
+	std::istringstream input(line);
+	std::string when;
+	std::string duration;
+	std::string action;
+	Event event;
+
+	if (!(input >> when) || (when[0] == '#'))
+	{
+		return true;
+	}
+
+	if ((when != "at") && (when != "every"))
+	{
+		error = "expected 'at' or 'every'";
+		return false;
+	}
+
+	if (!(input >> duration) || !parseDuration(duration, event.Next))
+	{
+		error = "invalid duration '" + duration + "'";
+		return false;
+	}
+
+	if (when == "every")
+	{
+		if (event.Next == 0)
+		{
+			error = "the period must not be zero";
+			return false;
+		}
+
+		event.Period = event.Next;
+	}
+	else
+	{
+		event.Period = 0;
+	}
+
+	if (!(input >> action))
+	{
+		error = "missing action";
+		return false;
+	}
+
+	std::string rest;
+	std::getline(input >> std::ws, rest);
+
+	if ((action == "GET") || (action == "POST"))
+	{
+		size_t space = rest.find(' ');
+		event.Type = (action == "GET") ? ACTION_GET : ACTION_POST;
+		event.Target = rest.substr(0, space);
+		event.Data = (space != std::string::npos) ? rest.substr(space + 1) : "";
+
+		if (event.Target.empty() || (event.Target[0] != '/'))
+		{
+			error = "invalid path '" + event.Target + "'";
+			return false;
+		}
+	}
+	else if (action == "cmd")
+	{
+		event.Type = ACTION_COMMAND;
+		event.Target = rest;
+	}
+	else if ((action == "wifi-drop") || (action == "wifi-down") || (action == "wifi-up"))
+	{
+		event.Type = (action == "wifi-drop") ? ACTION_WIFI_DROP : (action == "wifi-down") ? ACTION_WIFI_DOWN : ACTION_WIFI_UP;
+	}
+	else if ((action == "adc") || (action == "temp"))
+	{
+		std::istringstream values(rest);
+		event.Type = (action == "adc") ? ACTION_ADC : ACTION_TEMP;
+
+		if (!(values >> event.Target >> event.Data))
+		{
+			error = "expected " + action + " <" + ((action == "adc") ? "pin" : "index") + "> <value>";
+			return false;
+		}
+	}
+	else
+	{
+		error = "unknown action '" + action + "'";
+		return false;
+	}
+
+	_events.push_back(event);
+	return true;
+}
+
+/// <summary>
+///  Returns the next due event (earliest first). Periodic events are rescheduled, events due
+///  more than once (large time steps) are returned once.
+/// </summary>
+/// <param name="now">The virtual time (msec)</param>
+/// <param name="event">The due event</param>
+/// <returns>True if an event is due</returns>
+bool Traffic::next(uint64_t now, Event& event)
+{
+	size_t due = _events.size();
+
+	for (size_t i = 0; i < _events.size(); i++)
+	{
+		if ((_events[i].Next <= now) && ((due == _events.size()) || (_events[i].Next < _events[due].Next)))
+		{
+			due = i;
+		}
+	}
+
+	if (due == _events.size())
+	{
+		return false;
+	}
+
+	event = _events[due];
+
+	if (event.Period > 0)
+	{
+		uint64_t missed = (now - event.Next) / event.Period;
+		_events[due].Next += (missed + 1) * event.Period;
+	}
+	else
+	{
+		_events.erase(_events.begin() + due);
+	}
+
+	return true;
+}
+
+/// <summary>
+///  Parses a duration (number and unit, may be repeated e.g. 1h30m). A number without unit is msec.
+/// </summary>
+/// <param name="text">The duration text</param>
+/// <param name="msec">The duration (msec)</param>
+/// <returns>True if valid</returns>
+bool Traffic::parseDuration(const std::string& text, uint64_t& msec)
+{
+	const char* p = text.c_str();
+	msec = 0;
+
+	if (*p == '\0')
+	{
+		return false;
+	}
+
+	while (*p != '\0')
+	{
+		char* end;
+		double value = strtod(p, &end);
+		uint64_t unit = 1;
+
+		if ((end == p) || (value < 0))
+		{
+			return false;
+		}
+
+		p = end;
+
+		if ((p[0] == 'm') && (p[1] == 's')) { unit = 1; p += 2; }
+		else if (*p == 's') { unit = 1000; p++; }
+		else if (*p == 'm') { unit = 60000; p++; }
+		else if (*p == 'h') { unit = 3600000; p++; }
+		else if (*p == 'd') { unit = 86400000; p++; }
+		else if (*p != '\0') { return false; }
+
+		msec += (uint64_t)(value * unit);
+	}
+
+	return true;
+}
+
+/// <summary>
+///  Returns the HTTP request of a GET or POST event (JSON body, the connection is closed).
+/// </summary>
+/// <param name="event">The event</param>
+/// <returns>The request text</returns>
+std::string Traffic::request(const Event& event)
+{
+	std::string text = ((event.Type == ACTION_POST) ? "POST " : "GET ") + event.Target + " HTTP/1.1\r\n";
+	text += "Host: soilmonitor\r\n";
+	text += "Connection: close\r\n";
+
+	if (event.Type == ACTION_POST)
+	{
+		text += "Content-Type: application/json\r\n";
+		text += "Content-Length: " + std::to_string(event.Data.size()) + "\r\n";
+	}
+
+	text += "\r\n";
+
+	if (event.Type == ACTION_POST)
+	{
+		text += event.Data;
+	}
+
+	return text;
+}
+
+/// <summary>
+///  Returns the HTTP status code of a response (0 if there is no valid status line).
+/// </summary>
+/// <param name="response">The response text</param>
+/// <returns>The status code</returns>
+int Traffic::getStatus(const std::string& response)
+{
+	if (response.compare(0, 5, "HTTP/") != 0)
+	{
+		return 0;
+	}
+
+	size_t space = response.find(' ');
+	return (space != std::string::npos) ? atoi(response.c_str() + space + 1) : 0;
+}
@@ -0,0 +1,68 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Traffic.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// This class implements the scripted traffic of the simulator. Each script line schedules an action
+/// once (at) or periodically (every), the time is the virtual time since the start (msec).
+///
+///   # comment
+///   every 10s GET /data
+///   every 1h POST /settings/soil/0 {"Name":"Soil 1"}
+///   every 30m cmd system
+///   at 2d wifi-drop
+///   at 3d wifi-down
+///   at 3d2h wifi-up
+///   at 1h adc 36 2500
+///   at 1h temp 0 18.5
+///
+/// The durations are numbers with the units ms, s, m, h, d (e.g. 1h30m).
+/// </summary>
+class Traffic
+{
+public:
+	enum Action
+	{
+		ACTION_GET,												// HTTP GET request
+		ACTION_POST,											// HTTP POST request
+		ACTION_COMMAND,											// Serial command line
+		ACTION_WIFI_DROP,										// Drops the WiFi connection
+		ACTION_WIFI_DOWN,										// The access point becomes unreachable
+		ACTION_WIFI_UP,											// The access point becomes reachable
+		ACTION_ADC,												// Sets an analog input (pin, value)
+		ACTION_TEMP												// Sets a temperature sensor (index, value)
+	};
+
+	struct Event
+	{
+		uint64_t Next;											// The next time the event is due (msec)
+		uint64_t Period;										// The period (msec, 0: once)
+		Action Type;											// The action
+		std::string Target;										// The path, command line, pin or index
+		std::string Data;										// The POST body or the value
+	};
+
+private:
+	std::vector<Event> _events;									// The scheduled events
+
+public:
+	bool load(const char* path, std::string& error);			// Loads a script file
+	bool add(const std::string& line, std::string& error);		// Adds a script line
+	bool next(uint64_t now, Event& event);						// Returns the next due event
+	size_t size() const { return _events.size(); }				// Returns the number of events
+
+	static bool parseDuration(const std::string& text,			// Parses a duration (e.g. 1h30m)
+		uint64_t& msec);
+	static std::string request(const Event& event);				// Returns the HTTP request of an event
+	static int getStatus(const std::string& response);			// Returns the HTTP status of a response
+};
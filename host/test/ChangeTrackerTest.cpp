@@ -0,0 +1,97 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="ChangeTrackerTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "ChangeTracker.h"
+
+TEST(ChangeTracker, PublishesFirstValue)
+{
+	ChangeTracker tracker(10.0f);
+	uint32_t since = ChangeTracker::getSequence();
+
+	EXPECT_FALSE(tracker.isChanged(since));
+	EXPECT_TRUE(tracker.update(0, 2000.0f, 0));
+	EXPECT_EQ(tracker.getVersion(0), since + 1);
+	EXPECT_EQ(ChangeTracker::getSequence(), since + 1);
+	EXPECT_TRUE(tracker.isChanged(0, since));
+	EXPECT_FALSE(tracker.isChanged(0, since + 1));
+	EXPECT_FALSE(tracker.isChanged(1, since));
+}
+
+TEST(ChangeTracker, SuppressesValuesInsideDeadband)
+{
+	ChangeTracker tracker(10.0f);
+
+	tracker.update(0, 2000.0f, 0);
+	uint32_t version = tracker.getVersion(0);
+
+	EXPECT_FALSE(tracker.update(0, 2009.0f, 1000));
+	EXPECT_FALSE(tracker.update(0, 1991.0f, 2000));
+	EXPECT_EQ(tracker.getVersion(0), version);
+	EXPECT_FLOAT_EQ(tracker.getValue(0), 2000.0f);
+	EXPECT_EQ(tracker.getSuppressed(), 2u);
+
+	EXPECT_TRUE(tracker.update(0, 2010.0f, 3000));
+	EXPECT_GT(tracker.getVersion(0), version);
+	EXPECT_FLOAT_EQ(tracker.getValue(0), 2010.0f);
+	EXPECT_EQ(tracker.getPublished(), 2u);
+}
+
+TEST(ChangeTracker, PublishesHeartbeat)
+{
+	ChangeTracker tracker(10.0f);
+
+	tracker.setMaxSilence(0, 60);
+	tracker.update(0, 22.5f, 0);
+
+	EXPECT_FALSE(tracker.update(0, 22.5f, 59000));
+	EXPECT_TRUE(tracker.update(0, 22.5f, 60000));
+	EXPECT_FALSE(tracker.update(0, 22.5f, 61000));
+
+	tracker.setMaxSilence(0, 0);
+	EXPECT_FALSE(tracker.update(0, 22.5f, 1000000));
+}
+
+TEST(ChangeTracker, OrdersVersionsAcrossTrackers)
+{
+	ChangeTracker soil(10.0f);
+	ChangeTracker temp(0.1f);
+
+	soil.update(0, 2000.0f, 0);
+	uint32_t since = ChangeTracker::getSequence();
+	temp.update(2, 22.5f, 0);
+
+	EXPECT_FALSE(soil.isChanged(since));
+	EXPECT_TRUE(temp.isChanged(2, since));
+	EXPECT_GT(temp.getVersion(2), soil.getVersion(0));
+}
+
+TEST(ChangeTracker, TreatsUnknownVersionAsZero)
+{
+	ChangeTracker tracker;
+
+	tracker.update(0, 1.0f, 0);
+
+	// A version seen before a reboot is newer than the current sequence.
+	EXPECT_TRUE(tracker.isChanged(0, ChangeTracker::getSequence() + 1000));
+	EXPECT_FALSE(tracker.isChanged(0, ChangeTracker::getSequence()));
+}
+
+TEST(ChangeTracker, PublishesAllChannelsAfterReset)
+{
+	ChangeTracker tracker(10.0f);
+
+	tracker.update(0, 2000.0f, 0);
+	EXPECT_FALSE(tracker.update(0, 2000.0f, 1000));
+
+	tracker.reset();
+	EXPECT_EQ(tracker.getVersion(0), 0u);
+	EXPECT_TRUE(tracker.update(0, 2000.0f, 2000));
+	EXPECT_FALSE(tracker.update(ChangeTracker::MAX_CHANNELS, 2000.0f, 2000));
+}
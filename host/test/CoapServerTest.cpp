@@ -0,0 +1,379 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="CoapServerTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <Udp.h>
+#include "CoapServer.h"
+
+/// <summary>
+/// This class emulates the UDP socket: the received datagrams are queued, the sent datagrams are collected.
+/// </summary>
+class FakeCoapUdp : public UDP
+{
+public:
+	struct Packet
+	{
+		uint32_t Address;										// The remote address
+		uint16_t Port;											// The remote port
+		std::string Data;										// The datagram
+	};
+
+	int Begins = 0;												// The number of begin calls
+	std::deque<Packet> Input;									// The datagrams to be received
+	std::vector<Packet> Output;									// The sent datagrams
+	Packet Current;												// The actual datagram
+
+	uint8_t begin(uint16_t port) override { Begins++; return 1; }
+	int beginPacket(IPAddress ip, uint16_t port) override { Current = Packet{ ip, port, "" }; return 1; }
+	int beginPacket(const char* host, uint16_t port) override { return 0; }
+	int endPacket() override { Output.push_back(Current); return 1; }
+	size_t write(uint8_t c) override { Current.Data += (char)c; return 1; }
+	size_t write(const uint8_t* buffer, size_t size) override { Current.Data.append((const char*)buffer, size); return size; }
+
+	int parsePacket() override
+	{
+		if (Input.empty()) return 0;
+		Current = Input.front();
+		Input.pop_front();
+		return (int)Current.Data.size();
+	}
+
+	int read(unsigned char* buffer, size_t size) override
+	{
+		size_t n = std::min(size, Current.Data.size());
+		memcpy(buffer, Current.Data.data(), n);
+		return (int)n;
+	}
+
+	IPAddress remoteIP() override { return IPAddress(Current.Address); }
+	uint16_t remotePort() override { return Current.Port; }
+	using Print::write;
+};
+
+/// <summary>
+/// The parsed CoAP message (options by number).
+/// </summary>
+struct Message
+{
+	uint8_t Type = 0;
+	uint8_t Code = 0;
+	uint16_t MessageId = 0;
+	std::string Token;
+	std::map<uint16_t, std::string> Options;
+	std::string Payload;
+
+	bool has(uint16_t number) const { return Options.count(number) > 0; }
+
+	uint32_t value(uint16_t number) const
+	{
+		uint32_t result = 0;
+		for (char c : Options.at(number)) result = (result << 8) | (uint8_t)c;
+		return result;
+	}
+};
+
+/// <summary>
+/// Parses a message (small deltas and lengths only, as written by the server).
+/// </summary>
+static Message parse(const std::string& data)
+{
+	Message message;
+	message.Type = (data[0] >> 4) & 0x03;
+	message.Code = data[1];
+	message.MessageId = ((uint8_t)data[2] << 8) | (uint8_t)data[3];
+	message.Token = data.substr(4, data[0] & 0x0F);
+	size_t position = 4 + message.Token.size();
+	uint16_t number = 0;
+
+	while ((position < data.size()) && ((uint8_t)data[position] != 0xFF))
+	{
+		number += (uint8_t)data[position] >> 4;
+		size_t length = data[position] & 0x0F;
+		message.Options[number] = data.substr(position + 1, length);
+		position += 1 + length;
+	}
+
+	if (position < data.size()) message.Payload = data.substr(position + 1);
+	return message;
+}
+
+/// <summary>
+/// Builds a request (options in ascending order, small deltas only).
+/// </summary>
+static std::string request(uint8_t type, uint8_t code, uint16_t messageId, const std::string& token,
+	const std::string& path, int observe = -1, int accept = -1)
+{
+	std::string data;
+	uint16_t number = 0;
+
+	data += (char)(0x40 | (type << 4) | token.size());
+	data += (char)code;
+	data += (char)(messageId >> 8);
+	data += (char)messageId;
+	data += token;
+
+	if (observe >= 0)
+	{
+		data += (char)(((6 - number) << 4) | ((observe > 0) ? 1 : 0));
+		if (observe > 0) data += (char)observe;
+		number = 6;
+	}
+
+	size_t start = 0;
+
+	while (start < path.size())
+	{
+		size_t end = path.find('/', start);
+		if (end == std::string::npos) end = path.size();
+		data += (char)(((11 - number) << 4) | (end - start));
+		data += path.substr(start, end - start);
+		number = 11;
+		start = end + 1;
+	}
+
+	if (accept >= 0)
+	{
+		data += (char)(((17 - number) << 4) | 1);
+		data += (char)accept;
+	}
+
+	return data;
+}
+
+static bool online = true;
+static uint32_t versions[3] = {};
+static bool isOnline() { return online; }
+
+static int findResource(const char* path)
+{
+	if (strcmp(path, "data") == 0) return 0;
+	if (strcmp(path, "soil/1") == 0) return 1;
+	if (strcmp(path, "large") == 0) return 2;
+	return -1;
+}
+
+static uint32_t getVersion(uint8_t resource) { return versions[resource]; }
+
+static void writeResource(uint8_t resource, WireFormat& writer)
+{
+	if (resource == 2)
+	{
+		std::string text(CoapServer::PAYLOAD_SIZE, 'x');
+		writer.writeString(text.c_str());
+		return;
+	}
+
+	writer.writeMap(1);
+	writer.writeString("Version");
+	writer.writeUInt(versions[resource]);
+}
+
+static const uint32_t CLIENT = 0x0A00000A;
+
+class CoapServerTest : public ::testing::Test
+{
+protected:
+	FakeCoapUdp udp;
+	CoapServer server = CoapServer(&udp, &isOnline,
+		CoapServer::Resources{ &findResource, &getVersion, &writeResource, "</data>;obs;ct=60" });
+
+	void SetUp() override
+	{
+		Host::setTime(1000000);
+		online = true;
+		versions[0] = versions[1] = versions[2] = 0;
+	}
+
+	void TearDown() override
+	{
+		Host::useSystemTime();
+	}
+
+	Message exchange(const std::string& data, uint16_t port = 40000)
+	{
+		udp.Input.push_back(FakeCoapUdp::Packet{ CLIENT, port, data });
+		udp.Output.clear();
+		server.update();
+		EXPECT_EQ(udp.Output.size(), 1u);
+		return udp.Output.empty() ? Message() : parse(udp.Output.back().Data);
+	}
+
+	std::vector<Message> update()
+	{
+		std::vector<Message> messages;
+		udp.Output.clear();
+		server.update();
+		for (const FakeCoapUdp::Packet& packet : udp.Output) messages.push_back(parse(packet.Data));
+		return messages;
+	}
+};
+
+TEST_F(CoapServerTest, RespondsWithCbor)
+{
+	versions[0] = 5;
+
+	Message response = exchange(request(0, 0x01, 0x1234, "tk", "data"));
+	EXPECT_EQ(udp.Begins, 1);
+	EXPECT_EQ(udp.Output[0].Address, CLIENT);
+	EXPECT_EQ(udp.Output[0].Port, 40000);
+	EXPECT_EQ(response.Type, 2);
+	EXPECT_EQ(response.Code, 0x45);
+	EXPECT_EQ(response.MessageId, 0x1234);
+	EXPECT_EQ(response.Token, "tk");
+	EXPECT_FALSE(response.has(6));
+	EXPECT_EQ(response.value(12), 60u);
+	EXPECT_EQ(response.Payload, std::string("\xA1\x67Version\x05"));
+
+	// Non-confirmable request (non-confirmable response with a new message id).
+	response = exchange(request(1, 0x01, 0x2000, "", "soil/1", -1, 60));
+	EXPECT_EQ(response.Type, 1);
+	EXPECT_EQ(response.Code, 0x45);
+	EXPECT_NE(response.MessageId, 0x2000);
+
+	response = exchange(request(0, 0x01, 1, "a", ".well-known/core"));
+	EXPECT_EQ(response.value(12), 40u);
+	EXPECT_EQ(response.Payload, "</data>;obs;ct=60");
+	EXPECT_EQ(server.getRequests(), 3u);
+}
+
+TEST_F(CoapServerTest, RejectsInvalidRequests)
+{
+	EXPECT_EQ(exchange(request(0, 0x01, 1, "", "temp/9")).Code, 0x84);
+	EXPECT_EQ(exchange(request(0, 0x02, 2, "", "data")).Code, 0x85);
+	EXPECT_EQ(exchange(request(0, 0x01, 3, "", "data", -1, 50)).Code, 0x86);
+	EXPECT_EQ(exchange(request(0, 0x01, 4, "", "large")).Code, 0xA0);
+
+	// Unknown critical option (If-Match, 1).
+	std::string data = request(0, 0x01, 5, "", "");
+	data += (char)0x10;
+	EXPECT_EQ(exchange(data).Code, 0x82);
+
+	// Ping (empty confirmable message) is answered with a reset.
+	Message response = exchange(request(0, 0x00, 6, "", ""));
+	EXPECT_EQ(response.Type, 3);
+	EXPECT_EQ(response.MessageId, 6);
+
+	// Invalid messages (version 3) are ignored.
+	udp.Input.push_back(FakeCoapUdp::Packet{ CLIENT, 1, std::string("\xC0\x01\x00\x07", 4) });
+	EXPECT_TRUE(update().empty());
+	EXPECT_EQ(server.getErrors(), 6u);
+}
+
+TEST_F(CoapServerTest, NotifiesObservers)
+{
+	Message response = exchange(request(0, 0x01, 1, "o1", "data", 0));
+	EXPECT_EQ(response.Code, 0x45);
+	ASSERT_TRUE(response.has(6));
+	uint32_t sequence = response.value(6);
+	exchange(request(0, 0x01, 2, "o2", "data", 0), 40001);
+	exchange(request(0, 0x01, 3, "o3", "soil/1", 0), 40002);
+	EXPECT_EQ(server.getObservers(), 3u);
+
+	// No change, no notification.
+	EXPECT_TRUE(update().empty());
+
+	versions[0] = 7;
+	std::vector<Message> notifications = update();
+	ASSERT_EQ(notifications.size(), 2u);
+	EXPECT_EQ(notifications[0].Type, 1);
+	EXPECT_EQ(notifications[0].Token, "o1");
+	EXPECT_EQ(notifications[1].Token, "o2");
+	EXPECT_GT(notifications[0].value(6), sequence);
+	EXPECT_GT(notifications[1].value(6), notifications[0].value(6));
+	EXPECT_EQ(notifications[0].Payload, std::string("\xA1\x67Version\x07"));
+	EXPECT_EQ(server.getNotifications(), 2u);
+	EXPECT_TRUE(update().empty());
+
+	// Deregistration (Observe 1), a reset removes the observer too.
+	exchange(request(0, 0x01, 4, "o1", "data", 1));
+	udp.Input.push_back(FakeCoapUdp::Packet{ CLIENT, 40001,
+		request(3, 0x00, notifications[1].MessageId, "", "") });
+	update();
+	EXPECT_EQ(server.getObservers(), 1u);
+
+	versions[0] = 8;
+	EXPECT_TRUE(update().empty());
+	versions[1] = 1;
+	notifications = update();
+	ASSERT_EQ(notifications.size(), 1u);
+	EXPECT_EQ(notifications[0].Token, "o3");
+}
+
+TEST_F(CoapServerTest, ConfirmsObservers)
+{
+	exchange(request(0, 0x01, 1, "o1", "data", 0));
+	exchange(request(0, 0x01, 2, "o2", "data", 0), 40001);
+
+	// The first notification after the confirmation interval is confirmable.
+	Host::advanceTime(CoapServer::CONFIRM_INTERVAL * 1000ULL);
+	versions[0] = 1;
+	std::vector<Message> notifications = update();
+	ASSERT_EQ(notifications.size(), 2u);
+	EXPECT_EQ(notifications[0].Type, 0);
+	EXPECT_EQ(notifications[1].Type, 0);
+
+	// The first observer acknowledges, the second is retransmitted until removed.
+	udp.Input.push_back(FakeCoapUdp::Packet{ CLIENT, 40000, request(2, 0x00, notifications[0].MessageId, "", "") });
+	EXPECT_TRUE(update().empty());
+	uint32_t timeout = CoapServer::ACK_TIMEOUT;
+
+	for (uint8_t i = 1; i < CoapServer::MAX_ATTEMPTS; i++)
+	{
+		Host::advanceTime(timeout * 1000ULL - 1000);
+		EXPECT_TRUE(update().empty());
+		Host::advanceTime(1000);
+		notifications = update();
+		ASSERT_EQ(notifications.size(), 1u);
+		EXPECT_EQ(notifications[0].Type, 0);
+		EXPECT_EQ(notifications[0].Token, "o2");
+		timeout *= 2;
+	}
+
+	Host::advanceTime(timeout * 1000ULL);
+	EXPECT_TRUE(update().empty());
+	EXPECT_EQ(server.getObservers(), 1u);
+
+	// The acknowledged observer gets non-confirmable notifications.
+	versions[0] = 2;
+	notifications = update();
+	ASSERT_EQ(notifications.size(), 1u);
+	EXPECT_EQ(notifications[0].Type, 1);
+	EXPECT_EQ(notifications[0].Token, "o1");
+}
+
+TEST_F(CoapServerTest, LimitsObservers)
+{
+	for (uint8_t i = 0; i < CoapServer::MAX_OBSERVERS; i++)
+	{
+		EXPECT_TRUE(exchange(request(1, 0x01, i, "t", "data", 0), 30000 + i).has(6));
+	}
+
+	// The table is full: served without registration.
+	Message response = exchange(request(1, 0x01, 99, "t", "data", 0), 20000);
+	EXPECT_EQ(response.Code, 0x45);
+	EXPECT_FALSE(response.has(6));
+
+	// A registration of the same token replaces the entry.
+	EXPECT_TRUE(exchange(request(1, 0x01, 100, "t", "soil/1", 0), 30000).has(6));
+	EXPECT_EQ(server.getObservers(), (uint8_t)CoapServer::MAX_OBSERVERS);
+
+	// The socket is closed while the network is down, the observers are kept.
+	online = false;
+	server.update();
+	EXPECT_FALSE(server.isStarted());
+	online = true;
+	server.update();
+	EXPECT_EQ(udp.Begins, 2);
+	server.clear();
+	EXPECT_EQ(server.getObservers(), 0u);
+}
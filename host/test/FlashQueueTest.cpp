@@ -0,0 +1,131 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="FlashQueueTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <FS.h>
+#include "FlashQueue.h"
+
+class FlashQueueTest : public ::testing::Test
+{
+protected:
+	fs::FS fs;
+	FlashQueue queue = FlashQueue(&fs, "/mqtt");
+
+	std::string peek()
+	{
+		char buffer[FlashQueue::MAX_MESSAGE];
+		size_t length = queue.peek(buffer, sizeof(buffer));
+		return std::string(buffer, length);
+	}
+};
+
+TEST_F(FlashQueueTest, KeepsMessagesInOrder)
+{
+	queue.begin();
+	EXPECT_TRUE(queue.isEmpty());
+	EXPECT_EQ(peek(), "");
+
+	EXPECT_TRUE(queue.push("one", 3));
+	EXPECT_TRUE(queue.push("two", 3));
+	EXPECT_EQ(queue.getCount(), 2u);
+	EXPECT_TRUE(fs.exists("/mqtt0.q"));
+
+	EXPECT_EQ(peek(), "one");
+	EXPECT_EQ(peek(), "one");
+	queue.pop();
+	EXPECT_EQ(peek(), "two");
+	queue.pop();
+	EXPECT_TRUE(queue.isEmpty());
+	EXPECT_FALSE(fs.exists("/mqtt0.q"));
+
+	EXPECT_FALSE(queue.push("", 0));
+	EXPECT_EQ(queue.getDropped(), 1u);
+}
+
+TEST_F(FlashQueueTest, RestoresFromFiles)
+{
+	std::string message(1000, 'a');
+
+	queue.begin();
+
+	for (int i = 0; i < 10; i++)
+	{
+		message[0] = (char)('0' + i);
+		ASSERT_TRUE(queue.push(message.c_str(), message.size()));
+	}
+
+	queue.pop();
+	EXPECT_TRUE(fs.exists("/mqtt1.q"));
+
+	// The messages of the oldest segment are restored (including the one already popped).
+	FlashQueue restored(&fs, "/mqtt");
+	restored.begin();
+	EXPECT_EQ(restored.getCount(), 10u);
+
+	char buffer[FlashQueue::MAX_MESSAGE];
+	ASSERT_EQ(restored.peek(buffer, sizeof(buffer)), message.size());
+	EXPECT_EQ(buffer[0], '0');
+
+	// A new message is appended after the restored messages.
+	message[0] = 'X';
+	ASSERT_TRUE(restored.push(message.c_str(), message.size()));
+
+	for (int i = 0; i < 10; i++)
+	{
+		restored.pop();
+	}
+
+	ASSERT_EQ(restored.peek(buffer, sizeof(buffer)), message.size());
+	EXPECT_EQ(buffer[0], 'X');
+}
+
+TEST_F(FlashQueueTest, DropsOldestSegmentIfFull)
+{
+	std::string message(1000, 'a');
+
+	queue.begin();
+
+	// Eight messages per segment, four segments.
+	for (int i = 0; i < 40; i++)
+	{
+		message[0] = (char)('0' + i);
+		queue.push(message.c_str(), message.size());
+	}
+
+	EXPECT_EQ(queue.getCount(), 32u);
+	EXPECT_EQ(queue.getDropped(), 8u);
+	EXPECT_LE(fs.usedBytes(), FlashQueue::SEGMENT_COUNT * FlashQueue::SEGMENT_SIZE);
+	EXPECT_EQ(peek()[0], (char)('0' + 8));
+
+	queue.clear();
+	EXPECT_TRUE(queue.isEmpty());
+	EXPECT_EQ(fs.usedBytes(), 0u);
+}
+
+TEST_F(FlashQueueTest, IgnoresIncompleteMessage)
+{
+	queue.begin();
+	queue.push("one", 3);
+	queue.push("two", 3);
+
+	// Power loss while appending: the last message is incomplete.
+	File file = fs.open("/mqtt0.q", FILE_APPEND);
+	uint8_t partial[] = { 10, 0, 'x' };
+	file.write(partial, sizeof(partial));
+	file.close();
+
+	FlashQueue restored(&fs, "/mqtt");
+	restored.begin();
+	EXPECT_EQ(restored.getCount(), 2u);
+
+	// The next message starts a new segment.
+	restored.push("three", 5);
+	EXPECT_TRUE(fs.exists("/mqtt1.q"));
+	EXPECT_EQ(restored.getCount(), 3u);
+}
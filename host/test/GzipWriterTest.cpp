@@ -0,0 +1,125 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="GzipWriterTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "GzipWriter.h"
+
+#if HOST_ZLIB
+#include <zlib.h>
+
+/// <summary>
+/// Decompresses gzip data using zlib (the reference implementation).
+/// </summary>
+static std::string inflateGzip(const uint8_t* data, size_t length)
+{
+	std::string result;
+	std::vector<char> buffer(4096);
+	z_stream stream = {};
+
+	EXPECT_EQ(inflateInit2(&stream, 16 + MAX_WBITS), Z_OK);
+	stream.next_in = (Bytef*)data;
+	stream.avail_in = (uInt)length;
+	int status = Z_OK;
+
+	while (status == Z_OK)
+	{
+		stream.next_out = (Bytef*)buffer.data();
+		stream.avail_out = (uInt)buffer.size();
+		status = inflate(&stream, Z_NO_FLUSH);
+		result.append(buffer.data(), buffer.size() - stream.avail_out);
+	}
+
+	EXPECT_EQ(status, Z_STREAM_END);
+	inflateEnd(&stream);
+	return result;
+}
+#endif
+
+static std::string makeLines(int count)
+{
+	std::string lines;
+
+	for (int i = 0; i < count; i++)
+	{
+		lines += "soil,host=soilmonitor,sensor=" + std::to_string(i % 6) + " humidity=" + std::to_string(40 + i % 7) +
+			"i,voltage=2." + std::to_string(50 + i % 13) + " " + std::to_string(1600000000 + i) + "\n";
+	}
+
+	return lines;
+}
+
+TEST(GzipWriter, ComputesCrc32)
+{
+	EXPECT_EQ(GzipWriter::crc32((const uint8_t*)"123456789", 9), 0xCBF43926u);
+	EXPECT_EQ(GzipWriter::crc32(NULL, 0), 0u);
+}
+
+TEST(GzipWriter, WritesGzipFormat)
+{
+	static GzipWriter gzip;
+	std::string lines = makeLines(60);
+	std::vector<uint8_t> out(lines.size());
+
+	size_t length = gzip.compress((const uint8_t*)lines.data(), lines.size(), out.data(), out.size());
+	ASSERT_GT(length, 18u);
+	EXPECT_LT(length, lines.size() / 3);
+	EXPECT_EQ(out[0], 0x1F);
+	EXPECT_EQ(out[1], 0x8B);
+	EXPECT_EQ(out[2], 8);
+
+	// The trailer contains the CRC-32 and the size.
+	uint32_t crc = GzipWriter::crc32((const uint8_t*)lines.data(), lines.size());
+	EXPECT_EQ(out[length - 8], (uint8_t)crc);
+	EXPECT_EQ(out[length - 4], (uint8_t)lines.size());
+
+	// The output does not fit.
+	EXPECT_EQ(gzip.compress((const uint8_t*)lines.data(), lines.size(), out.data(), 40), 0u);
+
+#if HOST_ZLIB
+	EXPECT_EQ(inflateGzip(out.data(), length), lines);
+#endif
+}
+
+#if HOST_ZLIB
+TEST(GzipWriter, RoundTripsWithZlib)
+{
+	static GzipWriter gzip;
+	std::vector<uint8_t> out(GzipWriter::MAX_LENGTH * 2);
+	std::string inputs[] = {
+		"",
+		"a",
+		std::string(1000, 'x'),
+		std::string(GzipWriter::MAX_LENGTH, 'y'),
+		makeLines(300)
+	};
+
+	for (const std::string& input : inputs)
+	{
+		size_t length = gzip.compress((const uint8_t*)input.data(), input.size(), out.data(), out.size());
+		ASSERT_GT(length, 0u);
+		EXPECT_EQ(inflateGzip(out.data(), length), input);
+	}
+
+	// Random data (literals above 143 use 9 bit codes).
+	std::string noise;
+	uint32_t seed = 1;
+
+	for (int i = 0; i < 5000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		noise += (char)(seed >> 16);
+	}
+
+	size_t length = gzip.compress((const uint8_t*)noise.data(), noise.size(), out.data(), out.size());
+	ASSERT_GT(length, 0u);
+	EXPECT_EQ(inflateGzip(out.data(), length), noise);
+}
+#endif
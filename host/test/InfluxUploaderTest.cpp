@@ -0,0 +1,279 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="InfluxUploaderTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <vector>
+#include <Arduino.h>
+#include <Client.h>
+#include <FS.h>
+#include "InfluxUploader.h"
+
+/// <summary>
+/// This class emulates an InfluxDB HTTP server connection: the written requests are parsed (headers and body
+/// using Content-Length) and answered with the configured status (no response if disabled).
+/// </summary>
+class FakeInflux : public Client
+{
+public:
+	struct Request
+	{
+		std::string Head;										// The request line and headers
+		std::string Body;										// The request body
+	};
+
+	bool Reachable = true;										// Accepts connections
+	bool Respond = true;										// Sends a response
+	int Status = 204;											// The response status
+	bool Open = false;											// The connection state
+	int Connects = 0;											// The number of TCP connects
+	std::vector<Request> Requests;								// The received requests
+	std::string Input;											// The data sent to the client
+	std::string Output;											// The unparsed data written by the client
+
+	int connect(IPAddress ip, uint16_t port) override { return 0; }
+	int connect(const char* host, uint16_t port) override
+	{
+		Connects++;
+		Open = Reachable;
+		Input.clear();
+		Output.clear();
+		return Open ? 1 : 0;
+	}
+
+	size_t write(uint8_t c) override { return write(&c, 1); }
+	size_t write(const uint8_t* buffer, size_t size) override
+	{
+		if (!Open) return 0;
+		Output.append((const char*)buffer, size);
+		parse();
+		return size;
+	}
+
+	int available() override { return (int)Input.size(); }
+	int read() override
+	{
+		if (Input.empty()) return -1;
+		uint8_t c = Input[0];
+		Input.erase(0, 1);
+		return c;
+	}
+	int read(uint8_t* buffer, size_t size) override { return 0; }
+	int peek() override { return Input.empty() ? -1 : (uint8_t)Input[0]; }
+	void flush() override {}
+	void stop() override { Open = false; }
+	uint8_t connected() override { return Open ? 1 : 0; }
+	operator bool() override { return Open; }
+	using Print::write;
+
+private:
+	void parse()
+	{
+		size_t end = Output.find("\r\n\r\n");
+
+		if (end == std::string::npos) return;
+
+		std::string head = Output.substr(0, end + 2);
+		size_t position = head.find("Content-Length: ");
+		size_t length = (position != std::string::npos) ? strtoul(head.c_str() + position + 16, NULL, 10) : 0;
+
+		if (Output.size() < end + 4 + length) return;
+
+		Requests.push_back(Request{ head, Output.substr(end + 4, length) });
+		Output.erase(0, end + 4 + length);
+
+		if (!Respond) return;
+
+		if (Status == 204)
+		{
+			Input += "HTTP/1.1 204 No Content\r\nX-Influxdb-Version: 1.8.3\r\n\r\n";
+		}
+		else
+		{
+			std::string body = "{\"error\":\"failure\"}";
+			Input += "HTTP/1.1 " + std::to_string(Status) + " Error\r\nContent-Type: application/json\r\n" +
+				"Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+		}
+	}
+};
+
+static bool online = true;
+static bool isOnline() { return online; }
+
+class InfluxUploaderTest : public ::testing::Test
+{
+protected:
+	FakeInflux server;
+	fs::FS fs;
+	FlashQueue spool = FlashQueue(&fs, "/influx");
+	InfluxUploader uploader = InfluxUploader(&server, &isOnline, &spool);
+
+	void SetUp() override
+	{
+		Host::setTime(0);
+		online = true;
+		uploader.configure("influx", 8086, "/write?db=test&precision=s", "secret");
+	}
+
+	void TearDown() override
+	{
+		Host::useSystemTime();
+	}
+
+	void add(int value)
+	{
+		std::string line = "soil,sensor=0 humidity=" + std::to_string(value) + "i 1600000000\n";
+		ASSERT_TRUE(uploader.addLine(line.c_str(), line.size()));
+	}
+
+	void run(int count = 3)
+	{
+		for (int i = 0; i < count; i++) uploader.update();
+	}
+};
+
+TEST_F(InfluxUploaderTest, UploadsBatchesOverPersistentConnection)
+{
+	uploader.setBatch(2, 60, false);
+
+	add(1);
+	run();
+	EXPECT_TRUE(server.Requests.empty());
+	add(2);
+	run();
+
+	ASSERT_EQ(server.Requests.size(), 1u);
+	EXPECT_EQ(server.Requests[0].Head.find("POST /write?db=test&precision=s HTTP/1.1\r\n"), 0u);
+	EXPECT_NE(server.Requests[0].Head.find("Host: influx\r\n"), std::string::npos);
+	EXPECT_NE(server.Requests[0].Head.find("Authorization: Token secret\r\n"), std::string::npos);
+	EXPECT_EQ(server.Requests[0].Head.find("Content-Encoding"), std::string::npos);
+	EXPECT_EQ(server.Requests[0].Body,
+		"soil,sensor=0 humidity=1i 1600000000\nsoil,sensor=0 humidity=2i 1600000000\n");
+	EXPECT_FALSE(uploader.isBusy());
+	EXPECT_EQ(uploader.getUploaded(), 1u);
+
+	add(3);
+	add(4);
+	run();
+	EXPECT_EQ(server.Requests.size(), 2u);
+	EXPECT_EQ(server.Connects, 1);
+	EXPECT_EQ(uploader.getUploaded(), 2u);
+}
+
+TEST_F(InfluxUploaderTest, CompletesBatchByAgeAndCompresses)
+{
+	uploader.setBatch(100, 10, true);
+
+	for (int i = 0; i < 50; i++)
+	{
+		add(40 + i % 5);
+	}
+
+	Host::advanceTime(9999000);
+	run();
+	EXPECT_TRUE(server.Requests.empty());
+	EXPECT_EQ(uploader.getLines(), 50u);
+
+	Host::advanceTime(1000);
+	run();
+	ASSERT_EQ(server.Requests.size(), 1u);
+	EXPECT_NE(server.Requests[0].Head.find("Content-Encoding: gzip\r\n"), std::string::npos);
+	EXPECT_EQ((uint8_t)server.Requests[0].Body[0], 0x1F);
+	EXPECT_EQ((uint8_t)server.Requests[0].Body[1], 0x8B);
+	EXPECT_LT(uploader.getBytesOut() * 4, uploader.getBytesIn());
+
+	// A small batch is sent uncompressed (gzip does not save anything).
+	add(1);
+	Host::advanceTime(10000000);
+	run();
+	ASSERT_EQ(server.Requests.size(), 2u);
+	EXPECT_EQ(server.Requests[1].Head.find("Content-Encoding"), std::string::npos);
+}
+
+TEST_F(InfluxUploaderTest, SpoolsFailedBatchesAndRetries)
+{
+	uploader.setBatch(1, 60, false);
+	server.Reachable = false;
+
+	add(1);
+	run();
+	EXPECT_EQ(uploader.getFailed(), 1u);
+	EXPECT_EQ(spool.getCount(), 1u);
+	EXPECT_TRUE(fs.exists("/influx0.q"));
+
+	add(2);
+	run();
+	EXPECT_EQ(spool.getCount(), 2u);
+	EXPECT_EQ(server.Connects, 1);
+
+	// No retry while the network is down.
+	server.Reachable = true;
+	online = false;
+	Host::advanceTime(InfluxUploader::RETRY_MAX * 1000ULL);
+	run();
+	EXPECT_EQ(server.Connects, 1);
+
+	online = true;
+	run(6);
+	ASSERT_EQ(server.Requests.size(), 2u);
+	EXPECT_EQ(server.Requests[0].Body, "soil,sensor=0 humidity=1i 1600000000\n");
+	EXPECT_EQ(server.Requests[1].Body, "soil,sensor=0 humidity=2i 1600000000\n");
+	EXPECT_TRUE(spool.isEmpty());
+
+	// A new batch is sent directly after the spool has been drained.
+	add(3);
+	run();
+	EXPECT_EQ(server.Requests.size(), 3u);
+	EXPECT_EQ(server.Connects, 2);
+}
+
+TEST_F(InfluxUploaderTest, RetriesServerErrorsWithBackoff)
+{
+	uploader.setBatch(1, 60, false);
+	server.Status = 503;
+
+	add(1);
+	run();
+	EXPECT_EQ(server.Requests.size(), 1u);
+	EXPECT_EQ(uploader.getFailed(), 1u);
+	EXPECT_EQ(spool.getCount(), 1u);
+
+	// The first retry after RETRY_MIN, the next after twice the interval.
+	Host::advanceTime((InfluxUploader::RETRY_MIN - 1) * 1000ULL);
+	run();
+	EXPECT_EQ(server.Requests.size(), 1u);
+	Host::advanceTime(1000);
+	run();
+	EXPECT_EQ(server.Requests.size(), 2u);
+	Host::advanceTime(InfluxUploader::RETRY_MIN * 1000ULL);
+	run();
+	EXPECT_EQ(server.Requests.size(), 2u);
+	Host::advanceTime(InfluxUploader::RETRY_MIN * 1000ULL);
+	run();
+	EXPECT_EQ(server.Requests.size(), 3u);
+
+	// A missing response times out.
+	server.Respond = false;
+	Host::advanceTime(InfluxUploader::RETRY_MAX * 1000ULL);
+	run();
+	EXPECT_TRUE(uploader.isBusy());
+	Host::advanceTime(InfluxUploader::RESPONSE_TIMEOUT * 1000ULL);
+	run();
+	EXPECT_FALSE(uploader.isBusy());
+	EXPECT_EQ(uploader.getFailed(), 4u);
+	EXPECT_EQ(spool.getCount(), 1u);
+
+	// A rejected batch (invalid data) is dropped, the connection is kept.
+	server.Respond = true;
+	server.Status = 400;
+	Host::advanceTime(InfluxUploader::RETRY_MAX * 1000ULL);
+	run();
+	EXPECT_EQ(uploader.getRejected(), 1u);
+	EXPECT_TRUE(spool.isEmpty());
+	EXPECT_TRUE(server.Open);
+}
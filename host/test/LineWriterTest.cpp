@@ -0,0 +1,95 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LineWriterTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "LineWriter.h"
+
+static std::string text(const LineWriter& writer)
+{
+	return std::string(writer.getData(), writer.getLength());
+}
+
+TEST(LineWriter, WritesLines)
+{
+	char buffer[256];
+	LineWriter writer(buffer, sizeof(buffer));
+
+	writer.begin("soil");
+	writer.tag("host", "soilmonitor");
+	writer.tag("sensor", "0");
+	writer.field("humidity", 45);
+	writer.field("voltage", 2.58f);
+	EXPECT_TRUE(writer.end(1600000000));
+
+	writer.begin("temp");
+	writer.tag("sensor", "1");
+	writer.field("celsius", -0.5f);
+	EXPECT_TRUE(writer.end());
+
+	EXPECT_EQ(text(writer),
+		"soil,host=soilmonitor,sensor=0 humidity=45i,voltage=2.58 1600000000\n"
+		"temp,sensor=1 celsius=-0.5\n");
+	EXPECT_EQ(writer.getLines(), 2u);
+
+	writer.clear();
+	EXPECT_EQ(writer.getLength(), 0u);
+	EXPECT_EQ(writer.getLines(), 0u);
+}
+
+TEST(LineWriter, EscapesNames)
+{
+	char buffer[256];
+	LineWriter writer(buffer, sizeof(buffer));
+
+	writer.begin("soil moisture,raw");
+	writer.tag("name", "Sensor 1,a=b");
+	writer.tag("empty", "");
+	writer.field("value=", 1);
+	EXPECT_TRUE(writer.end());
+
+	EXPECT_EQ(text(writer), "soil\\ moisture\\,raw,name=Sensor\\ 1\\,a\\=b value\\==1i\n");
+}
+
+TEST(LineWriter, SkipsInvalidValues)
+{
+	char buffer[256];
+	LineWriter writer(buffer, sizeof(buffer));
+
+	writer.begin("temp");
+	writer.field("celsius", NAN);
+	writer.field("raw", INFINITY);
+	EXPECT_FALSE(writer.end(1600000000));
+	EXPECT_EQ(writer.getLength(), 0u);
+
+	writer.begin("temp");
+	writer.field("celsius", NAN);
+	writer.field("resolution", 12);
+	EXPECT_TRUE(writer.end());
+	EXPECT_EQ(text(writer), "temp resolution=12i\n");
+}
+
+TEST(LineWriter, RemovesLineIfFull)
+{
+	char buffer[40];
+	LineWriter writer(buffer, sizeof(buffer));
+
+	writer.begin("soil");
+	writer.field("humidity", 45);
+	EXPECT_TRUE(writer.end(1600000000));
+	size_t length = writer.getLength();
+
+	writer.begin("soil");
+	writer.tag("sensor", "5");
+	writer.field("humidity", 45);
+	EXPECT_FALSE(writer.end(1600000000));
+	EXPECT_EQ(writer.getLength(), length);
+	EXPECT_EQ(writer.getLines(), 1u);
+	EXPECT_EQ(text(writer), "soil humidity=45i 1600000000\n");
+}
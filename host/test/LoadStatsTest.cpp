@@ -0,0 +1,67 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LoadStatsTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include "LoadStats.h"
+
+TEST(LoadStats, ReturnsNearestRankPercentiles)
+{
+	std::vector<uint32_t> values;
+
+	for (uint32_t i = 100; i >= 1; i--)
+	{
+		values.push_back(i);
+	}
+
+	EXPECT_EQ(LoadStats::percentile(values, 50), 50u);
+	EXPECT_EQ(LoadStats::percentile(values, 90), 90u);
+	EXPECT_EQ(LoadStats::percentile(values, 99), 99u);
+	EXPECT_EQ(LoadStats::percentile(values, 100), 100u);
+	EXPECT_EQ(LoadStats::percentile(values, 0), 1u);
+	EXPECT_EQ(LoadStats::percentile({ 7 }, 99), 7u);
+	EXPECT_EQ(LoadStats::percentile({}, 50), 0u);
+}
+
+TEST(LoadStats, CountsRequestsPerRoute)
+{
+	LoadStats stats;
+
+	stats.add("/data", 10, 1000, true);
+	stats.add("/data", 30, 1000, true);
+	stats.add("/config", 50, 200, false);
+	stats.refuse("/data");
+
+	EXPECT_EQ(stats.get("/data").Latencies.size(), 2u);
+	EXPECT_EQ(stats.get("/data").Bytes, 2000u);
+	EXPECT_EQ(stats.get("/data").Errors, 1u);
+	EXPECT_EQ(stats.get("/data").Refused, 1u);
+	EXPECT_EQ(stats.get("/config").Errors, 1u);
+	EXPECT_EQ(stats.total().Latencies.size(), 3u);
+	EXPECT_EQ(stats.total().Errors, 2u);
+	EXPECT_EQ(stats.total().Bytes, 2200u);
+}
+
+TEST(LoadStats, PrintsTable)
+{
+	LoadStats stats;
+	char* text = nullptr;
+	size_t size = 0;
+	FILE* out = open_memstream(&text, &size);
+
+	stats.add("/data", 20, 2048, true);
+	stats.print(out, 2.0);
+	fclose(out);
+
+	std::string table(text, size);
+	free(text);
+
+	EXPECT_NE(table.find("route"), std::string::npos);
+	EXPECT_NE(table.find("/data"), std::string::npos);
+	EXPECT_NE(table.find("total"), std::string::npos);
+	EXPECT_NE(table.find("0.50"), std::string::npos);
+}
@@ -0,0 +1,101 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogBufferTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <ArduinoLog.h>
+#include "LogBuffer.h"
+
+/// <summary>
+///  Pushes a message with the arguments, pops it and returns the formatted text.
+/// </summary>
+template <typename... Args>
+static std::string format(const char* text, const Args&... args)
+{
+	LogBuffer buffer;
+	LogRecord record;
+	LogArg list[sizeof...(Args) + 1] = { LogArg(args)..., LogArg() };
+	char message[160];
+
+	EXPECT_TRUE(buffer.push(LOG_LEVEL_NOTICE, text, list, sizeof...(Args)));
+	EXPECT_TRUE(buffer.pop(record));
+	LogBuffer::format(record, message, sizeof(message));
+
+	return message;
+}
+
+TEST(LogBuffer, FormatsIntegers)
+{
+	EXPECT_EQ(format("a=%d b=%u c=%x d=%X", -5, 7u, 255u, 255u), "a=-5 b=7 c=ff d=0xFF");
+}
+
+TEST(LogBuffer, FormatsDoublesAndBooleans)
+{
+	EXPECT_EQ(format("%F %D %T %t", 1.5, 2.25f, true, false), "1.50 2.25 true F");
+}
+
+TEST(LogBuffer, CopiesStrings)
+{
+	char text[] = "volatile";
+	LogBuffer buffer;
+	LogRecord record;
+	LogArg args[] = { LogArg(text), LogArg(String("copy")) };
+	char message[64];
+
+	ASSERT_TRUE(buffer.push(LOG_LEVEL_ERROR, "%s %s%%", args, 2));
+	strcpy(text, "changed");
+	ASSERT_TRUE(buffer.pop(record));
+	LogBuffer::format(record, message, sizeof(message));
+
+	EXPECT_STREQ(message, "volatile copy%");
+	EXPECT_EQ(record.Level, LOG_LEVEL_ERROR);
+}
+
+TEST(LogBuffer, TruncatesLongStrings)
+{
+	std::string text(100, 'x');
+	std::string message = format("%s", text.c_str());
+
+	EXPECT_EQ(message.size(), (size_t)LogRecord::TEXT_SIZE - 1);
+}
+
+TEST(LogBuffer, TruncatesToBufferSize)
+{
+	LogBuffer buffer;
+	LogRecord record;
+	char message[8];
+
+	ASSERT_TRUE(buffer.push(LOG_LEVEL_NOTICE, "0123456789", NULL, 0));
+	ASSERT_TRUE(buffer.pop(record));
+
+	EXPECT_EQ(LogBuffer::format(record, message, sizeof(message)), sizeof(message) - 1);
+	EXPECT_STREQ(message, "0123456");
+}
+
+TEST(LogBuffer, DropsWhenFull)
+{
+	LogBuffer buffer;
+	LogRecord record;
+
+	for (uint16_t i = 0; i < LogBuffer::SIZE; i++)
+	{
+		ASSERT_TRUE(buffer.push(LOG_LEVEL_NOTICE, "message", NULL, 0));
+	}
+
+	EXPECT_FALSE(buffer.push(LOG_LEVEL_NOTICE, "dropped", NULL, 0));
+	EXPECT_EQ(buffer.getDropped(), 1u);
+
+	for (uint16_t i = 0; i < LogBuffer::SIZE; i++)
+	{
+		ASSERT_TRUE(buffer.pop(record));
+		EXPECT_STREQ(record.Format, "message");
+	}
+
+	EXPECT_FALSE(buffer.pop(record));
+	EXPECT_TRUE(buffer.push(LOG_LEVEL_NOTICE, "again", NULL, 0));
+}
@@ -0,0 +1,108 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogFileTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <FS.h>
+#include <ArduinoLog.h>
+#include "LogFile.h"
+
+class LogFileTest : public ::testing::Test
+{
+protected:
+	fs::FS fs;
+	LogFile file = LogFile(&fs);
+
+	void SetUp() override
+	{
+		Host::setTime(0);
+	}
+
+	void TearDown() override
+	{
+		Host::useSystemTime();
+	}
+
+	std::string read(const char* path)
+	{
+		File f = fs.open(path, FILE_READ);
+		return f ? std::string(f.readString().c_str()) : std::string();
+	}
+};
+
+TEST_F(LogFileTest, BuffersLines)
+{
+	file.write(61000, LOG_LEVEL_NOTICE, "hello", 5);
+
+	EXPECT_FALSE(fs.exists("/log0.txt"));
+	EXPECT_EQ(file.size(), 18u);
+
+	file.flush();
+
+	EXPECT_EQ(read("/log0.txt"), "00:01:01 N: hello\n");
+}
+
+TEST_F(LogFileTest, WritesAfterFlushInterval)
+{
+	file.write(0, LOG_LEVEL_ERROR, "error", 5);
+	Host::advanceTime((uint64_t)(LogFile::FLUSH_INTERVAL - 1) * 1000);
+	file.update();
+
+	EXPECT_FALSE(fs.exists("/log0.txt"));
+
+	Host::advanceTime(1000);
+	file.update();
+
+	EXPECT_EQ(read("/log0.txt"), "00:00:00 E: error\n");
+}
+
+TEST_F(LogFileTest, RotatesFiles)
+{
+	std::string message(100, 'x');
+	size_t lines = 5 * LogFile::MAX_FILE_SIZE / (2 * (message.size() + 13));
+
+	for (size_t i = 0; i < lines; i++)
+	{
+		file.write(0, LOG_LEVEL_NOTICE, message.c_str(), message.size());
+	}
+
+	file.flush();
+
+	EXPECT_TRUE(fs.exists("/log1.txt"));
+	EXPECT_TRUE(fs.exists("/log2.txt"));
+	EXPECT_FALSE(fs.exists("/log3.txt"));
+	EXPECT_GE(read("/log2.txt").size(), (size_t)LogFile::MAX_FILE_SIZE);
+	EXPECT_EQ(file.size(), lines * (message.size() + 13));
+}
+
+TEST_F(LogFileTest, PrintsTail)
+{
+	StringPrint output;
+
+	file.write(0, LOG_LEVEL_NOTICE, "first", 5);
+	file.flush();
+	file.write(0, LOG_LEVEL_NOTICE, "second", 6);
+
+	EXPECT_EQ(file.tail(output, 1000), file.size());
+	EXPECT_EQ(output.Text, "00:00:00 N: first\n00:00:00 N: second\n");
+
+	output.Text.clear();
+	file.tail(output, 10);
+	EXPECT_EQ(output.Text, "N: second\n");
+}
+
+TEST_F(LogFileTest, ClearsFiles)
+{
+	file.write(0, LOG_LEVEL_NOTICE, "first", 5);
+	file.flush();
+	file.write(0, LOG_LEVEL_NOTICE, "second", 6);
+	file.clear();
+
+	EXPECT_FALSE(fs.exists("/log0.txt"));
+	EXPECT_EQ(file.size(), 0u);
+}
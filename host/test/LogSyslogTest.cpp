@@ -0,0 +1,216 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogSyslogTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <regex>
+#include <vector>
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <Udp.h>
+#include <WiFiUdp.h>
+#include "LogSyslog.h"
+
+// The socket headers are included after the shims (INADDR_NONE is an IPAddress constant there).
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/// <summary>
+/// This class collects the sent datagrams.
+/// </summary>
+class FakeUdp : public UDP
+{
+public:
+	std::vector<std::string> Packets;							// The sent datagrams
+	std::string Packet;											// The actual datagram
+	bool Fail = false;											// Fails all packets
+
+	int beginPacket(const char* host, uint16_t port) override { Packet.clear(); return Fail ? 0 : 1; }
+	int endPacket() override { Packets.push_back(Packet); return 1; }
+	size_t write(uint8_t c) override { Packet += (char)c; return 1; }
+	size_t write(const uint8_t* buffer, size_t size) override { Packet.append((const char*)buffer, size); return size; }
+};
+
+static bool online = true;
+static bool isOnline() { return online; }
+
+class LogSyslogTest : public ::testing::Test
+{
+protected:
+	FakeUdp udp;
+	LogSyslog sink = LogSyslog(&udp, &isOnline);
+
+	void SetUp() override
+	{
+		online = true;
+		Host::setTime(1000000);
+		sink.configure(LOG_LEVEL_NOTICE, "syslog.local", 514, "soil monitor");
+	}
+
+	void TearDown() override
+	{
+		Host::useSystemTime();
+	}
+
+	void write(uint8_t level, const std::string& message)
+	{
+		sink.write(millis(), level, message.c_str(), message.size());
+	}
+};
+
+TEST_F(LogSyslogTest, FormatsMessage)
+{
+	char buffer[LogSyslog::MESSAGE_SIZE];
+	size_t n = LogSyslog::formatMessage(buffer, sizeof(buffer), 0, 12345, 7, LOG_LEVEL_ERROR, "host", "text", 4);
+
+	EXPECT_STREQ(buffer, "<131>1 - host SoilMonitor - - [meta sequenceId=\"7\" sysUpTime=\"1234\"] text");
+	EXPECT_EQ(n, strlen(buffer));
+}
+
+TEST_F(LogSyslogTest, FormatsTimestamp)
+{
+	char buffer[LogSyslog::MESSAGE_SIZE];
+
+	LogSyslog::formatMessage(buffer, sizeof(buffer), 1586080800, millis(), 1, LOG_LEVEL_NOTICE, "", "text", 4);
+
+	EXPECT_STREQ(buffer, "<133>1 2020-04-05T10:00:00Z - SoilMonitor - - [meta sequenceId=\"1\" sysUpTime=\"100\"] text");
+}
+
+TEST_F(LogSyslogTest, MapsSeverity)
+{
+	EXPECT_EQ(LogSyslog::getSeverity(LOG_LEVEL_FATAL), 2);
+	EXPECT_EQ(LogSyslog::getSeverity(LOG_LEVEL_WARNING), 4);
+	EXPECT_EQ(LogSyslog::getSeverity(LOG_LEVEL_VERBOSE), 7);
+}
+
+TEST_F(LogSyslogTest, BatchesMessages)
+{
+	write(LOG_LEVEL_ERROR, "first");
+	write(LOG_LEVEL_NOTICE, "second");
+	write(LOG_LEVEL_TRACE, "filtered");
+	sink.update();
+
+	EXPECT_TRUE(udp.Packets.empty());
+
+	Host::advanceTime(LogSyslog::BATCH_INTERVAL * 1000);
+	sink.update();
+
+	// RFC 5426: one message per datagram.
+	ASSERT_EQ(udp.Packets.size(), 2u);
+	EXPECT_EQ(udp.Packets[0].find("<131>1"), 0u);
+	EXPECT_NE(udp.Packets[0].find("soil_monitor SoilMonitor"), std::string::npos);
+	EXPECT_NE(udp.Packets[0].find("] first"), std::string::npos);
+	EXPECT_EQ(udp.Packets[1].find("<133>1"), 0u);
+	EXPECT_NE(udp.Packets[1].find("] second"), std::string::npos);
+	EXPECT_EQ(udp.Packets[0].find('\n'), std::string::npos);
+	EXPECT_EQ(sink.getSent(), 2u);
+}
+
+TEST_F(LogSyslogTest, LimitsDatagramRate)
+{
+	std::string message(300, 'x');
+
+	for (int i = 0; i < 20; i++)
+	{
+		write(LOG_LEVEL_NOTICE, message);
+	}
+
+	for (const std::string& packet : udp.Packets)
+	{
+		EXPECT_LE(packet.size(), (size_t)LogSyslog::MESSAGE_SIZE);
+	}
+
+	// The buffer holds three messages, the messages exceeding the rate and the buffer are dropped.
+	EXPECT_EQ(udp.Packets.size(), (size_t)LogSyslog::MAX_RATE);
+	EXPECT_EQ(sink.getSent(), 10u);
+	EXPECT_EQ(sink.getDropped(), 7u);
+
+	sink.flush();
+	EXPECT_EQ(sink.getSent(), 13u);
+	EXPECT_EQ(udp.Packets.size(), 13u);
+}
+
+TEST_F(LogSyslogTest, DropsWhileOffline)
+{
+	online = false;
+	write(LOG_LEVEL_ERROR, "lost");
+	sink.flush();
+
+	EXPECT_TRUE(udp.Packets.empty());
+	EXPECT_EQ(sink.getDropped(), 1u);
+}
+
+TEST_F(LogSyslogTest, DropsFailedDatagram)
+{
+	udp.Fail = true;
+	write(LOG_LEVEL_ERROR, "first");
+	write(LOG_LEVEL_ERROR, "second");
+	sink.flush();
+
+	EXPECT_EQ(sink.getSent(), 0u);
+	EXPECT_EQ(sink.getDropped(), 2u);
+}
+
+TEST(LogSyslogLoopback, SendsFramesToServer)
+{
+	// The syslog server (bound to an ephemeral loopback port).
+	int server = socket(AF_INET, SOCK_DGRAM, 0);
+	ASSERT_GE(server, 0);
+
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length = sizeof(address);
+	ASSERT_EQ(bind(server, (const sockaddr*)&address, sizeof(address)), 0);
+	ASSERT_EQ(getsockname(server, (sockaddr*)&address, &length), 0);
+
+	timeval timeout = { 2, 0 };
+	setsockopt(server, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	WiFiUDP udp;
+	LogSyslog sink(&udp, &isOnline);
+	online = true;
+	sink.configure(LOG_LEVEL_NOTICE, "127.0.0.1", ntohs(address.sin_port), "soil monitor");
+	sink.write(millis(), LOG_LEVEL_ERROR, "first", 5);
+	sink.write(millis(), LOG_LEVEL_NOTICE, "second message", 14);
+	sink.flush();
+
+	// RFC 5426: one message per datagram.
+	std::vector<std::string> lines;
+	char buffer[LogSyslog::MESSAGE_SIZE + 1];
+
+	for (int i = 0; i < 2; i++)
+	{
+		ssize_t size = recv(server, buffer, sizeof(buffer), 0);
+		ASSERT_GT(size, 0);
+		lines.push_back(std::string(buffer, (size_t)size));
+	}
+
+	close(server);
+
+	// RFC 5424: <PRI>VERSION TIMESTAMP HOSTNAME APP-NAME PROCID MSGID STRUCTURED-DATA MSG.
+	std::regex format("<([0-9]+)>1 (\\S+) (\\S+) (\\S+) (\\S+) (\\S+) (\\[[^\\]]*\\]) (.*)");
+
+	std::smatch first;
+	std::smatch second;
+	ASSERT_TRUE(std::regex_match(lines[0], first, format));
+	ASSERT_TRUE(std::regex_match(lines[1], second, format));
+
+	EXPECT_EQ(first[1], "131");
+	EXPECT_EQ(first[3], "soil_monitor");
+	EXPECT_EQ(first[4], "SoilMonitor");
+	EXPECT_EQ(first[5], "-");
+	EXPECT_EQ(first[6], "-");
+	EXPECT_NE(first[7].str().find("sequenceId=\"1\""), std::string::npos);
+	EXPECT_EQ(first[8], "first");
+	EXPECT_EQ(second[1], "133");
+	EXPECT_NE(second[7].str().find("sequenceId=\"2\""), std::string::npos);
+	EXPECT_EQ(second[8], "second message");
+	EXPECT_EQ(sink.getSent(), 2u);
+}
@@ -0,0 +1,111 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LoggerTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "Logger.h"
+
+/// <summary>
+/// This class collects the formatted messages written by the logger.
+/// </summary>
+class CaptureSink : public LogSink
+{
+public:
+	std::vector<std::string> Messages;							// The captured messages
+	std::vector<uint8_t> Levels;								// The captured levels
+
+	void write(uint32_t timestamp, uint8_t level, const char* message, size_t length) override
+	{
+		Messages.push_back(std::string(message, length));
+		Levels.push_back(level);
+	}
+};
+
+/// <summary>
+/// The logger is a static class, the sink is attached once and the task is never started (drain() is called).
+/// </summary>
+class LoggerTest : public ::testing::Test
+{
+protected:
+	static CaptureSink sink;
+
+	static void SetUpTestSuite()
+	{
+		Logger::attach(&sink);
+	}
+
+	void SetUp() override
+	{
+		Logger::setLevel(LOG_LEVEL_NOTICE);
+		Logger::drain();
+		sink.Messages.clear();
+		sink.Levels.clear();
+	}
+};
+
+CaptureSink LoggerTest::sink;
+
+TEST_F(LoggerTest, WritesEnabledLevels)
+{
+	LOG_ERROR("error %d", 1);
+	LOG_NOTICE("notice %s", "two");
+	Logger::drain();
+
+	ASSERT_EQ(sink.Messages.size(), 2u);
+	EXPECT_EQ(sink.Messages[0], "error 1");
+	EXPECT_EQ(sink.Messages[1], "notice two");
+	EXPECT_EQ(sink.Levels[0], LOG_LEVEL_ERROR);
+}
+
+TEST_F(LoggerTest, SkipsDisabledLevels)
+{
+	int evaluated = 0;
+
+	Logger::setLevel(LOG_LEVEL_WARNING);
+	LOG_NOTICE("notice %d", ++evaluated);
+	LOG_TRACE("trace %d", ++evaluated);
+	Logger::drain();
+
+	EXPECT_TRUE(sink.Messages.empty());
+	EXPECT_EQ(evaluated, 0);
+}
+
+TEST_F(LoggerTest, ReportsDroppedMessages)
+{
+	uint32_t dropped = Logger::getDropped();
+
+	for (uint16_t i = 0; i <= LogBuffer::SIZE; i++)
+	{
+		LOG_NOTICE("message %u", (unsigned int)i);
+	}
+
+	EXPECT_EQ(Logger::getDropped(), dropped + 1);
+	Logger::drain();
+
+	ASSERT_EQ(sink.Messages.size(), (size_t)LogBuffer::SIZE + 1);
+	EXPECT_EQ(sink.Levels.back(), LOG_LEVEL_WARNING);
+}
+
+TEST(LogSink, FormatsPrefix)
+{
+	char prefix[24];
+	size_t n = LogSink::formatPrefix(prefix, sizeof(prefix), ((2 * 3600) + (3 * 60) + 4) * 1000 + 999, LOG_LEVEL_WARNING);
+
+	EXPECT_STREQ(prefix, "02:03:04 W: ");
+	EXPECT_EQ(n, strlen(prefix));
+}
+
+TEST(LogSink, PrintSinkWritesLines)
+{
+	StringPrint output;
+	PrintSink sink(&output);
+
+	sink.write(1000, LOG_LEVEL_ERROR, "failed", 6);
+
+	EXPECT_EQ(output.Text, "00:00:01 E: failed\n");
+}
@@ -0,0 +1,91 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MetricsWriterTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "MetricsWriter.h"
+#include "HeapMonitor.h"
+
+TEST(MetricsWriter, WritesFamiliesAndSamples)
+{
+	StringPrint out;
+	MetricsWriter writer(out);
+
+	writer.writeFamily("soilmonitor_uptime_seconds", "gauge", "Time since the start.");
+	writer.writeInt("soilmonitor_uptime_seconds", 86400);
+	writer.writeFamily("soilmonitor_temp_celsius", "gauge", "Temperature.");
+	writer.writeFloat("soilmonitor_temp_celsius", 21.5f, "sensor", "0");
+	writer.writeFloat("soilmonitor_temp_celsius", -0.1f, "sensor", "1");
+	writer.writeInt("soilmonitor_wifi_rssi_dbm", -67);
+
+	EXPECT_EQ(out.Text,
+		"# HELP soilmonitor_uptime_seconds Time since the start.\n"
+		"# TYPE soilmonitor_uptime_seconds gauge\n"
+		"soilmonitor_uptime_seconds 86400\n"
+		"# HELP soilmonitor_temp_celsius Temperature.\n"
+		"# TYPE soilmonitor_temp_celsius gauge\n"
+		"soilmonitor_temp_celsius{sensor=\"0\"} 21.5\n"
+		"soilmonitor_temp_celsius{sensor=\"1\"} -0.1\n"
+		"soilmonitor_wifi_rssi_dbm -67\n");
+	EXPECT_EQ(writer.getSize(), out.Text.size());
+}
+
+TEST(MetricsWriter, WritesSpecialValuesAndEscapes)
+{
+	StringPrint out;
+	MetricsWriter writer(out);
+
+	writer.writeFloat("m", NAN);
+	writer.writeFloat("m", INFINITY);
+	writer.writeFloat("m", -INFINITY);
+	writer.writeInt("m", 1, "name", "a\"b\\c\nd");
+
+	EXPECT_EQ(out.Text, "m NaN\nm +Inf\nm -Inf\nm{name=\"a\\\"b\\\\c\\nd\"} 1\n");
+}
+
+TEST(MetricsWriter, SkipsTruncatedLines)
+{
+	StringPrint out;
+	MetricsWriter writer(out);
+	std::string name(MetricsWriter::MAX_LINE, 'x');
+
+	writer.writeInt(name.c_str(), 1);
+	writer.writeInt("m", 2);
+
+	EXPECT_EQ(out.Text, "m 2\n");
+	EXPECT_EQ(writer.getSkipped(), 1);
+}
+
+TEST(MetricsWriter, OmitsAllocationsWithoutHook)
+{
+	StringPrint out;
+	MetricsWriter writer(out);
+
+	HeapMonitor::writeMetrics(writer);
+
+	EXPECT_FALSE(HeapMonitor::isCounting());
+	EXPECT_NE(out.Text.find("soilmonitor_heap_free_bytes 200000\n"), std::string::npos);
+	EXPECT_EQ(out.Text.find("soilmonitor_heap_allocations_total"), std::string::npos);
+}
+
+TEST(MetricsWriter, WritesHeapMetrics)
+{
+	StringPrint out;
+	MetricsWriter writer(out);
+
+	HeapMonitor::onAlloc(16);
+	HeapMonitor::writeMetrics(writer);
+
+	EXPECT_NE(out.Text.find("# TYPE soilmonitor_heap_free_bytes gauge\nsoilmonitor_heap_free_bytes 200000\n"),
+		std::string::npos);
+	EXPECT_NE(out.Text.find("soilmonitor_heap_max_alloc_bytes 110000\n"), std::string::npos);
+	EXPECT_NE(out.Text.find("# TYPE soilmonitor_heap_allocations_total counter\n"), std::string::npos);
+	EXPECT_NE(out.Text.find("soilmonitor_heap_allocations_total{subsystem=\"Web\"} "), std::string::npos);
+	EXPECT_EQ(writer.getSkipped(), 0);
+}
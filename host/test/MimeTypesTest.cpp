@@ -0,0 +1,35 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MimeTypesTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include "MimeTypes.h"
+
+TEST(MimeTypes, ReturnsTypeForExtension)
+{
+	EXPECT_STREQ(MimeTypes::getType("/index.html"), "text/html");
+	EXPECT_STREQ(MimeTypes::getType("/css/site.css"), "text/css");
+	EXPECT_STREQ(MimeTypes::getType("/js/app.js"), "application/javascript");
+	EXPECT_STREQ(MimeTypes::getType("/settings.json"), "application/json");
+	EXPECT_STREQ(MimeTypes::getType("/image.png"), "image/png");
+}
+
+TEST(MimeTypes, IgnoresCase)
+{
+	EXPECT_STREQ(MimeTypes::getType("/INDEX.HTML"), MimeTypes::getType("/index.html"));
+}
+
+TEST(MimeTypes, ReturnsNullForUnknownExtension)
+{
+	EXPECT_EQ(MimeTypes::getType("/file.unknownext"), nullptr);
+	EXPECT_EQ(MimeTypes::getType("/noextension"), nullptr);
+}
+
+TEST(MimeTypes, ReturnsExtensionForType)
+{
+	EXPECT_STREQ(MimeTypes::getExtension("text/css"), "css");
+}
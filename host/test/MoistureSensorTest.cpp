@@ -0,0 +1,103 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MoistureSensorTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "MoistureSensor.h"
+
+/// <summary>
+///  Sets the analog input and updates the sensor several times (smoothing).
+/// </summary>
+static void settle(MoistureSensor& sensor, uint16_t value, int count = 200)
+{
+	Host::setAnalog(sensor.getPin(), value);
+
+	for (int i = 0; i < count; i++)
+	{
+		sensor.update();
+	}
+}
+
+TEST(MoistureSensor, ConvertsVoltageToHumidity)
+{
+	MoistureSensor sensor(A0, "Test", 1.5f, 3.5f);
+
+	sensor.begin();
+
+	settle(sensor, 1500);
+	EXPECT_EQ(sensor.getValue(), 1500);
+	EXPECT_NEAR(sensor.getVoltage(), 1.5f, 0.01f);
+	EXPECT_EQ(sensor.getHumidity(), 100);
+
+	settle(sensor, 2500);
+	EXPECT_NEAR(sensor.getHumidity(), 50, 1);
+
+	settle(sensor, 3500);
+	EXPECT_EQ(sensor.getHumidity(), 0);
+}
+
+TEST(MoistureSensor, LimitsHumidity)
+{
+	MoistureSensor sensor(A0, "Test", 1.5f, 3.5f);
+
+	sensor.begin();
+
+	settle(sensor, 500);
+	EXPECT_EQ(sensor.getHumidity(), 100);
+
+	settle(sensor, 4095);
+	EXPECT_EQ(sensor.getHumidity(), 0);
+}
+
+TEST(MoistureSensor, SmoothsValues)
+{
+	MoistureSensor sensor(A0, "Test", 1.5f, 3.5f);
+
+	sensor.begin();
+	settle(sensor, 2000);
+	settle(sensor, 3000, 1);
+
+	EXPECT_EQ(sensor.getValue(), 3000);
+	EXPECT_GT(sensor.getVoltage(), 2.0f);
+	EXPECT_LT(sensor.getVoltage(), 3.0f);
+}
+
+TEST(MoistureSensor, IgnoresSpikeInMedian)
+{
+	MoistureSensor sensor(A0, "Test", 1.5f, 3.5f);
+
+	sensor.begin();
+	settle(sensor, 2000, 3);
+	settle(sensor, 4095, 1);
+
+	EXPECT_EQ(sensor.getValue(), 4095);
+	EXPECT_EQ(sensor.getMedian(), 2000);
+
+	settle(sensor, 2000, 1);
+	EXPECT_EQ(sensor.getMedian(), 2000);
+
+	settle(sensor, 3000, 2);
+	EXPECT_EQ(sensor.getMedian(), 3000);
+}
+
+TEST(MoistureSensor, UsesFilterChain)
+{
+	MoistureSensor sensor(A0, "Test", 1.5f, 3.5f);
+
+	EXPECT_STREQ(sensor.getFilter().c_str(), "exp:10");
+	EXPECT_TRUE(sensor.setFilter("hampel:5"));
+	EXPECT_FALSE(sensor.setFilter("unknown:5"));
+	EXPECT_STREQ(sensor.getFilter().c_str(), "hampel:5");
+
+	sensor.begin();
+	settle(sensor, 2500, 10);
+	settle(sensor, 4095, 1);
+
+	EXPECT_EQ(sensor.getValue(), 4095);
+	EXPECT_NEAR(sensor.getVoltage(), 2.5f, 0.01f);
+}
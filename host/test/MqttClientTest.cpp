@@ -0,0 +1,368 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MqttClientTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <vector>
+#include <Arduino.h>
+#include <Client.h>
+#include <FS.h>
+#include "MqttClient.h"
+#include "MqttPublisher.h"
+
+/// <summary>
+/// This class emulates a MQTT broker connection: the written packets are parsed, CONNECT, PUBLISH (QoS 1),
+/// and PINGREQ are answered (CONNACK, PUBACK, PINGRESP) unless acknowledgements are disabled.
+/// </summary>
+class FakeBroker : public Client
+{
+public:
+	struct Message
+	{
+		std::string Topic;										// The topic
+		std::string Payload;									// The payload
+		uint8_t Header;											// The fixed header (flags)
+	};
+
+	bool Reachable = true;										// Accepts connections
+	bool Acknowledge = true;									// Sends PUBACK
+	uint8_t ReturnCode = 0;										// The CONNACK return code
+	bool Open = false;											// The connection state
+	int Connects = 0;											// The number of TCP connects
+	std::string Connect;										// The last CONNECT packet
+	std::vector<Message> Messages;								// The received messages
+	int Pings = 0;												// The number of PINGREQ packets
+	std::string Input;											// The data sent to the client
+	std::string Output;											// The unparsed data written by the client
+
+	int connect(IPAddress ip, uint16_t port) override { return 0; }
+	int connect(const char* host, uint16_t port) override
+	{
+		Connects++;
+		Open = Reachable;
+		Input.clear();
+		Output.clear();
+		return Open ? 1 : 0;
+	}
+
+	size_t write(uint8_t c) override { return write(&c, 1); }
+	size_t write(const uint8_t* buffer, size_t size) override
+	{
+		if (!Open) return 0;
+		Output.append((const char*)buffer, size);
+		parse();
+		return size;
+	}
+
+	int available() override { return (int)Input.size(); }
+	int read() override
+	{
+		if (Input.empty()) return -1;
+		uint8_t c = Input[0];
+		Input.erase(0, 1);
+		return c;
+	}
+	int read(uint8_t* buffer, size_t size) override { return 0; }
+	int peek() override { return Input.empty() ? -1 : (uint8_t)Input[0]; }
+	void flush() override {}
+	void stop() override { Open = false; }
+	uint8_t connected() override { return Open ? 1 : 0; }
+	operator bool() override { return Open; }
+	using Print::write;
+
+private:
+	void parse()
+	{
+		while (Output.size() >= 2)
+		{
+			size_t length = 0;
+			size_t n = 1;
+			int shift = 0;
+
+			do
+			{
+				if (n >= Output.size()) return;
+				length |= (size_t)(Output[n] & 0x7F) << shift;
+				shift += 7;
+			} while (Output[n++] & 0x80);
+
+			if (Output.size() < n + length) return;
+
+			std::string body = Output.substr(n, length);
+			uint8_t header = (uint8_t)Output[0];
+			Output.erase(0, n + length);
+
+			switch (header & 0xF0)
+			{
+			case 0x10:
+				Connect = body;
+				Input += std::string("\x20\x02\x00", 3) + (char)ReturnCode;
+				break;
+
+			case 0x30:
+			{
+				size_t topicLength = ((uint8_t)body[0] << 8) | (uint8_t)body[1];
+				std::string id = body.substr(2 + topicLength, 2);
+				Messages.push_back(Message{ body.substr(2, topicLength), body.substr(4 + topicLength), header });
+				if (Acknowledge) Input += std::string("\x40\x02", 2) + id;
+				break;
+			}
+
+			case 0xC0:
+				Pings++;
+				Input += std::string("\xD0\x00", 2);
+				break;
+			}
+		}
+	}
+};
+
+static bool online = true;
+static bool isOnline() { return online; }
+
+class MqttClientTest : public ::testing::Test
+{
+protected:
+	FakeBroker broker;
+	MqttClient client = MqttClient(&broker, &isOnline);
+
+	void SetUp() override
+	{
+		Host::setTime(0);
+		online = true;
+	}
+
+	void TearDown() override
+	{
+		Host::useSystemTime();
+	}
+};
+
+TEST_F(MqttClientTest, ConnectsAndPublishes)
+{
+	client.update();
+	EXPECT_FALSE(client.isActive());
+	EXPECT_EQ(broker.Connects, 0);
+
+	client.configure("broker", 1883, "soilmonitor", "user", "secret");
+	client.update();
+	EXPECT_EQ(client.getState(), MqttClient::STATE_CONNECTING);
+	EXPECT_EQ(broker.Connect.substr(0, 10), std::string("\x00\x04MQTT\x04\xC2\x00\x3C", 10));
+	EXPECT_NE(broker.Connect.find("soilmonitor"), std::string::npos);
+	EXPECT_NE(broker.Connect.find("secret"), std::string::npos);
+
+	client.update();
+	ASSERT_TRUE(client.isConnected());
+	EXPECT_EQ(client.getConnects(), 1u);
+
+	EXPECT_TRUE(client.publish("soilmonitor/data", "[1]", 3));
+	EXPECT_TRUE(client.isBusy());
+	EXPECT_FALSE(client.publish("soilmonitor/data", "[2]", 3));
+
+	client.update();
+	EXPECT_FALSE(client.isBusy());
+	EXPECT_EQ(client.getAcknowledged(), 1u);
+	ASSERT_EQ(broker.Messages.size(), 1u);
+	EXPECT_EQ(broker.Messages[0].Topic, "soilmonitor/data");
+	EXPECT_EQ(broker.Messages[0].Payload, "[1]");
+	EXPECT_EQ(broker.Messages[0].Header, 0x32);
+}
+
+TEST_F(MqttClientTest, ConnectsWithMaximumLengthCredentials)
+{
+	std::string clientId(MqttClient::MAX_NAME_LEN, 'c');
+	std::string user(MqttClient::MAX_NAME_LEN, 'u');
+	std::string pass(MqttClient::MAX_PASS_LEN, 'p');
+
+	// Longer values are truncated to the maximum length.
+	client.configure("broker", 1883, (clientId + "x").c_str(), (user + "x").c_str(), (pass + "x").c_str());
+	client.update();
+	EXPECT_EQ(client.getState(), MqttClient::STATE_CONNECTING);
+
+	std::string expected = std::string("\x00\x04MQTT\x04\xC2\x00\x3C", 10) +
+		std::string("\x00\x20", 2) + clientId + std::string("\x00\x20", 2) + user +
+		std::string("\x00\x40", 2) + pass;
+	EXPECT_EQ(broker.Connect, expected);
+	EXPECT_EQ(broker.Connect.size(), 144u);
+
+	client.update();
+	EXPECT_TRUE(client.isConnected());
+}
+
+TEST_F(MqttClientTest, SendsKeepAlivePing)
+{
+	client.configure("broker", 1883, "soilmonitor", "", "");
+	client.update();
+	client.update();
+	ASSERT_TRUE(client.isConnected());
+	EXPECT_EQ(broker.Connect[7], '\x02');
+
+	Host::advanceTime(MqttClient::KEEP_ALIVE * 500000ULL);
+	client.update();
+	EXPECT_EQ(broker.Pings, 1);
+	client.update();
+	EXPECT_TRUE(client.isConnected());
+
+	// A missing PINGRESP drops the connection.
+	Host::advanceTime(MqttClient::KEEP_ALIVE * 500000ULL);
+	client.update();
+	broker.Input.clear();
+	Host::advanceTime(MqttClient::ACK_TIMEOUT * 1000ULL);
+	client.update();
+	EXPECT_FALSE(client.isConnected());
+}
+
+TEST_F(MqttClientTest, ReconnectsWithBackoff)
+{
+	broker.Reachable = false;
+	client.configure("broker", 1883, "soilmonitor", "", "");
+	client.update();
+	EXPECT_EQ(broker.Connects, 1);
+
+	// The first retry after RETRY_MIN, the next after twice the interval.
+	Host::advanceTime((MqttClient::RETRY_MIN - 1) * 1000ULL);
+	client.update();
+	EXPECT_EQ(broker.Connects, 1);
+	Host::advanceTime(1000);
+	client.update();
+	EXPECT_EQ(broker.Connects, 2);
+	Host::advanceTime(MqttClient::RETRY_MIN * 1000ULL);
+	client.update();
+	EXPECT_EQ(broker.Connects, 2);
+	Host::advanceTime(MqttClient::RETRY_MIN * 1000ULL);
+	client.update();
+	EXPECT_EQ(broker.Connects, 3);
+
+	// No attempt while the network is down.
+	online = false;
+	Host::advanceTime(MqttClient::RETRY_MAX * 1000ULL);
+	client.update();
+	EXPECT_EQ(broker.Connects, 3);
+
+	online = true;
+	broker.Reachable = true;
+	client.update();
+	client.update();
+	EXPECT_TRUE(client.isConnected());
+
+	// A refused connection (CONNACK return code) is closed.
+	broker.ReturnCode = 5;
+	client.stop();
+	client.update();
+	client.update();
+	EXPECT_FALSE(client.isConnected());
+	EXPECT_EQ(client.getConnects(), 1u);
+}
+
+TEST_F(MqttClientTest, ResendsUnacknowledgedMessage)
+{
+	client.configure("broker", 1883, "soilmonitor", "", "");
+	client.update();
+	client.update();
+	ASSERT_TRUE(client.isConnected());
+
+	broker.Acknowledge = false;
+	ASSERT_TRUE(client.publish("t", "m", 1));
+	Host::advanceTime(MqttClient::ACK_TIMEOUT * 1000ULL);
+	client.update();
+	EXPECT_FALSE(client.isConnected());
+	EXPECT_TRUE(client.isBusy());
+
+	broker.Acknowledge = true;
+	Host::advanceTime(MqttClient::RETRY_MIN * 1000ULL);
+	client.update();
+	client.update();
+	client.update();
+	EXPECT_TRUE(client.isConnected());
+	EXPECT_FALSE(client.isBusy());
+	ASSERT_EQ(broker.Messages.size(), 2u);
+	EXPECT_EQ(broker.Messages[1].Payload, "m");
+	EXPECT_EQ(broker.Messages[1].Header, 0x3A);
+}
+
+TEST_F(MqttClientTest, PublisherBatchesFrames)
+{
+	fs::FS fs;
+	FlashQueue queue(&fs, "/mqtt");
+	MqttPublisher publisher(&client, &queue);
+
+	client.configure("broker", 1883, "soilmonitor", "", "");
+	client.update();
+	client.update();
+	publisher.configure("soilmonitor/data", 3, 2);
+
+	EXPECT_TRUE(publisher.addFrame("{\"T\":1}", 7));
+	EXPECT_TRUE(publisher.addFrame("{\"T\":2}", 7));
+	EXPECT_TRUE(broker.Messages.empty());
+	EXPECT_TRUE(publisher.addFrame("{\"T\":3}", 7));
+
+	ASSERT_EQ(broker.Messages.size(), 1u);
+	EXPECT_EQ(broker.Messages[0].Payload, "[{\"T\":1},{\"T\":2},{\"T\":3}]");
+	EXPECT_EQ(publisher.getDirect(), 1u);
+	EXPECT_EQ(publisher.getFrames(), 3u);
+
+	std::string large(MqttPublisher::MESSAGE_SIZE, 'x');
+	EXPECT_FALSE(publisher.addFrame(large.c_str(), large.size()));
+}
+
+TEST_F(MqttClientTest, PublisherQueuesWhileOffline)
+{
+	fs::FS fs;
+	FlashQueue queue(&fs, "/mqtt");
+	MqttPublisher publisher(&client, &queue);
+
+	broker.Reachable = false;
+	client.configure("broker", 1883, "soilmonitor", "", "");
+	publisher.configure("soilmonitor/data", 1, 2);
+
+	for (int i = 0; i < 5; i++)
+	{
+		std::string frame = "{\"T\":" + std::to_string(i) + "}";
+		publisher.addFrame(frame.c_str(), frame.size());
+		client.update();
+		publisher.update();
+	}
+
+	EXPECT_EQ(queue.getCount(), 5u);
+	EXPECT_EQ(publisher.getQueued(), 5u);
+	EXPECT_TRUE(broker.Messages.empty());
+
+	// The queue is drained in order, at most two messages per second.
+	broker.Reachable = true;
+	Host::advanceTime(MqttClient::RETRY_MAX * 1000ULL);
+
+	for (int i = 0; i < 10; i++)
+	{
+		client.update();
+		publisher.update();
+	}
+
+	EXPECT_EQ(broker.Messages.size(), 2u);
+
+	for (int i = 0; i < 3; i++)
+	{
+		Host::advanceTime(1000000);
+
+		for (int j = 0; j < 10; j++)
+		{
+			client.update();
+			publisher.update();
+		}
+	}
+
+	ASSERT_EQ(broker.Messages.size(), 5u);
+	EXPECT_TRUE(queue.isEmpty());
+
+	for (int i = 0; i < 5; i++)
+	{
+		EXPECT_EQ(broker.Messages[i].Payload, "[{\"T\":" + std::to_string(i) + "}]");
+	}
+
+	// A new frame is published directly after the queue has been drained.
+	publisher.addFrame("{\"T\":5}", 7);
+	EXPECT_EQ(publisher.getDirect(), 1u);
+}
@@ -0,0 +1,62 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="NameListTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "NameList.h"
+
+TEST(NameList, ParsesCommaSeparatedNames)
+{
+	NameList list("server,ap, sta,,settings/soil,");
+
+	ASSERT_TRUE(list.isValid());
+	ASSERT_EQ(list.getCount(), 4);
+	EXPECT_STREQ(list.getName(0), "server");
+	EXPECT_STREQ(list.getName(1), "ap");
+	EXPECT_STREQ(list.getName(2), "sta");
+	EXPECT_STREQ(list.getName(3), "settings/soil");
+	EXPECT_EQ(list.getName(4), nullptr);
+
+	EXPECT_TRUE(list.contains("sta"));
+	EXPECT_FALSE(list.contains("st"));
+	EXPECT_FALSE(list.contains("Server"));
+}
+
+TEST(NameList, EmptyListSelectsAll)
+{
+	NameList none;
+	NameList null(NULL);
+	NameList blank(" , ");
+	NameList fields("Humidity,TempC");
+
+	EXPECT_TRUE(none.isEmpty());
+	EXPECT_TRUE(null.isEmpty());
+	EXPECT_TRUE(blank.isEmpty());
+	EXPECT_TRUE(blank.selects("Voltage"));
+	EXPECT_TRUE(fields.selects("TempC"));
+	EXPECT_FALSE(fields.selects("Voltage"));
+}
+
+TEST(NameList, RejectsOversizedLists)
+{
+	std::string names;
+
+	for (int i = 0; i <= NameList::MAX_NAMES; i++) names += "a,";
+
+	NameList many(names.c_str());
+	EXPECT_FALSE(many.isValid());
+	EXPECT_EQ(many.getCount(), (uint8_t)NameList::MAX_NAMES);
+
+	NameList longer(std::string(NameList::MAX_LENGTH, 'x').c_str());
+	EXPECT_FALSE(longer.isValid());
+	EXPECT_TRUE(longer.isEmpty());
+
+	// A copy refers to its own buffer.
+	NameList copy = NameList("Humidity");
+	EXPECT_STREQ(copy.getName(0), "Humidity");
+}
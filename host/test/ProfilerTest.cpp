@@ -0,0 +1,119 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="ProfilerTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "Profiler.h"
+
+TEST(Histogram, RecordsSamples)
+{
+	Histogram h;
+
+	h.record(0);
+	h.record(10);
+	h.record(1000);
+
+	EXPECT_EQ(h.Count, 3u);
+	EXPECT_EQ(h.Sum, 1010u);
+	EXPECT_EQ(h.Max, 1000u);
+	EXPECT_EQ(h.getMean(), 336u);
+	EXPECT_EQ(h.Buckets[0], 1u);
+	EXPECT_EQ(h.Buckets[4], 1u);
+	EXPECT_EQ(h.Buckets[10], 1u);
+}
+
+TEST(Histogram, ReturnsPercentileUpperBound)
+{
+	Histogram h;
+
+	for (int i = 0; i < 99; i++) h.record(100);
+	h.record(5000);
+
+	EXPECT_EQ(h.getPercentile(50), 127u);
+	EXPECT_EQ(h.getPercentile(99), 127u);
+	EXPECT_EQ(h.getPercentile(100), 5000u);
+}
+
+TEST(Histogram, LimitsPercentileToMaximum)
+{
+	Histogram h;
+
+	h.record(70);
+
+	EXPECT_EQ(h.getPercentile(99), 70u);
+}
+
+TEST(Histogram, HalvesCounts)
+{
+	Histogram h;
+
+	for (int i = 0; i < 4; i++) h.record(8);
+	h.halve();
+
+	EXPECT_EQ(h.Count, 2u);
+	EXPECT_EQ(h.Buckets[4], 2u);
+	EXPECT_EQ(h.Max, 8u);
+
+	h.reset();
+	EXPECT_EQ(h.Count, 0u);
+	EXPECT_EQ(h.getMean(), 0u);
+}
+
+TEST(Profiler, NormalizesRouteIndex)
+{
+	StringPrint out;
+
+	Profiler::reset();
+	Profiler::setRoute("/sensors/soil/3");
+	Profiler::recordRoute(100);
+	Profiler::setRoute("/sensors/soil/12");
+	Profiler::recordRoute(200);
+	Profiler::setRoute("/settings");
+	Profiler::recordRoute(300);
+	Profiler::print(out);
+
+	EXPECT_NE(out.Text.find("\"/sensors/soil/:i\":{\"Count\":2"), std::string::npos);
+	EXPECT_NE(out.Text.find("\"/settings\":{\"Count\":1"), std::string::npos);
+}
+
+TEST(Profiler, RecordsUnknownPathsAsNotFound)
+{
+	StringPrint out;
+	char path[32];
+
+	Profiler::reset();
+
+	for (int i = 0; i < Profiler::MAX_ROUTES * 2; i++)
+	{
+		snprintf(path, sizeof(path), "/scan/path%d.php", i);
+		Profiler::setRoute(path, false);
+		Profiler::recordRoute(100);
+	}
+
+	Profiler::setRoute("/data");
+	Profiler::recordRoute(200);
+	Profiler::print(out);
+
+	EXPECT_NE(out.Text.find("\"404\":{\"Count\":48"), std::string::npos);
+	EXPECT_NE(out.Text.find("\"/data\":{\"Count\":1"), std::string::npos);
+	EXPECT_EQ(out.Text.find("/scan"), std::string::npos);
+	EXPECT_EQ(out.Text.find("other"), std::string::npos);
+}
+
+TEST(Profiler, RecordsPhases)
+{
+	StringPrint out;
+
+	Profiler::reset();
+	uint32_t start = Profiler::start();
+	Profiler::lap(Profiler::PHASE_SENSORS, start);
+	Profiler::printTable(out);
+
+	EXPECT_STREQ(Profiler::getPhaseName(Profiler::PHASE_SENSORS), "Sensors");
+	EXPECT_NE(out.Text.find("Sensors"), std::string::npos);
+}
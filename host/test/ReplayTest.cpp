@@ -0,0 +1,103 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="ReplayTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <FS.h>
+#include "CaptureFile.h"
+#include "FilterStats.h"
+#include "SensorCapture.h"
+
+/// <summary>
+///  Returns a capture file with two soil samples and one temperature sample.
+/// </summary>
+static std::string createCapture(bool hex)
+{
+	fs::FS fs;
+	SensorCapture capture(&fs);
+	StringPrint output;
+
+	capture.start();
+	capture.add(0, SensorCapture::CHANNEL_TEMP, 0, 2150);
+	capture.add(0, SensorCapture::CHANNEL_SOIL, 1, 2500);
+	capture.add(1000, SensorCapture::CHANNEL_SOIL, 1, 2510);
+	capture.dump(output, hex);
+
+	return output.Text;
+}
+
+TEST(CaptureFile, ParsesBinaryCapture)
+{
+	CaptureFile file;
+	std::string error;
+
+	ASSERT_TRUE(file.parse(createCapture(false), error)) << error;
+	ASSERT_EQ(file.records().size(), 3u);
+
+	auto series = file.series();
+	ASSERT_EQ(series.size(), 2u);
+	EXPECT_EQ(series[0].Channel, SensorCapture::CHANNEL_SOIL);
+	EXPECT_EQ(series[0].Index, 1);
+	EXPECT_EQ(series[0].Values, (std::vector<int16_t>{ 2500, 2510 }));
+	EXPECT_EQ(series[0].Times, (std::vector<uint32_t>{ 0, 1000 }));
+	EXPECT_EQ(series[1].Channel, SensorCapture::CHANNEL_TEMP);
+	EXPECT_EQ(series[1].Values[0], 2150);
+}
+
+TEST(CaptureFile, ParsesHexDumpInSerialLog)
+{
+	CaptureFile file;
+	std::string error;
+	std::string log = "SoilMonitor> capture dump\r\n" + createCapture(true) + "SoilMonitor> \r\n";
+
+	ASSERT_TRUE(file.parse(log, error)) << error;
+	EXPECT_EQ(file.records().size(), 3u);
+}
+
+TEST(CaptureFile, RejectsInvalidData)
+{
+	CaptureFile file;
+	std::string error;
+
+	EXPECT_FALSE(file.parse("", error));
+	EXPECT_FALSE(file.parse("0011223344556677\n", error));
+	EXPECT_FALSE(file.load("/nonexistent/capture.bin", error));
+}
+
+TEST(FilterStats, ReturnsCenteredReference)
+{
+	auto reference = FilterStats::reference({ 1, 2, 3, 4, 5 }, 3);
+
+	EXPECT_TRUE(isnan(reference[0]));
+	EXPECT_DOUBLE_EQ(reference[1], 2.0);
+	EXPECT_DOUBLE_EQ(reference[3], 4.0);
+	EXPECT_TRUE(isnan(reference[4]));
+}
+
+TEST(FilterStats, FindsLagOfDelayedOutput)
+{
+	std::vector<double> signal;
+	std::vector<double> delayed;
+
+	for (int i = 0; i < 200; i++)
+	{
+		signal.push_back(sin(i / 10.0));
+		delayed.push_back(sin((i - 5) / 10.0));
+	}
+
+	EXPECT_EQ(FilterStats::lag(delayed, signal, 20), 5u);
+	EXPECT_NEAR(FilterStats::rms(delayed, signal, 5), 0.0, 1e-9);
+	EXPECT_GT(FilterStats::rms(delayed, signal, 0), 0.1);
+}
+
+TEST(FilterStats, CountsChanges)
+{
+	EXPECT_EQ(FilterStats::changes({ 50, 50, 51, 50, 50 }), 2u);
+	EXPECT_EQ(FilterStats::changes({}), 0u);
+}
@@ -0,0 +1,51 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="RoutesTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include "Routes.h"
+
+TEST(Routes, TablesAreSorted)
+{
+	EXPECT_TRUE(Routes::isSorted());
+}
+
+TEST(Routes, AcceptsKnownPaths)
+{
+	const char* paths[] = { "/", "/about", "/temp", "/system/trend", "/settings", "/settings/temp", "/favicon.ico",
+		"/js/bootstrap.min.js", "/css/bootstrap-grid.min.css", "/reboot", "/meta", "/batch", "/metrics", "/settings/mqtt",
+		"/settings/influx" };
+
+	for (const char* path : paths)
+	{
+		EXPECT_EQ(Routes::match(path), Routes::MATCH_ACCEPTED) << path;
+	}
+}
+
+TEST(Routes, AcceptsIndexedPaths)
+{
+	EXPECT_EQ(Routes::match("/soil/0"), Routes::MATCH_ACCEPTED);
+	EXPECT_EQ(Routes::match("/temp/5"), Routes::MATCH_ACCEPTED);
+	EXPECT_EQ(Routes::match("/settings/soil/3"), Routes::MATCH_ACCEPTED);
+	EXPECT_EQ(Routes::match("/settings/temp/1"), Routes::MATCH_ACCEPTED);
+}
+
+TEST(Routes, IgnoresMapFiles)
+{
+	EXPECT_EQ(Routes::match("/js/bootstrap.min.js.map"), Routes::MATCH_IGNORED);
+	EXPECT_EQ(Routes::match("/css/soilmonitor.min.css.map"), Routes::MATCH_IGNORED);
+}
+
+TEST(Routes, RejectsUnknownPaths)
+{
+	EXPECT_EQ(Routes::match("/unknown"), Routes::MATCH_NONE);
+	EXPECT_EQ(Routes::match(""), Routes::MATCH_NONE);
+	EXPECT_EQ(Routes::match("/settings/"), Routes::MATCH_NONE);
+	EXPECT_EQ(Routes::match("/soil"), Routes::MATCH_ACCEPTED);
+	EXPECT_EQ(Routes::match("/soilx"), Routes::MATCH_NONE);
+	EXPECT_EQ(Routes::match(NULL), Routes::MATCH_NONE);
+}
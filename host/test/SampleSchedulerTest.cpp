@@ -0,0 +1,149 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SampleSchedulerTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "SampleScheduler.h"
+
+/// <summary>
+///  Calls the scheduler once per second (update timer) and returns the number of samples taken.
+/// </summary>
+static uint32_t run(SampleScheduler& scheduler, uint32_t& now, uint32_t seconds, float value)
+{
+	uint32_t samples = scheduler.getSamples();
+
+	for (uint32_t i = 0; i < seconds; i++, now += 1000)
+	{
+		if (scheduler.isDue(now))
+		{
+			scheduler.sample(now, value);
+		}
+	}
+
+	return scheduler.getSamples() - samples;
+}
+
+TEST(SampleScheduler, LimitsIntervals)
+{
+	SampleScheduler scheduler(10.0f);
+
+	EXPECT_EQ(scheduler.getMinInterval(), (uint16_t)SampleScheduler::MIN_INTERVAL);
+	EXPECT_EQ(scheduler.getMaxInterval(), (uint16_t)SampleScheduler::MAX_INTERVAL);
+
+	scheduler.setIntervals(0, 10000);
+	EXPECT_EQ(scheduler.getMinInterval(), 1);
+	EXPECT_EQ(scheduler.getMaxInterval(), (uint16_t)SampleScheduler::MAX_LIMIT);
+
+	scheduler.setIntervals(30, 10);
+	EXPECT_EQ(scheduler.getMinInterval(), 30);
+	EXPECT_EQ(scheduler.getMaxInterval(), 30);
+
+	scheduler.setThreshold(-1.0f);
+	EXPECT_FLOAT_EQ(scheduler.getThreshold(), 0.0f);
+}
+
+TEST(SampleScheduler, BacksOffWhileStable)
+{
+	SampleScheduler scheduler(10.0f);
+	uint32_t now = 0;
+
+	scheduler.setIntervals(1, 60);
+	EXPECT_TRUE(scheduler.isDue(now));
+
+	// Samples at 0, 1, 3, 7, 15, 31, 63, 123, ... seconds.
+	EXPECT_EQ(run(scheduler, now, 64, 2000.0f), 7u);
+	EXPECT_EQ(scheduler.getInterval(), 60000u);
+	EXPECT_EQ(run(scheduler, now, 3600, 2005.0f), 60u);
+}
+
+TEST(SampleScheduler, SamplesFastWhileChanging)
+{
+	SampleScheduler scheduler(10.0f);
+	uint32_t now = 0;
+
+	run(scheduler, now, 600, 2000.0f);
+	EXPECT_EQ(scheduler.getInterval(), 60000u);
+
+	// A change is detected at the next (slow) sample, the channel is then sampled every second.
+	float value = 2000.0f;
+	uint32_t samples = scheduler.getSamples();
+
+	for (int i = 0; i < 120; i++, now += 1000)
+	{
+		if (scheduler.isDue(now))
+		{
+			value += 20.0f;
+			scheduler.sample(now, value);
+		}
+	}
+
+	EXPECT_EQ(scheduler.getInterval(), 1000u);
+	EXPECT_GE(scheduler.getSamples() - samples, 60u);
+}
+
+TEST(SampleScheduler, KeepsMinimumIntervalUntilSettled)
+{
+	SampleScheduler scheduler(10.0f);
+	uint32_t now = 0;
+
+	scheduler.sample(now, 2000.0f);
+	now += 1000;
+	scheduler.sample(now, 2000.0f, false);
+	EXPECT_EQ(scheduler.getInterval(), 1000u);
+
+	now += 1000;
+	scheduler.sample(now, 2000.0f);
+	EXPECT_EQ(scheduler.getInterval(), 2000u);
+}
+
+TEST(SampleScheduler, DetectsSlowDrift)
+{
+	SampleScheduler scheduler(10.0f);
+	uint32_t now = 0;
+	float value = 2000.0f;
+
+	run(scheduler, now, 600, value);
+	EXPECT_EQ(scheduler.getInterval(), 60000u);
+
+	// A drift of 4 per sample stays below the threshold, the accumulated change restarts the fast sampling.
+	for (int i = 0; i < 3; i++)
+	{
+		value += 4.0f;
+		now += 60000;
+		ASSERT_TRUE(scheduler.isDue(now));
+		scheduler.sample(now, value);
+	}
+
+	EXPECT_EQ(scheduler.getInterval(), 1000u);
+}
+
+TEST(SampleScheduler, ToleratesTimerJitter)
+{
+	SampleScheduler scheduler(10.0f);
+
+	scheduler.setIntervals(2, 2);
+	scheduler.sample(1005, 1.0f);
+
+	EXPECT_FALSE(scheduler.isDue(2005));
+	EXPECT_TRUE(scheduler.isDue(2998));
+
+	scheduler.reset();
+	EXPECT_TRUE(scheduler.isDue(1006));
+	EXPECT_EQ(scheduler.getInterval(), 2000u);
+}
+
+TEST(SampleScheduler, HandlesTimerOverflow)
+{
+	SampleScheduler scheduler(10.0f);
+
+	scheduler.setIntervals(1, 4);
+	scheduler.sample(0xFFFFFC18, 1.0f);
+
+	EXPECT_FALSE(scheduler.isDue(0xFFFFFE00));
+	EXPECT_TRUE(scheduler.isDue(0x000003E8));
+}
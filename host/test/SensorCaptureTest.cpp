@@ -0,0 +1,118 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SensorCaptureTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <FS.h>
+#include "SensorCapture.h"
+
+class SensorCaptureTest : public ::testing::Test
+{
+protected:
+	fs::FS fs;
+	SensorCapture capture = SensorCapture(&fs);
+
+	std::string read()
+	{
+		File f = fs.open(SensorCapture::PATH, FILE_READ);
+		std::string data(f.size(), '\0');
+		f.read((uint8_t*)&data[0], data.size());
+		return data;
+	}
+};
+
+TEST_F(SensorCaptureTest, WritesHeader)
+{
+	ASSERT_TRUE(capture.start());
+	EXPECT_TRUE(capture.isRunning());
+
+	std::string data = read();
+	ASSERT_EQ(data.size(), sizeof(SensorCapture::Header));
+	EXPECT_EQ(data.substr(0, 4), "SCAP");
+	EXPECT_EQ(capture.size(), sizeof(SensorCapture::Header));
+}
+
+TEST_F(SensorCaptureTest, BuffersRecords)
+{
+	capture.add(0, SensorCapture::CHANNEL_SOIL, 0, 1234);
+	EXPECT_EQ(capture.getRecords(), 0u);
+
+	capture.start();
+	capture.add(1000, SensorCapture::CHANNEL_SOIL, 0, 1234);
+	capture.add(1000, SensorCapture::CHANNEL_TEMP, 1, -550);
+
+	EXPECT_EQ(capture.getRecords(), 2u);
+	EXPECT_EQ(read().size(), sizeof(SensorCapture::Header));
+
+	capture.stop();
+	std::string data = read();
+	ASSERT_EQ(data.size(), sizeof(SensorCapture::Header) + 2 * sizeof(SensorCapture::Record));
+
+	SensorCapture::Record record;
+	memcpy(&record, data.data() + sizeof(SensorCapture::Header) + sizeof(record), sizeof(record));
+	EXPECT_EQ(record.Time, 1000u);
+	EXPECT_EQ(record.Channel, SensorCapture::CHANNEL_TEMP);
+	EXPECT_EQ(record.Index, 1);
+	EXPECT_EQ(record.Value, -550);
+}
+
+TEST_F(SensorCaptureTest, WritesFullBuffer)
+{
+	capture.start();
+
+	for (size_t i = 0; i < SensorCapture::BUFFER_COUNT; i++)
+	{
+		capture.add(i * 1000, SensorCapture::CHANNEL_SOIL, 0, 2000);
+	}
+
+	EXPECT_EQ(read().size(), sizeof(SensorCapture::Header) + SensorCapture::BUFFER_COUNT * sizeof(SensorCapture::Record));
+}
+
+TEST_F(SensorCaptureTest, StopsAtMaximumSize)
+{
+	size_t count = (SensorCapture::MAX_FILE_SIZE - sizeof(SensorCapture::Header)) / sizeof(SensorCapture::Record);
+
+	capture.start();
+
+	for (size_t i = 0; i < count + 10; i++)
+	{
+		capture.add(i, SensorCapture::CHANNEL_SOIL, 0, 2000);
+	}
+
+	EXPECT_FALSE(capture.isRunning());
+	EXPECT_EQ(capture.getRecords(), count);
+	EXPECT_LE(read().size(), (size_t)SensorCapture::MAX_FILE_SIZE);
+}
+
+TEST_F(SensorCaptureTest, DumpsBinaryAndHex)
+{
+	StringPrint binary;
+	StringPrint hex;
+
+	capture.start();
+	capture.add(1, SensorCapture::CHANNEL_SOIL, 2, 0x0102);
+
+	EXPECT_EQ(capture.dump(binary), sizeof(SensorCapture::Header) + sizeof(SensorCapture::Record));
+	EXPECT_EQ(binary.Text, read());
+
+	capture.dump(hex, true);
+	EXPECT_EQ(hex.Text.substr(0, 8), "53434150");
+	EXPECT_EQ(hex.Text.find("0100000000020201"), 16u);
+	EXPECT_EQ(hex.Text.back(), '\n');
+}
+
+TEST_F(SensorCaptureTest, ClearsCapture)
+{
+	capture.start();
+	capture.add(1, SensorCapture::CHANNEL_SOIL, 0, 100);
+	capture.clear();
+
+	EXPECT_FALSE(capture.isRunning());
+	EXPECT_FALSE(fs.exists(SensorCapture::PATH));
+	EXPECT_EQ(capture.size(), 0u);
+}
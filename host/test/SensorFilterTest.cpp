@@ -0,0 +1,157 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SensorFilterTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "SensorFilter.h"
+
+/// <summary>
+///  Returns the median of the last values (reference implementation, lower median).
+/// </summary>
+static int median(const std::vector<int>& values, size_t end, size_t window)
+{
+	size_t begin = (end > window) ? end - window : 0;
+	std::vector<int> sorted(values.begin() + begin, values.begin() + end);
+	std::sort(sorted.begin(), sorted.end());
+	return sorted[(sorted.size() - 1) / 2];
+}
+
+TEST(SensorFilter, ParsesChains)
+{
+	EXPECT_TRUE(SensorFilter::isValid(""));
+	EXPECT_TRUE(SensorFilter::isValid("exp:10"));
+	EXPECT_TRUE(SensorFilter::isValid("hampel:7,median:5,exp:10,avg:15"));
+	EXPECT_FALSE(SensorFilter::isValid("exp"));
+	EXPECT_FALSE(SensorFilter::isValid("exp:0"));
+	EXPECT_FALSE(SensorFilter::isValid("exp:10,"));
+	EXPECT_FALSE(SensorFilter::isValid("median:16"));
+	EXPECT_FALSE(SensorFilter::isValid("hampel:2"));
+	EXPECT_FALSE(SensorFilter::isValid("avg:5x"));
+	EXPECT_FALSE(SensorFilter::isValid("kalman:5"));
+	EXPECT_FALSE(SensorFilter::isValid("exp:1,exp:1,exp:1,exp:1,exp:1"));
+}
+
+TEST(SensorFilter, KeepsChainIfInvalid)
+{
+	SensorFilter filter;
+
+	EXPECT_STREQ(filter.getChain().c_str(), SensorFilter::DEFAULT_CHAIN);
+	EXPECT_TRUE(filter.setChain("median:5"));
+	EXPECT_FALSE(filter.setChain("median:50"));
+	EXPECT_STREQ(filter.getChain().c_str(), "median:5");
+	EXPECT_EQ(filter.getStages(), 1);
+}
+
+TEST(SensorFilter, PassesValuesWithoutStages)
+{
+	SensorFilter filter;
+
+	filter.setChain("");
+	EXPECT_EQ(filter.add(1234), 1234);
+	EXPECT_EQ(filter.add(-5), -5);
+}
+
+TEST(SensorFilter, MatchesReferenceMedian)
+{
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<int> distribution(0, 40);
+	std::vector<int> values;
+
+	for (int window : { 1, 4, 5, 15 })
+	{
+		SensorFilter filter;
+		filter.setChain("median:" + String(window));
+		values.clear();
+
+		for (int i = 0; i < 500; i++)
+		{
+			values.push_back(2000 + distribution(generator));
+			ASSERT_EQ(filter.add(values.back()), median(values, values.size(), window)) << window << " " << i;
+		}
+	}
+}
+
+TEST(SensorFilter, RejectsSpikes)
+{
+	SensorFilter filter;
+	filter.setChain("hampel:7");
+
+	for (int i = 0; i < 20; i++)
+	{
+		filter.add(2000 + (i % 3) * 10);
+	}
+
+	EXPECT_EQ(filter.add(3500), 2010);
+	EXPECT_EQ(filter.add(2020), 2020);
+	EXPECT_EQ(filter.add(500), 2010);
+	EXPECT_EQ(filter.add(2000), 2000);
+}
+
+TEST(SensorFilter, FollowsSteps)
+{
+	SensorFilter filter;
+	filter.setChain("hampel:7");
+
+	for (int i = 0; i < 20; i++)
+	{
+		filter.add(2000 + (i % 2) * 10);
+	}
+
+	int output = 0;
+
+	for (int i = 0; i < 7; i++)
+	{
+		output = filter.add(2500 + (i % 2) * 10);
+	}
+
+	EXPECT_GE(output, 2500);
+}
+
+TEST(SensorFilter, AveragesExponentially)
+{
+	SensorFilter filter;
+
+	EXPECT_EQ(filter.add(2000), 2000);
+	EXPECT_EQ(filter.add(3000), 2100);
+
+	for (int i = 0; i < 200; i++)
+	{
+		filter.add(3000);
+	}
+
+	EXPECT_EQ(filter.get(), 3000);
+}
+
+TEST(SensorFilter, AveragesWindow)
+{
+	SensorFilter filter;
+	filter.setChain("avg:4");
+
+	EXPECT_EQ(filter.add(100), 100);
+	EXPECT_EQ(filter.add(200), 150);
+	EXPECT_EQ(filter.add(300), 200);
+	EXPECT_EQ(filter.add(400), 250);
+	EXPECT_EQ(filter.add(500), 350);
+}
+
+TEST(SensorFilter, ChainsStages)
+{
+	SensorFilter filter;
+	filter.setChain("median:3,avg:2");
+
+	filter.add(100);
+	filter.add(100);
+	EXPECT_EQ(filter.add(4000), 100);
+	EXPECT_EQ(filter.add(100), 100);
+
+	filter.reset();
+	EXPECT_EQ(filter.add(700), 700);
+}
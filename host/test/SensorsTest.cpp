@@ -0,0 +1,277 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SensorsTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "Sensors.h"
+
+class SensorsTest : public ::testing::Test
+{
+protected:
+	const uint8_t address[8] = { 0x28, 0xFF, 0x64, 0x1E, 0x0F, 0x00, 0x00, 0x5A };
+
+	void SetUp() override
+	{
+		DallasTemperature::clearDevices();
+		DallasTemperature::addDevice(address, 22.5f);
+	}
+
+	void TearDown() override
+	{
+		DallasTemperature::clearDevices();
+	}
+};
+
+TEST_F(SensorsTest, UpdatesTemperatures)
+{
+	Sensors sensors;
+
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+
+	EXPECT_TRUE(sensors.TempSensors.isConnectedByIndex(0));
+	EXPECT_FALSE(sensors.TempSensors.isConnectedByIndex(1));
+	EXPECT_FLOAT_EQ(sensors.TempSensors.getTempCByIndex(0), 22.5f);
+}
+
+TEST_F(SensorsTest, SerializesAllSensors)
+{
+	Sensors sensors;
+	DynamicJsonDocument doc(8192);
+
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+	sensors.SoilSensors.begin();
+	sensors.SoilSensors.update();
+
+	String json = sensors.serialize();
+	ASSERT_FALSE(deserializeJson(doc, json.c_str()));
+
+	EXPECT_EQ(doc["SoilSensors"].size(), (size_t)SoilSensors::MAX_SENSORS);
+	EXPECT_TRUE(doc["SoilSensors"][0].containsKey("Humidity"));
+	EXPECT_FALSE(doc["SoilSensors"][0].containsKey("Name"));
+	EXPECT_TRUE(doc["TempSensors"].is<JsonArray>());
+	EXPECT_FLOAT_EQ(doc["TempSensors"][0]["TempC"].as<float>(), 22.5f);
+}
+
+TEST_F(SensorsTest, SerializesSelectedFields)
+{
+	Sensors sensors;
+	DynamicJsonDocument doc(8192);
+
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+	sensors.SoilSensors.begin();
+	sensors.SoilSensors.enableByIndex(0);
+	sensors.SoilSensors.update();
+
+	ASSERT_FALSE(deserializeJson(doc, sensors.serialize(NameList("Humidity,TempC")).c_str()));
+	EXPECT_TRUE(doc["SoilSensors"][0].containsKey("Humidity"));
+	EXPECT_FALSE(doc["SoilSensors"][0].containsKey("Voltage"));
+	EXPECT_FLOAT_EQ(doc["TempSensors"][0]["TempC"].as<float>(), 22.5f);
+	EXPECT_FALSE(doc["TempSensors"][0].containsKey("TempF"));
+
+	// The index and version of the changes are always included.
+	ASSERT_FALSE(deserializeJson(doc, sensors.serialize(0, NameList("TempC")).c_str()));
+	EXPECT_EQ(doc["TempSensors"][0]["Index"].as<int>(), 0);
+	EXPECT_TRUE(doc["TempSensors"][0].containsKey("Version"));
+	EXPECT_FALSE(doc["TempSensors"][0].containsKey("Connected"));
+	EXPECT_EQ(doc["SoilSensors"][0].size(), 2u);
+
+	ASSERT_FALSE(deserializeJson(doc, sensors.TempSensors.serialize(NameList("Name")).c_str()));
+	EXPECT_EQ(doc[0].size(), 1u);
+	EXPECT_TRUE(doc[0].containsKey("Name"));
+}
+
+TEST_F(SensorsTest, SerializesMetadata)
+{
+	Sensors sensors;
+	DynamicJsonDocument doc(4096);
+
+	sensors.TempSensors.begin();
+
+	ASSERT_FALSE(deserializeJson(doc, sensors.serializeMeta().c_str()));
+	EXPECT_EQ(doc["SoilSensors"].size(), (size_t)SoilSensors::MAX_SENSORS);
+	EXPECT_STREQ(doc["SoilSensors"][0]["Name"].as<const char*>(), "Sensor 1");
+	EXPECT_STREQ(doc["TempSensors"][0]["Address"].as<const char*>(), "28FF641EF005A");
+	EXPECT_EQ(doc["TempSensors"][0]["Resolution"].as<int>(), 12);
+	EXPECT_FALSE(doc["TempSensors"][0].containsKey("TempC"));
+}
+
+TEST_F(SensorsTest, WritesBinaryFormats)
+{
+	Sensors sensors;
+	DynamicJsonDocument doc(4096);
+	StringPrint msgpack;
+	StringPrint cbor;
+
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+
+	WireFormat packer(msgpack, WireFormat::FORMAT_MSGPACK);
+	sensors.serialize(packer);
+	ASSERT_FALSE(deserializeMsgPack(doc, msgpack.Text.data(), msgpack.Text.size()));
+	EXPECT_EQ(doc["Version"].as<uint32_t>(), sensors.getVersion());
+	EXPECT_EQ(doc["TempSensors"].size(), (size_t)TempSensors::MAX_SENSORS);
+	EXPECT_FLOAT_EQ(doc["TempSensors"][0]["TempC"].as<float>(), sensors.TempSensors.getTempCByIndex(0));
+	EXPECT_EQ(doc["SoilSensors"][0]["Enabled"].as<bool>(), sensors.SoilSensors.isEnabledByIndex(0));
+
+	WireFormat writer(cbor, WireFormat::FORMAT_CBOR);
+	sensors.serialize(writer);
+	EXPECT_EQ((uint8_t)cbor.Text[0], 0xA3);
+	EXPECT_LT(cbor.Text.size(), sensors.serialize().length() / 2);
+}
+
+TEST_F(SensorsTest, WritesMetrics)
+{
+	Sensors sensors;
+	StringPrint out;
+	MetricsWriter writer(out);
+
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+	sensors.SoilSensors.begin();
+	sensors.SoilSensors.enableByIndex(0);
+	sensors.SoilSensors.update();
+	sensors.SoilSensors.writeMetrics(writer);
+	sensors.TempSensors.writeMetrics(writer);
+
+	EXPECT_NE(out.Text.find("soilmonitor_soil_enabled{sensor=\"0\"} 1\n"), std::string::npos);
+	EXPECT_NE(out.Text.find("soilmonitor_soil_enabled{sensor=\"1\"} 0\n"), std::string::npos);
+	EXPECT_NE(out.Text.find("soilmonitor_soil_humidity_percent{sensor=\"0\"} "), std::string::npos);
+	EXPECT_EQ(out.Text.find("soilmonitor_soil_humidity_percent{sensor=\"1\"}"), std::string::npos);
+	EXPECT_NE(out.Text.find("soilmonitor_temp_celsius{sensor=\"0\"} 22.5\n"), std::string::npos);
+	EXPECT_NE(out.Text.find("# TYPE soilmonitor_temp_connected gauge\n"), std::string::npos);
+	EXPECT_EQ(writer.getSkipped(), 0);
+}
+
+TEST_F(SensorsTest, ReportsDisconnectedTemperatureSensor)
+{
+	Sensors sensors;
+	StringPrint out;
+	MetricsWriter writer(out);
+
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+	EXPECT_TRUE(sensors.TempSensors.isConnectedByIndex(0));
+
+	// The sensor reads DEVICE_DISCONNECTED_C after it has been unplugged.
+	DallasTemperature::setConnected(0, false);
+	sensors.TempSensors.update(true);
+	EXPECT_FLOAT_EQ(sensors.TempSensors.getTempCByIndex(0), (float)DEVICE_DISCONNECTED_C);
+	EXPECT_FALSE(sensors.TempSensors.isConnectedByIndex(0));
+
+	sensors.TempSensors.writeMetrics(writer);
+	EXPECT_NE(out.Text.find("soilmonitor_temp_connected{sensor=\"0\"} 0\n"), std::string::npos);
+	EXPECT_EQ(out.Text.find("soilmonitor_temp_celsius{sensor=\"0\"}"), std::string::npos);
+
+	DallasTemperature::setConnected(0, true);
+	sensors.TempSensors.update(true);
+	EXPECT_TRUE(sensors.TempSensors.isConnectedByIndex(0));
+}
+
+TEST_F(SensorsTest, SamplesStableTemperaturesLessOften)
+{
+	Sensors sensors;
+
+	Host::setTime(0);
+	sensors.TempSensors.begin();
+	sensors.TempSensors.update();
+	Host::advanceTime(1000000);
+	sensors.TempSensors.update();
+
+	// The temperature is stable, the next sample is due after two seconds.
+	DallasTemperature::setTemperature(0, 30.0f);
+	Host::advanceTime(1000000);
+	sensors.TempSensors.update();
+	EXPECT_FLOAT_EQ(sensors.TempSensors.getTempCByIndex(0), 22.5f);
+
+	Host::advanceTime(1000000);
+	sensors.TempSensors.update();
+	EXPECT_FLOAT_EQ(sensors.TempSensors.getTempCByIndex(0), 30.0f);
+
+	sensors.TempSensors.setSampling(5, 60, 1.0f);
+	EXPECT_EQ(sensors.TempSensors.getMinInterval(), 5);
+	EXPECT_EQ(sensors.TempSensors.getMaxInterval(), 60);
+	EXPECT_FLOAT_EQ(sensors.TempSensors.getThreshold(), 1.0f);
+
+	Host::useSystemTime();
+}
+
+TEST_F(SensorsTest, FollowsSoilStepAtSlowInterval)
+{
+	Sensors sensors;
+	uint8_t pin = sensors.SoilSensors.getPinByIndex(0);
+	float threshold = sensors.SoilSensors.getThresholdByIndex(0);
+
+	Host::setTime(0);
+	Host::setAnalog(pin, 2000);
+	sensors.SoilSensors.begin();
+	EXPECT_EQ(sensors.SoilSensors.getFilterByIndex(0), "exp:10");
+
+	// The value is stable, the sensor is sampled at the maximum interval.
+	for (int i = 0; i < 600; i++, Host::advanceTime(1000000))
+	{
+		sensors.SoilSensors.update();
+	}
+
+	// A step smaller than ten times the threshold is detected on the raw value median at the second slow sample,
+	// the sensor is then sampled every second until the filtered value has settled.
+	Host::setAnalog(pin, 1850);
+
+	for (int i = 0; i < 180; i++, Host::advanceTime(1000000))
+	{
+		sensors.SoilSensors.update();
+	}
+
+	EXPECT_EQ(sensors.SoilSensors.getValueByIndex(0), 1850);
+	EXPECT_NEAR(sensors.SoilSensors.getVoltageByIndex(0) * 1000.0f, 1850.0f, threshold);
+
+	Host::setAnalog(pin, 0);
+	Host::useSystemTime();
+}
+
+TEST_F(SensorsTest, ReturnsChangedSensorsOnly)
+{
+	Sensors sensors;
+	DynamicJsonDocument doc(4096);
+
+	Host::setTime(0);
+	sensors.TempSensors.begin();
+	sensors.SoilSensors.begin();
+	sensors.SoilSensors.enableByIndex(0);
+	sensors.TempSensors.update();
+	sensors.SoilSensors.update();
+
+	ASSERT_FALSE(deserializeJson(doc, sensors.serialize(0).c_str()));
+	uint32_t version = doc["Version"];
+	EXPECT_EQ(doc["TempSensors"].size(), (size_t)TempSensors::MAX_SENSORS);
+	EXPECT_EQ(doc["SoilSensors"].size(), 1u);
+
+	// Nothing changed.
+	Host::advanceTime(1000000);
+	sensors.TempSensors.update();
+	sensors.SoilSensors.update();
+	EXPECT_FALSE(sensors.isChanged(version));
+	ASSERT_FALSE(deserializeJson(doc, sensors.serialize(version).c_str()));
+	EXPECT_EQ(doc["TempSensors"].size(), 0u);
+	EXPECT_EQ(doc["SoilSensors"].size(), 0u);
+
+	DallasTemperature::setTemperature(0, 23.0f);
+	Host::advanceTime(2000000);
+	sensors.TempSensors.update();
+	sensors.SoilSensors.update();
+	ASSERT_FALSE(deserializeJson(doc, sensors.serialize(version).c_str()));
+	ASSERT_EQ(doc["TempSensors"].size(), 1u);
+	EXPECT_EQ(doc["TempSensors"][0]["Index"].as<int>(), 0);
+	EXPECT_FLOAT_EQ(doc["TempSensors"][0]["TempC"].as<float>(), 23.0f);
+	EXPECT_GT(doc["Version"].as<uint32_t>(), version);
+
+	Host::useSystemTime();
+}
@@ -0,0 +1,132 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SettingsTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include "Settings.h"
+
+/// <summary>
+///  Returns the content of the settings file shipped with the sketch (data/settings.json).
+/// </summary>
+static String readSettingsFile()
+{
+	std::ifstream file(SKETCH_DIR "/data/settings.json");
+	std::stringstream text;
+
+	text << file.rdbuf();
+	return String(text.str());
+}
+
+TEST(Settings, DeserializesSettingsFile)
+{
+	Sensors sensors;
+	Settings settings(&sensors);
+	String json = readSettingsFile();
+
+	ASSERT_GT(json.length(), 0u);
+	ASSERT_TRUE(settings.deserialize(json));
+
+	EXPECT_STREQ(settings.StaSettings.Hostname.c_str(), "soilmonitor");
+	EXPECT_TRUE(settings.StaSettings.DHCP);
+	EXPECT_STREQ(settings.CmdSettings.Prompt.c_str(), "cmd");
+	EXPECT_STREQ(settings.MqttSettings.Server.c_str(), "");
+	EXPECT_STREQ(settings.MqttSettings.Topic.c_str(), "soilmonitor");
+	EXPECT_EQ(settings.MqttSettings.Port, 1883);
+	EXPECT_STREQ(settings.InfluxSettings.Path.c_str(), "/write?db=soilmonitor&precision=s");
+	EXPECT_TRUE(settings.InfluxSettings.Gzip);
+	EXPECT_FALSE(settings.FastBoot);
+	EXPECT_STREQ(sensors.SoilSensors.getNameByIndex(0).c_str(), "Sensor 1");
+	EXPECT_FLOAT_EQ(sensors.SoilSensors.getWetValueByIndex(0), 1.76f);
+	EXPECT_FLOAT_EQ(sensors.SoilSensors.getDryValueByIndex(0), 3.4f);
+}
+
+TEST(Settings, RoundTrips)
+{
+	Sensors sensors1;
+	Sensors sensors2;
+	Settings settings1(&sensors1);
+	Settings settings2(&sensors2);
+
+	ASSERT_TRUE(settings1.deserialize(readSettingsFile()));
+	settings1.StaSettings.SSID = "network";
+	settings1.FastBoot = true;
+	settings1.MqttSettings.Server = "broker";
+	settings1.InfluxSettings.Lines = 20;
+
+	String json = settings1.serialize();
+	ASSERT_TRUE(settings2.deserialize(json));
+
+	EXPECT_STREQ(settings2.StaSettings.SSID.c_str(), "network");
+	EXPECT_TRUE(settings2.FastBoot);
+	EXPECT_STREQ(settings2.MqttSettings.Server.c_str(), "broker");
+	EXPECT_EQ(settings2.InfluxSettings.Lines, 20);
+	EXPECT_STREQ(settings2.serialize().c_str(), json.c_str());
+}
+
+TEST(Settings, WritesBinaryDocument)
+{
+	Sensors sensors;
+	Settings settings(&sensors);
+	StringPrint out;
+	WireFormat writer(out, WireFormat::FORMAT_MSGPACK);
+	DynamicJsonDocument doc(8192);
+	String expected;
+	String actual;
+
+	ASSERT_TRUE(settings.deserialize(readSettingsFile()));
+	settings.serialize(writer);
+
+	// The nested settings are written directly, the document matches the JSON document.
+	ASSERT_FALSE(deserializeJson(doc, settings.serialize()));
+	serializeJson(doc, expected);
+	ASSERT_FALSE(deserializeMsgPack(doc, out.Text.data(), out.Text.size()));
+	serializeJson(doc, actual);
+
+	EXPECT_STREQ(actual.c_str(), expected.c_str());
+	EXPECT_STREQ(doc["Mqtt"]["Topic"], "soilmonitor");
+}
+
+TEST(Settings, RejectsTooLongMqttSettings)
+{
+	MqttSettings settings;
+	String pass(std::string(MqttClient::MAX_PASS_LEN, 'p').c_str());
+
+	EXPECT_TRUE(settings.deserialize("{\"User\":\"user\",\"Pass\":\"" + pass + "\"}"));
+	EXPECT_STREQ(settings.Pass.c_str(), pass.c_str());
+
+	EXPECT_FALSE(settings.deserialize("{\"Server\":\"broker\",\"Pass\":\"" + pass + "p\"}"));
+	EXPECT_FALSE(settings.deserialize("{\"ClientId\":\"" + String(std::string(33, 'c').c_str()) + "\"}"));
+	EXPECT_STREQ(settings.Server.c_str(), "");
+	EXPECT_STREQ(settings.Pass.c_str(), pass.c_str());
+}
+
+TEST(Settings, InitializesFromFileSystem)
+{
+	Sensors sensors;
+	Settings settings(&sensors);
+	SystemInfo info;
+
+	SPIFFS.format();
+	File file = SPIFFS.open(Settings::SETTINGS_FILE, FILE_WRITE);
+	file.print(readSettingsFile());
+	file.close();
+
+	settings.init(info);
+
+	EXPECT_STREQ(settings.ApSettings.SSID.c_str(), (String("ESP32_") + info.ChipID).c_str());
+
+	Sensors stored;
+	Settings reloaded(&stored);
+	reloaded.init(info);
+
+	EXPECT_STREQ(reloaded.ApSettings.SSID.c_str(), settings.ApSettings.SSID.c_str());
+	SPIFFS.format();
+}
@@ -0,0 +1,295 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="ShimsTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <WiFi.h>
+#include <esp_wifi.h>
+#include <neotimer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+TEST(Shims, StringConversions)
+{
+	EXPECT_STREQ(String(42).c_str(), "42");
+	EXPECT_STREQ(String(-42).c_str(), "-42");
+	EXPECT_STREQ(String((uint8_t)0x0A, HEX).c_str(), "A");
+	EXPECT_STREQ(String(1.005f, 1).c_str(), "1.0");
+	EXPECT_EQ(String("123").toInt(), 123);
+
+	String text = String("/log") + String(3) + ".txt";
+	text.toUpperCase();
+	EXPECT_TRUE(text == "/LOG3.TXT");
+	EXPECT_EQ(text.substring(1, 4), String("LOG"));
+	EXPECT_EQ(text.indexOf('.'), 5);
+}
+
+TEST(Shims, PrintFormatsNumbers)
+{
+	StringPrint out;
+
+	out.print(12);
+	out.print(' ');
+	out.print(255u, HEX);
+	out.print(' ');
+	out.println(3.14159, 3);
+
+	EXPECT_EQ(out.Text, "12 FF 3.142\r\n");
+}
+
+TEST(Shims, FileSystem)
+{
+	SPIFFS.format();
+
+	File file = SPIFFS.open("/a.txt", FILE_WRITE);
+	ASSERT_TRUE(file);
+	file.print("hello");
+	file.close();
+
+	file = SPIFFS.open("/a.txt", FILE_APPEND);
+	file.print(" world");
+	file.close();
+
+	EXPECT_FALSE(SPIFFS.open("/missing.txt", FILE_READ));
+	EXPECT_TRUE(SPIFFS.rename("/a.txt", "/b.txt"));
+	EXPECT_FALSE(SPIFFS.exists("/a.txt"));
+
+	file = SPIFFS.open("/b.txt", FILE_READ);
+	EXPECT_EQ(file.size(), 11u);
+	EXPECT_TRUE(file.seek(6));
+	EXPECT_STREQ(file.readString().c_str(), "world");
+	EXPECT_FALSE(file.seek(12));
+	EXPECT_EQ(SPIFFS.usedBytes(), 11u);
+}
+
+TEST(Shims, Directory)
+{
+	SPIFFS.format();
+	SPIFFS.open("/a.txt", FILE_WRITE).print("a");
+	SPIFFS.open("/b.txt", FILE_WRITE).print("bb");
+
+	File root = SPIFFS.open("/");
+	ASSERT_TRUE(root);
+	EXPECT_TRUE(root.isDirectory());
+
+	File file = root.openNextFile();
+	EXPECT_FALSE(file.isDirectory());
+	EXPECT_STREQ(file.name(), "/a.txt");
+	file = root.openNextFile();
+	EXPECT_EQ(file.size(), 2u);
+	EXPECT_FALSE(root.openNextFile());
+}
+
+TEST(Shims, SerialInput)
+{
+	Serial.inject("help\nx");
+	EXPECT_EQ(Serial.available(), 6);
+	EXPECT_EQ(Serial.readStringUntil('\n'), String("help"));
+	EXPECT_EQ(Serial.peek(), 'x');
+	EXPECT_EQ(Serial.read(), 'x');
+	EXPECT_EQ(Serial.read(), -1);
+}
+
+TEST(Shims, IPAddress)
+{
+	IPAddress address;
+
+	EXPECT_TRUE(address.fromString("192.168.1.50"));
+	EXPECT_EQ(address.toString(), String("192.168.1.50"));
+	EXPECT_EQ(address[3], 50);
+	EXPECT_EQ(IPAddress((uint32_t)address), address);
+	EXPECT_FALSE(address.fromString("192.168.1"));
+	EXPECT_FALSE(address.fromString("192.168.1.256"));
+}
+
+TEST(Shims, Neotimer)
+{
+	Host::setTime(0);
+	Neotimer timer(100);
+
+	EXPECT_FALSE(timer.done());
+	EXPECT_FALSE(timer.repeat());
+	Host::advanceTime(100000);
+	EXPECT_TRUE(timer.repeat());
+	EXPECT_FALSE(timer.repeat());
+	timer.start();
+	Host::advanceTime(99000);
+	EXPECT_FALSE(timer.done());
+	Host::advanceTime(1000);
+	EXPECT_TRUE(timer.done());
+	Host::useSystemTime();
+}
+
+static uint32_t disconnects = 0;
+static uint8_t reason = 0;
+
+static void onEvent(system_event_id_t event, system_event_info_t info)
+{
+	if (event == SYSTEM_EVENT_STA_DISCONNECTED)
+	{
+		disconnects++;
+		reason = info.disconnected.reason;
+	}
+}
+
+TEST(Shims, WiFiConnection)
+{
+	Host::resetWiFi();
+	Host::setTime(0);
+	Host::setWiFiDelay(1000);
+	WiFi.onEvent(&onEvent);
+	disconnects = 0;
+
+	WiFi.mode(WIFI_STA);
+	WiFi.begin("SoilNet", "secret");
+	EXPECT_EQ(WiFi.status(), WL_DISCONNECTED);
+	Host::advanceTime(1000000);
+	EXPECT_TRUE(WiFi.isConnected());
+	EXPECT_EQ(WiFi.localIP().toString(), String("192.168.1.50"));
+	EXPECT_NE(WiFi.BSSID(), nullptr);
+
+	wifi_config_t config;
+	esp_wifi_get_config(WIFI_IF_STA, &config);
+	EXPECT_STREQ((const char*)config.sta.ssid, "SoilNet");
+
+	Host::dropWiFi(WIFI_REASON_BEACON_TIMEOUT);
+	EXPECT_FALSE(WiFi.isConnected());
+	EXPECT_EQ(disconnects, 1u);
+	EXPECT_EQ(reason, WIFI_REASON_BEACON_TIMEOUT);
+
+	Host::setWiFiAvailable(false);
+	WiFi.begin("SoilNet", "secret");
+	Host::advanceTime(5000000);
+	EXPECT_EQ(WiFi.status(), WL_NO_SSID_AVAIL);
+
+	EXPECT_EQ(WiFi.scanNetworks(true), WIFI_SCAN_RUNNING);
+	EXPECT_EQ(WiFi.scanComplete(), WIFI_SCAN_RUNNING);
+	Host::advanceTime(2000000);
+	EXPECT_EQ(WiFi.scanComplete(), 3);
+	EXPECT_EQ(WiFi.SSID(0), String("SoilNet"));
+	WiFi.scanDelete();
+	EXPECT_EQ(WiFi.scanComplete(), WIFI_SCAN_FAILED);
+
+	Host::resetWiFi();
+	Host::useSystemTime();
+}
+
+TEST(Shims, WiFiLoopback)
+{
+	Host::resetWiFi();
+	Host::setTime(0);
+	WiFiServer server(80);
+	server.begin();
+
+	EXPECT_FALSE(server.available());
+	std::shared_ptr<Host::Connection> connection = Host::connect(80, "GET / HTTP/1.1\r\n\r\n");
+	EXPECT_EQ(Host::getPendingConnections(), 1u);
+
+	{
+		WiFiClient client = server.available();
+		ASSERT_TRUE(client.connected());
+		EXPECT_EQ(client.readStringUntil('\r'), String("GET / HTTP/1.1"));
+		client.readString();
+
+		// Reading an empty connection advances the virtual time (read timeouts).
+		unsigned long time = millis();
+		EXPECT_EQ(client.read(), -1);
+		EXPECT_EQ(millis() - time, 1u);
+
+		client.print("HTTP/1.1 200 OK\r\n\r\n");
+		EXPECT_EQ(connection.use_count(), 2);
+	}
+
+	EXPECT_EQ(connection.use_count(), 1);
+	EXPECT_EQ(connection->Response, "HTTP/1.1 200 OK\r\n\r\n");
+	Host::useSystemTime();
+}
+
+TEST(Shims, ManualClock)
+{
+	Host::setTime(5000000);
+	EXPECT_EQ(millis(), 5000u);
+	delay(20);
+	EXPECT_EQ(millis(), 5020u);
+	Host::advanceTime(1);
+	EXPECT_EQ(micros(), 5020001u);
+	Host::useSystemTime();
+}
+
+TEST(Shims, AnalogRead)
+{
+	Host::setAnalog(A0, 1650);
+	EXPECT_EQ(analogRead(A0), 1650);
+}
+
+TEST(Shims, DallasTemperature)
+{
+	const uint8_t address[8] = { 0x28, 1, 2, 3, 4, 5, 6, 7 };
+	DeviceAddress found;
+	OneWire wire(4);
+	DallasTemperature sensors(&wire);
+
+	DallasTemperature::clearDevices();
+	DallasTemperature::addDevice(address, 21.5f);
+	sensors.begin();
+	sensors.setResolution(10);
+
+	EXPECT_EQ(sensors.getDeviceCount(), 1);
+	EXPECT_TRUE(sensors.getAddress(found, 0));
+	EXPECT_FALSE(sensors.getAddress(found, 1));
+	EXPECT_EQ(sensors.getResolution(found), 10);
+	EXPECT_EQ(sensors.getTempCByIndex(0), DEVICE_DISCONNECTED_C);
+
+	sensors.requestTemperatures();
+	EXPECT_FLOAT_EQ(sensors.getTempCByIndex(0), 21.5f);
+	EXPECT_FLOAT_EQ(sensors.getTempFByIndex(0), 70.7f);
+
+	DallasTemperature::setConnected(0, false);
+	sensors.requestTemperatures();
+	EXPECT_EQ(sensors.getTempCByIndex(0), DEVICE_DISCONNECTED_C);
+	DallasTemperature::clearDevices();
+}
+
+static void increment(void* parameter)
+{
+	SemaphoreHandle_t mutex = ((SemaphoreHandle_t*)parameter)[0];
+	int* counter = (int*)((SemaphoreHandle_t*)parameter)[1];
+
+	xSemaphoreTake(mutex, portMAX_DELAY);
+	(*counter)++;
+	xSemaphoreGive(mutex);
+	vTaskDelete(NULL);
+}
+
+TEST(Shims, TasksAndMutex)
+{
+	int counter = 0;
+	SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+	void* parameter[2] = { mutex, &counter };
+
+	ASSERT_EQ(xSemaphoreTake(mutex, 0), pdTRUE);
+	EXPECT_EQ(xSemaphoreTake(mutex, 0), pdFALSE);
+	ASSERT_EQ(xTaskCreatePinnedToCore(increment, "test", 4096, parameter, tskIDLE_PRIORITY, NULL, 0), pdPASS);
+	vTaskDelay(pdMS_TO_TICKS(20));
+	EXPECT_EQ(counter, 0);
+	xSemaphoreGive(mutex);
+
+	for (int i = 0; (i < 100) && (counter == 0); i++)
+	{
+		vTaskDelay(pdMS_TO_TICKS(5));
+	}
+
+	xSemaphoreTake(mutex, portMAX_DELAY);
+	EXPECT_EQ(counter, 1);
+	xSemaphoreGive(mutex);
+	vSemaphoreDelete(mutex);
+}
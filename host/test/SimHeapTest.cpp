@@ -0,0 +1,118 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SimHeapTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
+#include "SimHeap.h"
+
+static const size_t SIZE = 4096;
+static const size_t ALIGNMENT = SimHeap::ALIGNMENT;
+
+class SimHeapTest : public ::testing::Test
+{
+protected:
+	alignas(16) uint8_t arena[SIZE];
+	SimHeap heap;
+
+	SimHeapTest() : heap(arena, SIZE) {}
+};
+
+TEST_F(SimHeapTest, StartsWithOneFreeBlock)
+{
+	SimHeap::Stats stats = heap.getStats();
+
+	EXPECT_EQ(stats.Size, SIZE);
+	EXPECT_EQ(stats.Free, SIZE);
+	EXPECT_EQ(stats.MaxAlloc, SIZE - ALIGNMENT);
+	EXPECT_EQ(stats.FreeBlocks, 1u);
+	EXPECT_EQ(stats.Fragmentation, 0);
+}
+
+TEST_F(SimHeapTest, AllocatesAlignedBlocks)
+{
+	void* a = heap.allocate(1);
+	void* b = heap.allocate(100);
+
+	ASSERT_NE(a, nullptr);
+	ASSERT_NE(b, nullptr);
+	EXPECT_EQ((uintptr_t)a % ALIGNMENT, 0u);
+	EXPECT_EQ((uintptr_t)b % ALIGNMENT, 0u);
+	EXPECT_TRUE(heap.contains(a));
+	EXPECT_FALSE(heap.contains(&heap));
+	EXPECT_GE(heap.usable(b), 100u);
+	EXPECT_EQ(heap.getStats().Blocks, 2u);
+	EXPECT_EQ(heap.getStats().Free, SIZE - 32 - 128);
+}
+
+TEST_F(SimHeapTest, CoalescesFreedBlocks)
+{
+	void* a = heap.allocate(200);
+	void* b = heap.allocate(200);
+	void* c = heap.allocate(200);
+
+	heap.release(a);
+	heap.release(c);
+	EXPECT_EQ(heap.getStats().FreeBlocks, 2u);
+
+	heap.release(b);
+	SimHeap::Stats stats = heap.getStats();
+	EXPECT_EQ(stats.FreeBlocks, 1u);
+	EXPECT_EQ(stats.Free, SIZE);
+	EXPECT_EQ(stats.MinFree, SIZE - 3 * 224);
+}
+
+TEST_F(SimHeapTest, ReportsFragmentation)
+{
+	std::vector<void*> blocks;
+
+	for (void* p = heap.allocate(48); p != NULL; p = heap.allocate(48))
+	{
+		blocks.push_back(p);
+	}
+
+	for (size_t i = 0; i < blocks.size(); i += 2)
+	{
+		heap.release(blocks[i]);
+	}
+
+	SimHeap::Stats stats = heap.getStats();
+	EXPECT_EQ(stats.MaxAlloc, 48u);
+	EXPECT_GT(stats.Fragmentation, 90);
+	EXPECT_EQ(stats.Failures, 1u);
+	EXPECT_EQ(heap.allocate(100), nullptr);
+}
+
+TEST_F(SimHeapTest, ReallocatesBlocks)
+{
+	char* p = (char*)heap.allocate(10);
+	strcpy(p, "hello");
+
+	EXPECT_EQ(heap.reallocate(p, 16), p);
+
+	char* q = (char*)heap.reallocate(p, 1000);
+	ASSERT_NE(q, nullptr);
+	EXPECT_STREQ(q, "hello");
+	EXPECT_EQ(heap.getStats().Blocks, 1u);
+	EXPECT_EQ(heap.reallocate(q, SIZE), nullptr);
+	EXPECT_STREQ(q, "hello");
+}
+
+static size_t failed = 0;
+
+static void onFailure(size_t size)
+{
+	failed = size;
+}
+
+TEST_F(SimHeapTest, CallsFailureHook)
+{
+	heap.OnFailure = &onFailure;
+	EXPECT_EQ(heap.allocate(SIZE), nullptr);
+	EXPECT_EQ(failed, SIZE);
+}
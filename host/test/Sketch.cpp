@@ -0,0 +1,14 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Sketch.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "SystemInfo.h"
+
+/// <summary>
+/// The globals defined in the sketch (SoilMonitor3.ino) and used by the classes.
+/// </summary>
+char* SystemInfo::SOFTWARE_VERSION = "V0.0.0 host";
@@ -0,0 +1,91 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="TrafficTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include "Traffic.h"
+
+TEST(Traffic, ParsesDurations)
+{
+	uint64_t msec;
+
+	EXPECT_TRUE(Traffic::parseDuration("250", msec));
+	EXPECT_EQ(msec, 250u);
+	EXPECT_TRUE(Traffic::parseDuration("10ms", msec));
+	EXPECT_EQ(msec, 10u);
+	EXPECT_TRUE(Traffic::parseDuration("1h30m", msec));
+	EXPECT_EQ(msec, 5400000u);
+	EXPECT_TRUE(Traffic::parseDuration("1.5d", msec));
+	EXPECT_EQ(msec, 129600000u);
+	EXPECT_FALSE(Traffic::parseDuration("", msec));
+	EXPECT_FALSE(Traffic::parseDuration("5x", msec));
+	EXPECT_FALSE(Traffic::parseDuration("m", msec));
+}
+
+TEST(Traffic, ParsesScriptLines)
+{
+	Traffic traffic;
+	std::string error;
+
+	EXPECT_TRUE(traffic.add("# comment", error));
+	EXPECT_TRUE(traffic.add("   ", error));
+	EXPECT_TRUE(traffic.add("every 10s GET /data", error));
+	EXPECT_TRUE(traffic.add("at 1h POST /settings/soil/0 {\"Name\": \"Soil 1\"}", error));
+	EXPECT_TRUE(traffic.add("every 1h cmd system", error));
+	EXPECT_TRUE(traffic.add("at 2d wifi-drop", error));
+	EXPECT_TRUE(traffic.add("at 1m adc 36 2500", error));
+	EXPECT_EQ(traffic.size(), 5u);
+
+	EXPECT_FALSE(traffic.add("sometimes GET /data", error));
+	EXPECT_FALSE(traffic.add("every 0s GET /data", error));
+	EXPECT_FALSE(traffic.add("at 1s GET data", error));
+	EXPECT_FALSE(traffic.add("at 1s adc 36", error));
+	EXPECT_FALSE(traffic.add("at 1s reboot", error));
+	EXPECT_EQ(error, "unknown action 'reboot'");
+}
+
+TEST(Traffic, ReturnsDueEventsInOrder)
+{
+	Traffic traffic;
+	Traffic::Event event;
+	std::string error;
+
+	traffic.add("every 10s GET /data", error);
+	traffic.add("at 15s cmd system", error);
+
+	EXPECT_FALSE(traffic.next(9999, event));
+	ASSERT_TRUE(traffic.next(10000, event));
+	EXPECT_EQ(event.Type, Traffic::ACTION_GET);
+	EXPECT_EQ(event.Target, "/data");
+	EXPECT_FALSE(traffic.next(10000, event));
+
+	// Both events are due, the earlier first, missed periods are skipped.
+	ASSERT_TRUE(traffic.next(45000, event));
+	EXPECT_EQ(event.Type, Traffic::ACTION_COMMAND);
+	ASSERT_TRUE(traffic.next(45000, event));
+	EXPECT_EQ(event.Type, Traffic::ACTION_GET);
+	EXPECT_FALSE(traffic.next(49999, event));
+	EXPECT_TRUE(traffic.next(50000, event));
+	EXPECT_EQ(traffic.size(), 1u);
+}
+
+TEST(Traffic, BuildsRequests)
+{
+	Traffic traffic;
+	Traffic::Event event;
+	std::string error;
+
+	traffic.add("at 0 POST /save {}", error);
+	ASSERT_TRUE(traffic.next(0, event));
+
+	std::string request = Traffic::request(event);
+	EXPECT_EQ(request.substr(0, 21), "POST /save HTTP/1.1\r\n");
+	EXPECT_NE(request.find("Content-Length: 2\r\n\r\n{}"), std::string::npos);
+
+	EXPECT_EQ(Traffic::getStatus("HTTP/1.1 404 Not Found\r\n"), 404);
+	EXPECT_EQ(Traffic::getStatus(""), 0);
+}
@@ -0,0 +1,154 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WireFormatTest.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <Arduino.h>
+#include "WireFormat.h"
+#include "HeapMonitor.h"
+
+/// <summary>
+///  Returns the written bytes as a hex string (lower case).
+/// </summary>
+static std::string hex(const StringPrint& out)
+{
+	static const char digits[] = "0123456789abcdef";
+	std::string text;
+
+	for (unsigned char c : out.Text)
+	{
+		text += digits[c >> 4];
+		text += digits[c & 0x0F];
+	}
+
+	return text;
+}
+
+TEST(WireFormat, EncodesCborIntegers)
+{
+	StringPrint out;
+	WireFormat writer(out, WireFormat::FORMAT_CBOR);
+
+	// The examples of RFC 8949 (appendix A).
+	writer.writeUInt(0);
+	writer.writeUInt(23);
+	writer.writeUInt(24);
+	writer.writeUInt(1000);
+	writer.writeUInt(1000000);
+	writer.writeInt(-1);
+	writer.writeInt(-100);
+	writer.writeInt(-1000);
+
+	EXPECT_EQ(hex(out), "00" "17" "1818" "1903e8" "1a000f4240" "20" "3863" "3903e7");
+	EXPECT_EQ(writer.getSize(), out.Text.size());
+}
+
+TEST(WireFormat, EncodesCborStructures)
+{
+	StringPrint out;
+	WireFormat writer(out, WireFormat::FORMAT_CBOR);
+
+	writer.writeMap(2);
+	writer.writeString("a");
+	writer.writeUInt(1);
+	writer.writeString("b");
+	writer.writeArray(2);
+	writer.writeUInt(2);
+	writer.writeUInt(3);
+	writer.writeString("IETF");
+	writer.writeBool(true);
+	writer.writeBool(false);
+	writer.writeNull();
+
+	EXPECT_EQ(hex(out), "a26161016162820203" "6449455446" "f5" "f4" "f6");
+}
+
+TEST(WireFormat, EncodesMsgPackIntegers)
+{
+	StringPrint out;
+	WireFormat writer(out, WireFormat::FORMAT_MSGPACK);
+
+	writer.writeUInt(127);
+	writer.writeUInt(128);
+	writer.writeUInt(256);
+	writer.writeUInt(65536);
+	writer.writeInt(-1);
+	writer.writeInt(-32);
+	writer.writeInt(-33);
+	writer.writeInt(-129);
+	writer.writeInt(-40000);
+
+	EXPECT_EQ(hex(out), "7f" "cc80" "cd0100" "ce00010000" "ff" "e0" "d0df" "d1ff7f" "d2ffff63c0");
+}
+
+TEST(WireFormat, EncodesMsgPackStructures)
+{
+	StringPrint out;
+	WireFormat writer(out, WireFormat::FORMAT_MSGPACK);
+
+	writer.writeMap(1);
+	writer.writeString("a");
+	writer.writeArray(16);
+	writer.writeBool(true);
+	writer.writeNull();
+	EXPECT_EQ(hex(out), "81" "a161" "dc0010" "c3" "c0");
+
+	StringPrint text;
+	WireFormat strings(text, WireFormat::FORMAT_MSGPACK);
+	strings.writeString("0123456789012345678901234567890");
+	strings.writeString("01234567890123456789012345678901");
+	EXPECT_EQ((uint8_t)text.Text[0], 0xBF);
+	EXPECT_EQ((uint8_t)text.Text[32], 0xD9);
+	EXPECT_EQ((uint8_t)text.Text[33], 32);
+	EXPECT_EQ(strings.getSize(), 31u + 1 + 32 + 2);
+}
+
+TEST(WireFormat, EncodesFloatsCompact)
+{
+	StringPrint cbor;
+	WireFormat writer(cbor, WireFormat::FORMAT_CBOR);
+
+	writer.writeFloat(1.5);
+	writer.writeFloat(0.1f);
+	writer.writeFloat(0.1);
+	EXPECT_EQ(hex(cbor), "fa3fc00000" "fa3dcccccd" "fb3fb999999999999a");
+
+	StringPrint msgpack;
+	WireFormat packer(msgpack, WireFormat::FORMAT_MSGPACK);
+
+	packer.writeFloat(-21.5f);
+	packer.writeFloat(0.1);
+	EXPECT_EQ(hex(msgpack), "cac1ac0000" "cb3fb999999999999a");
+}
+
+TEST(WireFormat, NegotiatesFormat)
+{
+	EXPECT_EQ(WireFormat::negotiate(NULL), WireFormat::FORMAT_JSON);
+	EXPECT_EQ(WireFormat::negotiate(""), WireFormat::FORMAT_JSON);
+	EXPECT_EQ(WireFormat::negotiate("*/*"), WireFormat::FORMAT_JSON);
+	EXPECT_EQ(WireFormat::negotiate("application/json, text/plain, */*"), WireFormat::FORMAT_JSON);
+	EXPECT_EQ(WireFormat::negotiate("application/cbor"), WireFormat::FORMAT_CBOR);
+	EXPECT_EQ(WireFormat::negotiate("Application/CBOR;q=0.9"), WireFormat::FORMAT_CBOR);
+	EXPECT_EQ(WireFormat::negotiate("application/msgpack"), WireFormat::FORMAT_MSGPACK);
+	EXPECT_EQ(WireFormat::negotiate("application/x-msgpack, application/json"), WireFormat::FORMAT_MSGPACK);
+	EXPECT_EQ(WireFormat::negotiate("application/msgpack, application/cbor"), WireFormat::FORMAT_MSGPACK);
+
+	EXPECT_STREQ(WireFormat::getContentType(WireFormat::FORMAT_JSON), "application/json");
+	EXPECT_STREQ(WireFormat::getContentType(WireFormat::FORMAT_CBOR), "application/cbor");
+	EXPECT_STREQ(WireFormat::getContentType(WireFormat::FORMAT_MSGPACK), "application/msgpack");
+}
+
+TEST(WireFormat, WritesHeapTrend)
+{
+	StringPrint out;
+	WireFormat writer(out, WireFormat::FORMAT_CBOR);
+
+	HeapMonitor::writeTrend(writer);
+
+	// {"Interval": 60, "Samples": [...]}
+	EXPECT_EQ(hex(out).substr(0, 41), "a2" "68496e74657276616c" "183c" "6753616d706c6573" "8");
+}
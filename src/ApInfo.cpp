@@ -7,7 +7,8 @@
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
 #include <esp_wifi.h>
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "ApInfo.h"
 
 bool ApInfo::Active = false;
@@ -18,7 +19,7 @@ bool ApInfo::Active = false;
 /// <param name="wifi">The WiFiClass instance</param>
 ApInfo::ApInfo(WiFiClass wifi)
 {
-	Log.trace("ApInfo::ApInfo()" CR);
+	LOG_TRACE("ApInfo::ApInfo()" CR);
 	wifi_config_t config;
 	esp_wifi_get_config(WIFI_IF_AP, &config);
 	
@@ -37,9 +38,31 @@ ApInfo::ApInfo(WiFiClass wifi)
 /// <returns>The JSON string</returns>
 String ApInfo::serialize()
 {
-	Log.trace("ApInfo::serialize()" CR);
+	LOG_TRACE("ApInfo::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void ApInfo::serialize(WireFormat& writer)
+{
+	LOG_TRACE("ApInfo::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void ApInfo::build()
+{
 	_doc.clear();
 	_doc["Active"]    = ApInfo::Active;
 	_doc["SSID"]      = SSID;
@@ -49,7 +72,4 @@ String ApInfo::serialize()
 	_doc["Address"]   = Address;
 	_doc["Clients"]   = Clients;
 	_doc["MAC"]       = MAC;
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
@@ -11,6 +11,7 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <WiFi.h>
+#include "WireFormat.h"
 
 /// /// <summary>
 /// This class holds the actual WiFi access point data.
@@ -21,6 +22,7 @@ private:
 	static const int CAPACITY =					// The maximum size for the JSON document
 		JSON_OBJECT_SIZE(8) + 237;	
 	StaticJsonDocument<CAPACITY> _doc;			// The static JSON document
+	void build();								// Builds the document
 
 public:
 	ApInfo(WiFiClass wifi);						// Constructor using WiFi instance to initialize fields
@@ -35,5 +37,6 @@ public:
 	String MAC;									// The WiFi Access Point MAC address
 
 	String serialize();							// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);			// Writes a binary serialization (CBOR, MessagePack)
 };
 
@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "ApSettings.h"
 
 /// <summary>
@@ -23,7 +24,7 @@ ApSettings::ApSettings() :
 	Gateway(""),
 	Subnet(SUBNET_MASK)
 {
-	Log.trace("ApSettings::ApSettings()" CR);
+	LOG_TRACE("ApSettings::ApSettings()" CR);
 }
 
 /// <summary>
@@ -33,7 +34,7 @@ ApSettings::ApSettings() :
 /// <returns>True if successful</returns>
 bool ApSettings::deserialize(String json)
 {
-	Log.trace("ApSettings::deserialize()" CR);
+	LOG_TRACE("ApSettings::deserialize()" CR);
 
 	if (json.length() > 0)
 	{
@@ -41,7 +42,7 @@ bool ApSettings::deserialize(String json)
 
 		if (err)
 		{
-			Log.error("ApSettings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
+			LOG_ERROR("ApSettings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
 			return false;
 		}
 
@@ -57,7 +58,7 @@ bool ApSettings::deserialize(String json)
 		return true;
 	}
 
-	Log.warning("ApSettings::deserialize() Invalid JSON string" CR);
+	LOG_WARNING("ApSettings::deserialize() Invalid JSON string" CR);
 	return false;
 }
 
@@ -67,9 +68,31 @@ bool ApSettings::deserialize(String json)
 /// <returns>The JSON string</returns>
 String ApSettings::serialize()
 {
-	Log.trace("ApSettings::serialize()" CR);
+	LOG_TRACE("ApSettings::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void ApSettings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("ApSettings::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void ApSettings::build()
+{
 	_doc.clear();
 	_doc["Backup"]   = Backup;
 	_doc["SSID"]     = SSID;
@@ -79,9 +102,6 @@ String ApSettings::serialize()
 	_doc["Address"]  = Address;
 	_doc["Gateway"]  = Gateway;
 	_doc["Subnet"]   = Subnet;
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
 
 /// <summary>
@@ -89,7 +109,7 @@ String ApSettings::serialize()
 /// </summary>
 void ApSettings::reset()
 {
-	Log.trace("ApSettings::reset()" CR);
+	LOG_TRACE("ApSettings::reset()" CR);
 	Backup = true;
 	SSID = WIFI_SSID_AP;
 	PASS = "";
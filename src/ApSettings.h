@@ -10,6 +10,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "WireFormat.h"
 
 /// <summary>
 /// This class holds the WiFi access point configuration data.
@@ -22,6 +23,7 @@ private:
 	static const int CAPACITY =						// The maximum size for the JSON document
 		JSON_OBJECT_SIZE(8) + 235;	
 	StaticJsonDocument<CAPACITY> _doc;				// The static JSON document
+	void build();									// Builds the document
 
 public:	
 	const char* WIFI_SSID_AP = "ESP32";				// The default access point SSID
@@ -40,6 +42,7 @@ public:
 
 	bool deserialize(String json);					// Read a JSON string and updates the fields.
 	String serialize();								// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);				// Writes a binary serialization (CBOR, MessagePack)
 	void reset();									// Resets all settings
 };
 
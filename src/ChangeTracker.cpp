@@ -0,0 +1,183 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="ChangeTracker.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+
+#include "ChangeTracker.h"
+
+/// <summary>
+/// The global version sequence (0: nothing published since the start).
+/// </summary>
+uint32_t ChangeTracker::_sequence = 0;
+
+/// <summary>
+///  Default constructor (every change is published).
+/// </summary>
+ChangeTracker::ChangeTracker() : ChangeTracker(0.0)
+{
+}
+
+/// <summary>
+///  Constructor setting the deadband of all channels.
+/// </summary>
+/// <param name="deadband">The deadband (channel unit)</param>
+ChangeTracker::ChangeTracker(float deadband)
+{
+	for (uint8_t i = 0; i < MAX_CHANNELS; i++)
+	{
+		_channels[i].Deadband = (deadband < 0.0) ? 0.0 : deadband;
+		_channels[i].MaxSilence = MAX_SILENCE;
+	}
+
+	reset();
+}
+
+/// <summary>
+///  Returns the deadband of the specified channel.
+/// </summary>
+/// <param name="channel">The channel index</param>
+/// <returns>The deadband (channel unit)</returns>
+float ChangeTracker::getDeadband(uint8_t channel) const
+{
+	return (channel < MAX_CHANNELS) ? _channels[channel].Deadband : 0.0;
+}
+
+/// <summary>
+///  Returns the maximum silence interval of the specified channel.
+/// </summary>
+/// <param name="channel">The channel index</param>
+/// <returns>The maximum silence interval (sec)</returns>
+uint16_t ChangeTracker::getMaxSilence(uint8_t channel) const
+{
+	return (channel < MAX_CHANNELS) ? _channels[channel].MaxSilence : 0;
+}
+
+/// <summary>
+///  Sets the deadband of the specified channel (negative values are ignored).
+/// </summary>
+/// <param name="channel">The channel index</param>
+/// <param name="deadband">The deadband (channel unit)</param>
+void ChangeTracker::setDeadband(uint8_t channel, float deadband)
+{
+	if (channel < MAX_CHANNELS)
+	{
+		_channels[channel].Deadband = (deadband < 0.0) ? 0.0 : deadband;
+	}
+}
+
+/// <summary>
+///  Sets the maximum silence interval of the specified channel (0 disables the heartbeat).
+/// </summary>
+/// <param name="channel">The channel index</param>
+/// <param name="seconds">The maximum silence interval (sec)</param>
+void ChangeTracker::setMaxSilence(uint8_t channel, uint16_t seconds)
+{
+	if (channel < MAX_CHANNELS)
+	{
+		_channels[channel].MaxSilence = seconds;
+	}
+}
+
+/// <summary>
+///  Updates the value of the specified channel. The value is published (new channel version) if it is the first
+///  value, if it differs from the last published value by at least the deadband, or if the channel has been
+///  silent for the maximum silence interval.
+/// </summary>
+/// <param name="channel">The channel index</param>
+/// <param name="value">The current value</param>
+/// <param name="now">The current time (msec)</param>
+/// <returns>True if published</returns>
+bool ChangeTracker::update(uint8_t channel, float value, uint32_t now)
+{
+	if (channel >= MAX_CHANNELS)
+	{
+		return false;
+	}
+
+	Channel& data = _channels[channel];
+	bool changed = (value != data.Value) && (fabsf(value - data.Value) >= data.Deadband);
+	bool silent = (data.MaxSilence > 0) && ((now - data.Time) >= data.MaxSilence * 1000UL);
+
+	if ((data.Version != 0) && !changed && !silent)
+	{
+		_suppressed++;
+		return false;
+	}
+
+	data.Value = value;
+	data.Time = now;
+	data.Version = ++_sequence;
+	_published++;
+
+	return true;
+}
+
+/// <summary>
+///  Clears all publications, the next update of every channel is published.
+/// </summary>
+void ChangeTracker::reset()
+{
+	for (uint8_t i = 0; i < MAX_CHANNELS; i++)
+	{
+		_channels[i].Value = 0.0;
+		_channels[i].Time = 0;
+		_channels[i].Version = 0;
+	}
+}
+
+/// <summary>
+///  Returns the version of the last publication of the specified channel (0: not published).
+/// </summary>
+/// <param name="channel">The channel index</param>
+/// <returns>The channel version</returns>
+uint32_t ChangeTracker::getVersion(uint8_t channel) const
+{
+	return (channel < MAX_CHANNELS) ? _channels[channel].Version : 0;
+}
+
+/// <summary>
+///  Returns the last published value of the specified channel.
+/// </summary>
+/// <param name="channel">The channel index</param>
+/// <returns>The published value</returns>
+float ChangeTracker::getValue(uint8_t channel) const
+{
+	return (channel < MAX_CHANNELS) ? _channels[channel].Value : 0.0;
+}
+
+/// <summary>
+///  Returns true if the specified channel has been published after the version. Note that a version
+///  newer than the global sequence (e.g. seen before a reboot) is treated as zero (all channels changed).
+/// </summary>
+/// <param name="channel">The channel index</param>
+/// <param name="since">The version seen by the consumer</param>
+/// <returns>True if changed</returns>
+bool ChangeTracker::isChanged(uint8_t channel, uint32_t since) const
+{
+	if ((channel >= MAX_CHANNELS) || (_channels[channel].Version == 0))
+	{
+		return false;
+	}
+
+	return (since > _sequence) || (_channels[channel].Version > since);
+}
+
+/// <summary>
+///  Returns true if any channel has been published after the version.
+/// </summary>
+/// <param name="since">The version seen by the consumer</param>
+/// <returns>True if changed</returns>
+bool ChangeTracker::isChanged(uint32_t since) const
+{
+	for (uint8_t i = 0; i < MAX_CHANNELS; i++)
+	{
+		if (isChanged(i, since)) return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,62 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="ChangeTracker.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class implements the report-by-exception change detection of a group of sensor channels.
+/// A channel value is published if it differs from the last published value by at least the deadband,
+/// or if the channel has been silent for the maximum silence interval (heartbeat). Every publication
+/// assigns the next value of a global sequence (shared by all trackers) as the channel version, so a
+/// consumer which has seen all data up to a version only needs the channels with a newer version.
+/// </summary>
+class ChangeTracker
+{
+public:
+	static const uint8_t MAX_CHANNELS = 6;						// The maximum number of channels
+	static const uint16_t MAX_SILENCE = 300;					// The default maximum silence interval (sec)
+
+private:
+	struct Channel
+	{
+		float Deadband;											// The deadband (channel unit)
+		uint16_t MaxSilence;									// The maximum silence interval (sec, 0: none)
+		float Value;											// The last published value
+		uint32_t Time;											// The time of the last publication (msec)
+		uint32_t Version;										// The version of the last publication (0: none)
+	};
+
+	static uint32_t _sequence;									// The global version sequence
+
+	Channel _channels[MAX_CHANNELS];							// The channels
+	uint32_t _published = 0;									// The number of published values
+	uint32_t _suppressed = 0;									// The number of suppressed values
+
+public:
+	ChangeTracker();											// Default constructor (no deadband)
+	ChangeTracker(float deadband);								// Constructor setting the deadband of all channels
+
+	float getDeadband(uint8_t channel) const;					// Returns the deadband of a channel
+	uint16_t getMaxSilence(uint8_t channel) const;				// Returns the maximum silence of a channel (sec)
+	void setDeadband(uint8_t channel, float deadband);			// Sets the deadband of a channel
+	void setMaxSilence(uint8_t channel, uint16_t seconds);		// Sets the maximum silence of a channel (sec)
+
+	bool update(uint8_t channel, float value, uint32_t now);	// Updates a channel value, returns true if published
+	void reset();												// Clears all publications (all channels are published)
+
+	uint32_t getVersion(uint8_t channel) const;					// Returns the version of a channel
+	float getValue(uint8_t channel) const;						// Returns the last published value of a channel
+	bool isChanged(uint8_t channel, uint32_t since) const;		// Returns true if published after the version
+	bool isChanged(uint32_t since) const;						// Returns true if any channel has been published
+	uint32_t getPublished() const { return _published; }		// Returns the number of published values
+	uint32_t getSuppressed() const { return _suppressed; }		// Returns the number of suppressed values
+
+	static uint32_t getSequence() { return _sequence; }			// Returns the current global version
+};
@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "CmdSettings.h"
 
 /// <summary>
@@ -22,7 +23,7 @@ CmdSettings::CmdSettings() :
 	ErrorMessages(true),
 	CommandPrompt(true)
 {
-	Log.trace("CmdSettings::CmdSettings()" CR);
+	LOG_TRACE("CmdSettings::CmdSettings()" CR);
 }
 
 /// <summary>
@@ -32,7 +33,7 @@ CmdSettings::CmdSettings() :
 /// <returns>True if successful</returns>
 bool CmdSettings::deserialize(String json)
 {
-	Log.trace("CmdSettings::deserialize()" CR);
+	LOG_TRACE("CmdSettings::deserialize()" CR);
 
 	if (json.length() > 0)
 	{
@@ -40,7 +41,7 @@ bool CmdSettings::deserialize(String json)
 
 		if (err)
 		{
-			Log.error("CmdSettings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
+			LOG_ERROR("CmdSettings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
 			return false;
 		}
 
@@ -56,7 +57,7 @@ bool CmdSettings::deserialize(String json)
 		return true;
 	}
 
-	Log.warning("CmdSettings::deserialize() Invalid JSON string" CR);
+	LOG_WARNING("CmdSettings::deserialize() Invalid JSON string" CR);
 	return false;
 }
 
@@ -66,9 +67,31 @@ bool CmdSettings::deserialize(String json)
 /// <returns>The JSON string</returns>
 String CmdSettings::serialize()
 {
-	Log.trace("CmdSettings::serialize()" CR);
+	LOG_TRACE("CmdSettings::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void CmdSettings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("CmdSettings::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void CmdSettings::build()
+{
 	_doc.clear();
 	_doc["Prompt"]        = Prompt;
 	_doc["PassPhrase"]    = PassPhrase;
@@ -78,9 +101,6 @@ String CmdSettings::serialize()
 	_doc["Locked"]        = Locked;
 	_doc["ErrorMessages"] = ErrorMessages;
 	_doc["CommandPrompt"] = CommandPrompt;
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
 
 /// <summary>
@@ -88,7 +108,7 @@ String CmdSettings::serialize()
 /// </summary>
 void CmdSettings::reset()
 {
-	Log.trace("CmdSettings::reset()" CR);
+	LOG_TRACE("CmdSettings::reset()" CR);
 
 	Prompt = CMDR_PROMPT;
 	PassPhrase = "";
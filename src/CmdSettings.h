@@ -10,6 +10,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "WireFormat.h"
 
 /// <summary>
 /// This class holds the commander configuration data.
@@ -23,6 +24,7 @@ private:
 	static const int CAPACITY =					// The maximum size for the JSON document
 		JSON_OBJECT_SIZE(8) + 216;				
 	StaticJsonDocument<CAPACITY> _doc;			// The static JSON document
+	void build();								// Builds the document
 
 public:
 	const char* BT_LOCAL_NAME = "ESP32";		// The default bluetooth name
@@ -40,6 +42,7 @@ public:
 
 	bool deserialize(String json);				// Read a JSON string and updates the fields
 	String serialize();							// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);			// Writes a binary serialization (CBOR, MessagePack)
 	void reset();								// Resets all settings
 };
 
@@ -0,0 +1,659 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="CoapServer.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string.h>
+
+#include "CoapServer.h"
+
+/// <summary>
+/// The message types, codes, options, and content formats (RFC 7252, 12 and RFC 7641, 2).
+/// </summary>
+static const uint8_t TYPE_CON = 0;
+static const uint8_t TYPE_NON = 1;
+static const uint8_t TYPE_ACK = 2;
+static const uint8_t TYPE_RST = 3;
+
+static const uint8_t CODE_EMPTY = 0x00;
+static const uint8_t CODE_GET = 0x01;
+static const uint8_t CODE_CONTENT = 0x45;					// 2.05
+static const uint8_t CODE_BAD_REQUEST = 0x80;				// 4.00
+static const uint8_t CODE_BAD_OPTION = 0x82;				// 4.02
+static const uint8_t CODE_NOT_FOUND = 0x84;					// 4.04
+static const uint8_t CODE_NOT_ALLOWED = 0x85;				// 4.05
+static const uint8_t CODE_NOT_ACCEPTABLE = 0x86;			// 4.06
+static const uint8_t CODE_SERVER_ERROR = 0xA0;				// 5.00
+
+static const uint16_t OPTION_URI_HOST = 3;
+static const uint16_t OPTION_OBSERVE = 6;
+static const uint16_t OPTION_URI_PORT = 7;
+static const uint16_t OPTION_URI_PATH = 11;
+static const uint16_t OPTION_CONTENT_FORMAT = 12;
+static const uint16_t OPTION_URI_QUERY = 15;
+static const uint16_t OPTION_ACCEPT = 17;
+
+static const long FORMAT_LINKS = 40;						// application/link-format
+static const long FORMAT_CBOR = 60;							// application/cbor
+
+static const uint8_t PAYLOAD_MARKER = 0xFF;
+
+/// <summary>
+///  Reads the extended option delta or length (nibble 13: one byte, 14: two bytes, 15: invalid).
+/// </summary>
+/// <param name="data">The message</param>
+/// <param name="size">The message size</param>
+/// <param name="position">The read position (updated)</param>
+/// <param name="value">The nibble value (updated)</param>
+/// <returns>True if valid</returns>
+static bool readExtended(const uint8_t* data, size_t size, size_t& position, uint16_t& value)
+{
+	if (value == 13)
+	{
+		if (position + 1 > size) return false;
+		value = 13 + data[position];
+		position += 1;
+	}
+	else if (value == 14)
+	{
+		if (position + 2 > size) return false;
+		value = 269 + ((data[position] << 8) | data[position + 1]);
+		position += 2;
+	}
+	else if (value == 15)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/// <summary>
+///  Returns the value of an unsigned integer option (big endian, max. 4 bytes).
+/// </summary>
+/// <param name="value">The option value</param>
+/// <param name="length">The option length</param>
+/// <returns>The value</returns>
+static long readUInt(const uint8_t* value, uint16_t length)
+{
+	uint32_t result = 0;
+
+	for (uint16_t i = 0; (i < length) && (i < 4); i++)
+	{
+		result = (result << 8) | value[i];
+	}
+
+	return (long)(result & 0x7FFFFFFF);
+}
+
+/// <summary>
+///  Writes an unsigned integer option (smallest length, the delta has to be below 13).
+/// </summary>
+/// <param name="out">The output buffer</param>
+/// <param name="delta">The option number delta</param>
+/// <param name="value">The value (max. 3 bytes)</param>
+/// <returns>The number of bytes written</returns>
+static size_t writeUInt(uint8_t* out, uint16_t delta, uint32_t value)
+{
+	uint8_t length = (value == 0) ? 0 : (value <= 0xFF) ? 1 : (value <= 0xFFFF) ? 2 : 3;
+
+	out[0] = (uint8_t)((delta << 4) | length);
+
+	for (uint8_t i = 0; i < length; i++)
+	{
+		out[1 + i] = (uint8_t)(value >> (8 * (length - 1 - i)));
+	}
+
+	return 1 + length;
+}
+
+/// <summary>
+///  Writes a byte to the payload buffer.
+/// </summary>
+/// <param name="c">The byte</param>
+/// <returns>The number of bytes written (0: full)</returns>
+size_t CoapServer::Payload::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+/// <summary>
+///  Writes bytes to the payload buffer (the overflow flag is set if they do not fit).
+/// </summary>
+/// <param name="buffer">The bytes</param>
+/// <param name="size">The number of bytes</param>
+/// <returns>The number of bytes written</returns>
+size_t CoapServer::Payload::write(const uint8_t* buffer, size_t size)
+{
+	if (Length + size > PAYLOAD_SIZE)
+	{
+		Overflow = true;
+		size = PAYLOAD_SIZE - Length;
+	}
+
+	memcpy(Data + Length, buffer, size);
+	Length += size;
+	return size;
+}
+
+/// <summary>
+///  Constructor using a UDP instance, a function checking the network, and the resource functions.
+/// </summary>
+/// <param name="udp">Pointer to the UDP instance</param>
+/// <param name="connected">Function returning true if the network is up</param>
+/// <param name="resources">The resource functions</param>
+CoapServer::CoapServer(UDP* udp, bool (*connected)(), const Resources& resources) :
+	_udp(udp),
+	_connected(connected),
+	_resources(resources),
+	_started(false),
+	_messageId(0),
+	_sequence(0),
+	_requests(0),
+	_notifications(0),
+	_errors(0)
+{
+	_payload.Length = 0;
+	_payload.Overflow = false;
+	clear();
+}
+
+/// <summary>
+///  Returns the observer registered with the token by the client endpoint.
+/// </summary>
+/// <param name="address">The client address</param>
+/// <param name="port">The client port</param>
+/// <param name="token">The token</param>
+/// <param name="tokenLength">The token length</param>
+/// <returns>The observer (NULL if not registered)</returns>
+CoapServer::Observer* CoapServer::find(uint32_t address, uint16_t port, const uint8_t* token, uint8_t tokenLength)
+{
+	for (uint8_t i = 0; i < MAX_OBSERVERS; i++)
+	{
+		Observer& observer = _observers[i];
+
+		if ((observer.Resource != FREE) && (observer.Address == address) && (observer.Port == port) &&
+			(observer.TokenLength == tokenLength) && (memcmp(observer.Token, token, tokenLength) == 0))
+		{
+			return &observer;
+		}
+	}
+
+	return NULL;
+}
+
+/// <summary>
+///  Removes an observer (the table entry is freed).
+/// </summary>
+/// <param name="observer">The observer</param>
+void CoapServer::remove(Observer* observer)
+{
+	observer->Resource = FREE;
+	observer->Attempts = 0;
+}
+
+/// <summary>
+///  Removes all observers.
+/// </summary>
+void CoapServer::clear()
+{
+	for (uint8_t i = 0; i < MAX_OBSERVERS; i++)
+	{
+		remove(&_observers[i]);
+	}
+}
+
+/// <summary>
+///  Returns the number of registered observers.
+/// </summary>
+/// <returns>The number of observers</returns>
+uint8_t CoapServer::getObservers() const
+{
+	uint8_t count = 0;
+
+	for (uint8_t i = 0; i < MAX_OBSERVERS; i++)
+	{
+		if (_observers[i].Resource != FREE) count++;
+	}
+
+	return count;
+}
+
+/// <summary>
+///  Writes a resource to the payload buffer (CBOR).
+/// </summary>
+/// <param name="resource">The resource id</param>
+/// <returns>True if the representation fits</returns>
+bool CoapServer::render(uint8_t resource)
+{
+	_payload.Length = 0;
+	_payload.Overflow = false;
+
+	WireFormat writer(_payload, WireFormat::FORMAT_CBOR);
+	_resources.write(resource, writer);
+
+	return !_payload.Overflow;
+}
+
+/// <summary>
+///  Sends a message: header, token, options (Observe and Content-Format if not negative), and the payload buffer.
+/// </summary>
+/// <param name="address">The client address</param>
+/// <param name="port">The client port</param>
+/// <param name="type">The message type</param>
+/// <param name="code">The response code</param>
+/// <param name="messageId">The message id</param>
+/// <param name="token">The token</param>
+/// <param name="tokenLength">The token length</param>
+/// <param name="observe">The Observe option value (negative: none)</param>
+/// <param name="format">The Content-Format option value (negative: none)</param>
+void CoapServer::send(uint32_t address, uint16_t port, uint8_t type, uint8_t code, uint16_t messageId,
+	const uint8_t* token, uint8_t tokenLength, long observe, long format)
+{
+	uint8_t header[4 + MAX_TOKEN_LEN + 4 + 2 + 1];
+	uint16_t number = 0;
+	size_t n = 0;
+
+	header[n++] = (uint8_t)(0x40 | (type << 4) | tokenLength);
+	header[n++] = code;
+	header[n++] = (uint8_t)(messageId >> 8);
+	header[n++] = (uint8_t)messageId;
+	memcpy(header + n, token, tokenLength);
+	n += tokenLength;
+
+	if (observe >= 0)
+	{
+		n += writeUInt(header + n, OPTION_OBSERVE - number, (uint32_t)observe & 0xFFFFFF);
+		number = OPTION_OBSERVE;
+	}
+
+	if (format >= 0)
+	{
+		n += writeUInt(header + n, OPTION_CONTENT_FORMAT - number, (uint32_t)format);
+	}
+
+	if (_payload.Length > 0)
+	{
+		header[n++] = PAYLOAD_MARKER;
+	}
+
+	if (_udp->beginPacket(IPAddress(address), port))
+	{
+		_udp->write(header, n);
+		_udp->write(_payload.Data, _payload.Length);
+		_udp->endPacket();
+	}
+}
+
+/// <summary>
+///  Processes a received message: acknowledgements and resets of notifications, pings, and requests.
+///  The options are parsed (Uri-Path, Observe, Accept), unknown critical options are rejected.
+/// </summary>
+/// <param name="size">The message size</param>
+/// <param name="address">The client address</param>
+/// <param name="port">The client port</param>
+void CoapServer::receive(size_t size, uint32_t address, uint16_t port)
+{
+	const uint8_t* data = _request;
+
+	// Not a CoAP message (ignored).
+	if ((size < 4) || ((data[0] >> 6) != 1))
+	{
+		_errors++;
+		return;
+	}
+
+	uint8_t type = (data[0] >> 4) & 0x03;
+	uint8_t tokenLength = data[0] & 0x0F;
+	uint8_t code = data[1];
+	uint16_t messageId = (uint16_t)((data[2] << 8) | data[3]);
+	const uint8_t* token = data + 4;
+
+	// Acknowledgement or reset of a notification.
+	if ((type == TYPE_ACK) || (type == TYPE_RST))
+	{
+		for (uint8_t i = 0; i < MAX_OBSERVERS; i++)
+		{
+			Observer& observer = _observers[i];
+
+			if ((observer.Resource == FREE) || (observer.Address != address) || (observer.Port != port) ||
+				(observer.MessageId != messageId))
+			{
+				continue;
+			}
+
+			if (type == TYPE_RST)
+			{
+				remove(&observer);
+			}
+			else if (observer.Attempts > 0)
+			{
+				observer.Attempts = 0;
+				observer.Time = millis();
+			}
+		}
+
+		return;
+	}
+
+	_payload.Length = 0;
+
+	// Message format error, empty message (ping), or not a request: reset if confirmable.
+	if ((tokenLength > MAX_TOKEN_LEN) || ((size_t)(4 + tokenLength) > size) || (code == CODE_EMPTY) || ((code >> 5) != 0))
+	{
+		if (code != CODE_EMPTY) _errors++;
+		if (type == TYPE_CON) send(address, port, TYPE_RST, CODE_EMPTY, messageId, NULL, 0, -1, -1);
+		return;
+	}
+
+	char path[MAX_PATH_LEN + 1];
+	size_t pathLength = 0;
+	long observe = -1;
+	long accept = -1;
+	uint8_t error = 0;
+	uint16_t number = 0;
+	size_t position = 4 + tokenLength;
+
+	while ((position < size) && (data[position] != PAYLOAD_MARKER))
+	{
+		uint16_t delta = data[position] >> 4;
+		uint16_t length = data[position] & 0x0F;
+		position++;
+
+		if (!readExtended(data, size, position, delta) || !readExtended(data, size, position, length) ||
+			(position + length > size))
+		{
+			error = CODE_BAD_REQUEST;
+			break;
+		}
+
+		const uint8_t* value = data + position;
+		number += delta;
+		position += length;
+
+		switch (number)
+		{
+		case OPTION_OBSERVE:
+			observe = readUInt(value, length);
+			break;
+
+		case OPTION_ACCEPT:
+			accept = readUInt(value, length);
+			break;
+
+		case OPTION_URI_PATH:
+			if (pathLength + 1 + length > MAX_PATH_LEN)
+			{
+				error = CODE_NOT_FOUND;
+				break;
+			}
+
+			if (pathLength > 0) path[pathLength++] = '/';
+			memcpy(path + pathLength, value, length);
+			pathLength += length;
+			break;
+
+		case OPTION_URI_HOST:
+		case OPTION_URI_PORT:
+		case OPTION_URI_QUERY:
+			break;
+
+		default:
+			// Unknown critical options (odd numbers) are rejected, elective options are ignored.
+			if ((number & 1) && (error == 0)) error = CODE_BAD_OPTION;
+			break;
+		}
+	}
+
+	path[pathLength] = '\0';
+
+	uint8_t replyType = (type == TYPE_CON) ? TYPE_ACK : TYPE_NON;
+	uint16_t replyId = (type == TYPE_CON) ? messageId : ++_messageId;
+
+	if ((error == 0) && (code != CODE_GET))
+	{
+		error = CODE_NOT_ALLOWED;
+	}
+
+	if (error != 0)
+	{
+		_errors++;
+		send(address, port, replyType, error, replyId, token, tokenLength, -1, -1);
+		return;
+	}
+
+	respond(address, port, replyType, replyId, token, tokenLength, path, observe, accept);
+}
+
+/// <summary>
+///  Processes a GET request: returns the resource (CBOR) or the resource links, and registers (Observe 0) or
+///  deregisters (Observe 1 or no Observe option) the observer of the token.
+/// </summary>
+/// <param name="address">The client address</param>
+/// <param name="port">The client port</param>
+/// <param name="type">The response type (ACK or NON)</param>
+/// <param name="messageId">The response message id</param>
+/// <param name="token">The token</param>
+/// <param name="tokenLength">The token length</param>
+/// <param name="path">The resource path (without leading slash)</param>
+/// <param name="observe">The Observe option value (negative: none)</param>
+/// <param name="accept">The Accept option value (negative: none)</param>
+void CoapServer::respond(uint32_t address, uint16_t port, uint8_t type, uint16_t messageId,
+	const uint8_t* token, uint8_t tokenLength, const char* path, long observe, long accept)
+{
+	_requests++;
+
+	if (strcmp(path, ".well-known/core") == 0)
+	{
+		_payload.print(_resources.links);
+		send(address, port, type, CODE_CONTENT, messageId, token, tokenLength, -1, FORMAT_LINKS);
+		return;
+	}
+
+	int resource = _resources.find(path);
+	uint8_t error = 0;
+
+	if ((resource < 0) || (resource >= FREE))
+	{
+		error = CODE_NOT_FOUND;
+	}
+	else if ((accept >= 0) && (accept != FORMAT_CBOR))
+	{
+		error = CODE_NOT_ACCEPTABLE;
+	}
+
+	Observer* observer = find(address, port, token, tokenLength);
+
+	if (error != 0)
+	{
+		if (observer != NULL) remove(observer);
+		_errors++;
+		send(address, port, type, error, messageId, token, tokenLength, -1, -1);
+		return;
+	}
+
+	uint32_t version = _resources.getVersion((uint8_t)resource);
+
+	if (observe == 0)
+	{
+		// A new registration uses a free entry, the existing registration of the token is replaced.
+		for (uint8_t i = 0; (i < MAX_OBSERVERS) && (observer == NULL); i++)
+		{
+			if (_observers[i].Resource == FREE) observer = &_observers[i];
+		}
+
+		if (observer != NULL)
+		{
+			observer->Address = address;
+			observer->Port = port;
+			observer->MessageId = messageId;
+			observer->Version = version;
+			observer->Time = millis();
+			memcpy(observer->Token, token, tokenLength);
+			observer->TokenLength = tokenLength;
+			observer->Resource = (uint8_t)resource;
+			observer->Attempts = 0;
+		}
+	}
+	else if (observer != NULL)
+	{
+		remove(observer);
+		observer = NULL;
+	}
+
+	if (!render((uint8_t)resource))
+	{
+		if (observer != NULL) remove(observer);
+		_errors++;
+		_payload.Length = 0;
+		send(address, port, type, CODE_SERVER_ERROR, messageId, token, tokenLength, -1, -1);
+		return;
+	}
+
+	send(address, port, type, CODE_CONTENT, messageId, token, tokenLength,
+		(observer != NULL) ? (long)(++_sequence & 0xFFFFFF) : -1, FORMAT_CBOR);
+}
+
+/// <summary>
+///  Returns true if a notification is due: the resource version changed, or the acknowledgement timeout of the
+///  pending confirmable notification elapsed (doubled for every transmission).
+/// </summary>
+/// <param name="observer">The observer</param>
+/// <param name="now">The actual time (msec)</param>
+/// <returns>True if due</returns>
+bool CoapServer::isDue(const Observer& observer, uint32_t now)
+{
+	if (observer.Resource == FREE)
+	{
+		return false;
+	}
+
+	if (observer.Attempts > 0)
+	{
+		return (now - observer.Time) >= (ACK_TIMEOUT << (observer.Attempts - 1));
+	}
+
+	return _resources.getVersion(observer.Resource) != observer.Version;
+}
+
+/// <summary>
+///  Sends the due notifications. The representation of a resource is written once for all due observers.
+///  A notification is confirmable if the last confirmation is older than CONFIRM_INTERVAL or a confirmable
+///  notification is pending (retransmission with the actual representation), the observer is removed after
+///  MAX_ATTEMPTS transmissions without acknowledgement.
+/// </summary>
+void CoapServer::notify()
+{
+	uint32_t now = millis();
+
+	for (uint8_t i = 0; i < MAX_OBSERVERS; i++)
+	{
+		if (!isDue(_observers[i], now))
+		{
+			continue;
+		}
+
+		uint8_t resource = _observers[i].Resource;
+		uint32_t version = _resources.getVersion(resource);
+		bool rendered = render(resource);
+
+		for (uint8_t j = i; j < MAX_OBSERVERS; j++)
+		{
+			Observer& observer = _observers[j];
+
+			if ((observer.Resource != resource) || !isDue(observer, now))
+			{
+				continue;
+			}
+
+			if (observer.Attempts >= MAX_ATTEMPTS)
+			{
+				remove(&observer);
+				continue;
+			}
+
+			observer.Version = version;
+
+			// The representation does not fit (skipped until the next change).
+			if (!rendered)
+			{
+				observer.Attempts = 0;
+				continue;
+			}
+
+			bool confirm = (observer.Attempts > 0) || ((now - observer.Time) >= CONFIRM_INTERVAL);
+			observer.MessageId = ++_messageId;
+
+			if (confirm)
+			{
+				observer.Attempts++;
+				observer.Time = now;
+			}
+
+			send(observer.Address, observer.Port, confirm ? TYPE_CON : TYPE_NON, CODE_CONTENT, observer.MessageId,
+				observer.Token, observer.TokenLength, (long)(++_sequence & 0xFFFFFF), FORMAT_CBOR);
+			_notifications++;
+		}
+	}
+}
+
+/// <summary>
+///  Processes the received requests (MAX_REQUESTS per call) and sends the due notifications. The socket is opened
+///  if the network is up (closed if the network is down). Oversized requests are dropped.
+/// </summary>
+void CoapServer::update()
+{
+	if (!_connected())
+	{
+		stop();
+		return;
+	}
+
+	if (!_started)
+	{
+		_started = (_udp->begin(PORT) != 0);
+
+		if (!_started)
+		{
+			return;
+		}
+	}
+
+	for (uint8_t i = 0; i < MAX_REQUESTS; i++)
+	{
+		int size = _udp->parsePacket();
+
+		if (size <= 0)
+		{
+			break;
+		}
+
+		uint32_t address = _udp->remoteIP();
+		uint16_t port = _udp->remotePort();
+
+		if (((size_t)size > REQUEST_SIZE) || (_udp->read(_request, size) != size))
+		{
+			_errors++;
+			continue;
+		}
+
+		receive(size, address, port);
+	}
+
+	notify();
+}
+
+/// <summary>
+///  Closes the socket (the observers are kept).
+/// </summary>
+void CoapServer::stop()
+{
+	if (_started)
+	{
+		_udp->stop();
+		_started = false;
+	}
+}
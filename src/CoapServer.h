@@ -0,0 +1,129 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="CoapServer.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <Udp.h>
+
+#include "WireFormat.h"
+
+/// <summary>
+/// This class implements a read only CoAP server (RFC 7252) with Observe (RFC 7641) on UDP.
+///
+/// GET requests are answered with the CBOR representation of a resource (piggybacked in the ACK of a confirmable
+/// request), the resources are provided by the application (path lookup, version, and CBOR writer functions).
+/// A client registers as an observer using the Observe option, a notification is sent when the version of the
+/// resource changes. The representation is written once and sent to all observers of the resource. Notifications
+/// are non-confirmable, a confirmable notification is sent at least every CONFIRM_INTERVAL: if it is not acknowledged
+/// (retransmitted with exponential backoff) or rejected (reset), the observer is removed. The observers are kept in
+/// a fixed table (an entry holds the endpoint, the token, and the notification state), if the table is full the
+/// request is answered without registration (the client falls back to polling).
+/// </summary>
+class CoapServer
+{
+public:
+	static const uint16_t PORT = 5683;							// The default CoAP port
+	static const size_t REQUEST_SIZE = 256;						// The maximum request size
+	static const size_t PAYLOAD_SIZE = 1024;					// The maximum response payload size
+	static const uint8_t MAX_OBSERVERS = 32;					// The maximum number of observers
+	static const uint8_t MAX_TOKEN_LEN = 8;						// The maximum token length
+	static const size_t MAX_PATH_LEN = 31;						// The maximum length of the resource path
+	static const uint8_t MAX_REQUESTS = 4;						// The maximum number of requests per update
+	static const uint8_t MAX_ATTEMPTS = 4;						// The maximum number of confirmable transmissions
+	static const uint32_t ACK_TIMEOUT = 2000;					// The initial acknowledgement timeout (msec)
+	static const uint32_t CONFIRM_INTERVAL = 60000;				// The maximum time (msec) between confirmations
+
+	/// <summary>
+	/// The resources provided by the application (the resource id is returned by the path lookup).
+	/// </summary>
+	struct Resources
+	{
+		int (*find)(const char* path);							// Returns the resource id of a path (-1: not found)
+		uint32_t (*getVersion)(uint8_t resource);				// Returns the version (changes notify the observers)
+		void (*write)(uint8_t resource, WireFormat& writer);	// Writes the resource (CBOR)
+		const char* links;										// The resource links (/.well-known/core)
+	};
+
+private:
+	/// <summary>
+	/// The observer table entry (28 bytes).
+	/// </summary>
+	struct Observer
+	{
+		uint32_t Address;										// The client IPv4 address
+		uint16_t Port;											// The client UDP port
+		uint16_t MessageId;										// The message id of the last notification
+		uint32_t Version;										// The last notified version
+		uint32_t Time;											// The time of the confirmation (or pending transmission)
+		uint8_t Token[MAX_TOKEN_LEN];							// The token of the registration
+		uint8_t TokenLength;									// The token length
+		uint8_t Resource;										// The resource id (FREE: unused entry)
+		uint8_t Attempts;										// The transmissions of the pending confirmable notification
+	};
+
+	/// <summary>
+	/// This class writes the response payload to a fixed buffer (the overflow is flagged).
+	/// </summary>
+	class Payload : public Print
+	{
+	public:
+		uint8_t Data[PAYLOAD_SIZE];								// The payload buffer
+		size_t Length;											// The payload length
+		bool Overflow;											// Flag indicating that the payload does not fit
+
+		size_t write(uint8_t c) override;
+		size_t write(const uint8_t* buffer, size_t size) override;
+		using Print::write;
+	};
+
+	static const uint8_t FREE = 0xFF;							// The resource id of an unused observer entry
+
+	UDP* _udp;													// Pointer to the UDP instance
+	bool (*_connected)();										// Function returning true if the network is up
+	Resources _resources;										// The resource functions
+	bool _started;												// Flag indicating that the UDP socket is open
+
+	Observer _observers[MAX_OBSERVERS];							// The observer table
+	uint8_t _request[REQUEST_SIZE];								// The request buffer
+	Payload _payload;											// The response payload
+	uint16_t _messageId;										// The last message id
+	uint32_t _sequence;											// The last notification sequence (Observe option)
+
+	uint32_t _requests;											// The number of requests
+	uint32_t _notifications;									// The number of notifications
+	uint32_t _errors;											// The number of invalid or rejected requests
+
+	void receive(size_t size, uint32_t address, uint16_t port);	// Processes a received message
+	void respond(uint32_t address, uint16_t port, uint8_t type,	// Processes a GET request
+		uint16_t messageId, const uint8_t* token, uint8_t tokenLength,
+		const char* path, long observe, long accept);
+	void notify();												// Sends the due notifications
+	bool isDue(const Observer& observer, uint32_t now);			// Returns true if a notification is due
+	bool render(uint8_t resource);								// Writes a resource to the payload
+	void send(uint32_t address, uint16_t port, uint8_t type,	// Sends a message (header, options, and payload)
+		uint8_t code, uint16_t messageId, const uint8_t* token, uint8_t tokenLength,
+		long observe, long format);
+	Observer* find(uint32_t address, uint16_t port,				// Returns the observer with the token (NULL if none)
+		const uint8_t* token, uint8_t tokenLength);
+	void remove(Observer* observer);							// Removes an observer
+
+public:
+	CoapServer(UDP* udp, bool (*connected)(),					// Constructor using a UDP instance and the resources
+		const Resources& resources);
+
+	void update();												// Processes the requests and sends the notifications
+	void stop();												// Closes the socket
+	void clear();												// Removes all observers
+
+	uint8_t getObservers() const;								// Returns the number of observers
+	uint32_t getRequests() const { return _requests; }			// Returns the number of requests
+	uint32_t getNotifications() const { return _notifications; }// Returns the number of notifications
+	uint32_t getErrors() const { return _errors; }				// Returns the number of rejected requests
+	bool isStarted() const { return _started; }					// Returns true if the socket is open
+};
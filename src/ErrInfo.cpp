@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "ErrInfo.h"
 
 /// <summary>
@@ -18,12 +19,12 @@ ErrInfo::ErrInfo() :
 	Code(0),
 	Message("No Error")
 {
-	Log.trace("ErrInfo::ErrInfo()" CR);
+	LOG_TRACE("ErrInfo::ErrInfo()" CR);
 }
 
 bool ErrInfo::deserialize(String json)
 {
-	Log.trace("ErrInfo::deserialize()" CR);
+	LOG_TRACE("ErrInfo::deserialize()" CR);
 
 	if (json.length() > 0)
 	{
@@ -31,7 +32,7 @@ bool ErrInfo::deserialize(String json)
 
 		if (err)
 		{
-			Log.error("ErrInfo::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
+			LOG_ERROR("ErrInfo::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
 			return false;
 		}
 
@@ -44,7 +45,7 @@ bool ErrInfo::deserialize(String json)
 	Code = _doc["Code"] | 400;
 	Message = _doc["Message"] | "Invalid JSON string";
 
-	Log.warning("ErrInfo::deserialize() Invalid JSON string" CR);
+	LOG_WARNING("ErrInfo::deserialize() Invalid JSON string" CR);
 	return false;
 }
 
@@ -54,14 +55,33 @@ bool ErrInfo::deserialize(String json)
 /// <returns>The JSON string</returns>
 String ErrInfo::serialize()
 {
-	Log.trace("ErrInfo::serialize()" CR);
+	LOG_TRACE("ErrInfo::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void ErrInfo::serialize(WireFormat& writer)
+{
+	LOG_TRACE("ErrInfo::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void ErrInfo::build()
+{
 	_doc.clear();
 	_doc["Code"] = Code;
 	_doc["Message"] = Message;
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
 
@@ -10,6 +10,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "WireFormat.h"
 
 /// /// <summary>
 /// This class holds Error data.
@@ -20,6 +21,7 @@ private:
 	static const int CAPACITY =				// The maximum size for the JSON document
 		JSON_OBJECT_SIZE(2) + 270;	
 	StaticJsonDocument<CAPACITY> _doc;		// The static JSON document
+	void build();							// Builds the document
 
 public:
 	ErrInfo();								// Default constructor
@@ -29,5 +31,6 @@ public:
 
 	bool deserialize(String json);			// Read a JSON string and updates the fields
 	String serialize();						// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);		// Writes a binary serialization (CBOR, MessagePack)
 };
 
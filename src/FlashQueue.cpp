@@ -0,0 +1,372 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="FlashQueue.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "FlashQueue.h"
+
+/// <summary>
+/// The size of the segment header (sequence number) and of the message length.
+/// </summary>
+static const size_t HEADER_SIZE = 4;
+static const size_t LENGTH_SIZE = 2;
+
+/// <summary>
+///  Constructor using a file system and the path prefix of the segment files (e.g. "/mqtt").
+/// </summary>
+/// <param name="fs">Pointer to the file system</param>
+/// <param name="prefix">The path prefix (static string)</param>
+FlashQueue::FlashQueue(fs::FS* fs, const char* prefix) :
+	_fs(fs),
+	_prefix(prefix),
+	_head(0),
+	_tail(0),
+	_offset(HEADER_SIZE),
+	_size(0),
+	_sequence(0),
+	_count(0),
+	_dropped(0)
+{
+	for (uint8_t i = 0; i < SEGMENT_COUNT; i++)
+	{
+		_sequences[i] = 0;
+		_messages[i] = 0;
+	}
+}
+
+/// <summary>
+///  Returns the path of the specified segment file.
+/// </summary>
+/// <param name="index">The segment index</param>
+/// <returns>The file path</returns>
+String FlashQueue::getPath(uint8_t index) const
+{
+	return String(_prefix) + String(index) + String(".q");
+}
+
+/// <summary>
+///  Returns true if the specified segment is used.
+/// </summary>
+/// <param name="index">The segment index</param>
+/// <returns>True if used</returns>
+bool FlashQueue::isUsed(uint8_t index) const
+{
+	return _sequences[index] != 0;
+}
+
+/// <summary>
+///  Restores the queue from the segment files (the oldest segment is read first).
+/// </summary>
+void FlashQueue::begin()
+{
+	size_t sizes[SEGMENT_COUNT];
+
+	_count = 0;
+	_sequence = 0;
+
+	for (uint8_t i = 0; i < SEGMENT_COUNT; i++)
+	{
+		sizes[i] = scan(i);
+		_count += _messages[i];
+
+		if (isUsed(i) && ((_sequence == 0) || (_sequences[i] > _sequences[_tail])))
+		{
+			_tail = i;
+		}
+
+		if (isUsed(i) && ((_sequence == 0) || (_sequences[i] < _sequences[_head])))
+		{
+			_head = i;
+		}
+
+		if (isUsed(i) && (_sequences[i] > _sequence))
+		{
+			_sequence = _sequences[i];
+		}
+	}
+
+	_offset = HEADER_SIZE;
+	_size = isUsed(_tail) ? sizes[_tail] : 0;
+}
+
+/// <summary>
+///  Restores a segment from the file: reads the sequence number and counts the complete messages. An empty or
+///  invalid segment is removed. A segment ending with an incomplete message (power loss) is not appended to.
+/// </summary>
+/// <param name="index">The segment index</param>
+/// <returns>The size of the valid data (SEGMENT_SIZE if incomplete)</returns>
+size_t FlashQueue::scan(uint8_t index)
+{
+	String path = getPath(index);
+	uint8_t data[HEADER_SIZE];
+	size_t position = HEADER_SIZE;
+	uint16_t messages = 0;
+
+	_sequences[index] = 0;
+	_messages[index] = 0;
+
+	if (!_fs->exists(path))
+	{
+		return 0;
+	}
+
+	File file = _fs->open(path, FILE_READ);
+
+	if (!file || (file.read(data, HEADER_SIZE) != HEADER_SIZE))
+	{
+		file.close();
+		_fs->remove(path);
+		return 0;
+	}
+
+	uint32_t sequence = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+	size_t size = file.size();
+
+	while (position + LENGTH_SIZE <= size)
+	{
+		if (!file.seek(position) || (file.read(data, LENGTH_SIZE) != LENGTH_SIZE))
+		{
+			break;
+		}
+
+		size_t length = data[0] | (data[1] << 8);
+
+		if ((length == 0) || (position + LENGTH_SIZE + length > size))
+		{
+			break;
+		}
+
+		position += LENGTH_SIZE + length;
+		messages++;
+	}
+
+	file.close();
+
+	if ((sequence == 0) || (messages == 0))
+	{
+		_fs->remove(path);
+		return 0;
+	}
+
+	_sequences[index] = sequence;
+	_messages[index] = messages;
+
+	return (position < size) ? SEGMENT_SIZE : position;
+}
+
+/// <summary>
+///  Starts a new segment after the newest segment. If all segments are used, the oldest segment is dropped.
+/// </summary>
+/// <returns>True if successful</returns>
+bool FlashQueue::addSegment()
+{
+	bool empty = !isUsed(_tail);
+	uint8_t next = empty ? _tail : (_tail + 1) % SEGMENT_COUNT;
+
+	if (isUsed(next))
+	{
+		_dropped += _messages[next];
+		_count -= _messages[next];
+		removeSegment(next);
+		_head = (next + 1) % SEGMENT_COUNT;
+		_offset = HEADER_SIZE;
+	}
+
+	File file = _fs->open(getPath(next), FILE_WRITE);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	uint32_t sequence = ++_sequence;
+	uint8_t data[HEADER_SIZE] = {
+		(uint8_t)sequence, (uint8_t)(sequence >> 8), (uint8_t)(sequence >> 16), (uint8_t)(sequence >> 24) };
+	size_t written = file.write(data, HEADER_SIZE);
+	file.close();
+
+	if (written != HEADER_SIZE)
+	{
+		_fs->remove(getPath(next));
+		return false;
+	}
+
+	_sequences[next] = sequence;
+	_messages[next] = 0;
+	_tail = next;
+	_size = HEADER_SIZE;
+
+	if (empty)
+	{
+		_head = next;
+		_offset = HEADER_SIZE;
+	}
+
+	return true;
+}
+
+/// <summary>
+///  Removes a segment file.
+/// </summary>
+/// <param name="index">The segment index</param>
+void FlashQueue::removeSegment(uint8_t index)
+{
+	_fs->remove(getPath(index));
+	_sequences[index] = 0;
+	_messages[index] = 0;
+}
+
+/// <summary>
+///  Appends a message to the newest segment (a new segment is started if the message does not fit).
+///  Empty or too large messages, and messages that can not be written are dropped.
+/// </summary>
+/// <param name="message">The message</param>
+/// <param name="length">The message length</param>
+/// <returns>True if queued</returns>
+bool FlashQueue::push(const char* message, size_t length)
+{
+	if ((length == 0) || (length > MAX_MESSAGE))
+	{
+		_dropped++;
+		return false;
+	}
+
+	if (!isUsed(_tail) || (_size + LENGTH_SIZE + length > SEGMENT_SIZE))
+	{
+		if (!addSegment())
+		{
+			_dropped++;
+			return false;
+		}
+	}
+
+	File file = _fs->open(getPath(_tail), FILE_APPEND);
+
+	if (!file)
+	{
+		_dropped++;
+		return false;
+	}
+
+	uint8_t data[LENGTH_SIZE] = { (uint8_t)length, (uint8_t)(length >> 8) };
+	size_t written = file.write(data, LENGTH_SIZE);
+	written += file.write((const uint8_t*)message, length);
+	file.close();
+
+	if (written != LENGTH_SIZE + length)
+	{
+		// Do not append after an incomplete message.
+		_size = SEGMENT_SIZE;
+		_dropped++;
+		return false;
+	}
+
+	_size += LENGTH_SIZE + length;
+	_messages[_tail]++;
+	_count++;
+
+	return true;
+}
+
+/// <summary>
+///  Reads the oldest message. If the message can not be read (or does not fit), the oldest segment is dropped.
+/// </summary>
+/// <param name="buffer">The message buffer</param>
+/// <param name="size">The buffer size</param>
+/// <returns>The message length (0: empty)</returns>
+size_t FlashQueue::peek(char* buffer, size_t size)
+{
+	if (_count == 0)
+	{
+		return 0;
+	}
+
+	File file = _fs->open(getPath(_head), FILE_READ);
+	uint8_t data[LENGTH_SIZE];
+	size_t length = 0;
+
+	if (file && file.seek(_offset) && (file.read(data, LENGTH_SIZE) == LENGTH_SIZE))
+	{
+		length = data[0] | (data[1] << 8);
+
+		if ((length > size) || (file.read((uint8_t*)buffer, length) != length))
+		{
+			length = 0;
+		}
+	}
+
+	file.close();
+
+	if (length == 0)
+	{
+		_dropped += _messages[_head];
+		_count -= _messages[_head];
+		removeSegment(_head);
+		_head = (_head + 1) % SEGMENT_COUNT;
+		_offset = HEADER_SIZE;
+	}
+
+	return length;
+}
+
+/// <summary>
+///  Removes the oldest message (read by peek). A drained segment is removed.
+/// </summary>
+void FlashQueue::pop()
+{
+	if (_count == 0)
+	{
+		return;
+	}
+
+	File file = _fs->open(getPath(_head), FILE_READ);
+	uint8_t data[LENGTH_SIZE];
+
+	if (file && file.seek(_offset) && (file.read(data, LENGTH_SIZE) == LENGTH_SIZE))
+	{
+		_offset += LENGTH_SIZE + (data[0] | (data[1] << 8));
+	}
+
+	file.close();
+
+	_messages[_head]--;
+	_count--;
+
+	if (_messages[_head] == 0)
+	{
+		removeSegment(_head);
+
+		if (_count > 0)
+		{
+			_head = (_head + 1) % SEGMENT_COUNT;
+		}
+
+		_offset = HEADER_SIZE;
+	}
+}
+
+/// <summary>
+///  Removes all messages (the segment files).
+/// </summary>
+void FlashQueue::clear()
+{
+	for (uint8_t i = 0; i < SEGMENT_COUNT; i++)
+	{
+		if (_fs->exists(getPath(i)))
+		{
+			removeSegment(i);
+		}
+
+		_sequences[i] = 0;
+		_messages[i] = 0;
+	}
+
+	_head = 0;
+	_tail = 0;
+	_offset = HEADER_SIZE;
+	_size = 0;
+	_count = 0;
+}
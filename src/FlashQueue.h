@@ -0,0 +1,62 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="FlashQueue.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+/// <summary>
+/// This class implements a size bounded message queue on the flash file system (messages not yet sent, e.g. MQTT
+/// messages or upload batches).
+///
+/// The messages are appended to segment files ({prefix}0.q ... {prefix}3.q, used as a ring), every segment starts with
+/// its sequence number, followed by the messages (two byte length and data). A drained segment is removed. If all
+/// segments are used, the oldest segment is dropped (the messages are counted). The queue is restored from the files
+/// after a restart, the messages of the oldest segment already sent before the restart are sent again.
+/// </summary>
+class FlashQueue
+{
+public:
+	static const uint8_t SEGMENT_COUNT = 4;						// The number of segment files
+	static const size_t SEGMENT_SIZE = 8192;					// The maximum size of a segment file
+	static const size_t MAX_MESSAGE =							// The maximum message size
+		SEGMENT_SIZE - 6;
+
+private:
+	fs::FS* _fs;												// Pointer to the file system
+	const char* _prefix;										// The path prefix of the segment files
+	uint32_t _sequences[SEGMENT_COUNT];							// The segment sequence numbers (0: unused)
+	uint16_t _messages[SEGMENT_COUNT];							// The number of unread messages per segment
+	uint8_t _head;												// The oldest segment (read)
+	uint8_t _tail;												// The newest segment (write)
+	size_t _offset;												// The read position in the oldest segment
+	size_t _size;												// The size of the newest segment
+	uint32_t _sequence;											// The last segment sequence number
+	uint32_t _count;											// The number of queued messages
+	uint32_t _dropped;											// The number of dropped messages
+
+	String getPath(uint8_t index) const;						// Returns the path of a segment file
+	bool isUsed(uint8_t index) const;							// Returns true if the segment is used
+	size_t scan(uint8_t index);									// Restores a segment (returns the valid size)
+	bool addSegment();											// Starts a new segment (drops the oldest if full)
+	void removeSegment(uint8_t index);							// Removes a segment
+
+public:
+	FlashQueue(fs::FS* fs, const char* prefix);				// Constructor using a file system and a path prefix
+
+	void begin();												// Restores the queue from the files
+	bool push(const char* message, size_t length);				// Appends a message
+	size_t peek(char* buffer, size_t size);						// Reads the oldest message (0: empty)
+	void pop();													// Removes the oldest message
+	void clear();												// Removes all messages
+
+	bool isEmpty() const { return _count == 0; }				// Returns true if the queue is empty
+	uint32_t getCount() const { return _count; }				// Returns the number of queued messages
+	uint32_t getDropped() const { return _dropped; }			// Returns the number of dropped messages
+};
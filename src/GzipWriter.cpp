@@ -0,0 +1,253 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="GzipWriter.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string.h>
+
+#include "GzipWriter.h"
+
+/// <summary>
+/// The deflate length and distance codes (RFC 1951, 3.2.5): base values and number of extra bits.
+/// </summary>
+static const uint16_t LENGTH_BASE[] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t LENGTH_EXTRA[] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t DISTANCE_BASE[] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+	6145, 8193, 12289, 16385, 24577 };
+static const uint8_t DISTANCE_EXTRA[] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static const size_t MIN_MATCH = 3;
+static const size_t MAX_MATCH = 258;
+
+/// <summary>
+///  Default constructor.
+/// </summary>
+GzipWriter::GzipWriter() :
+	_out(NULL),
+	_size(0),
+	_length(0),
+	_bits(0),
+	_count(0),
+	_overflow(false)
+{
+}
+
+/// <summary>
+///  Returns the CRC-32 (ISO 3309, as used by gzip) of the data (using a 16 entry table).
+/// </summary>
+/// <param name="data">The data</param>
+/// <param name="length">The data length</param>
+/// <returns>The CRC-32</returns>
+uint32_t GzipWriter::crc32(const uint8_t* data, size_t length)
+{
+	static const uint32_t TABLE[16] = {
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C };
+	uint32_t crc = 0xFFFFFFFF;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+		crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+	}
+
+	return crc ^ 0xFFFFFFFF;
+}
+
+/// <summary>
+///  Writes a byte to the output (the overflow flag is set if it does not fit).
+/// </summary>
+/// <param name="value">The byte</param>
+void GzipWriter::putByte(uint8_t value)
+{
+	if (_length < _size)
+	{
+		_out[_length++] = value;
+	}
+	else
+	{
+		_overflow = true;
+	}
+}
+
+/// <summary>
+///  Writes bits to the output (deflate packs the bits starting with the least significant bit).
+/// </summary>
+/// <param name="value">The bits</param>
+/// <param name="count">The number of bits (max. 16)</param>
+void GzipWriter::putBits(uint32_t value, uint8_t count)
+{
+	_bits |= value << _count;
+	_count += count;
+
+	while (_count >= 8)
+	{
+		putByte((uint8_t)_bits);
+		_bits >>= 8;
+		_count -= 8;
+	}
+}
+
+/// <summary>
+///  Writes a Huffman code (the codes are packed starting with the most significant bit).
+/// </summary>
+/// <param name="code">The code</param>
+/// <param name="count">The code length</param>
+void GzipWriter::putCode(uint32_t code, uint8_t count)
+{
+	uint32_t reversed = 0;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		reversed = (reversed << 1) | ((code >> i) & 1);
+	}
+
+	putBits(reversed, count);
+}
+
+/// <summary>
+///  Writes a literal/length symbol using the fixed Huffman codes (RFC 1951, 3.2.6).
+/// </summary>
+/// <param name="value">The symbol (0..287)</param>
+void GzipWriter::putLiteral(uint16_t value)
+{
+	if (value < 144)      putCode(0x30 + value, 8);
+	else if (value < 256) putCode(0x190 + value - 144, 9);
+	else if (value < 280) putCode(value - 256, 7);
+	else                  putCode(0xC0 + value - 280, 8);
+}
+
+/// <summary>
+///  Writes a length/distance pair (length symbol, extra bits, distance code, extra bits).
+/// </summary>
+/// <param name="length">The match length (3..258)</param>
+/// <param name="distance">The match distance (1..32768)</param>
+void GzipWriter::putMatch(size_t length, size_t distance)
+{
+	uint8_t code = sizeof(LENGTH_BASE) / sizeof(*LENGTH_BASE) - 1;
+
+	while (LENGTH_BASE[code] > length) code--;
+
+	putLiteral(257 + code);
+	putBits(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+	code = sizeof(DISTANCE_BASE) / sizeof(*DISTANCE_BASE) - 1;
+
+	while (DISTANCE_BASE[code] > distance) code--;
+
+	putCode(code, 5);
+	putBits(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+}
+
+/// <summary>
+///  Writes the pending bits (padded to a full byte).
+/// </summary>
+void GzipWriter::flushBits()
+{
+	if (_count > 0)
+	{
+		putByte((uint8_t)_bits);
+	}
+
+	_bits = 0;
+	_count = 0;
+}
+
+/// <summary>
+///  Compresses the data into the gzip format (header, single fixed Huffman deflate block, CRC-32 and size).
+/// </summary>
+/// <param name="data">The data</param>
+/// <param name="length">The data length (max. MAX_LENGTH)</param>
+/// <param name="out">The output buffer</param>
+/// <param name="size">The output buffer size</param>
+/// <returns>The compressed length (0: the output does not fit or the input is too large)</returns>
+size_t GzipWriter::compress(const uint8_t* data, size_t length, uint8_t* out, size_t size)
+{
+	static const uint8_t HEADER[] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+
+	if (length > MAX_LENGTH)
+	{
+		return 0;
+	}
+
+	_out = out;
+	_size = size;
+	_length = 0;
+	_bits = 0;
+	_count = 0;
+	_overflow = false;
+	memset(_head, 0, sizeof(_head));
+
+	for (size_t i = 0; i < sizeof(HEADER); i++)
+	{
+		putByte(HEADER[i]);
+	}
+
+	// Final block, fixed Huffman codes.
+	putBits(1, 1);
+	putBits(1, 2);
+
+	size_t position = 0;
+
+	while ((position < length) && !_overflow)
+	{
+		size_t match = 0;
+		size_t distance = 0;
+
+		if (position + MIN_MATCH <= length)
+		{
+			uint16_t hash = ((data[position] << 10) ^ (data[position + 1] << 5) ^ data[position + 2]) & (HASH_SIZE - 1);
+			size_t candidate = _head[hash];
+			_head[hash] = (uint16_t)(position + 1);
+
+			if (candidate > 0)
+			{
+				const uint8_t* previous = data + candidate - 1;
+				size_t limit = length - position;
+
+				if (limit > MAX_MATCH) limit = MAX_MATCH;
+
+				while ((match < limit) && (previous[match] == data[position + match])) match++;
+
+				distance = position - (candidate - 1);
+			}
+		}
+
+		if (match >= MIN_MATCH)
+		{
+			putMatch(match, distance);
+
+			// The positions inside the match are added to the hash table.
+			for (size_t i = 1; (i < match) && (position + i + MIN_MATCH <= length); i++)
+			{
+				const uint8_t* p = data + position + i;
+				_head[((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & (HASH_SIZE - 1)] = (uint16_t)(position + i + 1);
+			}
+
+			position += match;
+		}
+		else
+		{
+			putLiteral(data[position]);
+			position++;
+		}
+	}
+
+	putLiteral(256);
+	flushBits();
+
+	uint32_t crc = crc32(data, length);
+
+	for (uint8_t i = 0; i < 4; i++) putByte((uint8_t)(crc >> (8 * i)));
+	for (uint8_t i = 0; i < 4; i++) putByte((uint8_t)(length >> (8 * i)));
+
+	return _overflow ? 0 : _length;
+}
@@ -0,0 +1,48 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="GzipWriter.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class compresses a buffer into the gzip format (RFC 1952) using a single deflate block with the fixed
+/// Huffman codes (RFC 1951). The LZ77 matches are found using a hash table of the last position of every three byte
+/// sequence (no hash chains), so the memory is bounded (HASH_SIZE entries) and no dynamic allocation is used.
+/// This is well suited for repetitive text (e.g. line protocol batches are typically about four times smaller).
+/// </summary>
+class GzipWriter
+{
+public:
+	static const size_t MAX_LENGTH = 32768;						// The maximum input length (deflate window)
+	static const size_t HASH_SIZE = 1024;						// The number of hash table entries
+
+private:
+	uint16_t _head[HASH_SIZE];									// The last position (+1) of the three byte hashes
+
+	uint8_t* _out;												// The output buffer
+	size_t _size;												// The output buffer size
+	size_t _length;												// The output length
+	uint32_t _bits;												// The pending bits (LSB first)
+	uint8_t _count;												// The number of pending bits
+	bool _overflow;												// Flag indicating that the output does not fit
+
+	void putByte(uint8_t value);								// Writes a byte
+	void putBits(uint32_t value, uint8_t count);				// Writes bits (LSB first)
+	void putCode(uint32_t code, uint8_t count);					// Writes a Huffman code (MSB first)
+	void putLiteral(uint16_t value);							// Writes a literal/length symbol (fixed codes)
+	void putMatch(size_t length, size_t distance);				// Writes a length/distance pair
+	void flushBits();											// Writes the pending bits (byte aligned)
+
+public:
+	GzipWriter();												// Default constructor
+
+	size_t compress(const uint8_t* data, size_t length,			// Compresses the data (0: does not fit)
+		uint8_t* out, size_t size);
+	static uint32_t crc32(const uint8_t* data, size_t length);	// Returns the CRC-32 of the data
+};
@@ -0,0 +1,70 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="HeapHook.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#if defined(HEAP_WRAP)
+
+#include <stdlib.h>
+#include "HeapMonitor.h"
+
+/// <summary>
+/// The allocation hook of the heap monitor, wrapping malloc / free / realloc / calloc at link time
+/// (-Wl,--wrap=malloc,..., see platform.local.txt). All heap allocations are counted, including operator
+/// new (see HeapMonitor.cpp), String (realloc), and the ArduinoJson documents (malloc). A reallocation of
+/// an existing block is counted as a deallocation and an allocation.
+/// </summary>
+extern "C"
+{
+	void* __real_malloc(size_t size);
+	void __real_free(void* p);
+	void* __real_realloc(void* p, size_t size);
+	void* __real_calloc(size_t count, size_t size);
+
+	void* __wrap_malloc(size_t size);
+	void __wrap_free(void* p);
+	void* __wrap_realloc(void* p, size_t size);
+	void* __wrap_calloc(size_t count, size_t size);
+}
+
+void* __wrap_malloc(size_t size)
+{
+	HeapMonitor::onAlloc(size);
+	return __real_malloc(size);
+}
+
+void __wrap_free(void* p)
+{
+	if (p != NULL)
+	{
+		HeapMonitor::onFree();
+	}
+
+	__real_free(p);
+}
+
+void* __wrap_realloc(void* p, size_t size)
+{
+	if (p != NULL)
+	{
+		HeapMonitor::onFree();
+	}
+
+	if (size > 0)
+	{
+		HeapMonitor::onAlloc(size);
+	}
+
+	return __real_realloc(p, size);
+}
+
+void* __wrap_calloc(size_t count, size_t size)
+{
+	HeapMonitor::onAlloc(count * size);
+	return __real_calloc(count, size);
+}
+
+#endif
@@ -0,0 +1,280 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="HeapMonitor.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <new>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "HeapMonitor.h"
+
+HeapMonitor::Counters HeapMonitor::_counters[HeapMonitor::SUBSYSTEM_COUNT];
+HeapMonitor::Sample HeapMonitor::_trend[HeapMonitor::TREND_SIZE];
+uint8_t HeapMonitor::_next = 0;
+uint8_t HeapMonitor::_samples = 0;
+uint32_t HeapMonitor::_sampled = 0;
+void* HeapMonitor::_task = NULL;
+bool HeapMonitor::_counting = false;
+volatile uint8_t HeapMonitor::Current = HeapMonitor::SUBSYSTEM_OTHER;
+
+/// <summary>
+///  Starts the accounting for the calling task (main loop), and adds the first trend sample.
+/// </summary>
+void HeapMonitor::begin()
+{
+	_task = xTaskGetCurrentTaskHandle();
+	_sampled = millis() - TREND_INTERVAL;
+	update();
+}
+
+/// <summary>
+///  Allocation hook, counts the allocation for the active subsystem (main loop task only).
+/// </summary>
+/// <param name="size">The allocation size</param>
+void HeapMonitor::onAlloc(size_t size)
+{
+	_counting = true;
+
+	if ((_task != NULL) && (xTaskGetCurrentTaskHandle() == _task))
+	{
+		_counters[Current].Allocs++;
+		_counters[Current].Bytes += size;
+	}
+}
+
+/// <summary>
+///  Deallocation hook, counts the deallocation for the active subsystem (main loop task only).
+/// </summary>
+void HeapMonitor::onFree()
+{
+	if ((_task != NULL) && (xTaskGetCurrentTaskHandle() == _task))
+	{
+		_counters[Current].Frees++;
+	}
+}
+
+/// <summary>
+///  Adds the net heap change of a scope.
+/// </summary>
+/// <param name="subsystem">The subsystem</param>
+/// <param name="bytes">The net heap change (bytes)</param>
+void HeapMonitor::addNet(uint8_t subsystem, int32_t bytes)
+{
+	_counters[subsystem].Calls++;
+	_counters[subsystem].Net += bytes;
+}
+
+/// <summary>
+///  Adds a trend sample (free heap, largest free block, minimum free heap) every TREND_INTERVAL.
+/// </summary>
+void HeapMonitor::update()
+{
+	uint32_t now = millis();
+
+	if (now - _sampled < TREND_INTERVAL)
+	{
+		return;
+	}
+
+	_sampled = now;
+	_trend[_next].Time = now / 1000;
+	_trend[_next].FreeHeap = ESP.getFreeHeap();
+	_trend[_next].MaxAlloc = ESP.getMaxAllocHeap();
+	_trend[_next].MinFree = ESP.getMinFreeHeap();
+	_next = (_next + 1) % TREND_SIZE;
+
+	if (_samples < TREND_SIZE)
+	{
+		_samples++;
+	}
+}
+
+/// <summary>
+///  Returns the counters of a subsystem.
+/// </summary>
+/// <param name="subsystem">The subsystem</param>
+/// <returns>The counters</returns>
+const HeapMonitor::Counters& HeapMonitor::getCounters(uint8_t subsystem)
+{
+	return _counters[(subsystem < SUBSYSTEM_COUNT) ? subsystem : SUBSYSTEM_OTHER];
+}
+
+/// <summary>
+///  Returns the heap fragmentation (100 - largest free block / free heap in %).
+/// </summary>
+/// <returns>The fragmentation (%)</returns>
+uint8_t HeapMonitor::getFragmentation()
+{
+	uint32_t free = ESP.getFreeHeap();
+	uint32_t largest = ESP.getMaxAllocHeap();
+
+	return (free > 0) ? 100 - (uint8_t)((uint64_t)largest * 100 / free) : 0;
+}
+
+/// <summary>
+///  Prints the trend buffer as JSON (oldest sample first, values in bytes, time in sec since start).
+/// </summary>
+/// <param name="out">The output (e.g. HTTP response)</param>
+void HeapMonitor::printTrend(Print& out)
+{
+	out.print("{\"Interval\":"); out.print(TREND_INTERVAL / 1000);
+	out.print(",\"Samples\":[");
+
+	for (uint8_t i = 0; i < _samples; i++)
+	{
+		const Sample& sample = _trend[(_next + TREND_SIZE - _samples + i) % TREND_SIZE];
+
+		if (i > 0) out.print(',');
+		out.print("{\"Time\":"); out.print(sample.Time);
+		out.print(",\"FreeHeap\":"); out.print(sample.FreeHeap);
+		out.print(",\"MaxAlloc\":"); out.print(sample.MaxAlloc);
+		out.print(",\"MinFree\":"); out.print(sample.MinFree);
+		out.print('}');
+	}
+
+	out.println("]}");
+}
+
+/// <summary>
+///  Writes the trend buffer in a binary format (same structure as the JSON trend, see printTrend).
+/// </summary>
+/// <param name="writer">The binary writer (e.g. HTTP response)</param>
+void HeapMonitor::writeTrend(WireFormat& writer)
+{
+	writer.writeMap(2);
+	writer.writeString("Interval"); writer.writeUInt(TREND_INTERVAL / 1000);
+	writer.writeString("Samples"); writer.writeArray(_samples);
+
+	for (uint8_t i = 0; i < _samples; i++)
+	{
+		const Sample& sample = _trend[(_next + TREND_SIZE - _samples + i) % TREND_SIZE];
+
+		writer.writeMap(4);
+		writer.writeString("Time"); writer.writeUInt(sample.Time);
+		writer.writeString("FreeHeap"); writer.writeUInt(sample.FreeHeap);
+		writer.writeString("MaxAlloc"); writer.writeUInt(sample.MaxAlloc);
+		writer.writeString("MinFree"); writer.writeUInt(sample.MinFree);
+	}
+}
+
+/// <summary>
+///  Writes the heap metrics (free heap, minimum free heap, largest free block, fragmentation, and the
+///  allocations counted per subsystem if the allocation hook is linked).
+/// </summary>
+/// <param name="writer">The metrics writer (e.g. HTTP response)</param>
+void HeapMonitor::writeMetrics(MetricsWriter& writer)
+{
+	writer.writeFamily("soilmonitor_heap_free_bytes", "gauge", "Free heap.");
+	writer.writeInt("soilmonitor_heap_free_bytes", ESP.getFreeHeap());
+	writer.writeFamily("soilmonitor_heap_min_free_bytes", "gauge", "Minimum free heap since the start.");
+	writer.writeInt("soilmonitor_heap_min_free_bytes", ESP.getMinFreeHeap());
+	writer.writeFamily("soilmonitor_heap_max_alloc_bytes", "gauge", "Largest free heap block.");
+	writer.writeInt("soilmonitor_heap_max_alloc_bytes", ESP.getMaxAllocHeap());
+	writer.writeFamily("soilmonitor_heap_fragmentation_percent", "gauge", "Heap fragmentation.");
+	writer.writeInt("soilmonitor_heap_fragmentation_percent", getFragmentation());
+
+	if (!_counting)
+	{
+		return;
+	}
+
+	writer.writeFamily("soilmonitor_heap_allocations_total", "counter", "Allocations (malloc) per subsystem.");
+
+	for (uint8_t i = 0; i < SUBSYSTEM_COUNT; i++)
+	{
+		writer.writeInt("soilmonitor_heap_allocations_total", _counters[i].Allocs, "subsystem", getSubsystemName(i));
+	}
+}
+
+/// <summary>
+///  Returns the subsystem name.
+/// </summary>
+/// <param name="subsystem">The subsystem</param>
+/// <returns>The subsystem name</returns>
+const char* HeapMonitor::getSubsystemName(uint8_t subsystem)
+{
+	switch (subsystem)
+	{
+	case SUBSYSTEM_OTHER:     return "Other";
+	case SUBSYSTEM_WEB:       return "Web";
+	case SUBSYSTEM_SETTINGS:  return "Settings";
+	case SUBSYSTEM_SENSORS:   return "Sensors";
+	case SUBSYSTEM_COMMANDER: return "Commander";
+	default:                  return "Unknown";
+	}
+}
+
+/// <summary>
+///  Enters the subsystem scope (remembering the free heap).
+/// </summary>
+/// <param name="subsystem">The subsystem</param>
+HeapScope::HeapScope(HeapMonitor::Subsystem subsystem) :
+	_previous(HeapMonitor::Current),
+	_subsystem(subsystem),
+	_free(ESP.getFreeHeap())
+{
+	HeapMonitor::Current = subsystem;
+}
+
+/// <summary>
+///  Leaves the subsystem scope (adding the net heap change).
+/// </summary>
+HeapScope::~HeapScope()
+{
+	HeapMonitor::addNet(_subsystem, (int32_t)_free - (int32_t)ESP.getFreeHeap());
+	HeapMonitor::Current = _previous;
+}
+
+/// <summary>
+///  The global operators new and delete using malloc and free (counted by the allocation hook, this also
+///  holds if the C++ library is linked dynamically, e.g. the simulator).
+/// </summary>
+void* operator new(size_t size)
+{
+	void* p = malloc(size);
+
+	if (p == NULL)
+	{
+		abort();
+	}
+
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return malloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete(void* p, size_t size) noexcept
+{
+	operator delete(p);
+}
+
+void operator delete[](void* p, size_t size) noexcept
+{
+	operator delete(p);
+}
@@ -0,0 +1,95 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="HeapMonitor.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include "WireFormat.h"
+#include "MetricsWriter.h"
+
+/// <summary>
+/// This class implements the heap accounting per subsystem and the heap trend buffer.
+/// 
+/// The main loop marks the active subsystem (HeapScope). The allocation hook (malloc / free / realloc /
+/// calloc wrapped at link time, see HeapHook.cpp) counts the allocations of the main loop task for the
+/// active subsystem. Without the hook (isCounting() is false) only the net heap change is available
+/// (free heap before and after the scope, including nested scopes and other tasks).
+/// </summary>
+class HeapMonitor
+{
+public:
+	enum Subsystem
+	{
+		SUBSYSTEM_OTHER,										// Not assigned
+		SUBSYSTEM_WEB,											// The web server (app.process)
+		SUBSYSTEM_SETTINGS,										// The settings (load, save, JSON)
+		SUBSYSTEM_SENSORS,										// The sensor updates
+		SUBSYSTEM_COMMANDER,									// The command processing
+		SUBSYSTEM_COUNT
+	};
+
+	struct Counters
+	{
+		uint32_t Calls;											// The number of scopes entered
+		uint32_t Allocs;										// The number of allocations (malloc)
+		uint32_t Frees;											// The number of deallocations (free)
+		uint32_t Bytes;											// The number of allocated bytes (malloc)
+		int32_t Net;											// The net heap change (bytes, positive: retained)
+	};
+
+	struct Sample
+	{
+		uint32_t Time;											// The sample time (sec since start)
+		uint32_t FreeHeap;										// The free heap (bytes)
+		uint32_t MaxAlloc;										// The largest free block (bytes)
+		uint32_t MinFree;										// The minimum free heap ever (bytes)
+	};
+
+	static const uint8_t TREND_SIZE = 60;						// The number of trend samples
+	static const uint32_t TREND_INTERVAL = 60000;				// The trend sample interval (msec)
+
+private:
+	static Counters _counters[SUBSYSTEM_COUNT];					// The counters per subsystem
+	static Sample _trend[TREND_SIZE];							// The trend buffer (ring)
+	static uint8_t _next;										// The next trend index
+	static uint8_t _samples;									// The number of trend samples
+	static uint32_t _sampled;									// The time of the last trend sample (msec)
+	static void* _task;											// The task accounted by the hook (main loop)
+	static bool _counting;										// Flag indicating that the allocation hook is linked
+
+public:
+	static volatile uint8_t Current;							// The active subsystem
+
+	static void begin();										// Starts the accounting for the calling task
+	static void onAlloc(size_t size);							// Allocation hook
+	static void onFree();										// Deallocation hook
+	static void addNet(uint8_t subsystem, int32_t bytes);		// Adds the net heap change of a scope
+	static void update();										// Adds a trend sample (every TREND_INTERVAL)
+	static const Counters& getCounters(uint8_t subsystem);		// Returns the counters of a subsystem
+	static bool isCounting() { return _counting; }				// Returns true if allocations are counted
+	static uint8_t getFragmentation();							// Returns the heap fragmentation (%)
+	static void printTrend(Print& out);							// Prints the trend buffer (JSON)
+	static void writeTrend(WireFormat& writer);					// Writes the trend buffer (CBOR, MessagePack)
+	static void writeMetrics(MetricsWriter& writer);			// Writes the heap metrics (Prometheus)
+	static const char* getSubsystemName(uint8_t subsystem);		// Returns the subsystem name
+};
+
+/// <summary>
+/// This class marks the active subsystem for the lifetime of the instance (scopes can be nested).
+/// </summary>
+class HeapScope
+{
+private:
+	uint8_t _previous;											// The previously active subsystem
+	uint8_t _subsystem;											// The active subsystem
+	uint32_t _free;												// The free heap when entering the scope
+
+public:
+	HeapScope(HeapMonitor::Subsystem subsystem);				// Enters the subsystem scope
+	~HeapScope();												// Leaves the subsystem scope
+};
@@ -0,0 +1,120 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="InfluxSettings.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "Logger.h"
+#include "JsonWire.h"
+#include "InfluxSettings.h"
+
+/// <summary>
+/// Initializes selected data fields to default values.
+/// </summary>
+InfluxSettings::InfluxSettings() :
+	Server(""),
+	Port(INFLUX_PORT),
+	Path(INFLUX_PATH),
+	Token(""),
+	Lines(50),
+	MaxAge(60),
+	Gzip(true)
+{
+	LOG_TRACE("InfluxSettings::InfluxSettings()" CR);
+}
+
+/// <summary>
+///  Deserialize the data fields from a JSON string.
+/// </summary>
+/// <param name="json">The JSON string</param>
+/// <returns>True if successful</returns>
+bool InfluxSettings::deserialize(String json)
+{
+	LOG_TRACE("InfluxSettings::deserialize()" CR);
+
+	if (json.length() > 0)
+	{
+		DeserializationError err = deserializeJson(_doc, json);
+
+		if (err)
+		{
+			LOG_ERROR("InfluxSettings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
+			return false;
+		}
+
+		Server = _doc["Server"] | Server;
+		Port   = _doc["Port"]   | Port;
+		Path   = _doc["Path"]   | Path;
+		Token  = _doc["Token"]  | Token;
+		Lines  = _doc["Lines"]  | Lines;
+		MaxAge = _doc["MaxAge"] | MaxAge;
+		Gzip   = _doc["Gzip"]   | Gzip;
+
+		if (Lines < 1) Lines = 1;
+		if (MaxAge < 1) MaxAge = 1;
+
+		return true;
+	}
+
+	LOG_WARNING("InfluxSettings::deserialize() Invalid JSON string" CR);
+	return false;
+}
+
+/// <summary>
+///  Serialize the class instance to a JSON string.
+/// </summary>
+/// <returns>The JSON string</returns>
+String InfluxSettings::serialize()
+{
+	LOG_TRACE("InfluxSettings::serialize()" CR);
+	String json;
+
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void InfluxSettings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("InfluxSettings::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void InfluxSettings::build()
+{
+	_doc.clear();
+	_doc["Server"] = Server;
+	_doc["Port"]   = Port;
+	_doc["Path"]   = Path;
+	_doc["Token"]  = Token;
+	_doc["Lines"]  = Lines;
+	_doc["MaxAge"] = MaxAge;
+	_doc["Gzip"]   = Gzip;
+}
+
+/// <summary>
+///  Resets all field to their default values.
+/// </summary>
+void InfluxSettings::reset()
+{
+	LOG_TRACE("InfluxSettings::reset()" CR);
+
+	Server = "";
+	Port = INFLUX_PORT;
+	Path = INFLUX_PATH;
+	Token = "";
+	Lines = 50;
+	MaxAge = 60;
+	Gzip = true;
+}
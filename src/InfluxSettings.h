@@ -0,0 +1,46 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="InfluxSettings.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "WireFormat.h"
+
+/// <summary>
+/// This class holds the InfluxDB uploader configuration data (an empty server disables the uploader).
+/// </summary>
+class InfluxSettings
+{
+private:
+	const char* INFLUX_PATH =					// The default request path (InfluxDB 1.x write API)
+		"/write?db=soilmonitor&precision=s";
+
+	static const int CAPACITY =					// The maximum size for the JSON document
+		JSON_OBJECT_SIZE(7) + 384;
+	StaticJsonDocument<CAPACITY> _doc;			// The static JSON document
+	void build();								// Builds the document
+
+public:
+	static const uint16_t INFLUX_PORT = 8086;	// The default server TCP port
+
+	InfluxSettings();							// Default constructor
+
+	String Server;								// The server (name or address, empty: disabled)
+	uint16_t Port;								// The server TCP port
+	String Path;								// The request path (write API, precision=s)
+	String Token;								// The API token (empty: no authorization)
+	uint16_t Lines;								// The maximum number of lines per batch
+	uint16_t MaxAge;							// The maximum age of a batch (sec)
+	bool Gzip;									// Flag indicating that batches are compressed
+
+	bool deserialize(String json);				// Read a JSON string and updates the fields
+	String serialize();							// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);			// Writes a binary serialization (CBOR, MessagePack)
+	void reset();								// Resets all settings
+};
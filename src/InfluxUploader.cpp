@@ -0,0 +1,452 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="InfluxUploader.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "InfluxUploader.h"
+
+/// <summary>
+/// The payload encodings (first byte of the payload and of the spooled batches).
+/// </summary>
+static const char ENCODING_GZIP = 'z';
+static const char ENCODING_TEXT = 't';
+
+/// <summary>
+///  Constructor using a network client, a function checking the network, and the flash spool.
+/// </summary>
+/// <param name="client">Pointer to the network client</param>
+/// <param name="connected">Function returning true if the network is up</param>
+/// <param name="spool">Pointer to the flash spool</param>
+InfluxUploader::InfluxUploader(Client* client, bool (*connected)(), FlashQueue* spool) :
+	_client(client),
+	_connected(connected),
+	_spool(spool),
+	_port(8086),
+	_maxLines(50),
+	_maxAge(60000),
+	_compress(true),
+	_length(0),
+	_lines(0),
+	_batchTime(0),
+	_payloadLength(0),
+	_spooled(false),
+	_state(STATE_IDLE),
+	_sentTime(0),
+	_retry(0),
+	_retryTime(0),
+	_lineLength(0),
+	_status(0),
+	_body(false),
+	_contentLength(0),
+	_close(false),
+	_uploaded(0),
+	_failed(0),
+	_rejected(0),
+	_droppedLines(0),
+	_bytesIn(0),
+	_bytesOut(0)
+{
+	_server[0] = '\0';
+	_path[0] = '\0';
+	_token[0] = '\0';
+	_batch[0] = ENCODING_TEXT;
+}
+
+/// <summary>
+///  Sets the server, the request path, and the API token. An empty server disables the uploader.
+///  The connection is closed (reopened with the new settings).
+/// </summary>
+/// <param name="server">The server (name or address)</param>
+/// <param name="port">The server TCP port</param>
+/// <param name="path">The request path (e.g. "/write?db=soilmonitor&precision=s")</param>
+/// <param name="token">The API token (empty: no authorization)</param>
+void InfluxUploader::configure(const char* server, uint16_t port, const char* path, const char* token)
+{
+	stop();
+
+	strncpy(_server, (server != NULL) ? server : "", MAX_SERVER_LEN);
+	_server[MAX_SERVER_LEN] = '\0';
+	strncpy(_path, (path != NULL) ? path : "", MAX_PATH_LEN);
+	_path[MAX_PATH_LEN] = '\0';
+	strncpy(_token, (token != NULL) ? token : "", MAX_TOKEN_LEN);
+	_token[MAX_TOKEN_LEN] = '\0';
+	_port = port;
+	_retry = 0;
+}
+
+/// <summary>
+///  Sets the batch limits and the compression.
+/// </summary>
+/// <param name="lines">The maximum number of lines per batch (at least 1)</param>
+/// <param name="age">The maximum age of a batch (sec, at least 1)</param>
+/// <param name="compress">True if the batches are compressed (gzip)</param>
+void InfluxUploader::setBatch(uint16_t lines, uint16_t age, bool compress)
+{
+	_maxLines = (lines < 1) ? 1 : lines;
+	_maxAge = ((age < 1) ? 1 : age) * 1000UL;
+	_compress = compress;
+}
+
+/// <summary>
+///  Adds a complete line to the batch. The batch is completed first if the line does not fit.
+/// </summary>
+/// <param name="line">The line (terminated by '\n')</param>
+/// <param name="length">The line length</param>
+/// <returns>True if added (false: line too large)</returns>
+bool InfluxUploader::addLine(const char* line, size_t length)
+{
+	if ((length == 0) || (length > BATCH_SIZE))
+	{
+		_droppedLines++;
+		return false;
+	}
+
+	if (_length + length > BATCH_SIZE)
+	{
+		seal();
+	}
+
+	if (_lines == 0)
+	{
+		_batchTime = millis();
+	}
+
+	memcpy(_batch + 1 + _length, line, length);
+	_length += length;
+	_lines++;
+
+	return true;
+}
+
+/// <summary>
+///  Returns true if a request can be sent (idle, network up, retry interval elapsed).
+/// </summary>
+/// <returns>True if ready</returns>
+bool InfluxUploader::isReady()
+{
+	if ((_state != STATE_IDLE) || ((_connected != NULL) && !_connected()))
+	{
+		return false;
+	}
+
+	return (_retry == 0) || (millis() - _retryTime >= _retry);
+}
+
+/// <summary>
+///  Doubles the retry interval (starting with RETRY_MIN, limited to RETRY_MAX).
+/// </summary>
+void InfluxUploader::backoff()
+{
+	_retry = (_retry == 0) ? RETRY_MIN : _retry * 2;
+
+	if (_retry > RETRY_MAX)
+	{
+		_retry = RETRY_MAX;
+	}
+}
+
+/// <summary>
+///  Completes the batch. The batch is compressed and sent directly if a request can be sent and the spool is
+///  empty (keeps the order), otherwise it is appended to the spool (uncompressed if a request is pending).
+///  A batch that can not be spooled is counted by the spool (dropped).
+/// </summary>
+void InfluxUploader::seal()
+{
+	if (_lines == 0)
+	{
+		return;
+	}
+
+	_bytesIn += _length;
+
+	if (_state != STATE_IDLE)
+	{
+		_spool->push(_batch, _length + 1);
+	}
+	else
+	{
+		size_t size = 0;
+
+		if (_compress)
+		{
+			size = _gzip.compress((const uint8_t*)_batch + 1, _length, (uint8_t*)_payload + 1, _length);
+		}
+
+		if (size > 0)
+		{
+			_payload[0] = ENCODING_GZIP;
+			_payloadLength = size + 1;
+		}
+		else
+		{
+			memcpy(_payload, _batch, _length + 1);
+			_payloadLength = _length + 1;
+		}
+
+		if (_spool->isEmpty() && isReady())
+		{
+			_spooled = false;
+			send();
+		}
+		else
+		{
+			_spool->push(_payload, _payloadLength);
+			_payloadLength = 0;
+		}
+	}
+
+	_length = 0;
+	_lines = 0;
+}
+
+/// <summary>
+///  Sends the payload as POST request (the connection is opened if not connected).
+/// </summary>
+void InfluxUploader::send()
+{
+	if (!_client->connected() && (_client->connect(_server, _port) == 0))
+	{
+		fail();
+		return;
+	}
+
+	char header[MAX_PATH_LEN + MAX_SERVER_LEN + MAX_TOKEN_LEN + 192];
+	size_t length = _payloadLength - 1;
+	bool token = (_token[0] != '\0');
+	int n = snprintf(header, sizeof(header),
+		"POST %s HTTP/1.1\r\n"
+		"Host: %s\r\n"
+		"Content-Type: text/plain; charset=utf-8\r\n"
+		"%s%s%s%s"
+		"Content-Length: %u\r\n\r\n",
+		_path, _server,
+		(_payload[0] == ENCODING_GZIP) ? "Content-Encoding: gzip\r\n" : "",
+		token ? "Authorization: Token " : "", _token, token ? "\r\n" : "",
+		(unsigned int)length);
+
+	if ((n <= 0) || ((size_t)n >= sizeof(header)) ||
+		(_client->write((const uint8_t*)header, n) != (size_t)n) ||
+		(_client->write((const uint8_t*)_payload + 1, length) != length))
+	{
+		fail();
+		return;
+	}
+
+	_state = STATE_SENDING;
+	_sentTime = millis();
+	_lineLength = 0;
+	_status = 0;
+	_body = false;
+	_contentLength = 0;
+	_close = false;
+}
+
+/// <summary>
+///  Parses the received bytes of the response (status line, headers, and body). The request fails if the
+///  connection is closed before the response is complete.
+/// </summary>
+void InfluxUploader::receive()
+{
+	while ((_state == STATE_SENDING) && (_client->available() > 0))
+	{
+		int c = _client->read();
+
+		if (c < 0)
+		{
+			break;
+		}
+
+		if (_body)
+		{
+			if (--_contentLength == 0)
+			{
+				complete();
+			}
+		}
+		else if (c == '\n')
+		{
+			if ((_lineLength > 0) && (_line[_lineLength - 1] == '\r'))
+			{
+				_lineLength--;
+			}
+
+			_line[_lineLength] = '\0';
+			parseLine();
+			_lineLength = 0;
+		}
+		else if (_lineLength < MAX_LINE)
+		{
+			_line[_lineLength++] = (char)c;
+		}
+	}
+
+	if ((_state == STATE_SENDING) && !_client->connected() && (_client->available() <= 0))
+	{
+		fail();
+	}
+}
+
+/// <summary>
+///  Handles a response line: the status line, the Content-Length and Connection headers, and the empty line
+///  ending the headers. A chunked response body is not parsed (the connection is closed instead).
+/// </summary>
+void InfluxUploader::parseLine()
+{
+	if (_status == 0)
+	{
+		const char* code = strchr(_line, ' ');
+
+		if ((strncmp(_line, "HTTP/", 5) == 0) && (code != NULL))
+		{
+			_status = (uint16_t)atoi(code + 1);
+		}
+
+		if (_status == 0)
+		{
+			fail();
+		}
+	}
+	else if (_lineLength == 0)
+	{
+		_body = true;
+
+		if (_contentLength == 0)
+		{
+			complete();
+		}
+	}
+	else if (strncasecmp(_line, "Content-Length:", 15) == 0)
+	{
+		_contentLength = strtoul(_line + 15, NULL, 10);
+	}
+	else if ((strncasecmp(_line, "Connection:", 11) == 0) && (strstr(_line + 11, "close") != NULL))
+	{
+		_close = true;
+	}
+	else if (strncasecmp(_line, "Transfer-Encoding:", 18) == 0)
+	{
+		_close = true;
+	}
+}
+
+/// <summary>
+///  Handles the complete response: 2xx (uploaded) and 4xx (rejected, except 408 and 429) remove the payload,
+///  the other status codes fail (the payload is retried).
+/// </summary>
+void InfluxUploader::complete()
+{
+	if ((_status >= 200) && (_status < 300))
+	{
+		_uploaded++;
+		_bytesOut += _payloadLength - 1;
+		_retry = 0;
+	}
+	else if ((_status >= 400) && (_status < 500) && (_status != 408) && (_status != 429))
+	{
+		_rejected++;
+	}
+	else
+	{
+		fail();
+		return;
+	}
+
+	if (_spooled)
+	{
+		_spool->pop();
+	}
+
+	if (_close)
+	{
+		_client->stop();
+	}
+
+	_state = STATE_IDLE;
+	_payloadLength = 0;
+}
+
+/// <summary>
+///  Closes the connection after a failed request, appends the payload to the spool (unless it is already
+///  spooled), and increases the retry interval.
+/// </summary>
+void InfluxUploader::fail()
+{
+	_client->stop();
+	_failed++;
+
+	if (!_spooled && (_payloadLength > 0))
+	{
+		_spool->push(_payload, _payloadLength);
+	}
+
+	_state = STATE_IDLE;
+	_payloadLength = 0;
+	_retryTime = millis();
+	backoff();
+}
+
+/// <summary>
+///  Completes, sends, and retries the batches: parses the response of a pending request (timeout), completes
+///  the batch if it is full or too old, and sends the oldest spooled batch if ready.
+/// </summary>
+void InfluxUploader::update()
+{
+	if (!isActive())
+	{
+		return;
+	}
+
+	if (_state == STATE_SENDING)
+	{
+		receive();
+
+		if ((_state == STATE_SENDING) && (millis() - _sentTime >= RESPONSE_TIMEOUT))
+		{
+			fail();
+		}
+	}
+
+	if ((_lines > 0) && ((_lines >= _maxLines) || (millis() - _batchTime >= _maxAge)))
+	{
+		seal();
+	}
+
+	if (!_spool->isEmpty() && isReady())
+	{
+		size_t length = _spool->peek(_payload, PAYLOAD_SIZE);
+
+		if (length > 1)
+		{
+			_payloadLength = length;
+			_spooled = true;
+			send();
+		}
+		else if (length > 0)
+		{
+			_spool->pop();
+		}
+	}
+}
+
+/// <summary>
+///  Closes the connection. The payload of a pending request is spooled (unless it is already spooled).
+/// </summary>
+void InfluxUploader::stop()
+{
+	if ((_state == STATE_SENDING) && !_spooled && (_payloadLength > 0))
+	{
+		_spool->push(_payload, _payloadLength);
+	}
+
+	_client->stop();
+	_state = STATE_IDLE;
+	_payloadLength = 0;
+}
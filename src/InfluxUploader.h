@@ -0,0 +1,118 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="InfluxUploader.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+
+#include "FlashQueue.h"
+#include "GzipWriter.h"
+
+/// <summary>
+/// This class uploads InfluxDB line protocol batches using HTTP POST requests (InfluxDB write API).
+///
+/// The lines are collected in a batch, the batch is completed if it contains the configured number of lines, its
+/// oldest line is older than the configured age, or the next line does not fit. A completed batch is compressed
+/// (gzip, sent uncompressed if it does not get smaller) and posted over a persistent connection (HTTP/1.1 keep
+/// alive), a batch completed while a request is pending is spooled uncompressed. The upload is driven by update() from the main loop, the response is parsed as it arrives.
+/// A failed batch (connect error, timeout, server error) is appended to the flash spool, the spooled batches are
+/// retried in order with an exponential backoff. A batch rejected by the server (4xx, e.g. invalid line protocol)
+/// is dropped. Note that the TCP connect itself may block (network client timeout).
+/// </summary>
+class InfluxUploader
+{
+public:
+	enum State : uint8_t
+	{
+		STATE_IDLE,												// No request pending
+		STATE_SENDING											// Request sent (waiting for the response)
+	};
+
+	static const size_t BATCH_SIZE = 4096;						// The maximum size of a batch (uncompressed)
+	static const size_t MAX_SERVER_LEN = 64;					// The maximum length of the server name
+	static const size_t MAX_PATH_LEN = 128;						// The maximum length of the request path
+	static const size_t MAX_TOKEN_LEN = 100;					// The maximum length of the API token
+	static const uint32_t RESPONSE_TIMEOUT = 10000;				// The time (msec) to wait for the response
+	static const uint32_t RETRY_MIN = 5000;						// The initial retry interval (msec)
+	static const uint32_t RETRY_MAX = 300000;					// The maximum retry interval (msec)
+
+private:
+	static const size_t PAYLOAD_SIZE = BATCH_SIZE + 1;			// The payload (encoding and body) buffer size
+	static const size_t MAX_LINE = 96;							// The maximum length of a response line
+
+	Client* _client;											// Pointer to the network client
+	bool (*_connected)();										// Function returning true if the network is up
+	FlashQueue* _spool;											// Pointer to the flash spool
+	GzipWriter _gzip;											// The compressor
+	char _server[MAX_SERVER_LEN + 1];							// The server (name or address)
+	uint16_t _port;												// The server TCP port
+	char _path[MAX_PATH_LEN + 1];								// The request path (write API with parameters)
+	char _token[MAX_TOKEN_LEN + 1];								// The API token (empty: no authorization)
+	uint16_t _maxLines;											// The maximum number of lines per batch
+	uint32_t _maxAge;											// The maximum age of a batch (msec)
+	bool _compress;												// Flag indicating that batches are compressed
+
+	char _batch[PAYLOAD_SIZE];									// The batch being collected ('t', lines)
+	size_t _length;												// The batch length
+	uint16_t _lines;											// The number of lines in the batch
+	uint32_t _batchTime;										// The time the first line has been added
+
+	char _payload[PAYLOAD_SIZE];								// The batch being sent ('z' gzip, 't' text, body)
+	size_t _payloadLength;										// The payload length (0: none)
+	bool _spooled;												// Flag indicating that the payload is from the spool
+
+	State _state;												// The upload state
+	uint32_t _sentTime;											// The time the request has been sent
+	uint32_t _retry;											// The current retry interval (msec, 0: none)
+	uint32_t _retryTime;										// The time of the last failure
+
+	char _line[MAX_LINE + 1];									// The received response line
+	size_t _lineLength;											// The response line length
+	uint16_t _status;											// The response status code (0: not received)
+	bool _body;													// Flag indicating that the headers are complete
+	uint32_t _contentLength;									// The remaining response body length
+	bool _close;												// Flag indicating that the server closes the connection
+
+	uint32_t _uploaded;											// The number of uploaded batches
+	uint32_t _failed;											// The number of failed requests
+	uint32_t _rejected;											// The number of batches rejected by the server
+	uint32_t _droppedLines;										// The number of lines dropped (too large)
+	uint32_t _bytesIn;											// The size of the completed batches (lines)
+	uint32_t _bytesOut;											// The size of the uploaded request bodies
+
+	bool isReady();												// Returns true if a request can be sent
+	void backoff();												// Doubles the retry interval
+	void seal();												// Completes the batch (send or spool)
+	void send();												// Sends the payload (POST request)
+	void receive();												// Parses the received response
+	void parseLine();											// Handles a response line (status, headers)
+	void complete();											// Handles the complete response
+	void fail();												// Closes the connection, spools the payload
+
+public:
+	InfluxUploader(Client* client, bool (*connected)(),			// Constructor using a client, a network check,
+		FlashQueue* spool);										// and a flash spool
+
+	void configure(const char* server, uint16_t port,			// Sets the server, port, path, and token
+		const char* path, const char* token);
+	void setBatch(uint16_t lines, uint16_t age, bool compress);	// Sets the batch limits (lines, sec) and gzip
+	bool addLine(const char* line, size_t length);				// Adds a complete line (terminated by '\n')
+	void update();												// Completes, sends, and retries batches
+	void stop();												// Closes the connection
+
+	bool isActive() const { return _server[0] != '\0'; }		// Returns true if a server is configured
+	bool isBusy() const { return _state != STATE_IDLE; }		// Returns true if a request is pending
+	uint16_t getLines() const { return _lines; }				// Returns the number of lines in the batch
+	uint32_t getUploaded() const { return _uploaded; }			// Returns the number of uploaded batches
+	uint32_t getFailed() const { return _failed; }				// Returns the number of failed requests
+	uint32_t getRejected() const { return _rejected; }			// Returns the number of rejected batches
+	uint32_t getDroppedLines() const { return _droppedLines; }	// Returns the number of dropped lines
+	uint32_t getBytesIn() const { return _bytesIn; }			// Returns the size of the completed batches
+	uint32_t getBytesOut() const { return _bytesOut; }			// Returns the size of the uploaded bodies
+};
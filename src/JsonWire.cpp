@@ -0,0 +1,66 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="JsonWire.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "Logger.h"
+#include "JsonWire.h"
+
+/// <summary>
+///  Writes a JSON value (objects and arrays recursively). Integers are written as integers, all other numbers
+///  as floating point numbers (single precision if exact). Raw (serialized) values are written as null.
+/// </summary>
+/// <param name="value">The JSON value</param>
+/// <param name="writer">The binary writer</param>
+void JsonWire::write(JsonVariantConst value, WireFormat& writer)
+{
+	JsonObjectConst obj = value.as<JsonObjectConst>();
+	JsonArrayConst arr = value.as<JsonArrayConst>();
+
+	if (!obj.isNull())
+	{
+		writer.writeMap(obj.size());
+
+		for (JsonPairConst pair : obj)
+		{
+			writer.writeString(pair.key().c_str());
+			write(pair.value(), writer);
+		}
+	}
+	else if (!arr.isNull())
+	{
+		writer.writeArray(arr.size());
+
+		for (JsonVariantConst item : arr)
+		{
+			write(item, writer);
+		}
+	}
+	else if (value.is<bool>())
+	{
+		writer.writeBool(value.as<bool>());
+	}
+	else if (value.is<long>())
+	{
+		writer.writeInt(value.as<long>());
+	}
+	else if (value.is<unsigned long>())
+	{
+		writer.writeUInt(value.as<unsigned long>());
+	}
+	else if (value.is<double>())
+	{
+		writer.writeFloat(value.as<double>());
+	}
+	else if (value.is<const char*>())
+	{
+		writer.writeString(value.as<const char*>());
+	}
+	else
+	{
+		writer.writeNull();
+	}
+}
@@ -0,0 +1,24 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="JsonWire.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "WireFormat.h"
+
+/// <summary>
+/// This class writes JSON documents in a binary format (CBOR or MessagePack, see WireFormat).
+/// The documents are written directly (no JSON string is created and parsed).
+/// </summary>
+class JsonWire
+{
+public:
+	static void write(JsonVariantConst value,					// Writes a JSON value (recursively)
+		WireFormat& writer);
+};
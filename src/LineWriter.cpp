@@ -0,0 +1,174 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LineWriter.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "LineWriter.h"
+
+/// <summary>
+///  Constructor using a buffer.
+/// </summary>
+/// <param name="buffer">The buffer</param>
+/// <param name="size">The buffer size</param>
+LineWriter::LineWriter(char* buffer, size_t size) :
+	_buffer(buffer),
+	_size(size),
+	_length(0),
+	_position(0),
+	_lines(0),
+	_fields(0),
+	_overflow(false)
+{
+}
+
+/// <summary>
+///  Appends text to the current line (the overflow flag is set if it does not fit).
+/// </summary>
+/// <param name="text">The text</param>
+/// <param name="length">The text length</param>
+void LineWriter::append(const char* text, size_t length)
+{
+	if (_overflow || (_position + length > _size))
+	{
+		_overflow = true;
+		return;
+	}
+
+	memcpy(_buffer + _position, text, length);
+	_position += length;
+}
+
+/// <summary>
+///  Appends text to the current line, the special characters are escaped using a backslash.
+/// </summary>
+/// <param name="text">The text</param>
+/// <param name="special">The characters to be escaped</param>
+void LineWriter::appendEscaped(const char* text, const char* special)
+{
+	for (const char* p = text; *p != '\0'; p++)
+	{
+		if (strchr(special, *p) != NULL)
+		{
+			append("\\", 1);
+		}
+
+		append(p, 1);
+	}
+}
+
+/// <summary>
+///  Starts a new line (an incomplete line is removed).
+/// </summary>
+/// <param name="measurement">The measurement name</param>
+void LineWriter::begin(const char* measurement)
+{
+	_position = _length;
+	_fields = 0;
+	_overflow = false;
+	appendEscaped(measurement, ", ");
+}
+
+/// <summary>
+///  Adds a tag. The tags have to be added before the first field.
+/// </summary>
+/// <param name="key">The tag key</param>
+/// <param name="value">The tag value (an empty value is skipped)</param>
+void LineWriter::tag(const char* key, const char* value)
+{
+	if ((_fields > 0) || (value == NULL) || (*value == '\0'))
+	{
+		return;
+	}
+
+	append(",", 1);
+	appendEscaped(key, ",= ");
+	append("=", 1);
+	appendEscaped(value, ",= ");
+}
+
+/// <summary>
+///  Adds an integer field (e.g. humidity=45i).
+/// </summary>
+/// <param name="key">The field key</param>
+/// <param name="value">The value</param>
+void LineWriter::field(const char* key, int value)
+{
+	char text[16];
+	int n = snprintf(text, sizeof(text), "%di", value);
+
+	append((_fields == 0) ? " " : ",", 1);
+	appendEscaped(key, ",= ");
+	append("=", 1);
+	append(text, n);
+	_fields++;
+}
+
+/// <summary>
+///  Adds a floating point field (e.g. voltage=2.58). NaN and infinite values are not supported by InfluxDB and
+///  are skipped.
+/// </summary>
+/// <param name="key">The field key</param>
+/// <param name="value">The value</param>
+void LineWriter::field(const char* key, float value)
+{
+	if (isnan(value) || isinf(value))
+	{
+		return;
+	}
+
+	char text[24];
+	int n = snprintf(text, sizeof(text), "%.7g", value);
+
+	append((_fields == 0) ? " " : ",", 1);
+	appendEscaped(key, ",= ");
+	append("=", 1);
+	append(text, n);
+	_fields++;
+}
+
+/// <summary>
+///  Completes the line. The line is removed if it does not fit or has no field.
+/// </summary>
+/// <param name="timestamp">The timestamp (0: none, the server time is used)</param>
+/// <returns>True if the line has been added</returns>
+bool LineWriter::end(uint32_t timestamp)
+{
+	if (timestamp > 0)
+	{
+		char text[16];
+		int n = snprintf(text, sizeof(text), " %lu", (unsigned long)timestamp);
+		append(text, n);
+	}
+
+	append("\n", 1);
+
+	if (_overflow || (_fields == 0))
+	{
+		_position = _length;
+		_overflow = false;
+		return false;
+	}
+
+	_length = _position;
+	_lines++;
+	return true;
+}
+
+/// <summary>
+///  Removes all lines.
+/// </summary>
+void LineWriter::clear()
+{
+	_length = 0;
+	_position = 0;
+	_lines = 0;
+	_fields = 0;
+	_overflow = false;
+}
@@ -0,0 +1,49 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LineWriter.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class writes lines of the InfluxDB line protocol into a fixed buffer:
+///
+///     measurement,tag=value,... field=value,... timestamp
+///
+/// The measurement, tag keys, tag values, and field keys are escaped (comma, equal sign, space), integer fields
+/// are written with the 'i' suffix. A line that does not fit into the buffer (or has no field) is removed again,
+/// so the buffer always contains complete lines.
+/// </summary>
+class LineWriter
+{
+private:
+	char* _buffer;												// The buffer
+	size_t _size;												// The buffer size
+	size_t _length;												// The length of the complete lines
+	size_t _position;											// The write position of the current line
+	uint16_t _lines;											// The number of complete lines
+	uint8_t _fields;											// The number of fields of the current line
+	bool _overflow;												// Flag indicating that the current line does not fit
+
+	void append(const char* text, size_t length);				// Appends text to the current line
+	void appendEscaped(const char* text, const char* special);	// Appends escaped text to the current line
+
+public:
+	LineWriter(char* buffer, size_t size);						// Constructor using a buffer
+
+	void begin(const char* measurement);						// Starts a line
+	void tag(const char* key, const char* value);				// Adds a tag (before the first field)
+	void field(const char* key, int value);						// Adds an integer field
+	void field(const char* key, float value);					// Adds a floating point field (NaN is skipped)
+	bool end(uint32_t timestamp = 0);							// Completes the line (false: removed)
+	void clear();												// Removes all lines
+
+	const char* getData() const { return _buffer; }				// Returns the lines
+	size_t getLength() const { return _length; }				// Returns the length of the complete lines
+	uint16_t getLines() const { return _lines; }				// Returns the number of complete lines
+};
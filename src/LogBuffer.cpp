@@ -0,0 +1,285 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogBuffer.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include "LogBuffer.h"
+
+/// <summary>
+///  Default constructor initializing the slot sequence numbers.
+/// </summary>
+LogBuffer::LogBuffer() :
+	_head(0),
+	_tail(0),
+	_dropped(0)
+{
+	for (uint32_t i = 0; i < SIZE; i++)
+	{
+		_slots[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+/// <summary>
+///  Stores a log record. The string arguments are copied into the record text area (truncated if necessary).
+///  This function never blocks, if the buffer is full the message is dropped.
+/// </summary>
+/// <param name="level">The log level</param>
+/// <param name="format">The format string (flash)</param>
+/// <param name="args">The raw arguments</param>
+/// <param name="count">The number of arguments</param>
+/// <returns>True if the record has been stored</returns>
+bool LogBuffer::push(uint8_t level, const char* format, const LogArg* args, uint8_t count)
+{
+	uint32_t position = _head.load(std::memory_order_relaxed);
+	Slot* slot;
+
+	for (;;)
+	{
+		slot = &_slots[position & (SIZE - 1)];
+		int32_t diff = (int32_t)(slot->Sequence.load(std::memory_order_acquire) - position);
+
+		if (diff == 0)
+		{
+			if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			position = _head.load(std::memory_order_relaxed);
+		}
+	}
+
+	LogRecord& record = slot->Record;
+	size_t used = 0;
+
+	record.Timestamp = millis();
+	record.Level = level;
+	record.Format = format;
+	record.Count = (count < LogRecord::MAX_ARGS) ? count : LogRecord::MAX_ARGS;
+
+	for (uint8_t i = 0; i < record.Count; i++)
+	{
+		record.Args[i] = args[i];
+
+		if (args[i].Kind == LogArg::STRING)
+		{
+			const char* text = (args[i].Text != NULL) ? args[i].Text : "";
+			size_t length = strnlen(text, LogRecord::TEXT_SIZE);
+
+			if (used + length + 1 > LogRecord::TEXT_SIZE)
+			{
+				length = (used < LogRecord::TEXT_SIZE) ? LogRecord::TEXT_SIZE - used - 1 : 0;
+			}
+
+			if (used < LogRecord::TEXT_SIZE)
+			{
+				memcpy(record.Text + used, text, length);
+				record.Text[used + length] = '\0';
+				record.Args[i].UInt = used;
+				used += length + 1;
+			}
+			else
+			{
+				record.Args[i].Kind = LogArg::NONE;
+			}
+		}
+	}
+
+	slot->Sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+/// <summary>
+///  Removes the oldest log record from the buffer.
+/// </summary>
+/// <param name="record">Reference to the record receiving the data</param>
+/// <returns>True if a record has been removed</returns>
+bool LogBuffer::pop(LogRecord& record)
+{
+	uint32_t position = _tail.load(std::memory_order_relaxed);
+	Slot* slot;
+
+	for (;;)
+	{
+		slot = &_slots[position & (SIZE - 1)];
+		int32_t diff = (int32_t)(slot->Sequence.load(std::memory_order_acquire) - (position + 1));
+
+		if (diff == 0)
+		{
+			if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			position = _tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	record = slot->Record;
+	slot->Sequence.store(position + SIZE, std::memory_order_release);
+	return true;
+}
+
+/// <summary>
+///  Returns the number of dropped messages (buffer full).
+/// </summary>
+/// <returns>The number of dropped messages</returns>
+uint32_t LogBuffer::getDropped() const
+{
+	return _dropped.load(std::memory_order_relaxed);
+}
+
+/// <summary>
+///  Appends a string to the buffer (truncated if necessary).
+/// </summary>
+/// <param name="buffer">The text buffer</param>
+/// <param name="size">The size of the text buffer</param>
+/// <param name="length">The current text length</param>
+/// <param name="text">The string to append</param>
+/// <returns>The new text length</returns>
+size_t LogBuffer::append(char* buffer, size_t size, size_t length, const char* text)
+{
+	while ((*text != '\0') && (length + 1 < size))
+	{
+		buffer[length++] = *text++;
+	}
+
+	buffer[length] = '\0';
+	return length;
+}
+
+/// <summary>
+///  Formats the message of a log record. The ArduinoLog format specifiers are supported:
+///  %s %S (string), %c (char), %d %i %l (integer), %u (unsigned), %x %X (hex), %b %B (binary),
+///  %t %T (boolean), %D %F (double), and %% (percent). A trailing newline is removed.
+/// </summary>
+/// <param name="record">The log record</param>
+/// <param name="buffer">The text buffer</param>
+/// <param name="size">The size of the text buffer</param>
+/// <returns>The message length</returns>
+size_t LogBuffer::format(const LogRecord& record, char* buffer, size_t size)
+{
+	const char* format = (record.Format != NULL) ? record.Format : "";
+	size_t length = 0;
+	uint8_t index = 0;
+	char number[36];
+
+	if (size == 0) return 0;
+	buffer[0] = '\0';
+
+	for (; (*format != '\0') && (length + 1 < size); format++)
+	{
+		if ((*format != '%') || (format[1] == '\0'))
+		{
+			buffer[length++] = *format;
+			buffer[length] = '\0';
+			continue;
+		}
+
+		char specifier = *++format;
+
+		if (specifier == '%')
+		{
+			length = append(buffer, size, length, "%");
+			continue;
+		}
+
+		if (index >= record.Count)
+		{
+			continue;
+		}
+
+		const LogArg& arg = record.Args[index++];
+		number[0] = '\0';
+
+		switch (specifier)
+		{
+		case 's':
+		case 'S':
+			if (arg.Kind == LogArg::STRING)
+			{
+				length = append(buffer, size, length, record.Text + arg.UInt);
+			}
+			break;
+		case 'c':
+			number[0] = (char)arg.Int;
+			number[1] = '\0';
+			break;
+		case 'd':
+		case 'i':
+		case 'l':
+			if (arg.Kind == LogArg::DOUBLE) snprintf(number, sizeof(number), "%ld", (long)arg.Double);
+			else snprintf(number, sizeof(number), "%ld", arg.Int);
+			break;
+		case 'u':
+			snprintf(number, sizeof(number), "%lu", arg.UInt);
+			break;
+		case 'x':
+			snprintf(number, sizeof(number), "%lx", arg.UInt);
+			break;
+		case 'X':
+			snprintf(number, sizeof(number), "0x%lX", arg.UInt);
+			break;
+		case 'b':
+		case 'B':
+		{
+			size_t n = 0;
+			unsigned long value = arg.UInt;
+			char bits[33];
+
+			do
+			{
+				bits[n++] = '0' + (value & 1);
+				value >>= 1;
+			} while ((value != 0) && (n < 32));
+
+			size_t offset = 0;
+			if (specifier == 'B') { number[offset++] = '0'; number[offset++] = 'b'; }
+			while (n > 0) number[offset++] = bits[--n];
+			number[offset] = '\0';
+			break;
+		}
+		case 't':
+			number[0] = arg.Int ? 'T' : 'F';
+			number[1] = '\0';
+			break;
+		case 'T':
+			snprintf(number, sizeof(number), "%s", arg.Int ? "true" : "false");
+			break;
+		case 'D':
+		case 'F':
+			if (arg.Kind == LogArg::DOUBLE) snprintf(number, sizeof(number), "%.2f", arg.Double);
+			else snprintf(number, sizeof(number), "%ld", arg.Int);
+			break;
+		default:
+			break;
+		}
+
+		length = append(buffer, size, length, number);
+	}
+
+	while ((length > 0) && ((buffer[length - 1] == '\n') || (buffer[length - 1] == '\r')))
+	{
+		buffer[--length] = '\0';
+	}
+
+	return length;
+}
@@ -0,0 +1,100 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogBuffer.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <Arduino.h>
+
+/// <summary>
+/// This class holds a single raw log argument (integer, unsigned, double, or string).
+/// String arguments are copied into the text area of the log record when the record is stored.
+/// </summary>
+class LogArg
+{
+public:
+	enum Type : uint8_t { NONE, INT, UINT, DOUBLE, STRING };
+
+	Type Kind;													// The argument type
+	union
+	{
+		long Int;												// Signed integer value (also bool and char)
+		unsigned long UInt;										// Unsigned integer value (or string offset)
+		double Double;											// Floating point value
+		const char* Text;										// String value (before it is stored)
+	};
+
+	LogArg() : Kind(NONE), UInt(0) {}
+	LogArg(bool value) : Kind(INT), Int(value) {}
+	LogArg(char value) : Kind(INT), Int(value) {}
+	LogArg(signed char value) : Kind(INT), Int(value) {}
+	LogArg(short value) : Kind(INT), Int(value) {}
+	LogArg(int value) : Kind(INT), Int(value) {}
+	LogArg(long value) : Kind(INT), Int(value) {}
+	LogArg(unsigned char value) : Kind(UINT), UInt(value) {}
+	LogArg(unsigned short value) : Kind(UINT), UInt(value) {}
+	LogArg(unsigned int value) : Kind(UINT), UInt(value) {}
+	LogArg(unsigned long value) : Kind(UINT), UInt(value) {}
+	LogArg(float value) : Kind(DOUBLE), Double(value) {}
+	LogArg(double value) : Kind(DOUBLE), Double(value) {}
+	LogArg(const char* value) : Kind(STRING), Text(value) {}
+	LogArg(const String& value) : Kind(STRING), Text(value.c_str()) {}
+};
+
+/// <summary>
+/// This class holds a single log message (timestamp, level, format and raw arguments).
+/// The format string is not copied, it has to be a string literal (flash resident).
+/// </summary>
+struct LogRecord
+{
+	static const uint8_t MAX_ARGS = 4;							// The maximum number of arguments
+	static const uint8_t TEXT_SIZE = 48;						// The size of the string argument area
+
+	uint32_t Timestamp;											// The time (msec) the message was logged
+	uint8_t Level;												// The log level
+	uint8_t Count;												// The number of arguments
+	const char* Format;											// The format string (flash)
+	LogArg Args[MAX_ARGS];										// The raw arguments
+	char Text[TEXT_SIZE];										// The copied string arguments
+};
+
+/// <summary>
+/// This class implements a bounded lock-free log record queue (multiple producers, multiple consumers).
+/// Producers never block, if the queue is full the message is dropped and counted.
+/// </summary>
+class LogBuffer
+{
+public:
+	static const uint16_t SIZE = 32;							// The number of records (power of two)
+
+private:
+	struct Slot
+	{
+		std::atomic<uint32_t> Sequence;							// The slot sequence number
+		LogRecord Record;										// The log record
+	};
+
+	Slot _slots[SIZE];											// The record slots
+	std::atomic<uint32_t> _head;								// The next write position
+	std::atomic<uint32_t> _tail;								// The next read position
+	std::atomic<uint32_t> _dropped;								// The number of dropped messages
+
+	static size_t append(char* buffer, size_t size,				// Appends a string to the buffer
+		size_t length, const char* text);
+
+public:
+	LogBuffer();												// Default constructor
+
+	bool push(uint8_t level, const char* format,				// Stores a log record (non blocking)
+		const LogArg* args, uint8_t count);
+	bool pop(LogRecord& record);								// Removes the oldest log record
+	uint32_t getDropped() const;								// Returns the number of dropped messages
+
+	static size_t format(const LogRecord& record,				// Formats the message of a log record
+		char* buffer, size_t size);
+};
@@ -0,0 +1,268 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogFile.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "LogFile.h"
+
+/// <summary>
+///  Constructor using a file system.
+/// </summary>
+/// <param name="fs">Pointer to the file system</param>
+LogFile::LogFile(fs::FS* fs) :
+	_fs(fs),
+	_length(0),
+	_first(0)
+{
+}
+
+/// <summary>
+///  Returns the path of the specified log file (/log0.txt is the current file).
+/// </summary>
+/// <param name="index">The file index</param>
+/// <returns>The file path</returns>
+String LogFile::getPath(uint8_t index)
+{
+	return String("/log") + String(index) + String(".txt");
+}
+
+/// <summary>
+///  Appends a single log line to the write buffer. The buffer is written to the file only if it is full.
+/// </summary>
+/// <param name="timestamp">The timestamp (msec)</param>
+/// <param name="level">The log level</param>
+/// <param name="message">The formatted message</param>
+/// <param name="length">The message length</param>
+void LogFile::write(uint32_t timestamp, uint8_t level, const char* message, size_t length)
+{
+	char prefix[24];
+	size_t n = formatPrefix(prefix, sizeof(prefix), timestamp, level);
+
+	if (n + length + 1 > BUFFER_SIZE)
+	{
+		length = BUFFER_SIZE - n - 1;
+	}
+
+	lock();
+
+	if (_length + n + length + 1 > BUFFER_SIZE)
+	{
+		writeBuffer();
+	}
+
+	if (_length == 0)
+	{
+		_first = millis();
+	}
+
+	memcpy(_buffer + _length, prefix, n);
+	_length += n;
+	memcpy(_buffer + _length, message, length);
+	_length += length;
+	_buffer[_length++] = '\n';
+
+	unlock();
+}
+
+/// <summary>
+///  Writes the buffer to the file if the oldest buffered line exceeds the flush interval.
+/// </summary>
+void LogFile::update()
+{
+	lock();
+
+	if ((_length > 0) && (millis() - _first >= FLUSH_INTERVAL))
+	{
+		writeBuffer();
+	}
+
+	unlock();
+}
+
+/// <summary>
+///  Writes the buffer to the current log file.
+/// </summary>
+void LogFile::flush()
+{
+	lock();
+	writeBuffer();
+	unlock();
+}
+
+/// <summary>
+///  Appends the buffer to the current log file, and rotates the files if the maximum size is exceeded.
+///  Note that the mutex has to be taken.
+/// </summary>
+void LogFile::writeBuffer()
+{
+	if ((_fs == NULL) || (_length == 0))
+	{
+		return;
+	}
+
+	File file = _fs->open(getPath(0), FILE_APPEND);
+
+	if (file)
+	{
+		file.write((const uint8_t*)_buffer, _length);
+		size_t size = file.size();
+		file.close();
+
+		if (size >= MAX_FILE_SIZE)
+		{
+			rotate();
+		}
+	}
+
+	_length = 0;
+}
+
+/// <summary>
+///  Rotates the log files (the oldest file is removed).
+/// </summary>
+void LogFile::rotate()
+{
+	String oldest = getPath(FILE_COUNT - 1);
+
+	if (_fs->exists(oldest))
+	{
+		_fs->remove(oldest);
+	}
+
+	for (int i = FILE_COUNT - 2; i >= 0; i--)
+	{
+		String path = getPath(i);
+
+		if (_fs->exists(path))
+		{
+			_fs->rename(path, getPath(i + 1));
+		}
+	}
+}
+
+/// <summary>
+///  Returns the total size of the log (all files and the write buffer).
+/// </summary>
+/// <returns>The log size in bytes</returns>
+size_t LogFile::size()
+{
+	size_t total = 0;
+
+	lock();
+
+	for (uint8_t i = 0; i < FILE_COUNT; i++)
+	{
+		File file = _fs->open(getPath(i), FILE_READ);
+
+		if (file)
+		{
+			total += file.size();
+			file.close();
+		}
+	}
+
+	total += _length;
+	unlock();
+
+	return total;
+}
+
+/// <summary>
+///  Prints the last bytes of the log (oldest first) in chunks, without loading the files into RAM.
+///  The mutex is only taken while reading a chunk, so the log task is not blocked by a slow output.
+/// </summary>
+/// <param name="output">The print output</param>
+/// <param name="count">The maximum number of bytes</param>
+/// <returns>The number of bytes printed</returns>
+size_t LogFile::tail(Print& output, size_t count)
+{
+	uint8_t chunk[CHUNK_SIZE];
+	size_t total = size();
+	size_t skip = (total > count) ? total - count : 0;
+	size_t printed = 0;
+
+	for (int i = FILE_COUNT - 1; i >= 0; i--)
+	{
+		size_t position = 0;
+
+		for (;;)
+		{
+			size_t n = 0;
+
+			lock();
+			File file = _fs->open(getPath(i), FILE_READ);
+
+			if (file)
+			{
+				size_t size = file.size();
+
+				if (position == 0)
+				{
+					if (skip >= size)
+					{
+						skip -= size;
+						position = size;
+					}
+					else
+					{
+						position = skip;
+						skip = 0;
+					}
+				}
+
+				if ((position < size) && file.seek(position))
+				{
+					n = file.read(chunk, sizeof(chunk));
+					position += n;
+				}
+
+				file.close();
+			}
+
+			unlock();
+
+			if (n == 0)
+			{
+				break;
+			}
+
+			printed += output.write(chunk, n);
+		}
+	}
+
+	// Print the (not yet written) buffered lines from a copy.
+	char pending[BUFFER_SIZE];
+
+	lock();
+	size_t offset = (skip < _length) ? skip : _length;
+	size_t n = _length - offset;
+	memcpy(pending, _buffer + offset, n);
+	unlock();
+
+	printed += output.write((const uint8_t*)pending, n);
+	return printed;
+}
+
+/// <summary>
+///  Removes all log files and clears the write buffer.
+/// </summary>
+void LogFile::clear()
+{
+	lock();
+
+	for (uint8_t i = 0; i < FILE_COUNT; i++)
+	{
+		String path = getPath(i);
+
+		if (_fs->exists(path))
+		{
+			_fs->remove(path);
+		}
+	}
+
+	_length = 0;
+	unlock();
+}
@@ -0,0 +1,53 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogFile.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "LogSink.h"
+
+/// <summary>
+/// This class implements a size bounded rotating log file sink on the flash file system.
+/// 
+/// The log lines are collected in a RAM buffer, and appended to the current log file only if the buffer is full,
+/// the flush interval has elapsed, or flush() is called. The files are rotated if the current file exceeds the
+/// maximum file size (log0.txt is the current file, log3.txt the oldest file).
+/// </summary>
+class LogFile : public LogSink
+{
+public:
+	static const uint8_t FILE_COUNT = 4;						// The number of log files
+	static const size_t MAX_FILE_SIZE = 16384;					// The maximum size of a single log file
+	static const size_t BUFFER_SIZE = 1024;						// The size of the write buffer
+	static const uint32_t FLUSH_INTERVAL = 60000;				// The maximum time (msec) a line is kept in RAM
+	static const size_t CHUNK_SIZE = 256;						// The chunk size used for reading
+
+private:
+	fs::FS* _fs;												// Pointer to the file system
+	char _buffer[BUFFER_SIZE];									// The write buffer
+	size_t _length;												// The number of buffered bytes
+	uint32_t _first;											// The time the first buffered line was written
+
+	static String getPath(uint8_t index);						// Returns the path of the specified log file
+	void writeBuffer();											// Appends the buffer to the current log file
+	void rotate();												// Rotates the log files
+
+public:
+	LogFile(fs::FS* fs);										// Constructor using a file system
+
+	void write(uint32_t timestamp, uint8_t level,				// Writes a single formatted message
+		const char* message, size_t length) override;
+	void update() override;										// Writes the buffer if the flush interval has elapsed
+	void flush() override;										// Writes the buffer to the current log file
+
+	size_t size();												// Returns the total size of the log (files and buffer)
+	size_t tail(Print& output, size_t count);					// Prints the last bytes of the log (chunked)
+	void clear();												// Removes all log files
+};
@@ -6,6 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
+#include "Logger.h"
+#include "JsonWire.h"
 #include "LogSettings.h"
 
 /// <summary>
@@ -13,12 +15,15 @@
 /// </summary>
 LogSettings::LogSettings() :
 	_logLevelApp(LOG_LEVEL_ERROR),
+	_logLevelSyslog(LOG_LEVEL_SILENT),
+	_syslogServer(""),
+	_syslogPort(SYSLOG_PORT),
 	_logLevelAll(ESP_LOG_ERROR),
 	_logLevelWiFi(ESP_LOG_ERROR),
 	_logLevelDhcps(ESP_LOG_ERROR),
 	_logLevelDhcpc(ESP_LOG_ERROR)
 {
-	Log.trace("LogSettings::LogSettings()" CR);
+	LOG_TRACE("LogSettings::LogSettings()" CR);
 }
 
 // set log level for the application
@@ -33,6 +38,30 @@ bool LogSettings::setLogLevelApp(String level)
 	return false;
 }
 
+// Set log level for the syslog output
+bool LogSettings::setLogLevelSyslog(String level)
+{
+	if (isLogLevel(level))
+	{
+		_logLevelSyslog = convertLogLevel(level);
+		return true;
+	}
+
+	return false;
+}
+
+// Set the syslog server (empty to disable)
+void LogSettings::setSyslogServer(String server)
+{
+	_syslogServer = server;
+}
+
+// Set the syslog server UDP port
+void LogSettings::setSyslogPort(uint16_t port)
+{
+	_syslogPort = port;
+}
+
 // Set log level component (all)
 bool LogSettings::setLogLevelAll(String level)
 {
@@ -87,6 +116,24 @@ String LogSettings::getLogLevelApp()
 	return convertLogLevel(_logLevelApp);
 }
 
+// Get log level for the syslog output
+String LogSettings::getLogLevelSyslog()
+{
+	return convertLogLevel(_logLevelSyslog);
+}
+
+// Get the syslog server
+String LogSettings::getSyslogServer()
+{
+	return _syslogServer;
+}
+
+// Get the syslog server UDP port
+uint16_t LogSettings::getSyslogPort()
+{
+	return _syslogPort;
+}
+
 // Set log level component (all)
 String LogSettings::getLogLevelAll()
 {
@@ -117,6 +164,12 @@ int LogSettings::getArduinoLogLevelApp()
 	return _logLevelApp;
 }
 
+// ArduinoLog level for the syslog output
+int LogSettings::getArduinoLogLevelSyslog()
+{
+	return _logLevelSyslog;
+}
+
 // ESP log level component (all)
 esp_log_level_t LogSettings::getEspLevelAll()
 {
@@ -148,7 +201,7 @@ esp_log_level_t LogSettings::getEspLevelDhcpc()
 /// <returns>True if successful</returns>
 bool LogSettings::deserialize(String json)
 {
-	Log.trace("LogSettings::deserialize()" CR);
+	LOG_TRACE("LogSettings::deserialize()" CR);
 
 	if (json.length() > 0)
 	{
@@ -156,17 +209,21 @@ bool LogSettings::deserialize(String json)
 
 		if (err)
 		{
-			Log.error("LogSettings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
+			LOG_ERROR("LogSettings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
 			return false;
 		}
 
 		String logLevelApp   = _doc["Level"] | convertLogLevel(_logLevelApp);
+		String logLevelSys   = _doc["Syslog"] | convertLogLevel(_logLevelSyslog);
 		String logLevelAll   = _doc["All"]   | convertEspLevel(_logLevelAll);
 		String logLevelWiFi  = _doc["WiFi"]  | convertEspLevel(_logLevelWiFi);
 		String logLevelDhcps = _doc["Dhcps"] | convertEspLevel(_logLevelDhcps);
 		String logLevelDhcpc = _doc["Dhcpc"] | convertEspLevel(_logLevelDhcpc);
 
 		_logLevelApp   = convertLogLevel(logLevelApp);
+		_logLevelSyslog = convertLogLevel(logLevelSys);
+		_syslogServer  = _doc["SyslogServer"] | _syslogServer;
+		_syslogPort    = _doc["SyslogPort"] | _syslogPort;
 		_logLevelAll   = convertEspLevel(logLevelAll);
 		_logLevelWiFi  = convertEspLevel(logLevelWiFi);
 		_logLevelDhcps = convertEspLevel(logLevelDhcps);
@@ -175,7 +232,7 @@ bool LogSettings::deserialize(String json)
 		return true;
 	}
 
-	Log.warning("LogSettings::deserialize() Invalid JSON string" CR);
+	LOG_WARNING("LogSettings::deserialize() Invalid JSON string" CR);
 	return false;
 }
 
@@ -185,18 +242,40 @@ bool LogSettings::deserialize(String json)
 /// <returns>The JSON string</returns>
 String LogSettings::serialize()
 {
-	Log.trace("LogSettings::serialize()" CR);
+	LOG_TRACE("LogSettings::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void LogSettings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("LogSettings::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void LogSettings::build()
+{
 	_doc.clear();
 	_doc["Level"] = convertLogLevel(_logLevelApp);
 	_doc["All"]   = convertEspLevel(_logLevelAll);
 	_doc["WiFi"]  = convertEspLevel(_logLevelWiFi);
 	_doc["Dhcps"] = convertEspLevel(_logLevelDhcps);
 	_doc["Dhcpc"] = convertEspLevel(_logLevelDhcpc);
-
-	serializeJsonPretty(_doc, json);
-	return json;
+	_doc["Syslog"] = convertLogLevel(_logLevelSyslog);
+	_doc["SyslogServer"] = _syslogServer;
+	_doc["SyslogPort"] = _syslogPort;
 }
 
 /// <summary>
@@ -214,7 +293,7 @@ String LogSettings::convertLogLevel(int level)
 	if (level == LOG_LEVEL_TRACE)   return "TRACE";
 	if (level == LOG_LEVEL_VERBOSE) return "VERBOSE";
 
-	Log.warning("LogSettings::convertLogLevel() Invalid log level: %d" CR, level);
+	LOG_WARNING("LogSettings::convertLogLevel() Invalid log level: %d" CR, level);
 	return String("INVALID");
 }
 
@@ -234,7 +313,7 @@ int LogSettings::convertLogLevel(String level)
 	if (level == "TRACE")   return LOG_LEVEL_TRACE;
 	if (level == "VERBOSE") return LOG_LEVEL_VERBOSE;
 
-	Log.warning("LogSettings::convertLogLevel() Invalid log level: %s" CR, level);
+	LOG_WARNING("LogSettings::convertLogLevel() Invalid log level: %s" CR, level.c_str());
 	return LOG_LEVEL_SILENT;
 }
 
@@ -270,7 +349,7 @@ esp_log_level_t LogSettings::convertEspLevel(String level)
 	if (level == "DEBUG")   return ESP_LOG_DEBUG;
 	if (level == "VERBOSE") return ESP_LOG_VERBOSE;
 
-	Log.warning("LogSettings::convertEspLevel() Invalid log level: %s" CR, level);
+	LOG_WARNING("LogSettings::convertEspLevel() Invalid log level: %s" CR, level.c_str());
 	return ESP_LOG_NONE;
 }
 
@@ -288,7 +367,7 @@ esp_log_level_t LogSettings::convertEspLevel(int level)
 	if (level == ESP_LOG_DEBUG)   return ESP_LOG_DEBUG;
 	if (level == ESP_LOG_VERBOSE) return ESP_LOG_VERBOSE;
 
-	Log.warning("LogSettings::convertEspLevel() Invalid log level: %s" CR, level);
+	LOG_WARNING("LogSettings::convertEspLevel() Invalid log level: %d" CR, level);
 	return ESP_LOG_NONE;
 }
 
@@ -336,9 +415,12 @@ bool LogSettings::isEspLevel(String level)
 /// </summary>
 void LogSettings::reset()
 {
-	Log.trace("LogSettings::reset()" CR);
+	LOG_TRACE("LogSettings::reset()" CR);
 
 	_logLevelApp = LOG_LEVEL_ERROR;
+	_logLevelSyslog = LOG_LEVEL_SILENT;
+	_syslogServer = "";
+	_syslogPort = SYSLOG_PORT;
 	_logLevelAll = ESP_LOG_ERROR;
 	_logLevelWiFi = ESP_LOG_ERROR;
 	_logLevelDhcps = ESP_LOG_ERROR;
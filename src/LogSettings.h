@@ -11,6 +11,7 @@
 #include <Arduino.h>
 #include <ArduinoLog.h>
 #include <ArduinoJson.h>
+#include "WireFormat.h"
 
 /// <summary>
 /// This class holds the log level configuration data.
@@ -39,10 +40,16 @@ class LogSettings
 {
 private:
 	static const int CAPACITY = 						// The maximum size for the JSON document
-		JSON_OBJECT_SIZE(5) + 67;
+		JSON_OBJECT_SIZE(8) + 192;
 	StaticJsonDocument<CAPACITY> _doc;					// The static JSON document
+	void build();										// Builds the document
+
+	static const uint16_t SYSLOG_PORT = 514;			// The default syslog UDP port
 
 	int _logLevelApp;									// Log level for the application
+	int _logLevelSyslog;								// Log level for the syslog output
+	String _syslogServer;								// The syslog server (name or address)
+	uint16_t _syslogPort;								// The syslog server UDP port
 	esp_log_level_t _logLevelAll;						// Log level component (all)
 	esp_log_level_t _logLevelWiFi;						// Log level component (wifi)
 	esp_log_level_t _logLevelDhcps;						// Log level component (dhcps)
@@ -60,18 +67,25 @@ public:
 	LogSettings();										// Default constructor
 
 	bool setLogLevelApp(String level);					// Log level for the application
+	bool setLogLevelSyslog(String level);				// Log level for the syslog output
+	void setSyslogServer(String server);				// The syslog server (empty to disable)
+	void setSyslogPort(uint16_t port);					// The syslog server UDP port
 	bool setLogLevelAll(String level);					// Log level component (all)
 	bool setLogLevelWiFi(String level);					// Log level component (wifi)
 	bool setLogLevelDhcps(String level);				// Log level component (dhcps)
 	bool setLogLevelDhcpc(String level);				// Log level component (dhcpc)
 
 	String getLogLevelApp();							// Log level for the application
+	String getLogLevelSyslog();							// Log level for the syslog output
+	String getSyslogServer();							// The syslog server
+	uint16_t getSyslogPort();							// The syslog server UDP port
 	String getLogLevelAll();							// Log level component (all)
 	String getLogLevelWiFi();							// Log level component (wifi)
 	String getLogLevelDhcps();							// Log level component (dhcps)
 	String getLogLevelDhcpc();							// Log level component (dhcpc)
 
 	int getArduinoLogLevelApp();						// ArduinoLog level for the application
+	int getArduinoLogLevelSyslog();						// ArduinoLog level for the syslog output
 	esp_log_level_t getEspLevelAll();					// ESP log level component (all)
 	esp_log_level_t getEspLevelWiFi();					// ESP log level component (wifi)
 	esp_log_level_t getEspLevelDhcps();					// ESP log level component (dhcps)
@@ -79,6 +93,7 @@ public:
 
 	bool deserialize(String json);						// Read a JSON string and updates the fields.
 	String serialize();									// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);					// Writes a binary serialization (CBOR, MessagePack)
 	void reset();										// Resets all settings
 };
 
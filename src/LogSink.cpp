@@ -0,0 +1,105 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogSink.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "LogSink.h"
+
+/// <summary>
+///  Initializes the sink (creates the mutex).
+/// </summary>
+void LogSink::begin()
+{
+	if (_mutex == NULL)
+	{
+		_mutex = xSemaphoreCreateMutex();
+	}
+}
+
+/// <summary>
+///  Takes the mutex (if initialized).
+/// </summary>
+void LogSink::lock()
+{
+	if (_mutex != NULL)
+	{
+		xSemaphoreTake((SemaphoreHandle_t)_mutex, portMAX_DELAY);
+	}
+}
+
+/// <summary>
+///  Gives the mutex (if initialized).
+/// </summary>
+void LogSink::unlock()
+{
+	if (_mutex != NULL)
+	{
+		xSemaphoreGive((SemaphoreHandle_t)_mutex);
+	}
+}
+
+/// <summary>
+///  Returns the level character (F, E, W, N, T, V).
+/// </summary>
+/// <param name="level">The ArduinoLog level</param>
+/// <returns>The level character</returns>
+char LogSink::getLevelChar(uint8_t level)
+{
+	static const char LEVELS[] = "?FEWNTV";
+	return (level < sizeof(LEVELS) - 1) ? LEVELS[level] : '?';
+}
+
+/// <summary>
+///  Formats the line prefix using the run time (hh:mm:ss) and the level character.
+/// </summary>
+/// <param name="buffer">The text buffer</param>
+/// <param name="size">The size of the text buffer</param>
+/// <param name="timestamp">The timestamp (msec)</param>
+/// <param name="level">The log level</param>
+/// <returns>The prefix length</returns>
+size_t LogSink::formatPrefix(char* buffer, size_t size, uint32_t timestamp, uint8_t level)
+{
+	unsigned long allSeconds = timestamp / 1000;
+	int runHours = allSeconds / 3600;
+	int secsRemaining = allSeconds % 3600;
+	int runMinutes = secsRemaining / 60;
+	int runSeconds = secsRemaining % 60;
+
+	int length = snprintf(buffer, size, "%02d:%02d:%02d %c: ", runHours, runMinutes, runSeconds, getLevelChar(level));
+	return (length < 0) ? 0 : ((size_t)length < size ? (size_t)length : size - 1);
+}
+
+/// <summary>
+///  Constructor using a print output.
+/// </summary>
+/// <param name="output">Pointer to the print output</param>
+PrintSink::PrintSink(Print* output) :
+	_output(output)
+{
+}
+
+/// <summary>
+///  Writes a single formatted message as a line (with prefix).
+/// </summary>
+/// <param name="timestamp">The timestamp (msec)</param>
+/// <param name="level">The log level</param>
+/// <param name="message">The formatted message</param>
+/// <param name="length">The message length</param>
+void PrintSink::write(uint32_t timestamp, uint8_t level, const char* message, size_t length)
+{
+	char prefix[24];
+
+	if (_output != NULL)
+	{
+		size_t n = formatPrefix(prefix, sizeof(prefix), timestamp, level);
+		_output->write((const uint8_t*)prefix, n);
+		_output->write((const uint8_t*)message, length);
+		_output->write((const uint8_t*)"\n", 1);
+	}
+}
@@ -0,0 +1,54 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogSink.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class is the base class for all log outputs (sinks).
+/// The sinks are called from the log task (or Logger::flush()), a formatted message does not contain a trailing newline.
+/// </summary>
+class LogSink
+{
+private:
+	void* _mutex = NULL;										// The mutex protecting the sink data
+
+protected:
+	void lock();												// Takes the mutex (if initialized)
+	void unlock();												// Gives the mutex (if initialized)
+
+public:
+	virtual ~LogSink() {}
+
+	void begin();												// Initializes the sink (mutex)
+
+	virtual void write(uint32_t timestamp, uint8_t level,		// Writes a single formatted message
+		const char* message, size_t length) = 0;
+	virtual void update() {}									// Called periodically by the log task
+	virtual void flush() {}										// Flushes any buffered output
+
+	static char getLevelChar(uint8_t level);					// Returns the level character (F, E, W, N, T, V)
+	static size_t formatPrefix(char* buffer, size_t size,		// Formats the line prefix (hh:mm:ss L: )
+		uint32_t timestamp, uint8_t level);
+};
+
+/// <summary>
+/// This class implements a log sink using a print output (Serial, Bluetooth serial).
+/// </summary>
+class PrintSink : public LogSink
+{
+private:
+	Print* _output;												// Pointer to the print output
+
+public:
+	PrintSink(Print* output);									// Constructor using a print output
+
+	void write(uint32_t timestamp, uint8_t level,				// Writes a single formatted message
+		const char* message, size_t length) override;
+};
@@ -0,0 +1,335 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogSyslog.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "LogSyslog.h"
+
+/// <summary>
+/// The minimum valid wall clock time (2020-01-01), before the time is synchronized no timestamp is sent.
+/// </summary>
+static const time_t MIN_VALID_TIME = 1577836800;
+
+/// <summary>
+///  Constructor using a UDP instance and a function checking the network connection.
+/// </summary>
+/// <param name="udp">Pointer to the UDP instance</param>
+/// <param name="connected">Function returning true if the network is up</param>
+LogSyslog::LogSyslog(UDP* udp, bool (*connected)()) :
+	_udp(udp),
+	_connected(connected),
+	_level(LOG_LEVEL_SILENT),
+	_port(514),
+	_length(0),
+	_count(0),
+	_first(0),
+	_tokens(MAX_RATE),
+	_refill(0),
+	_sequence(0),
+	_sent(0),
+	_dropped(0)
+{
+	_server[0] = '\0';
+	_hostname[0] = '\0';
+}
+
+/// <summary>
+///  Sets the syslog level, server, port and hostname. An empty server name disables the sink.
+/// </summary>
+/// <param name="level">The syslog log level</param>
+/// <param name="server">The syslog server (name or address)</param>
+/// <param name="port">The syslog server UDP port</param>
+/// <param name="hostname">The hostname used in the messages</param>
+void LogSyslog::configure(int level, const char* server, uint16_t port, const char* hostname)
+{
+	lock();
+
+	_level = level;
+	_port = port;
+	strncpy(_server, (server != NULL) ? server : "", MAX_SERVER_LEN);
+	_server[MAX_SERVER_LEN] = '\0';
+	strncpy(_hostname, (hostname != NULL) ? hostname : "", MAX_HOSTNAME_LEN);
+	_hostname[MAX_HOSTNAME_LEN] = '\0';
+
+	// Replace spaces (not allowed in the hostname field).
+	for (char* p = _hostname; *p != '\0'; p++)
+	{
+		if (*p == ' ') *p = '_';
+	}
+
+	unlock();
+}
+
+/// <summary>
+///  Returns true if the sink is configured (level and server).
+/// </summary>
+/// <returns>True if active</returns>
+bool LogSyslog::isActive()
+{
+	return (_level > LOG_LEVEL_SILENT) && (_server[0] != '\0') && (_port != 0);
+}
+
+/// <summary>
+///  Adds a single formatted message to the buffer. The message is dropped if the network is down,
+///  or if the buffer is full and can not be sent because of the rate limit.
+/// </summary>
+/// <param name="timestamp">The timestamp (msec)</param>
+/// <param name="level">The log level</param>
+/// <param name="message">The formatted message</param>
+/// <param name="length">The message length</param>
+void LogSyslog::write(uint32_t timestamp, uint8_t level, const char* message, size_t length)
+{
+	char buffer[MESSAGE_SIZE];
+
+	lock();
+
+	if (!isActive() || (level > _level))
+	{
+		unlock();
+		return;
+	}
+
+	if ((_connected != NULL) && !_connected())
+	{
+		_dropped++;
+		unlock();
+		return;
+	}
+
+	size_t n = formatMessage(buffer, sizeof(buffer), time(NULL), timestamp, ++_sequence, level, _hostname, message, length);
+
+	if ((_length > 0) && (_length + n + sizeof(uint16_t) > BUFFER_SIZE))
+	{
+		send(true);
+	}
+
+	if (_length + n + sizeof(uint16_t) > BUFFER_SIZE)
+	{
+		_dropped++;
+		unlock();
+		return;
+	}
+
+	if (_length == 0)
+	{
+		_first = millis();
+	}
+
+	uint16_t size = (uint16_t)n;
+	memcpy(_buffer + _length, &size, sizeof(size));
+	memcpy(_buffer + _length + sizeof(size), buffer, n);
+	_length += n + sizeof(size);
+	_count++;
+
+	unlock();
+}
+
+/// <summary>
+///  Sends the buffered messages if the oldest message exceeds the batch interval.
+/// </summary>
+void LogSyslog::update()
+{
+	lock();
+	refill();
+
+	if ((_length > 0) && (millis() - _first >= BATCH_INTERVAL))
+	{
+		send(true);
+	}
+
+	unlock();
+}
+
+/// <summary>
+///  Sends the buffered messages ignoring the rate limit (e.g. before a restart).
+/// </summary>
+void LogSyslog::flush()
+{
+	lock();
+	send(false);
+	unlock();
+}
+
+/// <summary>
+///  Refills the rate limit tokens (one token every 1000 / MAX_RATE msec).
+/// </summary>
+void LogSyslog::refill()
+{
+	uint32_t now = millis();
+	uint32_t interval = 1000 / MAX_RATE;
+	uint32_t tokens = (now - _refill) / interval;
+
+	if (tokens > 0)
+	{
+		_tokens = (_tokens + tokens > MAX_RATE) ? MAX_RATE : _tokens + tokens;
+		_refill += tokens * interval;
+	}
+
+	if (_tokens == MAX_RATE)
+	{
+		_refill = now;
+	}
+}
+
+/// <summary>
+///  Sends the buffered messages, one message per datagram (RFC 5426). The messages are dropped if the network
+///  is down or sending fails, the messages exceeding the rate limit are kept. Note that the mutex has to be taken.
+/// </summary>
+/// <param name="limited">True if the rate limit applies</param>
+/// <returns>True if all messages have been sent (or the buffer was empty)</returns>
+bool LogSyslog::send(bool limited)
+{
+	if (_length == 0)
+	{
+		return true;
+	}
+
+	if (!isActive() || (_udp == NULL) || ((_connected != NULL) && !_connected()))
+	{
+		drop();
+		return false;
+	}
+
+	size_t offset = 0;
+	bool sent = true;
+
+	while (offset < _length)
+	{
+		if (limited)
+		{
+			refill();
+
+			if (_tokens == 0)
+			{
+				break;
+			}
+
+			_tokens--;
+		}
+
+		uint16_t size;
+		memcpy(&size, _buffer + offset, sizeof(size));
+		const uint8_t* message = (const uint8_t*)_buffer + offset + sizeof(size);
+
+		if (_udp->beginPacket(_server, _port) &&
+			(_udp->write(message, size) == size) &&
+			_udp->endPacket())
+		{
+			_sent++;
+		}
+		else
+		{
+			_dropped++;
+			sent = false;
+		}
+
+		offset += size + sizeof(size);
+		_count--;
+	}
+
+	// Keep the messages exceeding the rate limit (sent by the next update).
+	memmove(_buffer, _buffer + offset, _length - offset);
+	_length -= offset;
+
+	return sent && (_length == 0);
+}
+
+/// <summary>
+///  Drops the buffered messages (counted).
+/// </summary>
+void LogSyslog::drop()
+{
+	_dropped += _count;
+	_length = 0;
+	_count = 0;
+}
+
+/// <summary>
+///  Returns the number of sent messages.
+/// </summary>
+/// <returns>The number of sent messages</returns>
+uint32_t LogSyslog::getSent()
+{
+	return _sent;
+}
+
+/// <summary>
+///  Returns the number of dropped messages.
+/// </summary>
+/// <returns>The number of dropped messages</returns>
+uint32_t LogSyslog::getDropped()
+{
+	return _dropped;
+}
+
+/// <summary>
+///  Returns the syslog severity for an ArduinoLog level.
+/// </summary>
+/// <param name="level">The ArduinoLog level</param>
+/// <returns>The syslog severity (2..7)</returns>
+uint8_t LogSyslog::getSeverity(uint8_t level)
+{
+	switch (level)
+	{
+	case LOG_LEVEL_FATAL:   return 2;	// Critical
+	case LOG_LEVEL_ERROR:   return 3;	// Error
+	case LOG_LEVEL_WARNING: return 4;	// Warning
+	case LOG_LEVEL_NOTICE:  return 5;	// Notice
+	case LOG_LEVEL_TRACE:   return 6;	// Informational
+	default:                return 7;	// Debug
+	}
+}
+
+/// <summary>
+///  Formats a RFC 5424 syslog message. The wall clock timestamp is only set if the time is synchronized,
+///  the uptime and sequence number are always included as structured data (meta).
+///  Example: &lt;131&gt;1 2020-04-05T10:00:00Z soilmonitor SoilMonitor - - [meta sequenceId="1" sysUpTime="123"] Text
+/// </summary>
+/// <param name="buffer">The text buffer</param>
+/// <param name="size">The size of the text buffer</param>
+/// <param name="time">The current wall clock time</param>
+/// <param name="timestamp">The message timestamp (msec since start)</param>
+/// <param name="sequence">The message sequence number</param>
+/// <param name="level">The log level</param>
+/// <param name="hostname">The hostname</param>
+/// <param name="message">The formatted message</param>
+/// <param name="length">The message length</param>
+/// <returns>The syslog message length</returns>
+size_t LogSyslog::formatMessage(char* buffer, size_t size, time_t time, uint32_t timestamp, uint32_t sequence,
+	uint8_t level, const char* hostname, const char* message, size_t length)
+{
+	char date[24] = "-";
+
+	if (time >= MIN_VALID_TIME)
+	{
+		// Correct the current time by the age of the message.
+		time_t event = time - (time_t)((millis() - timestamp) / 1000);
+		struct tm utc;
+		gmtime_r(&event, &utc);
+		strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &utc);
+	}
+
+	int n = snprintf(buffer, size, "<%u>1 %s %s SoilMonitor - - [meta sequenceId=\"%u\" sysUpTime=\"%u\"] ",
+		(unsigned int)(FACILITY * 8 + getSeverity(level)),
+		date,
+		((hostname != NULL) && (hostname[0] != '\0')) ? hostname : "-",
+		(unsigned int)sequence,
+		(unsigned int)(timestamp / 10));
+
+	if (n < 0)
+	{
+		return 0;
+	}
+
+	size_t total = ((size_t)n < size) ? (size_t)n : size - 1;
+	size_t copy = (total + length < size) ? length : size - total - 1;
+
+	memcpy(buffer + total, message, copy);
+	total += copy;
+	buffer[total] = '\0';
+
+	return total;
+}
@@ -0,0 +1,77 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="LogSyslog.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <time.h>
+#include <Arduino.h>
+#include <Udp.h>
+#include <ArduinoLog.h>
+
+#include "LogSink.h"
+
+/// <summary>
+/// This class implements a remote syslog sink (RFC 5424 messages over UDP).
+/// 
+/// The messages are buffered and sent when the buffer is full or the oldest message exceeds the batch interval,
+/// each message in its own datagram (RFC 5426). The number of datagrams per second is limited (token bucket),
+/// messages exceeding the rate stay buffered. Messages are dropped (and counted) if the network is down, the
+/// buffer is full, or sending fails.
+/// </summary>
+class LogSyslog : public LogSink
+{
+public:
+	static const size_t BUFFER_SIZE = 1200;						// The size of the message buffer
+	static const size_t MESSAGE_SIZE = 320;						// The maximum size of a single syslog message (datagram)
+	static const size_t MAX_SERVER_LEN = 64;					// The maximum length of the server name
+	static const size_t MAX_HOSTNAME_LEN = 32;					// The maximum length of the hostname
+	static const uint32_t BATCH_INTERVAL = 1000;				// The maximum time (msec) a message is buffered
+	static const uint8_t MAX_RATE = 10;							// The maximum number of datagrams per second
+	static const uint8_t FACILITY = 16;							// The syslog facility (local0)
+
+private:
+	UDP* _udp;													// Pointer to the UDP instance
+	bool (*_connected)();										// Function returning true if the network is up
+	int _level;													// The syslog log level
+	char _server[MAX_SERVER_LEN + 1];							// The syslog server (name or address)
+	uint16_t _port;												// The syslog server UDP port
+	char _hostname[MAX_HOSTNAME_LEN + 1];						// The hostname used in the messages
+
+	char _buffer[BUFFER_SIZE];									// The message buffer (length prefixed messages)
+	size_t _length;												// The used buffer length
+	uint16_t _count;											// The number of buffered messages
+	uint32_t _first;											// The time the first message was buffered
+	uint8_t _tokens;											// The available datagram tokens
+	uint32_t _refill;											// The time of the last token refill
+	uint32_t _sequence;											// The message sequence number
+	uint32_t _sent;												// The number of sent messages
+	uint32_t _dropped;											// The number of dropped messages
+
+	bool isActive();											// Returns true if the sink is configured
+	void refill();												// Refills the rate limit tokens
+	bool send(bool limited);									// Sends the buffered messages
+	void drop();												// Drops the buffered messages
+
+public:
+	LogSyslog(UDP* udp, bool (*connected)());					// Constructor using a UDP instance and a network check
+
+	void configure(int level, const char* server,				// Sets the syslog level, server, port, and hostname
+		uint16_t port, const char* hostname);
+	void write(uint32_t timestamp, uint8_t level,				// Buffers a single formatted message
+		const char* message, size_t length) override;
+	void update() override;										// Sends the messages if the batch interval elapsed
+	void flush() override;										// Sends the messages (ignoring the rate limit)
+
+	uint32_t getSent();											// Returns the number of sent messages
+	uint32_t getDropped();										// Returns the number of dropped messages
+
+	static uint8_t getSeverity(uint8_t level);					// Returns the syslog severity for a log level
+	static size_t formatMessage(char* buffer, size_t size,		// Formats a RFC 5424 syslog message
+		time_t time, uint32_t timestamp, uint32_t sequence, uint8_t level,
+		const char* hostname, const char* message, size_t length);
+};
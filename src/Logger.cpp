@@ -0,0 +1,196 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Logger.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "Logger.h"
+
+/// <summary>
+/// Logging is silent until begin() has been called.
+/// </summary>
+int Logger::_level = LOG_LEVEL_SILENT;
+LogBuffer Logger::_buffer;
+LogSink* Logger::_sinks[MAX_SINKS] = { NULL, NULL, NULL, NULL };
+uint8_t Logger::_count = 0;
+uint32_t Logger::_reported = 0;
+void* Logger::_task = NULL;
+void* Logger::_mutex = NULL;
+
+/// <summary>
+///  Initializes the runtime log level and starts the (low priority) log task.
+/// </summary>
+/// <param name="level">The runtime log level</param>
+void Logger::begin(int level)
+{
+	_level = level;
+
+	if (_mutex == NULL)
+	{
+		_mutex = xSemaphoreCreateMutex();
+	}
+
+	if (_task == NULL)
+	{
+		TaskHandle_t handle = NULL;
+		xTaskCreatePinnedToCore(run, "log", TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, &handle, 0);
+		_task = handle;
+	}
+}
+
+/// <summary>
+///  Attaches a log sink. Note that the sinks should be attached before the log task is started.
+/// </summary>
+/// <param name="sink">Pointer to the log sink</param>
+/// <returns>True if successful</returns>
+bool Logger::attach(LogSink* sink)
+{
+	if ((sink == NULL) || (_count >= MAX_SINKS))
+	{
+		return false;
+	}
+
+	_sinks[_count++] = sink;
+	return true;
+}
+
+/// <summary>
+///  Sets the runtime log level.
+/// </summary>
+/// <param name="level">The runtime log level</param>
+void Logger::setLevel(int level)
+{
+	_level = level;
+}
+
+/// <summary>
+///  Returns the runtime log level.
+/// </summary>
+/// <returns>The runtime log level</returns>
+int Logger::getLevel()
+{
+	return _level;
+}
+
+/// <summary>
+///  Returns the number of dropped messages.
+/// </summary>
+/// <returns>The number of dropped messages</returns>
+uint32_t Logger::getDropped()
+{
+	return _buffer.getDropped();
+}
+
+/// <summary>
+///  Stores a log record in the buffer (non blocking).
+/// </summary>
+/// <param name="level">The log level</param>
+/// <param name="format">The format string (flash)</param>
+/// <param name="args">The raw arguments</param>
+/// <param name="count">The number of arguments</param>
+void Logger::push(int level, const char* format, const LogArg* args, uint8_t count)
+{
+	_buffer.push((uint8_t)level, format, args, count);
+}
+
+/// <summary>
+///  Writes a formatted message to all attached sinks.
+/// </summary>
+/// <param name="timestamp">The timestamp (msec)</param>
+/// <param name="level">The log level</param>
+/// <param name="message">The formatted message</param>
+/// <param name="length">The message length</param>
+void Logger::write(uint32_t timestamp, uint8_t level, const char* message, size_t length)
+{
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		_sinks[i]->write(timestamp, level, message, length);
+	}
+}
+
+/// <summary>
+///  Formats all buffered messages and writes them to the sinks, and updates the sinks.
+///  A warning is written if messages have been dropped since the last call.
+/// </summary>
+/// <returns>True if any message has been written</returns>
+bool Logger::drain()
+{
+	LogRecord record;
+	char message[MESSAGE_SIZE];
+	bool written = false;
+
+	if (_mutex != NULL)
+	{
+		xSemaphoreTake((SemaphoreHandle_t)_mutex, portMAX_DELAY);
+	}
+
+	while (_buffer.pop(record))
+	{
+		size_t length = LogBuffer::format(record, message, sizeof(message));
+		write(record.Timestamp, record.Level, message, length);
+		written = true;
+	}
+
+	uint32_t dropped = _buffer.getDropped();
+
+	if (dropped != _reported)
+	{
+		int length = snprintf(message, sizeof(message), "Logger: %u messages dropped", (unsigned int)(dropped - _reported));
+		write(millis(), LOG_LEVEL_WARNING, message, length);
+		_reported = dropped;
+		written = true;
+	}
+
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		_sinks[i]->update();
+	}
+
+	if (_mutex != NULL)
+	{
+		xSemaphoreGive((SemaphoreHandle_t)_mutex);
+	}
+
+	return written;
+}
+
+/// <summary>
+///  The log task function draining the buffer.
+/// </summary>
+/// <param name="parameter">Not used</param>
+void Logger::run(void* parameter)
+{
+	for (;;)
+	{
+		// Always yield, so the idle task on this core is never starved.
+		vTaskDelay(drain() ? 1 : pdMS_TO_TICKS(DRAIN_INTERVAL));
+	}
+}
+
+/// <summary>
+///  Writes all buffered messages and flushes all sinks (e.g. before a restart).
+/// </summary>
+void Logger::flush()
+{
+	drain();
+
+	if (_mutex != NULL)
+	{
+		xSemaphoreTake((SemaphoreHandle_t)_mutex, portMAX_DELAY);
+	}
+
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		_sinks[i]->flush();
+	}
+
+	if (_mutex != NULL)
+	{
+		xSemaphoreGive((SemaphoreHandle_t)_mutex);
+	}
+}
@@ -0,0 +1,102 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Logger.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoLog.h>
+
+#include "LogBuffer.h"
+#include "LogSink.h"
+
+/// <summary>
+/// The compile-time minimum log level. All log statements above this level are removed by the compiler,
+/// including the evaluation of their arguments. Use a build flag (e.g. -DLOG_MIN_LEVEL=LOG_LEVEL_VERBOSE)
+/// to compile the trace and verbose statements back in for debugging.
+/// </summary>
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_NOTICE
+#endif
+
+/// <summary>
+/// This class implements the logging front end.
+/// 
+/// The LOG_XXX() macros check the compile-time level and the runtime level before any argument is evaluated.
+/// The format string has to be a string literal, it is placed in flash (PSTR) and the pointer is used as the
+/// message identifier, so no format string is copied to RAM.
+/// 
+/// The producers only store the timestamp, level, format pointer and raw arguments in a lock-free buffer.
+/// A low priority task formats the messages and writes them to the attached sinks (Serial, Bluetooth, file).
+/// If the buffer is full the message is dropped and counted, the producer never blocks.
+/// </summary>
+class Logger
+{
+public:
+	static const uint8_t MAX_SINKS = 4;							// The maximum number of log sinks
+	static const uint32_t DRAIN_INTERVAL = 20;					// The log task idle interval (msec)
+	static const uint32_t TASK_STACK_SIZE = 4096;				// The log task stack size
+	static const size_t MESSAGE_SIZE = 160;						// The maximum formatted message size
+
+private:
+	static int _level;											// The runtime log level
+	static LogBuffer _buffer;									// The log record buffer
+	static LogSink* _sinks[MAX_SINKS];							// The attached log sinks
+	static uint8_t _count;										// The number of attached sinks
+	static uint32_t _reported;									// The number of reported dropped messages
+	static void* _task;											// The log task handle
+	static void* _mutex;										// The mutex protecting the sinks
+
+	static void run(void* parameter);							// The log task function
+	static void push(int level, const char* format,				// Stores a log record
+		const LogArg* args, uint8_t count);
+	static void write(uint32_t timestamp, uint8_t level,		// Writes a formatted message to all sinks
+		const char* message, size_t length);
+
+public:
+	static void begin(int level);								// Initializes the runtime level and starts the log task
+	static bool attach(LogSink* sink);							// Attaches a log sink
+	static void setLevel(int level);							// Sets the runtime log level
+	static int getLevel();										// Returns the runtime log level
+	static uint32_t getDropped();								// Returns the number of dropped messages
+	static bool drain();										// Writes all buffered messages to the sinks
+	static void flush();										// Writes all buffered messages and flushes the sinks
+
+	/// <summary>
+	///  Returns true if the specified level is compiled in and enabled at runtime.
+	/// </summary>
+	/// <param name="level">The log level</param>
+	/// <returns>True if enabled</returns>
+	static inline bool isEnabled(int level)
+	{
+		return (level <= LOG_MIN_LEVEL) && (level <= _level);
+	}
+
+	/// <summary>
+	///  Stores a log message with the raw arguments (not formatted).
+	/// </summary>
+	/// <param name="level">The log level</param>
+	/// <param name="format">The format string (flash)</param>
+	/// <param name="args">The arguments</param>
+	template <typename... Args>
+	static void log(int level, const char* format, const Args&... args)
+	{
+		static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+		LogArg list[sizeof...(Args) + 1] = { LogArg(args)..., LogArg() };
+		push(level, format, list, sizeof...(Args));
+	}
+};
+
+#define LOG_AT(level, format, ...) \
+	do { if (Logger::isEnabled(level)) { Logger::log(level, PSTR(format), ##__VA_ARGS__); } } while (0)
+
+#define LOG_FATAL(format, ...)   LOG_AT(LOG_LEVEL_FATAL,   format, ##__VA_ARGS__)
+#define LOG_ERROR(format, ...)   LOG_AT(LOG_LEVEL_ERROR,   format, ##__VA_ARGS__)
+#define LOG_WARNING(format, ...) LOG_AT(LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
+#define LOG_NOTICE(format, ...)  LOG_AT(LOG_LEVEL_NOTICE,  format, ##__VA_ARGS__)
+#define LOG_TRACE(format, ...)   LOG_AT(LOG_LEVEL_TRACE,   format, ##__VA_ARGS__)
+#define LOG_VERBOSE(format, ...) LOG_AT(LOG_LEVEL_VERBOSE, format, ##__VA_ARGS__)
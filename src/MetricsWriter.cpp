@@ -0,0 +1,129 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MetricsWriter.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+#include <stdio.h>
+
+#include "MetricsWriter.h"
+
+/// <summary>
+/// The content type of the Prometheus text exposition format.
+/// </summary>
+const char* MetricsWriter::CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+/// <summary>
+///  Constructor.
+/// </summary>
+/// <param name="out">The output (e.g. HTTP response)</param>
+MetricsWriter::MetricsWriter(Print& out) : _out(out)
+{
+}
+
+/// <summary>
+///  Writes the line formatted into the line buffer. A truncated line is skipped (counted), since it would
+///  render the whole exposition invalid.
+/// </summary>
+/// <param name="length">The formatted length (snprintf)</param>
+void MetricsWriter::writeLine(int length)
+{
+	if ((length < 0) || ((size_t)length >= MAX_LINE))
+	{
+		_skipped++;
+		return;
+	}
+
+	_size += _out.write((const uint8_t*)_line, length);
+}
+
+/// <summary>
+///  Writes a sample line, the label value is escaped (backslash, double quote, and line feed).
+/// </summary>
+/// <param name="name">The metric name</param>
+/// <param name="label">The label name (NULL: no label)</param>
+/// <param name="value">The label value</param>
+/// <param name="text">The formatted sample value</param>
+void MetricsWriter::writeSample(const char* name, const char* label, const char* value, const char* text)
+{
+	if ((label == NULL) || (value == NULL))
+	{
+		writeLine(snprintf(_line, MAX_LINE, "%s %s\n", name, text));
+		return;
+	}
+
+	char escaped[48];
+	size_t length = 0;
+
+	for (; (*value != '\0') && (length < sizeof(escaped) - 2); value++)
+	{
+		char c = *value;
+
+		if ((c == '\\') || (c == '"') || (c == '\n'))
+		{
+			escaped[length++] = '\\';
+			c = (c == '\n') ? 'n' : c;
+		}
+
+		escaped[length++] = c;
+	}
+
+	escaped[length] = '\0';
+	writeLine(snprintf(_line, MAX_LINE, "%s{%s=\"%s\"} %s\n", name, label, escaped, text));
+}
+
+/// <summary>
+///  Writes the HELP and TYPE lines of a metric family (written once, before the samples of the metric).
+/// </summary>
+/// <param name="name">The metric name</param>
+/// <param name="type">The metric type (gauge, counter)</param>
+/// <param name="help">The help text (single line)</param>
+void MetricsWriter::writeFamily(const char* name, const char* type, const char* help)
+{
+	writeLine(snprintf(_line, MAX_LINE, "# HELP %s %s\n", name, help));
+	writeLine(snprintf(_line, MAX_LINE, "# TYPE %s %s\n", name, type));
+}
+
+/// <summary>
+///  Writes an integer sample.
+/// </summary>
+/// <param name="name">The metric name</param>
+/// <param name="value">The value</param>
+/// <param name="label">The label name (optional)</param>
+/// <param name="labelValue">The label value (optional)</param>
+void MetricsWriter::writeInt(const char* name, int64_t value, const char* label, const char* labelValue)
+{
+	char text[24];
+	snprintf(text, sizeof(text), "%lld", (long long)value);
+	writeSample(name, label, labelValue, text);
+}
+
+/// <summary>
+///  Writes a floating point sample (7 significant digits, NaN and +Inf/-Inf as defined by the format).
+/// </summary>
+/// <param name="name">The metric name</param>
+/// <param name="value">The value</param>
+/// <param name="label">The label name (optional)</param>
+/// <param name="labelValue">The label value (optional)</param>
+void MetricsWriter::writeFloat(const char* name, float value, const char* label, const char* labelValue)
+{
+	char text[24];
+
+	if (isnan(value))
+	{
+		snprintf(text, sizeof(text), "NaN");
+	}
+	else if (isinf(value))
+	{
+		snprintf(text, sizeof(text), (value > 0) ? "+Inf" : "-Inf");
+	}
+	else
+	{
+		snprintf(text, sizeof(text), "%.7g", (double)value);
+	}
+
+	writeSample(name, label, labelValue, text);
+}
@@ -0,0 +1,45 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MetricsWriter.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class implements a streaming writer of the Prometheus text exposition format (version 0.0.4).
+/// Every line (metric family header or sample) is formatted into a fixed buffer and written to the output
+/// directly, no String or JSON document is used. A sample has at most one label (e.g. sensor="0").
+/// </summary>
+class MetricsWriter
+{
+public:
+	static const size_t MAX_LINE = 160;							// The maximum length of a line
+	static const char* CONTENT_TYPE;							// The content type of the exposition format
+
+private:
+	Print& _out;												// The output
+	char _line[MAX_LINE];										// The line buffer
+	size_t _size = 0;											// The number of bytes written
+	uint16_t _skipped = 0;										// The number of lines skipped (too long)
+
+	void writeLine(int length);									// Writes the formatted line
+	void writeSample(const char* name, const char* label,		// Writes a sample (formatted value)
+		const char* value, const char* text);
+
+public:
+	MetricsWriter(Print& out);									// Constructor
+
+	void writeFamily(const char* name, const char* type,		// Writes the HELP and TYPE lines of a metric
+		const char* help);
+	void writeInt(const char* name, int64_t value,				// Writes an integer sample
+		const char* label = NULL, const char* labelValue = NULL);
+	void writeFloat(const char* name, float value,				// Writes a floating point sample
+		const char* label = NULL, const char* labelValue = NULL);
+	size_t getSize() const { return _size; }					// Returns the number of bytes written
+	uint16_t getSkipped() const { return _skipped; }			// Returns the number of lines skipped
+};
@@ -6,7 +6,7 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
 #include "MoistureSensor.h"
 
 /// <summary>
@@ -15,12 +15,17 @@
 const float MoistureSensor::WET_VALUE = 1.500;		// The default minimum voltage level in V (100% humidity - in water)
 const float MoistureSensor::DRY_VALUE = 3.400;		// The default maximum voltage level in V (0% humidity   - on air)
 
+/// <summary>
+/// The median of the last three raw values, a robust estimate for the adaptive sampling (a single spike is ignored).
+/// </summary>
+const char* MoistureSensor::MEDIAN_CHAIN = "median:3";
+
 /// <summary>
 /// Default constructor.
 /// </summary>
 MoistureSensor::MoistureSensor()
 {
-	Log.trace("MoistureSensor::MoistureSensor()" CR);
+	LOG_TRACE("MoistureSensor::MoistureSensor()" CR);
 }
 
 /// <summary>
@@ -29,7 +34,7 @@ MoistureSensor::MoistureSensor()
 /// <param name="pin">The analog input GPIO pin number</param>
 MoistureSensor::MoistureSensor(unsigned short pin)
 {
-	Log.trace("MoistureSensor::MoistureSensor()" CR);
+	LOG_TRACE("MoistureSensor::MoistureSensor()" CR);
 
 	setPin(pin);
 }
@@ -41,7 +46,7 @@ MoistureSensor::MoistureSensor(unsigned short pin)
 /// <param name="name">The sensor name</param>
 MoistureSensor::MoistureSensor(unsigned short pin, String name)
 {
-	Log.trace("MoistureSensor::MoistureSensor()" CR);
+	LOG_TRACE("MoistureSensor::MoistureSensor()" CR);
 
 	setPin(pin);
 	setName(name);
@@ -56,7 +61,7 @@ MoistureSensor::MoistureSensor(unsigned short pin, String name)
 /// <param name="dry">The maximum voltage level</param>
 MoistureSensor::MoistureSensor(unsigned short pin, String name, float wet, float dry)
 {
-	Log.trace("MoistureSensor::MoistureSensor()" CR);
+	LOG_TRACE("MoistureSensor::MoistureSensor()" CR);
 
 	setPin(pin);
 	setName(name);
@@ -109,6 +114,15 @@ const int MoistureSensor::getValue() const
 	return _value;
 }
 
+/// <summary>
+/// Returns the median of the last three analog input values (mV).
+/// </summary>
+/// <returns>The median analog input value</returns>
+const int MoistureSensor::getMedian() const
+{
+	return _median.get();
+}
+
 /// <summary>
 /// Returns the current analog input voltage (V).
 /// </summary>
@@ -164,24 +178,45 @@ void MoistureSensor::setDryValue(float dry)
 }
 
 /// <summary>
-/// Initializes the sensor (smoothing).
+/// Sets the filter chain (e.g. "hampel:7,exp:10", see SensorFilter), the filter state is cleared.
+/// </summary>
+/// <param name="chain">The filter chain</param>
+/// <returns>True if the chain is valid (an invalid chain is ignored)</returns>
+bool MoistureSensor::setFilter(const String& chain)
+{
+	return _filter.setChain(chain);
+}
+
+/// <summary>
+/// Returns the filter chain.
+/// </summary>
+/// <returns>The filter chain</returns>
+const String MoistureSensor::getFilter() const
+{
+	return _filter.getChain();
+}
+
+/// <summary>
+/// Initializes the sensor (the filter state is cleared).
 /// </summary>
 void MoistureSensor::begin()
 {
-	Log.trace("MoistureSensor::begin()" CR);
+	LOG_TRACE("MoistureSensor::begin()" CR);
 
-	_sensor.begin(SMOOTHED_EXPONENTIAL, 10);
+	_filter.reset();
+	_median.reset();
 }
 
 /// <summary>
-/// Updates the sensor data (smoothing).
+/// Updates the sensor data (filter chain).
 /// </summary>
 void MoistureSensor::update()
 {
-	Log.verbose("MoistureSensor::update()" CR);
+	LOG_VERBOSE("MoistureSensor::update()" CR);
 
 	_value = analogRead(_pin);
-	_sensor.add(_value);
-	_voltage = _sensor.get() / 1000.0;
-	_percentage = (int)min(100L, max(0L, map(_sensor.get(), _wet, _dry, 100, 0)));
+	_median.add(_value);
+	int value = _filter.add(_value);
+	_voltage = value / 1000.0;
+	_percentage = (int)min(100L, max(0L, map(value, _wet, _dry, 100, 0)));
 }
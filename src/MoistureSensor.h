@@ -10,7 +10,7 @@
 
 #include <math.h>
 #include <Arduino.h>
-#include <Smoothed.h>
+#include "SensorFilter.h"
 
 /// <summary>
 /// This class implements a moisture sensor using a capacitive soil moisture sensor.
@@ -20,6 +20,7 @@ class MoistureSensor
 public:
 	static const float WET_VALUE;								// The default minimum voltage level in V (100% humidity - in water)
 	static const float DRY_VALUE;								// The default maximum voltage level in V (0% humidity   - on air)
+	static const char* MEDIAN_CHAIN;							// The median of the recent raw values (median:3)
 
 private:
 	const int MAX_NAME_LEN = 32;								// The maximum length for the sensor name
@@ -31,7 +32,8 @@ private:
 	int _value = 0;												// The raw analog input value
 	float _voltage = 0.0;										// The analog input voltage value
 	int _percentage = 0;										// The humidity value in percent (0..100)
-	Smoothed<int> _sensor;										// Smoothed sensor value (int)
+	SensorFilter _filter;										// The filter chain (smoothed value in mV)
+	SensorFilter _median { MEDIAN_CHAIN };						// The median of the recent raw values (mV)
 
 public:
 	MoistureSensor();											// Default constructor
@@ -45,15 +47,18 @@ public:
 	const float getWetValue() const;							// Returns the wet calibration value
 	const float getDryValue() const;							// Returns the dry calibration value
 	const int getValue() const;									// Returns the raw sensor value (mV)
+	const int getMedian() const;								// Returns the median of the recent raw values (mV)
 	const float getVoltage() const;								// Returns the sensor value (V)
 	const int getHumidity() const;								// Returns the humidity in %
+	const String getFilter() const;								// Returns the filter chain
 
 	void setPin(unsigned short pin);							// Sets the analog input pin
 	void setName(String name);									// Sets the name of a sensor
 	void setWetValue(float wet);								// Sets the wet calibration value
 	void setDryValue(float dry);								// Sets the dry calibration value
+	bool setFilter(const String& chain);						// Sets the filter chain (false if invalid)
 
-	void begin();												// Initializes the sensor (smoothing)
+	void begin();												// Initializes the sensor (filter)
 	void update();												// Updates the sensor values
 };
 
@@ -0,0 +1,448 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MqttClient.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string.h>
+
+#include "MqttClient.h"
+
+/// <summary>
+/// The MQTT control packet types (upper nibble of the fixed header).
+/// </summary>
+static const uint8_t MQTT_CONNECT    = 0x10;
+static const uint8_t MQTT_CONNACK    = 0x20;
+static const uint8_t MQTT_PUBLISH    = 0x30;
+static const uint8_t MQTT_PUBACK     = 0x40;
+static const uint8_t MQTT_PINGREQ    = 0xC0;
+static const uint8_t MQTT_PINGRESP   = 0xD0;
+static const uint8_t MQTT_DISCONNECT = 0xE0;
+
+/// <summary>
+/// The PUBLISH flags (QoS 1, duplicate delivery).
+/// </summary>
+static const uint8_t MQTT_QOS1 = 0x02;
+static const uint8_t MQTT_DUP  = 0x08;
+
+/// <summary>
+/// The parser stages.
+/// </summary>
+static const uint8_t STAGE_HEADER = 0;
+static const uint8_t STAGE_LENGTH = 1;
+static const uint8_t STAGE_BODY   = 2;
+
+/// <summary>
+///  Constructor using a network client and a function checking the network connection.
+/// </summary>
+/// <param name="client">Pointer to the network client (e.g. WiFiClient)</param>
+/// <param name="connected">Function returning true if the network is up</param>
+MqttClient::MqttClient(Client* client, bool (*connected)()) :
+	_client(client),
+	_connected(connected),
+	_port(1883),
+	_state(STATE_DISCONNECTED),
+	_stateTime(0),
+	_retry(0),
+	_lastSent(0),
+	_pingTime(0),
+	_packetLength(0),
+	_packetId(0),
+	_sentTime(0),
+	_stage(STAGE_HEADER),
+	_header(0),
+	_remaining(0),
+	_shift(0),
+	_received(0),
+	_connects(0),
+	_acknowledged(0)
+{
+	_server[0] = '\0';
+	_clientId[0] = '\0';
+	_user[0] = '\0';
+	_pass[0] = '\0';
+}
+
+/// <summary>
+///  Sets the broker, port, client identifier, user, and password. An empty server name disables the client.
+///  An open connection is closed, the next update connects using the new configuration.
+/// </summary>
+/// <param name="server">The broker (name or address)</param>
+/// <param name="port">The broker TCP port</param>
+/// <param name="clientId">The client identifier</param>
+/// <param name="user">The user name (empty: anonymous)</param>
+/// <param name="pass">The password</param>
+void MqttClient::configure(const char* server, uint16_t port, const char* clientId, const char* user, const char* pass)
+{
+	if (_state != STATE_DISCONNECTED)
+	{
+		stop();
+	}
+
+	strncpy(_server, (server != NULL) ? server : "", MAX_SERVER_LEN);
+	_server[MAX_SERVER_LEN] = '\0';
+	strncpy(_clientId, (clientId != NULL) ? clientId : "", MAX_NAME_LEN);
+	_clientId[MAX_NAME_LEN] = '\0';
+	strncpy(_user, (user != NULL) ? user : "", MAX_NAME_LEN);
+	_user[MAX_NAME_LEN] = '\0';
+	strncpy(_pass, (pass != NULL) ? pass : "", MAX_PASS_LEN);
+	_pass[MAX_PASS_LEN] = '\0';
+	_port = port;
+	_retry = 0;
+}
+
+/// <summary>
+///  Returns true if the network is up (no check function: always up).
+/// </summary>
+/// <returns>True if connected</returns>
+bool MqttClient::isNetworkUp()
+{
+	return (_connected == NULL) || _connected();
+}
+
+/// <summary>
+///  Changes the connection state and records the time.
+/// </summary>
+/// <param name="state">The new state</param>
+void MqttClient::setState(State state)
+{
+	_state = state;
+	_stateTime = millis();
+}
+
+/// <summary>
+///  Doubles the reconnect interval (RETRY_MIN after a successful connect, at most RETRY_MAX).
+/// </summary>
+void MqttClient::backoff()
+{
+	_retry = (_retry == 0) ? RETRY_MIN : _retry * 2;
+
+	if (_retry > RETRY_MAX)
+	{
+		_retry = RETRY_MAX;
+	}
+}
+
+/// <summary>
+///  Runs the connection state machine: connects after the reconnect interval, parses the received packets,
+///  sends the keep alive ping, and drops the connection if an acknowledgement is missing.
+///  Nothing is waited for, the function returns as soon as no more data is available.
+/// </summary>
+void MqttClient::update()
+{
+	if (!isActive())
+	{
+		return;
+	}
+
+	uint32_t now = millis();
+
+	if (_state == STATE_DISCONNECTED)
+	{
+		if (((now - _stateTime) >= _retry) && isNetworkUp())
+		{
+			connect();
+		}
+
+		return;
+	}
+
+	if (!_client->connected())
+	{
+		disconnect();
+		return;
+	}
+
+	receive();
+
+	if (_state == STATE_CONNECTING)
+	{
+		if ((now - _stateTime) >= ACK_TIMEOUT)
+		{
+			disconnect();
+		}
+
+		return;
+	}
+
+	if (_state != STATE_CONNECTED)
+	{
+		return;
+	}
+
+	if ((_packetLength > 0) && ((now - _sentTime) >= ACK_TIMEOUT))
+	{
+		disconnect();
+	}
+	else if ((_pingTime != 0) && ((now - _pingTime) >= ACK_TIMEOUT))
+	{
+		disconnect();
+	}
+	else if ((_pingTime == 0) && ((now - _lastSent) >= KEEP_ALIVE * 500UL))
+	{
+		uint8_t ping[] = { MQTT_PINGREQ, 0 };
+
+		if (send(ping, sizeof(ping)))
+		{
+			_pingTime = (now != 0) ? now : 1;
+		}
+	}
+}
+
+/// <summary>
+///  Opens the TCP connection and sends the CONNECT packet (clean session, keep alive, optional user and password).
+///  If the connection fails, the reconnect interval is doubled (up to RETRY_MAX).
+/// </summary>
+void MqttClient::connect()
+{
+	uint8_t body[CONNECT_SIZE];
+	uint8_t packet[CONNECT_SIZE + 5];							// The fixed header (type, up to four length bytes)
+	size_t length = 0;
+
+	if (!_client->connect(_server, _port))
+	{
+		backoff();
+		setState(STATE_DISCONNECTED);
+		return;
+	}
+
+	uint8_t flags = 0x02;
+	if (_user[0] != '\0') flags |= 0x80;
+	if ((_user[0] != '\0') && (_pass[0] != '\0')) flags |= 0x40;
+
+	length += putString(body + length, "MQTT");
+	body[length++] = 4;
+	body[length++] = flags;
+	body[length++] = (uint8_t)(KEEP_ALIVE >> 8);
+	body[length++] = (uint8_t)(KEEP_ALIVE & 0xFF);
+	length += putString(body + length, _clientId);
+	if (flags & 0x80) length += putString(body + length, _user);
+	if (flags & 0x40) length += putString(body + length, _pass);
+
+	packet[0] = MQTT_CONNECT;
+	size_t header = 1 + putLength(packet + 1, length);
+	memcpy(packet + header, body, length);
+
+	_stage = STAGE_HEADER;
+	_pingTime = 0;
+	setState(STATE_CONNECTING);
+
+	if (!send(packet, header + length))
+	{
+		disconnect();
+	}
+}
+
+/// <summary>
+///  Closes the connection, the next attempt is made after the reconnect interval. A message in flight is kept.
+/// </summary>
+void MqttClient::disconnect()
+{
+	_client->stop();
+	backoff();
+	setState(STATE_DISCONNECTED);
+}
+
+/// <summary>
+///  Disconnects gracefully (DISCONNECT packet), the next update connects again.
+/// </summary>
+void MqttClient::stop()
+{
+	if (_state == STATE_CONNECTED)
+	{
+		uint8_t packet[] = { MQTT_DISCONNECT, 0 };
+		send(packet, sizeof(packet));
+	}
+
+	_client->stop();
+	_retry = 0;
+	setState(STATE_DISCONNECTED);
+}
+
+/// <summary>
+///  Parses the available bytes. Only the first bytes of a packet body are kept (enough for CONNACK and PUBACK),
+///  the rest of larger packets is skipped.
+/// </summary>
+void MqttClient::receive()
+{
+	while ((_state != STATE_DISCONNECTED) && (_client->available() > 0))
+	{
+		int c = _client->read();
+
+		if (c < 0)
+		{
+			break;
+		}
+
+		if (_stage == STAGE_HEADER)
+		{
+			_header = (uint8_t)c;
+			_remaining = 0;
+			_shift = 0;
+			_received = 0;
+			_stage = STAGE_LENGTH;
+		}
+		else if (_stage == STAGE_LENGTH)
+		{
+			_remaining |= (uint32_t)(c & 0x7F) << _shift;
+			_shift += 7;
+
+			if ((c & 0x80) == 0)
+			{
+				_stage = STAGE_BODY;
+				if (_remaining == 0) handle();
+			}
+			else if (_shift > 21)
+			{
+				disconnect();
+			}
+		}
+		else
+		{
+			if (_received < sizeof(_body)) _body[_received] = (uint8_t)c;
+			if (++_received == _remaining) handle();
+		}
+	}
+}
+
+/// <summary>
+///  Handles a complete received packet (CONNACK, PUBACK, PINGRESP), other packets are ignored.
+///  A refused connection (CONNACK return code) is closed.
+/// </summary>
+void MqttClient::handle()
+{
+	_stage = STAGE_HEADER;
+
+	switch (_header & 0xF0)
+	{
+	case MQTT_CONNACK:
+		if ((_state == STATE_CONNECTING) && (_received >= 2) && (_body[1] == 0))
+		{
+			_connects++;
+			_retry = 0;
+			_lastSent = millis();
+			setState(STATE_CONNECTED);
+
+			// Send the message again, the acknowledgement is missing.
+			if (_packetLength > 0)
+			{
+				_packet[0] |= MQTT_DUP;
+				_sentTime = millis();
+				if (!send(_packet, _packetLength)) disconnect();
+			}
+		}
+		else
+		{
+			disconnect();
+		}
+		break;
+
+	case MQTT_PUBACK:
+		if ((_packetLength > 0) && (_received >= 2) && (((_body[0] << 8) | _body[1]) == _packetId))
+		{
+			_packetLength = 0;
+			_acknowledged++;
+		}
+		break;
+
+	case MQTT_PINGRESP:
+		_pingTime = 0;
+		break;
+	}
+}
+
+/// <summary>
+///  Writes a packet, the connection is closed if the packet could not be written completely.
+/// </summary>
+/// <param name="data">The packet</param>
+/// <param name="length">The packet length</param>
+/// <returns>True if written</returns>
+bool MqttClient::send(const uint8_t* data, size_t length)
+{
+	if (_client->write(data, length) != length)
+	{
+		return false;
+	}
+
+	_lastSent = millis();
+	return true;
+}
+
+/// <summary>
+///  Publishes a message with QoS 1. The message is copied, it is kept until the broker has acknowledged it.
+///  Returns false if not connected, a message is still in flight, or the message is too large.
+/// </summary>
+/// <param name="topic">The topic</param>
+/// <param name="payload">The message</param>
+/// <param name="length">The message length</param>
+/// <returns>True if sent</returns>
+bool MqttClient::publish(const char* topic, const char* payload, size_t length)
+{
+	size_t topicLength = strlen(topic);
+
+	if ((_state != STATE_CONNECTED) || (_packetLength > 0) || (topicLength > MAX_TOPIC_LEN) || (length > MAX_PAYLOAD))
+	{
+		return false;
+	}
+
+	if (++_packetId == 0)
+	{
+		_packetId = 1;
+	}
+
+	_packet[0] = MQTT_PUBLISH | MQTT_QOS1;
+	size_t n = 1 + putLength(_packet + 1, 2 + topicLength + 2 + length);
+	n += putString(_packet + n, topic);
+	_packet[n++] = (uint8_t)(_packetId >> 8);
+	_packet[n++] = (uint8_t)(_packetId & 0xFF);
+	memcpy(_packet + n, payload, length);
+
+	_packetLength = n + length;
+	_sentTime = millis();
+
+	if (!send(_packet, _packetLength))
+	{
+		disconnect();
+	}
+
+	return true;
+}
+
+/// <summary>
+///  Encodes the remaining length (variable length, 7 bits per byte).
+/// </summary>
+/// <param name="buffer">The buffer (at least 4 bytes)</param>
+/// <param name="length">The remaining length</param>
+/// <returns>The number of bytes written</returns>
+size_t MqttClient::putLength(uint8_t* buffer, size_t length)
+{
+	size_t n = 0;
+
+	do
+	{
+		uint8_t digit = length & 0x7F;
+		length >>= 7;
+		buffer[n++] = (length > 0) ? (digit | 0x80) : digit;
+	} while (length > 0);
+
+	return n;
+}
+
+/// <summary>
+///  Encodes a string (two byte length prefix, big endian).
+/// </summary>
+/// <param name="buffer">The buffer</param>
+/// <param name="text">The string</param>
+/// <returns>The number of bytes written</returns>
+size_t MqttClient::putString(uint8_t* buffer, const char* text)
+{
+	size_t length = strlen(text);
+
+	buffer[0] = (uint8_t)(length >> 8);
+	buffer[1] = (uint8_t)(length & 0xFF);
+	memcpy(buffer + 2, text, length);
+
+	return length + 2;
+}
@@ -0,0 +1,104 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MqttClient.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+
+/// <summary>
+/// This class implements a minimal MQTT 3.1.1 client publishing messages with QoS 1 (no subscriptions).
+///
+/// The client is driven by update() from the main loop and never waits for the broker: the connection is
+/// (re)established with an exponential backoff, the received packets (CONNACK, PUBACK, PINGRESP) are parsed as they
+/// arrive. A single message is in flight, it is kept until the PUBACK is received and sent again (DUP) after a
+/// reconnect if the acknowledgement is missing. Note that the TCP connect itself may block (network client timeout).
+/// </summary>
+class MqttClient
+{
+public:
+	enum State : uint8_t
+	{
+		STATE_DISCONNECTED,										// Not connected (waiting for the next attempt)
+		STATE_CONNECTING,										// CONNECT sent (waiting for CONNACK)
+		STATE_CONNECTED											// Connected (CONNACK received)
+	};
+
+	static const size_t MAX_PAYLOAD = 1024;						// The maximum payload size
+	static const size_t MAX_TOPIC_LEN = 64;						// The maximum length of the topic
+	static const size_t MAX_SERVER_LEN = 64;					// The maximum length of the server name
+	static const size_t MAX_NAME_LEN = 32;						// The maximum length of client id and user
+	static const size_t MAX_PASS_LEN = 64;						// The maximum length of the password
+	static const uint16_t KEEP_ALIVE = 60;						// The keep alive interval (sec)
+	static const uint32_t ACK_TIMEOUT = 10000;					// The time (msec) to wait for CONNACK, PUBACK, PINGRESP
+	static const uint32_t RETRY_MIN = 2000;						// The initial reconnect interval (msec)
+	static const uint32_t RETRY_MAX = 60000;					// The maximum reconnect interval (msec)
+
+private:
+	static const size_t PACKET_SIZE =							// The size of the PUBLISH packet buffer
+		MAX_PAYLOAD + MAX_TOPIC_LEN + 8;
+	static const size_t CONNECT_SIZE =							// The maximum size of the CONNECT body
+		10 + 3 * 2 + 2 * MAX_NAME_LEN + MAX_PASS_LEN;
+
+	Client* _client;											// Pointer to the network client
+	bool (*_connected)();										// Function returning true if the network is up
+	char _server[MAX_SERVER_LEN + 1];							// The broker (name or address)
+	uint16_t _port;												// The broker TCP port
+	char _clientId[MAX_NAME_LEN + 1];							// The client identifier
+	char _user[MAX_NAME_LEN + 1];								// The user name (empty: anonymous)
+	char _pass[MAX_PASS_LEN + 1];								// The password
+
+	State _state;												// The connection state
+	uint32_t _stateTime;										// The time the state has been entered
+	uint32_t _retry;											// The current reconnect interval (msec)
+	uint32_t _lastSent;											// The time the last packet has been sent
+	uint32_t _pingTime;											// The time PINGREQ has been sent (0: none pending)
+
+	uint8_t _packet[PACKET_SIZE];								// The PUBLISH packet in flight
+	size_t _packetLength;										// The packet length (0: nothing in flight)
+	uint16_t _packetId;											// The packet identifier of the message in flight
+	uint32_t _sentTime;											// The time the message has been sent
+
+	uint8_t _stage;												// The parser stage (header, length, body)
+	uint8_t _header;											// The received fixed header
+	uint32_t _remaining;										// The received remaining length
+	uint8_t _shift;												// The remaining length shift
+	uint8_t _body[4];											// The received variable header (first bytes)
+	uint32_t _received;											// The number of received body bytes
+
+	uint32_t _connects;											// The number of successful connects
+	uint32_t _acknowledged;										// The number of acknowledged messages
+
+	bool isNetworkUp();											// Returns true if the network is up
+	void setState(State state);									// Changes the connection state
+	void backoff();												// Doubles the reconnect interval
+	void connect();												// Opens the connection and sends CONNECT
+	void disconnect();											// Closes the connection (backoff)
+	void receive();												// Parses the received bytes
+	void handle();												// Handles a complete received packet
+	bool send(const uint8_t* data, size_t length);				// Writes a packet
+	static size_t putLength(uint8_t* buffer, size_t length);	// Encodes the remaining length
+	static size_t putString(uint8_t* buffer, const char* text);	// Encodes a string (length prefixed)
+
+public:
+	MqttClient(Client* client, bool (*connected)());			// Constructor using a client and a network check
+
+	void configure(const char* server, uint16_t port,			// Sets the broker, port, client id, user, and password
+		const char* clientId, const char* user, const char* pass);
+	void update();												// Runs the connection state machine (non-blocking)
+	bool publish(const char* topic,								// Publishes a message (QoS 1), false if busy
+		const char* payload, size_t length);
+	void stop();												// Disconnects gracefully (DISCONNECT)
+
+	bool isActive() const { return _server[0] != '\0'; }		// Returns true if a broker is configured
+	bool isConnected() const { return _state == STATE_CONNECTED; }	// Returns true if connected
+	bool isBusy() const { return _packetLength > 0; }			// Returns true if a message is in flight
+	State getState() const { return _state; }					// Returns the connection state
+	uint32_t getConnects() const { return _connects; }			// Returns the number of successful connects
+	uint32_t getAcknowledged() const { return _acknowledged; }	// Returns the number of acknowledged messages
+};
@@ -0,0 +1,161 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MqttPublisher.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string.h>
+
+#include "MqttPublisher.h"
+
+/// <summary>
+///  Constructor using a MQTT client and a flash queue.
+/// </summary>
+/// <param name="client">Pointer to the MQTT client</param>
+/// <param name="queue">Pointer to the flash queue</param>
+MqttPublisher::MqttPublisher(MqttClient* client, FlashQueue* queue) :
+	_client(client),
+	_queue(queue),
+	_batch(1),
+	_rate(1),
+	_length(0),
+	_frames(0),
+	_draining(false),
+	_tokens(1),
+	_refill(0),
+	_frameCount(0),
+	_direct(0),
+	_queued(0)
+{
+	_topic[0] = '\0';
+}
+
+/// <summary>
+///  Sets the topic, the number of frames per message, and the maximum number of queued messages per second.
+///  A message being batched is completed first.
+/// </summary>
+/// <param name="topic">The topic</param>
+/// <param name="batch">The number of frames per message (1..MAX_BATCH)</param>
+/// <param name="rate">The drain rate (messages per second, at least 1)</param>
+void MqttPublisher::configure(const char* topic, uint8_t batch, uint8_t rate)
+{
+	flush();
+
+	strncpy(_topic, (topic != NULL) ? topic : "", MqttClient::MAX_TOPIC_LEN);
+	_topic[MqttClient::MAX_TOPIC_LEN] = '\0';
+	_batch = (batch < 1) ? 1 : ((batch > MAX_BATCH) ? MAX_BATCH : batch);
+	_rate = (rate < 1) ? 1 : rate;
+	_tokens = _rate;
+}
+
+/// <summary>
+///  Adds a frame to the message. The message is completed first if the frame does not fit, and after the frame
+///  if it contains the configured number of frames.
+/// </summary>
+/// <param name="frame">The frame (JSON object)</param>
+/// <param name="length">The frame length</param>
+/// <returns>True if added (false: frame too large)</returns>
+bool MqttPublisher::addFrame(const char* frame, size_t length)
+{
+	// The frame has to fit into an empty message: '[' frame ']'.
+	if (length + 2 > MESSAGE_SIZE)
+	{
+		return false;
+	}
+
+	if ((_frames > 0) && (_length + 1 + length + 1 > MESSAGE_SIZE))
+	{
+		flush();
+	}
+
+	_message[_length++] = (_frames == 0) ? '[' : ',';
+	memcpy(_message + _length, frame, length);
+	_length += length;
+	_frames++;
+	_frameCount++;
+
+	if (_frames >= _batch)
+	{
+		flush();
+	}
+
+	return true;
+}
+
+/// <summary>
+///  Completes the message. It is published directly if the client is idle and no message is queued (keeps the
+///  order), otherwise it is appended to the flash queue.
+/// </summary>
+void MqttPublisher::flush()
+{
+	if (_frames == 0)
+	{
+		return;
+	}
+
+	_message[_length++] = ']';
+
+	if (!_draining && _queue->isEmpty() && _client->isConnected() && !_client->isBusy() &&
+		_client->publish(_topic, _message, _length))
+	{
+		_direct++;
+	}
+	else if (_queue->push(_message, _length))
+	{
+		_queued++;
+	}
+
+	_length = 0;
+	_frames = 0;
+}
+
+/// <summary>
+///  Refills the rate limit tokens (rate tokens per second).
+/// </summary>
+void MqttPublisher::refill()
+{
+	uint32_t now = millis();
+	uint32_t elapsed = now - _refill;
+
+	if (elapsed >= 1000)
+	{
+		uint32_t tokens = _tokens + (elapsed / 1000) * _rate;
+		_tokens = (tokens > _rate) ? _rate : (uint8_t)tokens;
+		_refill = now - (elapsed % 1000);
+	}
+}
+
+/// <summary>
+///  Removes the queued message from the queue when it has been acknowledged, and publishes the next queued
+///  message if the client is idle (limited to the configured rate).
+/// </summary>
+void MqttPublisher::update()
+{
+	if (_draining)
+	{
+		if (_client->isBusy())
+		{
+			return;
+		}
+
+		_queue->pop();
+		_draining = false;
+	}
+
+	refill();
+
+	if (_queue->isEmpty() || (_tokens == 0) || !_client->isConnected() || _client->isBusy())
+	{
+		return;
+	}
+
+	size_t length = _queue->peek(_buffer, sizeof(_buffer));
+
+	if ((length > 0) && _client->publish(_topic, _buffer, length))
+	{
+		_draining = true;
+		_tokens--;
+	}
+}
@@ -0,0 +1,65 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MqttPublisher.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+#include "MqttClient.h"
+#include "FlashQueue.h"
+
+/// <summary>
+/// This class batches sensor frames into MQTT messages and publishes them (QoS 1), using the flash queue if the
+/// broker is not reachable.
+///
+/// The frames (JSON objects) are collected in a JSON array, the message is completed if it contains the configured
+/// number of frames or the next frame does not fit. A message is published directly if the client is idle and
+/// the queue is empty, otherwise it is appended to the queue. The queued messages are published in order at a
+/// limited rate (messages per second) after the connection is established, a queued message is removed when it has
+/// been acknowledged.
+/// </summary>
+class MqttPublisher
+{
+public:
+	static const size_t MESSAGE_SIZE = MqttClient::MAX_PAYLOAD;	// The maximum message size
+	static const uint8_t MAX_BATCH = 60;						// The maximum number of frames per message
+
+private:
+	MqttClient* _client;										// Pointer to the MQTT client
+	FlashQueue* _queue;											// Pointer to the flash queue
+	char _topic[MqttClient::MAX_TOPIC_LEN + 1];					// The topic
+	uint8_t _batch;												// The number of frames per message
+	uint8_t _rate;												// The maximum number of queued messages per second
+
+	char _message[MESSAGE_SIZE];								// The message being batched
+	size_t _length;												// The message length
+	uint8_t _frames;											// The number of frames in the message
+	char _buffer[MESSAGE_SIZE];									// The queued message being published
+	bool _draining;												// Flag indicating that a queued message is in flight
+	uint8_t _tokens;											// The available rate limit tokens
+	uint32_t _refill;											// The time of the last token refill
+
+	uint32_t _frameCount;										// The number of frames added
+	uint32_t _direct;											// The number of messages published directly
+	uint32_t _queued;											// The number of messages queued
+
+	void refill();												// Refills the rate limit tokens
+
+public:
+	MqttPublisher(MqttClient* client, FlashQueue* queue);		// Constructor using a client and a queue
+
+	void configure(const char* topic, uint8_t batch,			// Sets the topic, batch size, and drain rate
+		uint8_t rate);
+	bool addFrame(const char* frame, size_t length);			// Adds a frame (JSON object) to the message
+	void flush();												// Completes the message (publish or queue)
+	void update();												// Publishes the queued messages (rate limited)
+
+	uint32_t getFrames() const { return _frameCount; }			// Returns the number of frames added
+	uint32_t getDirect() const { return _direct; }				// Returns the number of messages published directly
+	uint32_t getQueued() const { return _queued; }				// Returns the number of messages queued
+};
@@ -0,0 +1,146 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MqttSettings.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "Logger.h"
+#include "JsonWire.h"
+#include "MqttSettings.h"
+
+/// <summary>
+/// Initializes selected data fields to default values.
+/// </summary>
+MqttSettings::MqttSettings() :
+	Server(""),
+	Port(MQTT_PORT),
+	ClientId(""),
+	User(""),
+	Pass(""),
+	Topic(MQTT_TOPIC),
+	Interval(60),
+	Batch(5),
+	DrainRate(2)
+{
+	LOG_TRACE("MqttSettings::MqttSettings()" CR);
+}
+
+/// <summary>
+///  Deserialize the data fields from a JSON string. The settings are rejected (not changed) if a string is
+///  longer than supported by the MQTT client.
+/// </summary>
+/// <param name="json">The JSON string</param>
+/// <returns>True if successful</returns>
+bool MqttSettings::deserialize(String json)
+{
+	LOG_TRACE("MqttSettings::deserialize()" CR);
+
+	if (json.length() > 0)
+	{
+		DeserializationError err = deserializeJson(_doc, json);
+
+		if (err)
+		{
+			LOG_ERROR("MqttSettings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
+			return false;
+		}
+
+		const char* server = _doc["Server"] | Server.c_str();
+		const char* clientId = _doc["ClientId"] | ClientId.c_str();
+		const char* user = _doc["User"] | User.c_str();
+		const char* pass = _doc["Pass"] | Pass.c_str();
+		const char* topic = _doc["Topic"] | Topic.c_str();
+
+		if ((strlen(server) > MqttClient::MAX_SERVER_LEN) ||
+			(strlen(clientId) > MqttClient::MAX_NAME_LEN) ||
+			(strlen(user) > MqttClient::MAX_NAME_LEN) ||
+			(strlen(pass) > MqttClient::MAX_PASS_LEN) ||
+			(strlen(topic) > MAX_TOPIC_LEN))
+		{
+			LOG_ERROR("MqttSettings::deserialize() Server, ClientId, User, Pass, or Topic too long" CR);
+			return false;
+		}
+
+		Server    = _doc["Server"]    | Server;
+		Port      = _doc["Port"]      | Port;
+		ClientId  = _doc["ClientId"]  | ClientId;
+		User      = _doc["User"]      | User;
+		Pass      = _doc["Pass"]      | Pass;
+		Topic     = _doc["Topic"]     | Topic;
+		Interval  = _doc["Interval"]  | Interval;
+		Batch     = _doc["Batch"]     | Batch;
+		DrainRate = _doc["DrainRate"] | DrainRate;
+
+		if (Interval < 1) Interval = 1;
+		if (Batch < 1) Batch = 1;
+		if (DrainRate < 1) DrainRate = 1;
+
+		return true;
+	}
+
+	LOG_WARNING("MqttSettings::deserialize() Invalid JSON string" CR);
+	return false;
+}
+
+/// <summary>
+///  Serialize the class instance to a JSON string.
+/// </summary>
+/// <returns>The JSON string</returns>
+String MqttSettings::serialize()
+{
+	LOG_TRACE("MqttSettings::serialize()" CR);
+	String json;
+
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void MqttSettings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("MqttSettings::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void MqttSettings::build()
+{
+	_doc.clear();
+	_doc["Server"]    = Server;
+	_doc["Port"]      = Port;
+	_doc["ClientId"]  = ClientId;
+	_doc["User"]      = User;
+	_doc["Pass"]      = Pass;
+	_doc["Topic"]     = Topic;
+	_doc["Interval"]  = Interval;
+	_doc["Batch"]     = Batch;
+	_doc["DrainRate"] = DrainRate;
+}
+
+/// <summary>
+///  Resets all field to their default values.
+/// </summary>
+void MqttSettings::reset()
+{
+	LOG_TRACE("MqttSettings::reset()" CR);
+
+	Server = "";
+	Port = MQTT_PORT;
+	ClientId = "";
+	User = "";
+	Pass = "";
+	Topic = MQTT_TOPIC;
+	Interval = 60;
+	Batch = 5;
+	DrainRate = 2;
+}
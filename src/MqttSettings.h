@@ -0,0 +1,51 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="MqttSettings.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "MqttClient.h"
+#include "WireFormat.h"
+
+/// <summary>
+/// This class holds the MQTT publisher configuration data (an empty server disables the publisher).
+/// </summary>
+class MqttSettings
+{
+private:
+	const char* MQTT_TOPIC = "soilmonitor";		// The default topic
+
+	static const int CAPACITY =					// The maximum size for the JSON document
+		JSON_OBJECT_SIZE(9) + 320;
+	StaticJsonDocument<CAPACITY> _doc;			// The static JSON document
+	void build();								// Builds the document
+
+public:
+	static const uint16_t MQTT_PORT = 1883;		// The default broker TCP port
+	static const size_t MAX_TOPIC_LEN =			// The maximum length of the topic prefix ("/data" appended)
+		MqttClient::MAX_TOPIC_LEN - 5;
+
+	MqttSettings();								// Default constructor
+
+	String Server;								// The broker (name or address, empty: disabled)
+	uint16_t Port;								// The broker TCP port
+	String ClientId;							// The client identifier (empty: hostname)
+	String User;								// The user name (empty: anonymous)
+	String Pass;								// The password
+	String Topic;								// The topic prefix (messages are sent to {Topic}/data)
+	uint16_t Interval;							// The frame interval (sec)
+	uint8_t Batch;								// The number of frames per message
+	uint8_t DrainRate;							// The maximum number of queued messages per second
+
+	bool deserialize(String json);				// Read a JSON string and updates the fields
+	String serialize();							// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);			// Writes a binary serialization (CBOR, MessagePack)
+	void reset();								// Resets all settings
+};
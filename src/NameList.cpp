@@ -0,0 +1,91 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="NameList.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <string.h>
+
+#include "NameList.h"
+
+/// <summary>
+///  Default constructor (empty list).
+/// </summary>
+NameList::NameList()
+{
+	_buffer[0] = '\0';
+}
+
+/// <summary>
+///  Constructor parsing a comma separated list (a NULL list is empty).
+/// </summary>
+/// <param name="list">The comma separated list</param>
+NameList::NameList(const char* list) : NameList()
+{
+	if (list == NULL)
+	{
+		return;
+	}
+
+	if (strlen(list) >= MAX_LENGTH)
+	{
+		_valid = false;
+		return;
+	}
+
+	strcpy(_buffer, list);
+	char* next = _buffer;
+
+	while (*next != '\0')
+	{
+		// Terminate the previous name and skip the separators.
+		while ((*next == ',') || (*next == ' ')) *next++ = '\0';
+		if (*next == '\0') break;
+
+		if (_count == MAX_NAMES)
+		{
+			_valid = false;
+			break;
+		}
+
+		_offsets[_count++] = (uint8_t)(next - _buffer);
+		while ((*next != '\0') && (*next != ',') && (*next != ' ')) next++;
+	}
+}
+
+/// <summary>
+///  Returns the name at the specified index.
+/// </summary>
+/// <param name="index">The index</param>
+/// <returns>The name (NULL if out of range)</returns>
+const char* NameList::getName(uint8_t index) const
+{
+	return (index < _count) ? &_buffer[_offsets[index]] : NULL;
+}
+
+/// <summary>
+///  Returns true if the list contains the name (case sensitive, like the JSON keys).
+/// </summary>
+/// <param name="name">The name</param>
+/// <returns>True if found</returns>
+bool NameList::contains(const char* name) const
+{
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (strcmp(&_buffer[_offsets[i]], name) == 0) return true;
+	}
+
+	return false;
+}
+
+/// <summary>
+///  Returns true if the name is selected by the list (an empty list selects all names).
+/// </summary>
+/// <param name="name">The name</param>
+/// <returns>True if selected</returns>
+bool NameList::selects(const char* name) const
+{
+	return isEmpty() || contains(name);
+}
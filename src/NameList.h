@@ -0,0 +1,42 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="NameList.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class holds a comma separated list of names from a query parameter, e.g. the resources of a batch request
+/// (/batch?r=server,ap,sta) or the fields of a projection (/data?fields=Humidity,TempC). Empty names and spaces are
+/// skipped. The list is copied into a fixed buffer (no allocation), a list exceeding the buffer or the maximum
+/// number of names is marked invalid. An empty list selects all fields.
+/// </summary>
+class NameList
+{
+public:
+	static const uint8_t MAX_NAMES = 12;						// The maximum number of names
+	static const uint8_t MAX_LENGTH = 128;						// The maximum length of the list
+
+private:
+	char _buffer[MAX_LENGTH];									// The names (null terminated)
+	uint8_t _offsets[MAX_NAMES];								// The buffer offsets of the names
+	uint8_t _count = 0;											// The number of names
+	bool _valid = true;											// Flag indicating that the list is complete
+
+public:
+	NameList();													// Default constructor (empty list)
+	explicit NameList(const char* list);						// Constructor parsing a comma separated list
+
+	uint8_t getCount() const { return _count; }					// Returns the number of names
+	const char* getName(uint8_t index) const;					// Returns a name (NULL if out of range)
+	bool isEmpty() const { return _count == 0; }				// Returns true if the list is empty
+	bool isValid() const { return _valid; }						// Returns true if the list is complete
+
+	bool contains(const char* name) const;						// Returns true if the list contains the name
+	bool selects(const char* name) const;						// Returns true if empty or containing the name
+};
@@ -0,0 +1,285 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Profiler.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "Profiler.h"
+
+const char* Profiler::NOT_FOUND = "404";
+Histogram Profiler::_phases[Profiler::PHASE_COUNT];
+Profiler::Route Profiler::_routes[Profiler::MAX_ROUTES];
+uint8_t Profiler::_count = 0;
+int8_t Profiler::_route = -1;
+uint32_t Profiler::_started = 0;
+
+/// <summary>
+///  Default constructor (no samples).
+/// </summary>
+Histogram::Histogram()
+{
+	reset();
+}
+
+/// <summary>
+///  Returns the mean value (usec).
+/// </summary>
+/// <returns>The mean value</returns>
+uint32_t Histogram::getMean()
+{
+	return (Count > 0) ? (uint32_t)(Sum / Count) : 0;
+}
+
+/// <summary>
+///  Returns the percentile as the upper bound of the bucket containing it (limited by the maximum).
+/// </summary>
+/// <param name="percent">The percentile (1..100)</param>
+/// <returns>The percentile value (usec)</returns>
+uint32_t Histogram::getPercentile(uint8_t percent)
+{
+	if (Count == 0)
+	{
+		return 0;
+	}
+
+	uint64_t limit = ((uint64_t)Count * percent + 99) / 100;
+	uint64_t total = 0;
+
+	for (uint8_t i = 0; i < BUCKETS - 1; i++)
+	{
+		total += Buckets[i];
+
+		if (total >= limit)
+		{
+			uint32_t upper = (i == 0) ? 0 : (1UL << i) - 1;
+			return (upper < Max) ? upper : Max;
+		}
+	}
+
+	return Max;
+}
+
+/// <summary>
+///  Halves all counts and the sum (keeping the distribution and the maximum).
+/// </summary>
+void Histogram::halve()
+{
+	for (uint8_t i = 0; i < BUCKETS; i++)
+	{
+		Buckets[i] /= 2;
+	}
+
+	Count /= 2;
+	Sum /= 2;
+}
+
+/// <summary>
+///  Clears all samples.
+/// </summary>
+void Histogram::reset()
+{
+	Count = 0;
+	Sum = 0;
+	Max = 0;
+	memset(Buckets, 0, sizeof(Buckets));
+}
+
+/// <summary>
+///  Prints the histogram as a JSON object (values in usec).
+/// </summary>
+/// <param name="out">The output (e.g. HTTP response)</param>
+void Histogram::print(Print& out)
+{
+	out.print("{\"Count\":"); out.print(Count);
+	out.print(",\"Mean\":"); out.print(getMean());
+	out.print(",\"P99\":"); out.print(getPercentile(99));
+	out.print(",\"Max\":"); out.print(Max);
+	out.print(",\"Buckets\":[");
+
+	for (uint8_t i = 0; i < BUCKETS; i++)
+	{
+		if (i > 0) out.print(',');
+		out.print(Buckets[i]);
+	}
+
+	out.print("]}");
+}
+
+/// <summary>
+///  Sets the route of the actual request. A trailing numeric index is replaced by ':i' (e.g. /soil/:i).
+///  The requests of unknown paths are recorded in the NOT_FOUND route (e.g. scanners and missing assets).
+///  If the route table is full, the last entry is used for all other routes.
+/// </summary>
+/// <param name="path">The request path</param>
+/// <param name="found">False if the path is unknown (no route or file handler)</param>
+void Profiler::setRoute(const char* path, bool found)
+{
+	char route[MAX_ROUTE_LEN + 1];
+
+	if (!found)
+	{
+		path = NOT_FOUND;
+	}
+
+	size_t length = strnlen(path, MAX_ROUTE_LEN);
+	size_t index = length;
+
+	memcpy(route, path, length);
+	route[length] = '\0';
+
+	while ((index > 0) && isdigit(route[index - 1]))
+	{
+		index--;
+	}
+
+	if ((index > 0) && (index < length) && (route[index - 1] == '/') && (index + 2 <= MAX_ROUTE_LEN))
+	{
+		strcpy(route + index, ":i");
+	}
+
+	for (_route = 0; _route < _count; _route++)
+	{
+		if (strcmp(_routes[_route].Path, route) == 0)
+		{
+			return;
+		}
+	}
+
+	if (_count < MAX_ROUTES - 1)
+	{
+		strcpy(_routes[_count].Path, route);
+	}
+	else
+	{
+		_route = MAX_ROUTES - 1;
+		strcpy(_routes[_route].Path, "other");
+	}
+
+	_count = _route + 1;
+}
+
+/// <summary>
+///  Records the latency of the actual request (using the route set by the middleware).
+/// </summary>
+/// <param name="us">The request latency (usec)</param>
+void Profiler::recordRoute(uint32_t us)
+{
+	if (_route >= 0)
+	{
+		_routes[_route].Latency.record(us);
+		_route = -1;
+	}
+}
+
+/// <summary>
+///  Clears all histograms (including the routes).
+/// </summary>
+void Profiler::reset()
+{
+	for (uint8_t i = 0; i < PHASE_COUNT; i++)
+	{
+		_phases[i].reset();
+	}
+
+	for (uint8_t i = 0; i < MAX_ROUTES; i++)
+	{
+		_routes[i].Latency.reset();
+	}
+
+	_count = 0;
+	_route = -1;
+	_started = millis();
+}
+
+/// <summary>
+///  Prints all histograms as a JSON object (values in usec, age in seconds).
+/// </summary>
+/// <param name="out">The output (e.g. HTTP response)</param>
+void Profiler::print(Print& out)
+{
+	out.print("{\"Age\":"); out.print((millis() - _started) / 1000);
+	out.print(",\"Phases\":{");
+
+	for (uint8_t i = 0; i < PHASE_COUNT; i++)
+	{
+		if (i > 0) out.print(',');
+		out.print('"'); out.print(getPhaseName(i)); out.print("\":");
+		_phases[i].print(out);
+	}
+
+	out.print("},\"Routes\":{");
+
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (i > 0) out.print(',');
+		out.print('"'); out.print(_routes[i].Path); out.print("\":");
+		_routes[i].Latency.print(out);
+	}
+
+	out.println("}}");
+}
+
+/// <summary>
+///  Prints a summary table (count, mean, p99, max in usec) of all phases and routes,
+///  and the measured recording overhead.
+/// </summary>
+/// <param name="out">The output (e.g. Commander)</param>
+void Profiler::printTable(Print& out)
+{
+	char line[80];
+
+	snprintf(line, sizeof(line), "%-20s %10s %8s %8s %8s", "Phase/Route", "Count", "Mean", "P99", "Max");
+	out.println(line);
+
+	for (uint8_t i = 0; i < PHASE_COUNT + _count; i++)
+	{
+		Histogram& h = (i < PHASE_COUNT) ? _phases[i] : _routes[i - PHASE_COUNT].Latency;
+		const char* name = (i < PHASE_COUNT) ? getPhaseName(i) : _routes[i - PHASE_COUNT].Path;
+
+		snprintf(line, sizeof(line), "%-20.20s %10u %8u %8u %8u", name,
+			(unsigned int)h.Count, (unsigned int)h.getMean(), (unsigned int)h.getPercentile(99), (unsigned int)h.Max);
+		out.println(line);
+	}
+
+	// Measure the recording overhead using a scratch histogram.
+	Histogram scratch;
+	uint32_t begin = micros();
+	uint32_t time = begin;
+
+	for (uint8_t i = 0; i < 100; i++)
+	{
+		uint32_t now = micros();
+		scratch.record(now - time);
+		time = now;
+	}
+
+	out.print("Overhead (ns/sample): ");
+	out.println((micros() - begin) * 10);
+	out.print("Age (sec): ");
+	out.println((millis() - _started) / 1000);
+}
+
+/// <summary>
+///  Returns the phase name.
+/// </summary>
+/// <param name="phase">The phase</param>
+/// <returns>The phase name</returns>
+const char* Profiler::getPhaseName(uint8_t phase)
+{
+	switch (phase)
+	{
+	case PHASE_LOOP:     return "Loop";
+	case PHASE_LED:      return "Led";
+	case PHASE_COMMANDS: return "Commands";
+	case PHASE_WIFI:     return "WiFi";
+	case PHASE_HTTP:     return "Http";
+	case PHASE_SENSORS:  return "Sensors";
+	case PHASE_SYSTEM:   return "System";
+	case PHASE_MQTT:     return "Mqtt";
+	case PHASE_INFLUX:   return "Influx";
+	case PHASE_COAP:     return "Coap";
+	default:             return "Unknown";
+	}
+}
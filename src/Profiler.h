@@ -0,0 +1,128 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Profiler.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class implements a fixed-bucket latency histogram (microseconds).
+/// Bucket 0 counts the samples below 1 usec, bucket i the samples in [2^(i-1), 2^i) usec,
+/// the last bucket all larger samples. Recording is a few instructions (no division, no allocation).
+/// </summary>
+class Histogram
+{
+public:
+	static const uint8_t BUCKETS = 20;							// The number of buckets (last: >= 262 msec)
+	static const uint32_t MAX_COUNT = 0x80000000UL;				// The count halving all values (no overflow)
+
+	uint32_t Count;												// The number of samples
+	uint64_t Sum;												// The sum of all samples (usec)
+	uint32_t Max;												// The maximum sample (usec)
+	uint32_t Buckets[BUCKETS];									// The sample counts per bucket
+
+	Histogram();												// Default constructor
+
+	/// <summary>
+	///  Records a single sample (usec).
+	/// </summary>
+	/// <param name="us">The sample value (usec)</param>
+	inline void record(uint32_t us)
+	{
+		uint8_t index = (us == 0) ? 0 : 32 - __builtin_clz(us);
+
+		if (index >= BUCKETS) index = BUCKETS - 1;
+		if (us > Max) Max = us;
+		if (Count >= MAX_COUNT) halve();
+
+		Buckets[index]++;
+		Sum += us;
+		Count++;
+	}
+
+	uint32_t getMean();											// Returns the mean value (usec)
+	uint32_t getPercentile(uint8_t percent);					// Returns the percentile (bucket upper bound)
+	void halve();												// Halves all counts (keeping the distribution)
+	void reset();												// Clears all samples
+	void print(Print& out);										// Prints the histogram (JSON)
+};
+
+/// <summary>
+/// This class implements the loop and HTTP handler profiler.
+/// 
+/// The main loop records the duration of every phase using lap(), which reads the timer once and returns
+/// the new start time. The HTTP requests are recorded per route (set by the request middleware), the requests
+/// of unknown paths are recorded in a single "404" route, so they do not fill the route table.
+/// All functions are called from the main loop, so no locking is necessary.
+/// </summary>
+class Profiler
+{
+public:
+	enum Phase
+	{
+		PHASE_LOOP,												// The complete loop iteration
+		PHASE_LED,												// led.Update()
+		PHASE_COMMANDS,											// cmd.update()
+		PHASE_WIFI,												// manager.loop()
+		PHASE_HTTP,												// app.process()
+		PHASE_SENSORS,											// The sensor updates
+		PHASE_SYSTEM,											// sysInfo.update()
+		PHASE_MQTT,												// updateMqtt()
+		PHASE_INFLUX,											// updateInflux()
+		PHASE_COAP,												// coapServer.update()
+		PHASE_COUNT
+	};
+
+	static const uint8_t MAX_ROUTES = 24;						// The maximum number of routes (last: other)
+	static const uint8_t MAX_ROUTE_LEN = 31;					// The maximum route length
+	static const char* NOT_FOUND;								// The route of the unknown paths ("404")
+
+private:
+	struct Route
+	{
+		char Path[MAX_ROUTE_LEN + 1];							// The route path (index replaced by ':i')
+		Histogram Latency;										// The request latency histogram
+	};
+
+	static Histogram _phases[PHASE_COUNT];						// The phase histograms
+	static Route _routes[MAX_ROUTES];							// The route histograms
+	static uint8_t _count;										// The number of routes
+	static int8_t _route;										// The route of the actual request (-1: none)
+	static uint32_t _started;									// The time of the last reset (msec)
+
+public:
+	/// <summary>
+	///  Returns the actual time (usec) used as the start of the first phase.
+	/// </summary>
+	/// <returns>The time (usec)</returns>
+	static inline uint32_t start()
+	{
+		return micros();
+	}
+
+	/// <summary>
+	///  Records the duration of a phase and returns the actual time (start of the next phase).
+	/// </summary>
+	/// <param name="phase">The phase</param>
+	/// <param name="start">The start time of the phase (usec)</param>
+	/// <returns>The actual time (usec)</returns>
+	static inline uint32_t lap(Phase phase, uint32_t start)
+	{
+		uint32_t now = micros();
+		_phases[phase].record(now - start);
+		return now;
+	}
+
+	static void setRoute(const char* path,						// Sets the route of the actual request
+		bool found = true);
+	static void recordRoute(uint32_t us);						// Records the latency of the actual request
+	static void reset();										// Clears all histograms
+	static void print(Print& out);								// Prints all histograms (JSON)
+	static void printTable(Print& out);							// Prints a summary table (text)
+	static const char* getPhaseName(uint8_t phase);				// Returns the phase name
+};
@@ -0,0 +1,178 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Routes.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "Routes.h"
+
+#define COUNT(table) (sizeof(table) / sizeof(*table))
+
+/// <summary>
+/// The source map files requested by the browser tools (sorted by strcmp).
+/// </summary>
+const char* Routes::IGNORED[] = {
+	"/css/bootstrap-grid.min.css.map",
+	"/css/bootstrap-reboot.min.css.map",
+	"/css/bootstrap.min.css.map",
+	"/css/soilmonitor.min.css.map",
+	"/js/bootstrap.bundle.min.js.map",
+	"/js/bootstrap.min.js.map",
+	"/js/jquery-3.4.1.min.js.map",
+	"/js/jquery.inputmask.min.js.map",
+	"/js/justgage.min.js.map",
+	"/js/popper.min.js.map",
+	"/js/raphael-2.1.4.min.js.map"
+};
+
+/// <summary>
+/// The files and JSON requests (sorted by strcmp).
+/// </summary>
+const char* Routes::ACCEPTED[] = {
+	"/",
+	"/about",
+	"/ap",
+	"/batch",
+	"/capture",
+	"/capture/start",
+	"/capture/stop",
+	"/config",
+	"/css/bootstrap-grid.min.css",
+	"/css/bootstrap-reboot.min.css",
+	"/css/bootstrap.min.css",
+	"/css/soilmonitor.min.css",
+	"/data",
+	"/err",
+	"/error",
+	"/favicon.ico",
+	"/home",
+	"/info",
+	"/js/bootstrap.bundle.min.js",
+	"/js/bootstrap.min.js",
+	"/js/jquery-3.4.1.min.js",
+	"/js/jquery.inputmask.min.js",
+	"/js/justgage.min.js",
+	"/js/popper.min.js",
+	"/js/raphael-2.1.4.min.js",
+	"/log",
+	"/meta",
+	"/metrics",
+	"/perf",
+	"/reboot",
+	"/reset",
+	"/save",
+	"/scan",
+	"/server",
+	"/settings",
+	"/settings/ap",
+	"/settings/cmd",
+	"/settings/influx",
+	"/settings/log",
+	"/settings/mqtt",
+	"/settings/soil",
+	"/settings/sta",
+	"/settings/temp",
+	"/soil",
+	"/sta",
+	"/system",
+	"/system/trend",
+	"/temp"
+};
+
+/// <summary>
+/// The indexed resources (e.g. /soil/:i).
+/// </summary>
+const char* Routes::PREFIXES[] = {
+	"/soil/",
+	"/temp/",
+	"/settings/soil/",
+	"/settings/temp/"
+};
+
+/// <summary>
+///  Returns true if the sorted table contains the path (binary search).
+/// </summary>
+/// <param name="table">The sorted table</param>
+/// <param name="count">The number of table entries</param>
+/// <param name="path">The request path</param>
+/// <returns>True if found</returns>
+bool Routes::contains(const char* const* table, size_t count, const char* path)
+{
+	size_t low = 0;
+	size_t high = count;
+
+	while (low < high)
+	{
+		size_t middle = (low + high) / 2;
+		int order = strcmp(path, table[middle]);
+
+		if (order == 0)
+		{
+			return true;
+		}
+		else if (order > 0)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return false;
+}
+
+/// <summary>
+///  Returns the match of a request path (accepted, ignored, or not found).
+/// </summary>
+/// <param name="path">The request path</param>
+/// <returns>The match</returns>
+Routes::Match Routes::match(const char* path)
+{
+	if (path == NULL)
+	{
+		return MATCH_NONE;
+	}
+
+	if (contains(ACCEPTED, COUNT(ACCEPTED), path))
+	{
+		return MATCH_ACCEPTED;
+	}
+
+	for (size_t i = 0; i < COUNT(PREFIXES); i++)
+	{
+		if (strncmp(path, PREFIXES[i], strlen(PREFIXES[i])) == 0)
+		{
+			return MATCH_ACCEPTED;
+		}
+	}
+
+	if (contains(IGNORED, COUNT(IGNORED), path))
+	{
+		return MATCH_IGNORED;
+	}
+
+	return MATCH_NONE;
+}
+
+/// <summary>
+///  Returns true if the tables are sorted (required by the binary search).
+/// </summary>
+/// <returns>True if sorted</returns>
+bool Routes::isSorted()
+{
+	for (size_t i = 1; i < COUNT(ACCEPTED); i++)
+	{
+		if (strcmp(ACCEPTED[i - 1], ACCEPTED[i]) >= 0) return false;
+	}
+
+	for (size_t i = 1; i < COUNT(IGNORED); i++)
+	{
+		if (strcmp(IGNORED[i - 1], IGNORED[i]) >= 0) return false;
+	}
+
+	return true;
+}
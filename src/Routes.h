@@ -0,0 +1,39 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="Routes.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <string.h>
+
+/// <summary>
+/// This class implements the request path check of the web server middleware (checkRequest).
+/// The known paths are kept in sorted tables (binary search), the indexed paths are matched by prefix.
+/// Note that the tables have to be updated if a handler is added to the web server.
+/// </summary>
+class Routes
+{
+public:
+	enum Match
+	{
+		MATCH_NONE,												// Unknown path (not found)
+		MATCH_IGNORED,											// Ignored path (source map files)
+		MATCH_ACCEPTED											// Accepted path (file or JSON request)
+	};
+
+private:
+	static const char* IGNORED[];								// The ignored paths (sorted)
+	static const char* ACCEPTED[];								// The accepted paths (sorted)
+	static const char* PREFIXES[];								// The accepted path prefixes (indexed resources)
+
+	static bool contains(const char* const* table,				// Returns true if the sorted table contains the path
+		size_t count, const char* path);
+
+public:
+	static Match match(const char* path);						// Returns the match of a request path
+	static bool isSorted();										// Returns true if the tables are sorted (test)
+};
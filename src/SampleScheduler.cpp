@@ -0,0 +1,94 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SampleScheduler.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <math.h>
+
+#include "SampleScheduler.h"
+
+/// <summary>
+///  Default constructor (no threshold, the channel is sampled at the minimum interval).
+/// </summary>
+SampleScheduler::SampleScheduler()
+{
+}
+
+/// <summary>
+///  Constructor setting the change threshold.
+/// </summary>
+/// <param name="threshold">The change threshold (channel unit)</param>
+SampleScheduler::SampleScheduler(float threshold)
+{
+	setThreshold(threshold);
+}
+
+/// <summary>
+///  Sets the minimum and maximum interval, the values are limited to 1..MAX_LIMIT seconds.
+///  Note that the maximum interval is at least the minimum interval. The schedule is restarted.
+/// </summary>
+/// <param name="min">The minimum interval (sec)</param>
+/// <param name="max">The maximum interval (sec)</param>
+void SampleScheduler::setIntervals(uint16_t min, uint16_t max)
+{
+	_minInterval = (min < 1) ? 1 : (min > MAX_LIMIT) ? MAX_LIMIT : min;
+	_maxInterval = (max < _minInterval) ? _minInterval : (max > MAX_LIMIT) ? MAX_LIMIT : max;
+	reset();
+}
+
+/// <summary>
+///  Sets the change threshold (negative values are ignored).
+/// </summary>
+/// <param name="threshold">The change threshold (channel unit)</param>
+void SampleScheduler::setThreshold(float threshold)
+{
+	_threshold = (threshold < 0.0) ? 0.0 : threshold;
+}
+
+/// <summary>
+///  Restarts the schedule, the next sample is due immediately and taken at the minimum interval.
+/// </summary>
+void SampleScheduler::reset()
+{
+	_interval = _minInterval * 1000UL;
+	_sampled = false;
+}
+
+/// <summary>
+///  Returns true if the next sample is due. The jitter of the update timer is tolerated.
+/// </summary>
+/// <param name="now">The current time (msec)</param>
+/// <returns>True if due</returns>
+bool SampleScheduler::isDue(uint32_t now) const
+{
+	return !_sampled || ((now - _last + JITTER) >= _interval);
+}
+
+/// <summary>
+///  Records a sample. The interval is reset to the minimum if the value changed by at least the threshold
+///  or the channel has not settled yet, otherwise it is doubled (limited to the maximum interval).
+/// </summary>
+/// <param name="now">The current time (msec)</param>
+/// <param name="value">The sample value</param>
+/// <param name="settled">False keeps the minimum interval (e.g. while a filter converges)</param>
+void SampleScheduler::sample(uint32_t now, float value, bool settled)
+{
+	uint32_t max = _maxInterval * 1000UL;
+
+	if (!_sampled || !settled || (fabsf(value - _value) >= _threshold))
+	{
+		_interval = _minInterval * 1000UL;
+		_value = value;
+	}
+	else
+	{
+		_interval = (_interval >= max / 2) ? max : _interval * 2;
+	}
+
+	_last = now;
+	_sampled = true;
+	_samples++;
+}
@@ -0,0 +1,55 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SampleScheduler.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class implements the adaptive sampling schedule of a single sensor channel. A channel is sampled at the
+/// minimum interval while the value is changing (a change of at least the threshold), the interval is doubled after
+/// each sample without change until the maximum interval is reached. The change is measured against the value of the
+/// last changed sample, so a slow drift is detected as well.
+/// The intervals are specified in seconds, the threshold in the unit of the channel value.
+/// </summary>
+class SampleScheduler
+{
+public:
+	static const uint16_t MIN_INTERVAL = 1;						// The default minimum interval (sec)
+	static const uint16_t MAX_INTERVAL = 60;					// The default maximum interval (sec)
+	static const uint16_t MAX_LIMIT = 3600;						// The upper limit of the intervals (sec)
+	static const uint16_t JITTER = 100;							// The tolerated timer jitter (msec)
+
+private:
+	uint16_t _minInterval = MIN_INTERVAL;						// The minimum interval (sec)
+	uint16_t _maxInterval = MAX_INTERVAL;						// The maximum interval (sec)
+	float _threshold = 0.0;										// The change threshold (channel unit)
+	uint32_t _interval = MIN_INTERVAL * 1000UL;					// The current interval (msec)
+	uint32_t _last = 0;											// The time of the last sample (msec)
+	float _value = 0.0;											// The value of the last changed sample
+	bool _sampled = false;										// Flag indicating that a sample has been taken
+	uint32_t _samples = 0;										// The number of samples taken
+
+public:
+	SampleScheduler();											// Default constructor
+	SampleScheduler(float threshold);							// Constructor setting the change threshold
+
+	uint16_t getMinInterval() const { return _minInterval; }	// Returns the minimum interval (sec)
+	uint16_t getMaxInterval() const { return _maxInterval; }	// Returns the maximum interval (sec)
+	float getThreshold() const { return _threshold; }			// Returns the change threshold
+	uint32_t getInterval() const { return _interval; }			// Returns the current interval (msec)
+	uint32_t getSamples() const { return _samples; }			// Returns the number of samples taken
+
+	void setIntervals(uint16_t min, uint16_t max);				// Sets the minimum and maximum interval (sec)
+	void setThreshold(float threshold);							// Sets the change threshold
+
+	void reset();												// Restarts the schedule (next sample is due)
+	bool isDue(uint32_t now) const;								// Returns true if the next sample is due
+	void sample(uint32_t now, float value,						// Records a sample and updates the interval
+		bool settled = true);
+};
@@ -0,0 +1,51 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="ScanInfo.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "Logger.h"
+#include "ScanInfo.h"
+
+/// <summary>
+///  Using the WiFi manager to get the cached scan results.
+/// </summary>
+/// <param name="manager">Pointer to the WiFi manager</param>
+ScanInfo::ScanInfo(WiFiManager* manager) :
+	_manager(manager)
+{
+	LOG_TRACE("ScanInfo::ScanInfo()" CR);
+}
+
+/// <summary>
+///  Serialize the scan results to a JSON string (age in seconds).
+/// </summary>
+/// <returns>The JSON string</returns>
+String ScanInfo::serialize()
+{
+	LOG_TRACE("ScanInfo::serialize()" CR);
+	String json;
+
+	_doc.clear();
+	_doc["Scanning"] = _manager->isScanning();
+	_doc["Valid"]    = _manager->isScanValid();
+	_doc["Age"]      = _manager->getScanAge() / 1000;
+
+	JsonArray networks = _doc.createNestedArray("Networks");
+
+	// The cached strings are not copied (the cache is not updated while serializing).
+	for (unsigned short i = 0; i < _manager->getNumberAP(); i++)
+	{
+		const WiFiManager::Network* ap = _manager->getNetwork(i);
+		JsonObject network = networks.createNestedObject();
+		network["SSID"]       = (const char*)ap->SSID;
+		network["RSSI"]       = ap->RSSI;
+		network["Channel"]    = ap->Channel;
+		network["Encryption"] = WiFiManager::getEncryption(ap->Encryption);
+	}
+
+	serializeJsonPretty(_doc, json);
+	return json;
+}
@@ -0,0 +1,32 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="ScanInfo.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#include "WiFiManager.h"
+
+/// <summary>
+/// This class holds the cached WiFi scan results.
+/// </summary>
+class ScanInfo
+{
+private:
+	static const int CAPACITY =						// The maximum size for the JSON document
+		JSON_OBJECT_SIZE(4) + JSON_ARRAY_SIZE(WiFiManager::MAX_NETWORKS) +
+		WiFiManager::MAX_NETWORKS * JSON_OBJECT_SIZE(4);
+	StaticJsonDocument<CAPACITY> _doc;				// The static JSON document
+	WiFiManager* _manager;							// Pointer to the WiFi manager (scan cache)
+
+public:
+	ScanInfo(WiFiManager* manager);					// Constructor using the WiFi manager
+
+	String serialize();								// Return a string serialization (JSON)
+};
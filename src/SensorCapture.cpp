@@ -0,0 +1,198 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SensorCapture.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include "SensorCapture.h"
+
+/// <summary>
+/// The path of the capture file.
+/// </summary>
+const char* SensorCapture::PATH = "/capture.bin";
+
+/// <summary>
+///  Constructor using a file system.
+/// </summary>
+/// <param name="fs">Pointer to the file system</param>
+SensorCapture::SensorCapture(fs::FS* fs) :
+	_fs(fs),
+	_count(0),
+	_size(0),
+	_records(0),
+	_running(false)
+{
+}
+
+/// <summary>
+///  Starts a new capture. The capture file is truncated and the header is written.
+/// </summary>
+/// <returns>True if the capture file has been created</returns>
+bool SensorCapture::start()
+{
+	if (_fs == NULL)
+	{
+		return false;
+	}
+
+	File file = _fs->open(PATH, FILE_WRITE);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	Header header = { MAGIC, VERSION, sizeof(Record) };
+	file.write((const uint8_t*)&header, sizeof(header));
+	_size = file.size();
+	file.close();
+
+	_count = 0;
+	_records = 0;
+	_running = true;
+
+	return true;
+}
+
+/// <summary>
+///  Stops the capture, the buffered records are written to the file.
+/// </summary>
+void SensorCapture::stop()
+{
+	writeBuffer();
+	_running = false;
+}
+
+/// <summary>
+///  Stops the capture and removes the capture file.
+/// </summary>
+void SensorCapture::clear()
+{
+	_running = false;
+	_count = 0;
+	_size = 0;
+	_records = 0;
+
+	if ((_fs != NULL) && _fs->exists(PATH))
+	{
+		_fs->remove(PATH);
+	}
+}
+
+/// <summary>
+///  Adds a sample to the write buffer. The buffer is written to the file if it is full, the capture is stopped
+///  if the maximum file size is reached.
+/// </summary>
+/// <param name="time">The sample time (msec)</param>
+/// <param name="channel">The sensor type</param>
+/// <param name="index">The sensor index</param>
+/// <param name="value">The raw sensor value (analog input value, or 1/100 degree Celsius)</param>
+void SensorCapture::add(uint32_t time, Channel channel, uint8_t index, int16_t value)
+{
+	if (!_running)
+	{
+		return;
+	}
+
+	if (size() + sizeof(Record) > MAX_FILE_SIZE)
+	{
+		stop();
+		return;
+	}
+
+	_buffer[_count++] = Record{ time, channel, index, value };
+	_records++;
+
+	if (_count >= BUFFER_COUNT)
+	{
+		writeBuffer();
+	}
+}
+
+/// <summary>
+///  Appends the buffer to the capture file.
+/// </summary>
+void SensorCapture::writeBuffer()
+{
+	if ((_fs == NULL) || (_count == 0))
+	{
+		return;
+	}
+
+	File file = _fs->open(PATH, FILE_APPEND);
+
+	if (file)
+	{
+		file.write((const uint8_t*)_buffer, _count * sizeof(Record));
+		_size = file.size();
+		file.close();
+	}
+
+	_count = 0;
+}
+
+/// <summary>
+///  Prints the capture file in chunks, either binary (HTTP download) or as hex lines (serial).
+///  The buffered records are written to the file first.
+/// </summary>
+/// <param name="output">The print output</param>
+/// <param name="hex">Print hex lines instead of binary data</param>
+/// <returns>The number of file bytes printed</returns>
+size_t SensorCapture::dump(Print& output, bool hex)
+{
+	uint8_t chunk[CHUNK_SIZE];
+	size_t printed = 0;
+
+	writeBuffer();
+
+	if ((_fs == NULL) || !_fs->exists(PATH))
+	{
+		return 0;
+	}
+
+	File file = _fs->open(PATH, FILE_READ);
+
+	if (!file)
+	{
+		return 0;
+	}
+
+	for (;;)
+	{
+		size_t n = file.read(chunk, sizeof(chunk));
+
+		if (n == 0)
+		{
+			break;
+		}
+
+		if (hex)
+		{
+			for (size_t i = 0; i < n; i++)
+			{
+				output.printf("%02X", chunk[i]);
+
+				if (((printed + i + 1) % HEX_LINE) == 0)
+				{
+					output.println();
+				}
+			}
+		}
+		else
+		{
+			output.write(chunk, n);
+		}
+
+		printed += n;
+	}
+
+	if (hex && ((printed % HEX_LINE) != 0))
+	{
+		output.println();
+	}
+
+	file.close();
+	return printed;
+}
@@ -0,0 +1,77 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SensorCapture.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+/// <summary>
+/// This class implements the capture of the raw sensor inputs (analog input values and DS18B20 temperatures) to a
+/// binary file on the flash file system. The captures are replayed on the host to compare the smoothing filters.
+///
+/// The file starts with a header (magic, version, record size), followed by fixed size records (little endian).
+/// The records are collected in a RAM buffer and appended to the file if the buffer is full or the capture is
+/// stopped. The capture stops if the maximum file size is reached.
+/// </summary>
+class SensorCapture
+{
+public:
+	static const char* PATH;									// The path of the capture file
+	static const uint32_t MAGIC = 0x50414353;					// The file magic ("SCAP")
+	static const uint16_t VERSION = 1;							// The file format version
+	static const size_t MAX_FILE_SIZE = 262144;					// The maximum size of the capture file
+	static const size_t BUFFER_COUNT = 64;						// The number of buffered records
+	static const size_t CHUNK_SIZE = 256;						// The chunk size used for reading
+	static const size_t HEX_LINE = 32;							// The number of bytes per hex dump line
+
+	enum Channel : uint8_t
+	{
+		CHANNEL_SOIL = 0,										// Soil moisture sensor (raw analog input value)
+		CHANNEL_TEMP = 1										// Temperature sensor (1/100 degree Celsius)
+	};
+
+	struct __attribute__((packed)) Header
+	{
+		uint32_t Magic;											// The file magic
+		uint16_t Version;										// The file format version
+		uint16_t RecordSize;									// The size of a record (bytes)
+	};
+
+	struct __attribute__((packed)) Record
+	{
+		uint32_t Time;											// The sample time (msec)
+		uint8_t Channel;										// The sensor type (Channel)
+		uint8_t Index;											// The sensor index
+		int16_t Value;											// The raw sensor value
+	};
+
+private:
+	fs::FS* _fs;												// Pointer to the file system
+	Record _buffer[BUFFER_COUNT];								// The write buffer
+	size_t _count;												// The number of buffered records
+	size_t _size;												// The size of the capture file (bytes)
+	uint32_t _records;											// The number of captured records
+	bool _running;												// The capture is running
+
+	void writeBuffer();											// Appends the buffer to the capture file
+
+public:
+	SensorCapture(fs::FS* fs);									// Constructor using a file system
+
+	bool start();												// Starts a new capture (the file is truncated)
+	void stop();												// Stops the capture (the buffer is written)
+	void clear();												// Stops the capture and removes the file
+	bool isRunning() const { return _running; }					// Returns true if the capture is running
+	uint32_t getRecords() const { return _records; }			// Returns the number of captured records
+	size_t size() const { return _size + _count * sizeof(Record); }	// Returns the capture size (file and buffer)
+
+	void add(uint32_t time, Channel channel,					// Adds a sample (ignored if not running)
+		uint8_t index, int16_t value);
+	size_t dump(Print& output, bool hex = false);				// Prints the capture file (binary or hex lines)
+};
@@ -0,0 +1,343 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SensorFilter.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+
+#include "SensorFilter.h"
+
+/// <summary>
+/// The default chain (the exponential smoothing used before the filter chain was configurable).
+/// </summary>
+const char* SensorFilter::DEFAULT_CHAIN = "exp:10";
+
+/// <summary>
+/// The Hampel threshold (number of scaled median absolute deviations).
+/// </summary>
+const float SensorFilter::HAMPEL_THRESHOLD = 3.0;
+
+/// <summary>
+/// The scale factor of the median absolute deviation (standard deviation of normal distributed values).
+/// </summary>
+static const float MAD_SCALE = 1.4826;
+
+/// <summary>
+///  Default constructor using the default chain.
+/// </summary>
+SensorFilter::SensorFilter()
+{
+	setChain(DEFAULT_CHAIN);
+}
+
+/// <summary>
+///  Constructor setting the filter chain (the default chain is used if invalid).
+/// </summary>
+/// <param name="chain">The chain specification (e.g. "median:3")</param>
+SensorFilter::SensorFilter(const char* chain)
+{
+	if (!setChain(chain))
+	{
+		setChain(DEFAULT_CHAIN);
+	}
+}
+
+/// <summary>
+///  Sets the filter chain, the filter state is cleared. An empty chain disables filtering.
+/// </summary>
+/// <param name="chain">The chain specification (e.g. "hampel:7,exp:10")</param>
+/// <returns>True if the chain is valid (an invalid chain is ignored)</returns>
+bool SensorFilter::setChain(const String& chain)
+{
+	Stage stages[MAX_STAGES];
+	uint8_t count = 0;
+
+	if ((chain.length() > MAX_CHAIN_LEN) || !parse(chain.c_str(), stages, count))
+	{
+		return false;
+	}
+
+	memcpy(_stages, stages, sizeof(Stage) * count);
+	_count = count;
+	_chain = chain;
+	reset();
+
+	return true;
+}
+
+/// <summary>
+///  Returns true if the chain specification is valid.
+/// </summary>
+/// <param name="chain">The chain specification</param>
+/// <returns>True if valid</returns>
+bool SensorFilter::isValid(const String& chain)
+{
+	Stage stages[MAX_STAGES];
+	uint8_t count = 0;
+
+	return (chain.length() <= MAX_CHAIN_LEN) && parse(chain.c_str(), stages, count);
+}
+
+/// <summary>
+///  Clears the state of all stages (the windows are empty).
+/// </summary>
+void SensorFilter::reset()
+{
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		_stages[i].Count = 0;
+		_stages[i].Next = 0;
+		_stages[i].State = 0;
+	}
+
+	_value = 0;
+}
+
+/// <summary>
+///  Filters a sample using all stages.
+/// </summary>
+/// <param name="value">The raw sample</param>
+/// <returns>The filter output</returns>
+int SensorFilter::add(int value)
+{
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		value = filter(_stages[i], value);
+	}
+
+	_value = value;
+	return value;
+}
+
+/// <summary>
+///  Parses the chain specification (comma separated list of name:size).
+/// </summary>
+/// <param name="chain">The chain specification</param>
+/// <param name="stages">The parsed stages</param>
+/// <param name="count">The number of stages</param>
+/// <returns>True if valid</returns>
+bool SensorFilter::parse(const char* chain, Stage* stages, uint8_t& count)
+{
+	count = 0;
+
+	while (*chain != '\0')
+	{
+		const char* colon = strchr(chain, ':');
+		const char* end = strchr(chain, ',');
+
+		end = (end != NULL) ? end : chain + strlen(chain);
+
+		if ((colon == NULL) || (colon > end) || (count >= MAX_STAGES))
+		{
+			return false;
+		}
+
+		char* last = NULL;
+		long size = strtol(colon + 1, &last, 10);
+		size_t length = colon - chain;
+		Stage& stage = stages[count];
+
+		if ((last != end) || (size < 1))
+		{
+			return false;
+		}
+
+		if ((length == 6) && (strncmp(chain, "median", length) == 0) && (size <= MAX_WINDOW))
+		{
+			stage.Kind = FILTER_MEDIAN;
+		}
+		else if ((length == 6) && (strncmp(chain, "hampel", length) == 0) && (size >= 3) && (size <= MAX_WINDOW))
+		{
+			stage.Kind = FILTER_HAMPEL;
+		}
+		else if ((length == 3) && (strncmp(chain, "exp", length) == 0) && (size <= MAX_FACTOR))
+		{
+			stage.Kind = FILTER_EXP;
+		}
+		else if ((length == 3) && (strncmp(chain, "avg", length) == 0) && (size <= MAX_WINDOW))
+		{
+			stage.Kind = FILTER_AVG;
+		}
+		else
+		{
+			return false;
+		}
+
+		stage.Size = (uint16_t)size;
+		stage.Count = 0;
+		stage.Next = 0;
+		stage.State = 0;
+		count++;
+
+		if ((*end == ',') && (*(end + 1) == '\0'))
+		{
+			return false;
+		}
+
+		chain = (*end == ',') ? end + 1 : end;
+	}
+
+	return true;
+}
+
+/// <summary>
+///  Adds a sample to the window. If the window is full, the oldest sample is replaced. The sorted window is kept
+///  sorted by moving the new sample to its position (at most MAX_WINDOW - 1 moves).
+/// </summary>
+/// <param name="stage">The filter stage</param>
+/// <param name="value">The sample</param>
+void SensorFilter::insert(Stage& stage, int16_t value)
+{
+	int16_t* sorted = stage.Sorted;
+	uint8_t position;
+
+	if (stage.Count < stage.Size)
+	{
+		position = stage.Count++;
+	}
+	else
+	{
+		// Binary search of the oldest sample (any of equal values can be replaced).
+		int16_t oldest = stage.Values[stage.Next];
+		uint8_t low = 0;
+		uint8_t high = stage.Count - 1;
+
+		while (low < high)
+		{
+			uint8_t middle = (low + high) / 2;
+
+			if (sorted[middle] < oldest)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+
+		position = low;
+	}
+
+	sorted[position] = value;
+
+	while ((position > 0) && (sorted[position - 1] > value))
+	{
+		sorted[position] = sorted[position - 1];
+		sorted[--position] = value;
+	}
+
+	while ((position + 1 < stage.Count) && (sorted[position + 1] < value))
+	{
+		sorted[position] = sorted[position + 1];
+		sorted[++position] = value;
+	}
+
+	stage.Values[stage.Next] = value;
+	stage.Next = (stage.Next + 1 < stage.Size) ? stage.Next + 1 : 0;
+}
+
+/// <summary>
+///  Returns the median of the window (the lower median for an even number of samples).
+/// </summary>
+/// <param name="stage">The filter stage</param>
+/// <returns>The median</returns>
+int16_t SensorFilter::getMedian(const Stage& stage)
+{
+	return stage.Sorted[(stage.Count - 1) / 2];
+}
+
+/// <summary>
+///  Returns the median absolute deviation from the median. The deviations of the sorted window increase from the
+///  median to both ends, so the median deviation is selected by merging both sides (single pass).
+/// </summary>
+/// <param name="stage">The filter stage</param>
+/// <param name="median">The median of the window</param>
+/// <returns>The median absolute deviation</returns>
+int16_t SensorFilter::getMad(const Stage& stage, int16_t median)
+{
+	int left = (stage.Count - 1) / 2;
+	int right = left + 1;
+	int deviation = 0;
+
+	for (int k = 0; k <= (stage.Count - 1) / 2; k++)
+	{
+		int lower = (left >= 0) ? median - stage.Sorted[left] : INT16_MAX;
+		int upper = (right < stage.Count) ? stage.Sorted[right] - median : INT16_MAX;
+
+		if (lower <= upper)
+		{
+			deviation = lower;
+			left--;
+		}
+		else
+		{
+			deviation = upper;
+			right++;
+		}
+	}
+
+	return (int16_t)deviation;
+}
+
+/// <summary>
+///  Filters a sample using a single stage.
+/// </summary>
+/// <param name="stage">The filter stage</param>
+/// <param name="value">The input sample</param>
+/// <returns>The stage output</returns>
+int SensorFilter::filter(Stage& stage, int value)
+{
+	value = (value < INT16_MIN) ? INT16_MIN : (value > INT16_MAX) ? INT16_MAX : value;
+
+	switch (stage.Kind)
+	{
+	case FILTER_MEDIAN:
+		insert(stage, (int16_t)value);
+		return getMedian(stage);
+
+	case FILTER_HAMPEL:
+	{
+		insert(stage, (int16_t)value);
+		int16_t median = getMedian(stage);
+		float limit = HAMPEL_THRESHOLD * MAD_SCALE * getMad(stage, median);
+		return (abs(value - median) > limit) ? median : value;
+	}
+
+	case FILTER_EXP:
+		if (stage.Count == 0)
+		{
+			stage.State = (int32_t)value << EXP_SHIFT;
+			stage.Count = 1;
+		}
+		else
+		{
+			// Round the step away from zero, so the average reaches a constant input.
+			int32_t difference = ((int32_t)value << EXP_SHIFT) - stage.State;
+			stage.State += (difference + ((difference > 0) ? stage.Size - 1 : 1 - stage.Size)) / stage.Size;
+		}
+
+		return (stage.State + (1 << (EXP_SHIFT - 1))) >> EXP_SHIFT;
+
+	case FILTER_AVG:
+		if (stage.Count < stage.Size)
+		{
+			stage.Count++;
+		}
+		else
+		{
+			stage.State -= stage.Values[stage.Next];
+		}
+
+		stage.State += value;
+		stage.Values[stage.Next] = (int16_t)value;
+		stage.Next = (stage.Next + 1 < stage.Size) ? stage.Next + 1 : 0;
+		return stage.State / stage.Count;
+	}
+
+	return value;
+}
@@ -0,0 +1,84 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="SensorFilter.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class implements a configurable filter chain for the raw sensor values. The chain is specified as a comma
+/// separated list of stages (e.g. "hampel:7,exp:10"), each stage is applied to the output of the previous stage:
+///
+///   median:n   sliding window median (n samples)
+///   hampel:n   Hampel outlier rejection, a sample deviating more than 3 scaled MADs from the window median
+///              is replaced by the median (n samples)
+///   exp:n      exponential moving average (weight 1/n)
+///   avg:n      moving average (n samples)
+///
+/// The window is limited to MAX_WINDOW samples, so the cost per sample is bounded: the sorted window of the median
+/// and Hampel stages is updated by a binary search and a shift of at most MAX_WINDOW values, the MAD is selected
+/// from the sorted window in a single pass. No memory is allocated while filtering.
+/// </summary>
+class SensorFilter
+{
+public:
+	static const uint8_t MAX_STAGES = 4;						// The maximum number of stages
+	static const uint8_t MAX_WINDOW = 15;						// The maximum window size (median, hampel, avg)
+	static const uint16_t MAX_FACTOR = 1000;					// The maximum factor (exp)
+	static const int MAX_CHAIN_LEN = 48;						// The maximum length of the chain specification
+	static const char* DEFAULT_CHAIN;							// The default chain (exp:10)
+	static const float HAMPEL_THRESHOLD;						// The Hampel threshold (scaled MADs)
+
+	enum Type : uint8_t
+	{
+		FILTER_MEDIAN,											// Sliding window median
+		FILTER_HAMPEL,											// Hampel outlier rejection
+		FILTER_EXP,												// Exponential moving average
+		FILTER_AVG												// Moving average
+	};
+
+private:
+	static const uint8_t EXP_SHIFT = 4;							// The fixed point shift of the exponential average
+
+	struct Stage
+	{
+		Type Kind;												// The stage type
+		uint16_t Size;											// The window size (samples) or factor (exp)
+		uint8_t Count;											// The number of samples in the window
+		uint8_t Next;											// The ring buffer position of the next sample
+		int16_t Values[MAX_WINDOW];								// The window samples (ring buffer)
+		int16_t Sorted[MAX_WINDOW];								// The window samples (sorted)
+		int32_t State;											// The running sum (avg) or fixed point average (exp)
+	};
+
+	Stage _stages[MAX_STAGES];									// The filter stages
+	uint8_t _count = 0;											// The number of stages
+	int _value = 0;												// The last filter output
+	String _chain;												// The chain specification
+
+	static bool parse(const char* chain, Stage* stages,			// Parses the chain specification
+		uint8_t& count);
+	static void insert(Stage& stage, int16_t value);			// Adds a sample to the sorted window
+	static int16_t getMedian(const Stage& stage);				// Returns the median of the window
+	static int16_t getMad(const Stage& stage, int16_t median);	// Returns the median absolute deviation
+	static int filter(Stage& stage, int value);					// Filters a sample using a single stage
+
+public:
+	SensorFilter();												// Default constructor (default chain)
+	SensorFilter(const char* chain);							// Constructor setting the chain
+
+	bool setChain(const String& chain);							// Sets the chain (false if invalid)
+	const String& getChain() const { return _chain; }			// Returns the chain specification
+	uint8_t getStages() const { return _count; }				// Returns the number of stages
+	int get() const { return _value; }							// Returns the last filter output
+
+	void reset();												// Clears the filter state
+	int add(int value);											// Filters a sample, returns the output
+
+	static bool isValid(const String& chain);					// Returns true if the chain is valid
+};
@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "Sensors.h"
 
 /// <summary>
@@ -14,22 +15,217 @@
 /// </summary>
 Sensors::Sensors()
 {
-	Log.trace("Sensors::Sensors()" CR);
+	LOG_TRACE("Sensors::Sensors()" CR);
 }
 
 /// <summary>
-///  Return a string serialization (JSON).
+///  Returns the current version (the global sequence of the reported sensor samples, see ChangeTracker).
 /// </summary>
-String Sensors::serialize()
+/// <returns>The version</returns>
+uint32_t Sensors::getVersion()
 {
-	Log.trace("Sensors::serialize()" CR);
-	String json;
+	return ChangeTracker::getSequence();
+}
 
-	_doc.clear();
-	_doc["TempSensors"] = serialized(this->TempSensors.serialize());
-	_doc["SoilSensors"] = serialized(this->SoilSensors.serialize());
+/// <summary>
+///  Returns true if any sensor has been reported after the specified version.
+/// </summary>
+/// <param name="since">The version seen by the consumer</param>
+/// <returns>True if changed</returns>
+bool Sensors::isChanged(uint32_t since)
+{
+	for (int i = 0; i < TempSensors::MAX_SENSORS; i++)
+	{
+		if (this->TempSensors.isChangedByIndex(i, since)) return true;
+	}
+
+	for (int i = 0; i < SoilSensors::MAX_SENSORS; i++)
+	{
+		if (this->SoilSensors.isChangedByIndex(i, since)) return true;
+	}
 
+	return false;
+}
+
+/// <summary>
+///  Return a string serialization (JSON) of the current values of all sensors (the array index is the sensor
+///  index). The metadata is not included (see serializeMeta).
+/// </summary>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+/// <returns>The JSON string</returns>
+String Sensors::serialize(const NameList& fields)
+{
+	LOG_TRACE("Sensors::serialize()" CR);
+	String json;
+
+	build(fields);
 	serializeJsonPretty(_doc, json);
 	return json;
+}
+
+/// <summary>
+///  Writes the current values of all sensors in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+void Sensors::serialize(WireFormat& writer, const NameList& fields)
+{
+	LOG_TRACE("Sensors::serialize()" CR);
 
+	build(fields);
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
 }
+
+/// <summary>
+///  Returns the sensor changes after the specified version (string serialization, JSON).
+///  Note that the compact format is used (the output is meant for polling consumers).
+/// </summary>
+/// <param name="since">The version seen by the consumer (0: all sensors)</param>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+/// <returns>The JSON string</returns>
+String Sensors::serialize(uint32_t since, const NameList& fields)
+{
+	LOG_TRACE("Sensors::serialize()" CR);
+	String json;
+
+	build(since, fields);
+	serializeJson(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the sensor changes after the specified version in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+/// <param name="since">The version seen by the consumer (0: all sensors)</param>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+void Sensors::serialize(WireFormat& writer, uint32_t since, const NameList& fields)
+{
+	LOG_TRACE("Sensors::serialize()" CR);
+
+	build(since, fields);
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Returns the metadata serialization (JSON). The metadata changes with the settings only.
+/// </summary>
+/// <returns>The JSON string</returns>
+String Sensors::serializeMeta()
+{
+	LOG_TRACE("Sensors::serializeMeta()" CR);
+	String json;
+
+	buildMeta();
+	serializeJson(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the metadata in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void Sensors::serializeMeta(WireFormat& writer)
+{
+	LOG_TRACE("Sensors::serializeMeta()" CR);
+
+	buildMeta();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the current values of all sensors (the array index is the sensor index).
+///  The metadata is not included (see buildMeta). Only the selected fields are added.
+/// </summary>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+void Sensors::build(const NameList& fields)
+{
+	_doc.clear();
+	_doc["Version"] = getVersion();
+	JsonArray temp = _doc.createNestedArray("TempSensors");
+
+	for (int i = 0; i < TempSensors::MAX_SENSORS; i++)
+	{
+		JsonObject obj = temp.createNestedObject();
+		if (fields.selects("Connected")) obj["Connected"] = this->TempSensors.isConnectedByIndex(i);
+		if (fields.selects("TempC"))     obj["TempC"]     = this->TempSensors.getTempCByIndex(i);
+		if (fields.selects("TempF"))     obj["TempF"]     = this->TempSensors.getTempFByIndex(i);
+	}
+
+	JsonArray soil = _doc.createNestedArray("SoilSensors");
+
+	for (int i = 0; i < SoilSensors::MAX_SENSORS; i++)
+	{
+		JsonObject obj = soil.createNestedObject();
+		if (fields.selects("Humidity")) obj["Humidity"] = this->SoilSensors.getHumidityByIndex(i);
+		if (fields.selects("Voltage"))  obj["Voltage"]  = this->SoilSensors.getVoltageByIndex(i);
+		if (fields.selects("Enabled"))  obj["Enabled"]  = this->SoilSensors.isEnabledByIndex(i);
+	}
+}
+
+/// <summary>
+///  Builds the document of the sensors reported after the specified version (report by exception,
+///  see ChangeTracker). The current version is included for the next request. Only the selected fields are
+///  added, the sensor index and version are always included.
+/// </summary>
+/// <param name="since">The version seen by the consumer (0: all sensors)</param>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+void Sensors::build(uint32_t since, const NameList& fields)
+{
+	_doc.clear();
+	_doc["Version"] = ChangeTracker::getSequence();
+	JsonArray temp = _doc.createNestedArray("TempSensors");
+
+	for (int i = 0; i < TempSensors::MAX_SENSORS; i++)
+	{
+		if (this->TempSensors.isChangedByIndex(i, since))
+		{
+			JsonObject obj = temp.createNestedObject();
+			obj["Index"]     = i;
+			obj["Version"]   = this->TempSensors.getVersionByIndex(i);
+			if (fields.selects("Connected")) obj["Connected"] = this->TempSensors.isConnectedByIndex(i);
+			if (fields.selects("TempC"))     obj["TempC"]     = this->TempSensors.getTempCByIndex(i);
+			if (fields.selects("TempF"))     obj["TempF"]     = this->TempSensors.getTempFByIndex(i);
+		}
+	}
+
+	JsonArray soil = _doc.createNestedArray("SoilSensors");
+
+	for (int i = 0; i < SoilSensors::MAX_SENSORS; i++)
+	{
+		if (this->SoilSensors.isChangedByIndex(i, since))
+		{
+			JsonObject obj = soil.createNestedObject();
+			obj["Index"]    = i;
+			obj["Version"]  = this->SoilSensors.getVersionByIndex(i);
+			if (fields.selects("Humidity")) obj["Humidity"] = this->SoilSensors.getHumidityByIndex(i);
+			if (fields.selects("Voltage"))  obj["Voltage"]  = this->SoilSensors.getVoltageByIndex(i);
+		}
+	}
+}
+
+/// <summary>
+///  Builds the document of the sensor metadata (names, addresses, and resolutions).
+/// </summary>
+void Sensors::buildMeta()
+{
+	_doc.clear();
+	JsonArray temp = _doc.createNestedArray("TempSensors");
+
+	for (int i = 0; i < TempSensors::MAX_SENSORS; i++)
+	{
+		JsonObject obj = temp.createNestedObject();
+		obj["Name"]       = this->TempSensors.getNameByIndex(i);
+		obj["Address"]    = this->TempSensors.getAddressByIndex(i);
+		obj["Resolution"] = this->TempSensors.getResolutionByIndex(i);
+	}
+
+	JsonArray soil = _doc.createNestedArray("SoilSensors");
+
+	for (int i = 0; i < SoilSensors::MAX_SENSORS; i++)
+	{
+		JsonObject obj = soil.createNestedObject();
+		obj["Name"] = this->SoilSensors.getNameByIndex(i);
+		obj["Pin"]  = this->SoilSensors.getPinByIndex(i);
+	}
+}
\ No newline at end of file
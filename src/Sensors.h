@@ -10,23 +10,44 @@
 
 #include "SoilSensors.h"
 #include "TempSensors.h"
+#include "WireFormat.h"
 
+/// <summary>
+/// This class holds all sensors. The sensor data (values) and the static metadata (names, addresses, and
+/// resolutions) are serialized separately, the metadata is requested once and cached by the consumers.
+/// </summary>
 class Sensors
 {
 private:
 	static const int CAPACITY = 			// The maximum size for the JSON document
 		2 * JSON_ARRAY_SIZE(6) +
-		JSON_OBJECT_SIZE(2) +
+		JSON_OBJECT_SIZE(3) +
 		6 * JSON_OBJECT_SIZE(4) +
-		JSON_OBJECT_SIZE(5) +
-		5 * JSON_OBJECT_SIZE(6) + 967;
+		6 * JSON_OBJECT_SIZE(5) + 504;
 StaticJsonDocument<CAPACITY> _doc;			// The static JSON document
 
+	void build(const NameList& fields);		// Builds the document of the current values
+	void build(uint32_t since,				// Builds the document of the changes after the version
+		const NameList& fields);
+	void buildMeta();						// Builds the document of the metadata
+
 public:
 	Sensors();								// Default constructor
 
 	class TempSensors TempSensors;			// Temperature sensors	
 	class SoilSensors SoilSensors;			// Soil moisture sensors
 
-	String serialize();						// Return a string serialization (JSON)
+	uint32_t getVersion();					// Returns the current version (sample sequence)
+	bool isChanged(uint32_t since);			// Returns true if a sensor changed after the version
+
+	String serialize(						// Return a string serialization (JSON)
+		const NameList& fields = NameList());
+	String serialize(uint32_t since,		// Return the changes after the version (JSON)
+		const NameList& fields = NameList());
+	void serialize(WireFormat& writer,		// Writes the current values (CBOR, MessagePack)
+		const NameList& fields = NameList());
+	void serialize(WireFormat& writer,		// Writes the changes after the version (CBOR, MessagePack)
+		uint32_t since, const NameList& fields = NameList());
+	String serializeMeta();					// Return the metadata serialization (JSON)
+	void serializeMeta(WireFormat& writer);	// Writes the metadata (CBOR, MessagePack)
 };
\ No newline at end of file
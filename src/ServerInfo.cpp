@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "ServerInfo.h"
 
 char* ServerInfo::HOSTNAME = "soilmonitor";		// The default hostname (mDNS)
@@ -23,7 +24,7 @@ ServerInfo::ServerInfo(WiFiClass wifi) :
 	ApAddress(wifi.softAPIP().toString()),
 	Url("http://" + String(HOSTNAME))
 {
-	Log.trace("ServerInfo::ServerInfo()" CR);
+	LOG_TRACE("ServerInfo::ServerInfo()" CR);
 }
 
 /// <summary>
@@ -32,17 +33,35 @@ ServerInfo::ServerInfo(WiFiClass wifi) :
 /// <returns>The JSON string</returns>
 String ServerInfo::serialize()
 {
-	Log.trace("ServerInfo::serialize()" CR);
+	LOG_TRACE("ServerInfo::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void ServerInfo::serialize(WireFormat& writer)
+{
+	LOG_TRACE("ServerInfo::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void ServerInfo::build()
+{
 	_doc.clear();
 	_doc["WiFiAddress"] = WiFiAddress;
 	_doc["ApAddress"]   = ApAddress;
 	_doc["Name"]        = Name;
 	_doc["Port"]        = Port;
 	_doc["Url"]         = Url;
-
-	serializeJsonPretty(_doc, json);
-
-	return json;
 }
@@ -11,6 +11,7 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <WiFi.h>
+#include "WireFormat.h"
 
 /// <summary>
 /// This class holds the actual HTTP server settings data.
@@ -21,6 +22,7 @@ private:
 	static const int CAPACITY = 			// The maximum size for the JSON document
 		JSON_OBJECT_SIZE(5) + 141;
 	StaticJsonDocument<CAPACITY> _doc;		// The static JSON document
+	void build();							// Builds the document
 
 public:
 	static char* HOSTNAME;					// The default hostname (mDNS)
@@ -35,4 +37,5 @@ public:
 	String Url;								// The web server URL (mDNS)
 
 	String serialize();						// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);		// Writes a binary serialization (CBOR, MessagePack)
 };
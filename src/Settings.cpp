@@ -10,7 +10,8 @@
 #include <FSImpl.h>
 #include <FS.h>
 #include <SPIFFS.h>
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "HeapMonitor.h"
 #include "Settings.h"
 
 char* Settings::SETTINGS_FILE = "/settings.json";
@@ -21,9 +22,10 @@ char* Settings::SETTINGS_FILE = "/settings.json";
 /// <param name="sensors">Pointer to sensors</param>
 Settings::Settings(Sensors* sensors) :
 	SoilSettings(&sensors->SoilSensors),
-	TempSettings(&sensors->TempSensors)
+	TempSettings(&sensors->TempSensors),
+	FastBoot(false)
 {
-	Log.trace("Settings::Settings()" CR);
+	LOG_TRACE("Settings::Settings()" CR);
 }
 
 /// <summary>
@@ -31,12 +33,13 @@ Settings::Settings(Sensors* sensors) :
 /// </summary>
 void Settings::init(SystemInfo& info)
 {
-	Log.trace("Settings::init()" CR);
+	LOG_TRACE("Settings::init()" CR);
+	HeapScope scope(HeapMonitor::SUBSYSTEM_SETTINGS);
 	File file = SPIFFS.open(SETTINGS_FILE, FILE_READ);
 
 	if (!file)
 	{
-		Log.error("Failed to open settings" CR);
+		LOG_ERROR("Failed to open settings" CR);
 		return;
 	}
 
@@ -45,7 +48,7 @@ void Settings::init(SystemInfo& info)
 
 	if (!deserialize(json))
 	{
-		Log.error("Failed to deserialize settings" CR);
+		LOG_ERROR("Failed to deserialize settings" CR);
 	}
 
 	// Update default AP SSID with unique chip ID (MAC address).
@@ -68,12 +71,13 @@ void Settings::init(SystemInfo& info)
 /// </summary>
 void Settings::save()
 {
-	Log.trace("Settings::save()" CR);
+	LOG_TRACE("Settings::save()" CR);
+	HeapScope scope(HeapMonitor::SUBSYSTEM_SETTINGS);
 	File file = SPIFFS.open(SETTINGS_FILE, FILE_WRITE);
 
 	if (!file)
 	{
-		Log.error("Failed to open settings" CR);
+		LOG_ERROR("Failed to open settings" CR);
 		return;
 	}
 
@@ -83,12 +87,12 @@ void Settings::save()
 	{
 		if (file.print(json) != json.length())
 		{
-			Log.error("Failed to write settings" CR);
+			LOG_ERROR("Failed to write settings" CR);
 		}
 	}
 	else
 	{
-		Log.error("Failed to serialize settings" CR);
+		LOG_ERROR("Failed to serialize settings" CR);
 	}
 
 	file.close();
@@ -101,7 +105,8 @@ void Settings::save()
 /// <returns>True if successful</returns>
 bool Settings::deserialize(String json)
 {
-	Log.trace("Settings::deserialize()" CR);
+	LOG_TRACE("Settings::deserialize()" CR);
+	HeapScope scope(HeapMonitor::SUBSYSTEM_SETTINGS);
 
 	if (json.length() > 0)
 	{
@@ -109,7 +114,7 @@ bool Settings::deserialize(String json)
 
 		if (err)
 		{
-			Log.error("Settings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
+			LOG_ERROR("Settings::deserialize() Deserialize JSON failed with code %s" CR, err.c_str());
 			return false;
 		}
 
@@ -129,6 +134,14 @@ bool Settings::deserialize(String json)
 		serializeJson(_doc["Cmd"], cmd);
 		CmdSettings.deserialize(cmd);
 
+		String mqtt;
+		serializeJson(_doc["Mqtt"], mqtt);
+		MqttSettings.deserialize(mqtt);
+
+		String influx;
+		serializeJson(_doc["Influx"], influx);
+		InfluxSettings.deserialize(influx);
+
 		String temp;
 		serializeJson(_doc["Temp"], temp);
 		TempSettings.deserialize(temp);
@@ -137,10 +150,12 @@ bool Settings::deserialize(String json)
 		serializeJson(_doc["Soil"], soil);
 		SoilSettings.deserialize(soil);
 
+		FastBoot = _doc["FastBoot"] | false;
+
 		return true;
 	}
 
-	Log.warning("Settings::deserialize() Invalid JSON string" CR);
+	LOG_WARNING("Settings::deserialize() Invalid JSON string" CR);
 	return false;
 }
 
@@ -150,7 +165,8 @@ bool Settings::deserialize(String json)
 /// <returns>The JSON string</returns>
 String Settings::serialize()
 {
-	Log.trace("Settings::serialize()" CR);
+	LOG_TRACE("Settings::serialize()" CR);
+	HeapScope scope(HeapMonitor::SUBSYSTEM_SETTINGS);
 	String json;
 
 	_doc.clear();
@@ -158,22 +174,58 @@ String Settings::serialize()
 	_doc["STA"]  = serialized(StaSettings.serialize());
 	_doc["Log"]  = serialized(LogSettings.serialize());
 	_doc["Cmd"]  = serialized(CmdSettings.serialize());
+	_doc["Mqtt"] = serialized(MqttSettings.serialize());
+	_doc["Influx"] = serialized(InfluxSettings.serialize());
 	_doc["Temp"] = serialized(TempSettings.serialize());
 	_doc["Soil"] = serialized(SoilSettings.serialize());
+	_doc["FastBoot"] = FastBoot;
 
 	serializeJsonPretty(_doc, json);
 	return json;
 }
 
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+///  The settings are written one after the other, so only one settings document is built at a time.
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void Settings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("Settings::serialize()" CR);
+	HeapScope scope(HeapMonitor::SUBSYSTEM_SETTINGS);
+
+	writer.writeMap(9);
+	writer.writeString("AP");
+	ApSettings.serialize(writer);
+	writer.writeString("STA");
+	StaSettings.serialize(writer);
+	writer.writeString("Log");
+	LogSettings.serialize(writer);
+	writer.writeString("Cmd");
+	CmdSettings.serialize(writer);
+	writer.writeString("Mqtt");
+	MqttSettings.serialize(writer);
+	writer.writeString("Influx");
+	InfluxSettings.serialize(writer);
+	writer.writeString("Temp");
+	TempSettings.serialize(writer);
+	writer.writeString("Soil");
+	SoilSettings.serialize(writer);
+	writer.writeString("FastBoot");
+	writer.writeBool(FastBoot);
+}
+
 /// <summary>
 ///  Resets all field to their default values.
 /// </summary>
 void Settings::reset()
 {
-	Log.trace("Settings::reset()" CR);
+	LOG_TRACE("Settings::reset()" CR);
 
 	ApSettings.reset();
 	StaSettings.reset();
 	LogSettings.reset();
 	CmdSettings.reset();
+	MqttSettings.reset();
+	InfluxSettings.reset();
 }
\ No newline at end of file
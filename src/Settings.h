@@ -16,9 +16,12 @@
 #include "StaSettings.h"
 #include "LogSettings.h"
 #include "CmdSettings.h"
+#include "MqttSettings.h"
+#include "InfluxSettings.h"
 #include "SoilSettings.h"
 #include "TempSettings.h"
 #include "Sensors.h"
+#include "WireFormat.h"
 
 /// <summary>
 /// This class holds the all settings data.
@@ -34,9 +37,14 @@ private:
 	6 * JSON_OBJECT_SIZE(1) +
 	2 * JSON_OBJECT_SIZE(2) +
 	6 * JSON_OBJECT_SIZE(4) +
-	2 * JSON_OBJECT_SIZE(5) +
-	2 * JSON_OBJECT_SIZE(8) +
-		JSON_OBJECT_SIZE(9) + 1395;
+		JSON_OBJECT_SIZE(5) +
+	3 * JSON_OBJECT_SIZE(8) +
+		JSON_OBJECT_SIZE(9) +
+		JSON_OBJECT_SIZE(1) +
+	6 * JSON_OBJECT_SIZE(1) + 1495 + 6 * 56 +	// Soil filter chains
+	7 * JSON_OBJECT_SIZE(5) + 7 * 54 +			// Sampling and reporting (deadband)
+		JSON_OBJECT_SIZE(9) + 320 +				// MQTT
+		JSON_OBJECT_SIZE(7) + 384;				// InfluxDB
 	StaticJsonDocument<CAPACITY> _doc;			// The static JSON document
 
 public:
@@ -46,11 +54,15 @@ public:
 	class StaSettings StaSettings;				// The WiFi station connection settings
 	class LogSettings LogSettings;				// The Log settings
 	class CmdSettings CmdSettings;				// The Commander settings
+	class MqttSettings MqttSettings;			// The MQTT publisher settings
+	class InfluxSettings InfluxSettings;		// The InfluxDB uploader settings
 	class TempSettings TempSettings;			// The SoilMonitor temperature sensor settings
 	class SoilSettings SoilSettings;			// The SoilMonitor moisture sensor settings
+	bool FastBoot;								// Fast boot mode (no delays, sensors first)
 
 	bool deserialize(String json);				// Read a JSON string and updates the fields.
 	String serialize();							// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);			// Writes a binary serialization (CBOR, MessagePack)
 	void save();								// Save the settings to storage
 	void init(SystemInfo& info);				// Initializes the settings from storage
 	void reset();								// Resets all settings
@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "SoilSensors.h"
 
 /// <summary>
@@ -21,12 +22,28 @@ unsigned short SoilSensors::PINS[MAX_SENSORS] = {
 	ADC1_CH5
 };
 
+/// <summary>
+/// The default sampling change threshold (mV, about 1% humidity).
+/// </summary>
+const float SoilSensors::THRESHOLD = 20.0;
+
+/// <summary>
+/// The default reporting deadband (mV, about 0.5% humidity).
+/// </summary>
+const float SoilSensors::DEADBAND = 10.0;
+
 /// <summary>
 ///  Default constructor.
 /// </summary>
 SoilSensors::SoilSensors()
 {
-	Log.trace("SoilSensors::SoilSensors()" CR);
+	LOG_TRACE("SoilSensors::SoilSensors()" CR);
+
+	for (int i = 0; i < MAX_SENSORS; i++)
+	{
+		_schedulers[i].setThreshold(THRESHOLD);
+		_changes.setDeadband(i, DEADBAND);
+	}
 }
 
 /// <summary>
@@ -38,7 +55,7 @@ SoilSensors::SoilSensors()
 /// <param name="enabled">The enabled flag</param>
 void SoilSensors::setDataByIndex(unsigned short index, String name, float wet, float dry, bool enabled)
 {
-	Log.trace("SoilSensors::setDataByIndex()" CR);
+	LOG_TRACE("SoilSensors::setDataByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -49,7 +66,7 @@ void SoilSensors::setDataByIndex(unsigned short index, String name, float wet, f
 	}
 	else
 	{
-		Log.error("SoilSensors::setDataByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::setDataByIndex() Soil Sensor not found" CR);
 	}
 }
 
@@ -60,7 +77,7 @@ void SoilSensors::setDataByIndex(unsigned short index, String name, float wet, f
 /// <returns>The analog input pin</returns>
 unsigned short SoilSensors::getPinByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::getPinByIndex()" CR);
+	LOG_TRACE("SoilSensors::getPinByIndex()" CR);
 	return _sensors[index].getPin();
 }
 
@@ -72,7 +89,7 @@ unsigned short SoilSensors::getPinByIndex(unsigned short index)
 /// <returns>The sensor name</returns>
 String SoilSensors::getNameByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::getNameByIndex()" CR);
+	LOG_TRACE("SoilSensors::getNameByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -80,7 +97,7 @@ String SoilSensors::getNameByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("SoilSensors::getNameByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::getNameByIndex() Soil Sensor not found" CR);
 	}
 
 	return String();
@@ -93,7 +110,7 @@ String SoilSensors::getNameByIndex(unsigned short index)
 /// <param name="name">The sensor name</param>
 void SoilSensors::setNameByIndex(unsigned short index, String name)
 {
-	Log.trace("SoilSensors::setNameByIndex()" CR);
+	LOG_TRACE("SoilSensors::setNameByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -101,7 +118,7 @@ void SoilSensors::setNameByIndex(unsigned short index, String name)
 	}
 	else
 	{
-		Log.error("SoilSensors::setNameByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::setNameByIndex() Soil Sensor not found" CR);
 	}
 }
 
@@ -112,7 +129,7 @@ void SoilSensors::setNameByIndex(unsigned short index, String name)
 /// <param name="enabled">The enabled flag</param>
 void SoilSensors::enableByIndex(unsigned short index, bool enabled)
 {
-	Log.trace("SoilSensors::enableByIndex()" CR);
+	LOG_TRACE("SoilSensors::enableByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -120,7 +137,7 @@ void SoilSensors::enableByIndex(unsigned short index, bool enabled)
 	}
 	else
 	{
-		Log.error("SoilSensors::enableByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::enableByIndex() Soil Sensor not found" CR);
 	}
 }
 
@@ -131,7 +148,7 @@ void SoilSensors::enableByIndex(unsigned short index, bool enabled)
 /// <returns>The wet calibration value</returns>
 float SoilSensors::getWetValueByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::getWetValueByIndex()" CR);
+	LOG_TRACE("SoilSensors::getWetValueByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -139,7 +156,7 @@ float SoilSensors::getWetValueByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("SoilSensors::getWetValueByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::getWetValueByIndex() Soil Sensor not found" CR);
 	}
 
 	return 0.0;
@@ -152,7 +169,7 @@ float SoilSensors::getWetValueByIndex(unsigned short index)
 /// <returns>The dry calibration value</returns>
 float SoilSensors::getDryValueByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::getDryValueByIndex()" CR);
+	LOG_TRACE("SoilSensors::getDryValueByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -160,12 +177,261 @@ float SoilSensors::getDryValueByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("SoilSensors::getDryValueByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::getDryValueByIndex() Soil Sensor not found" CR);
+	}
+
+	return 0.0;
+}
+
+/// <summary>
+///  Returns the filter chain of the specified sensor (see SensorFilter).
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <returns>The filter chain</returns>
+String SoilSensors::getFilterByIndex(unsigned short index)
+{
+	LOG_TRACE("SoilSensors::getFilterByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _sensors[index].getFilter();
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::getFilterByIndex() Soil Sensor not found" CR);
+	}
+
+	return String();
+}
+
+/// <summary>
+///  Sets the filter chain of the specified sensor (see SensorFilter).
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <param name="chain">The filter chain (e.g. "hampel:7,exp:10")</param>
+/// <returns>True if successful (an invalid chain is ignored)</returns>
+bool SoilSensors::setFilterByIndex(unsigned short index, String chain)
+{
+	LOG_TRACE("SoilSensors::setFilterByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		if (_sensors[index].getFilter() == chain)
+		{
+			return true;
+		}
+
+		if (_sensors[index].setFilter(chain))
+		{
+			return true;
+		}
+
+		LOG_WARNING("SoilSensors::setFilterByIndex() Invalid filter chain" CR);
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::setFilterByIndex() Soil Sensor not found" CR);
+	}
+
+	return false;
+}
+
+/// <summary>
+///  Returns the minimum sampling interval (sec) of the specified sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <returns>The minimum interval</returns>
+uint16_t SoilSensors::getMinIntervalByIndex(unsigned short index)
+{
+	LOG_TRACE("SoilSensors::getMinIntervalByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _schedulers[index].getMinInterval();
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::getMinIntervalByIndex() Soil Sensor not found" CR);
+	}
+
+	return 0;
+}
+
+/// <summary>
+///  Returns the maximum sampling interval (sec) of the specified sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <returns>The maximum interval</returns>
+uint16_t SoilSensors::getMaxIntervalByIndex(unsigned short index)
+{
+	LOG_TRACE("SoilSensors::getMaxIntervalByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _schedulers[index].getMaxInterval();
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::getMaxIntervalByIndex() Soil Sensor not found" CR);
+	}
+
+	return 0;
+}
+
+/// <summary>
+///  Returns the sampling change threshold (mV) of the specified sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <returns>The change threshold</returns>
+float SoilSensors::getThresholdByIndex(unsigned short index)
+{
+	LOG_TRACE("SoilSensors::getThresholdByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _schedulers[index].getThreshold();
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::getThresholdByIndex() Soil Sensor not found" CR);
 	}
 
 	return 0.0;
 }
 
+/// <summary>
+///  Sets the adaptive sampling of the specified sensor (see SampleScheduler).
+///  The intervals are limited to 1..3600 sec, the schedule is restarted if the intervals change.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <param name="min">The minimum interval (sec)</param>
+/// <param name="max">The maximum interval (sec)</param>
+/// <param name="threshold">The change threshold of the raw value median (mV)</param>
+void SoilSensors::setSamplingByIndex(unsigned short index, uint16_t min, uint16_t max, float threshold)
+{
+	LOG_TRACE("SoilSensors::setSamplingByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		if ((_schedulers[index].getMinInterval() != min) || (_schedulers[index].getMaxInterval() != max))
+		{
+			_schedulers[index].setIntervals(min, max);
+		}
+
+		_schedulers[index].setThreshold(threshold);
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::setSamplingByIndex() Soil Sensor not found" CR);
+	}
+}
+
+/// <summary>
+///  Returns the reporting deadband (mV) of the specified sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <returns>The deadband</returns>
+float SoilSensors::getDeadbandByIndex(unsigned short index)
+{
+	LOG_TRACE("SoilSensors::getDeadbandByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _changes.getDeadband(index);
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::getDeadbandByIndex() Soil Sensor not found" CR);
+	}
+
+	return 0.0;
+}
+
+/// <summary>
+///  Returns the maximum silence interval (sec) of the specified sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <returns>The maximum silence interval</returns>
+uint16_t SoilSensors::getMaxSilenceByIndex(unsigned short index)
+{
+	LOG_TRACE("SoilSensors::getMaxSilenceByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _changes.getMaxSilence(index);
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::getMaxSilenceByIndex() Soil Sensor not found" CR);
+	}
+
+	return 0;
+}
+
+/// <summary>
+///  Sets the report by exception parameters of the specified sensor (see ChangeTracker).
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <param name="deadband">The deadband of the filtered value (mV)</param>
+/// <param name="maxSilence">The maximum silence interval (sec, 0: no heartbeat)</param>
+void SoilSensors::setReportingByIndex(unsigned short index, float deadband, uint16_t maxSilence)
+{
+	LOG_TRACE("SoilSensors::setReportingByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		_changes.setDeadband(index, deadband);
+		_changes.setMaxSilence(index, maxSilence);
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::setReportingByIndex() Soil Sensor not found" CR);
+	}
+}
+
+/// <summary>
+///  Returns the reported version of the specified sensor (0: not reported).
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <returns>The version</returns>
+uint32_t SoilSensors::getVersionByIndex(unsigned short index)
+{
+	LOG_TRACE("SoilSensors::getVersionByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _changes.getVersion(index);
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::getVersionByIndex() Soil Sensor not found" CR);
+	}
+
+	return 0;
+}
+
+/// <summary>
+///  Returns true if the specified sensor has been reported after the version.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <param name="since">The version seen by the consumer</param>
+/// <returns>True if changed</returns>
+bool SoilSensors::isChangedByIndex(unsigned short index, uint32_t since)
+{
+	LOG_TRACE("SoilSensors::isChangedByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _changes.isChanged(index, since);
+	}
+	else
+	{
+		LOG_ERROR("SoilSensors::isChangedByIndex() Soil Sensor not found" CR);
+	}
+
+	return false;
+}
+
 /// <summary>
 ///  Returns true if the specified sensor is enabled.
 /// </summary>
@@ -173,7 +439,7 @@ float SoilSensors::getDryValueByIndex(unsigned short index)
 /// <returns>The enabled flag</returns>
 bool SoilSensors::isEnabledByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::isEnabledByIndex()" CR);
+	LOG_TRACE("SoilSensors::isEnabledByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -181,7 +447,7 @@ bool SoilSensors::isEnabledByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("SoilSensors::isEnabledByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::isEnabledByIndex() Soil Sensor not found" CR);
 	}
 
 	return false;
@@ -194,7 +460,7 @@ bool SoilSensors::isEnabledByIndex(unsigned short index)
 /// <returns>The input value</returns>
 int SoilSensors::getValueByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::getValueByIndex()" CR);
+	LOG_TRACE("SoilSensors::getValueByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -202,7 +468,7 @@ int SoilSensors::getValueByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("oilSensors::getValueByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("oilSensors::getValueByIndex() Soil Sensor not found" CR);
 	}
 
 	return 0;
@@ -215,7 +481,7 @@ int SoilSensors::getValueByIndex(unsigned short index)
 /// <returns>The analog input value</returns>
 float SoilSensors::getVoltageByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::getVoltageByIndex()" CR);
+	LOG_TRACE("SoilSensors::getVoltageByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -223,7 +489,7 @@ float SoilSensors::getVoltageByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("SoilSensors::getVoltageByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::getVoltageByIndex() Soil Sensor not found" CR);
 	}
 
 	return 0.0;
@@ -236,7 +502,7 @@ float SoilSensors::getVoltageByIndex(unsigned short index)
 /// <returns>The humidity in percent</returns>
 int SoilSensors::getHumidityByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::getHumidityByIndex()" CR);
+	LOG_TRACE("SoilSensors::getHumidityByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -244,7 +510,7 @@ int SoilSensors::getHumidityByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("SoilSensors::getHumidityByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::getHumidityByIndex() Soil Sensor not found" CR);
 	}
 
 	return 0;
@@ -255,24 +521,46 @@ int SoilSensors::getHumidityByIndex(unsigned short index)
 /// </summary>
 void SoilSensors::begin()
 {
-	Log.trace("SoilSensors::begin()" CR);
+	LOG_TRACE("SoilSensors::begin()" CR);
 
 	for (int i = 0; i < MAX_SENSORS; i++)
 	{
 		_sensors[i].begin();
+		_schedulers[i].reset();
 	}
+
+	_changes.reset();
 }
 
 /// <summary>
-///  Updates all soil moisture sensors.
+///  Updates the soil moisture sensors which are due (adaptive sampling, see SampleScheduler).
+///  The schedule is driven by the change of the median of the last three raw values (mV), since the filter
+///  is defined in samples and responds slower at longer intervals, and a single spike of the raw value would
+///  reset the interval. The minimum interval is kept until the filtered value has settled (within the threshold
+///  of the raw value median). Note that all sensors are updated
+///  if requested (e.g. while the raw inputs are captured). The changes of the enabled sensors are
+///  reported by exception (see ChangeTracker), the heartbeat is checked on every update.
 /// </summary>
-void SoilSensors::update()
+/// <param name="all">Update all sensors (ignore the schedule)</param>
+void SoilSensors::update(bool all)
 {
-	Log.verbose("SoilSensors::update()" CR);
+	LOG_VERBOSE("SoilSensors::update()" CR);
+	uint32_t now = millis();
 
 	for (int i = 0; i < MAX_SENSORS; i++)
 	{
-		_sensors[i].update();
+		if (all || _schedulers[i].isDue(now))
+		{
+			_sensors[i].update();
+			float median = _sensors[i].getMedian();
+			float filtered = _sensors[i].getVoltage() * 1000.0;
+			_schedulers[i].sample(now, median, fabsf(filtered - median) < _schedulers[i].getThreshold());
+		}
+
+		if (_enabled[i])
+		{
+			_changes.update(i, _sensors[i].getVoltage() * 1000.0, now);
+		}
 	}
 }
 
@@ -283,9 +571,33 @@ void SoilSensors::update()
 /// <returns>The JSON string</returns>
 String SoilSensors::serializeByIndex(unsigned short index)
 {
-	Log.trace("SoilSensors::serializeByIndex()" CR);
+	LOG_TRACE("SoilSensors::serializeByIndex()" CR);
 	String json;
 
+	buildByIndex(index);
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes a single soil sensor in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void SoilSensors::serializeByIndex(unsigned short index, WireFormat& writer)
+{
+	LOG_TRACE("SoilSensors::serializeByIndex()" CR);
+
+	buildByIndex(index);
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of a single soil sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+void SoilSensors::buildByIndex(unsigned short index)
+{
 	_doc.clear();
 
 	if (index < MAX_SENSORS)
@@ -297,33 +609,89 @@ String SoilSensors::serializeByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("SoilSensors::serializeByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSensors::serializeByIndex() Soil Sensor not found" CR);
 	}
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
 
 /// <summary>
 ///  Serialize the SoilSensors instance to a JSON string.
 /// </summary>
+/// <param name="fields">The selected fields (empty: all fields)</param>
 /// <returns>The JSON string</returns>
-String SoilSensors::serialize()
+String SoilSensors::serialize(const NameList& fields)
 {
-	Log.trace("SoilSensors::serialize()" CR);
+	LOG_TRACE("SoilSensors::serialize()" CR);
 	String json;
-	
+
+	build(fields);
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes all sensors in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+void SoilSensors::serialize(WireFormat& writer, const NameList& fields)
+{
+	LOG_TRACE("SoilSensors::serialize()" CR);
+
+	build(fields);
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Writes the metrics of the soil sensors (humidity and voltage of the enabled sensors, enabled flag of all
+///  sensors). The sensor index is used as label, the names are available in /meta.
+/// </summary>
+/// <param name="writer">The metrics writer (e.g. HTTP response)</param>
+void SoilSensors::writeMetrics(MetricsWriter& writer)
+{
+	LOG_TRACE("SoilSensors::writeMetrics()" CR);
+	char index[4];
+
+	writer.writeFamily("soilmonitor_soil_enabled", "gauge", "Soil sensor enabled (1) or disabled (0).");
+
+	for (unsigned short i = 0; i < MAX_SENSORS; i++)
+	{
+		snprintf(index, sizeof(index), "%u", i);
+		writer.writeInt("soilmonitor_soil_enabled", isEnabledByIndex(i) ? 1 : 0, "sensor", index);
+	}
+
+	writer.writeFamily("soilmonitor_soil_humidity_percent", "gauge", "Soil moisture.");
+
+	for (unsigned short i = 0; i < MAX_SENSORS; i++)
+	{
+		if (!isEnabledByIndex(i)) continue;
+		snprintf(index, sizeof(index), "%u", i);
+		writer.writeInt("soilmonitor_soil_humidity_percent", getHumidityByIndex(i), "sensor", index);
+	}
+
+	writer.writeFamily("soilmonitor_soil_voltage_volts", "gauge", "Soil sensor voltage.");
+
+	for (unsigned short i = 0; i < MAX_SENSORS; i++)
+	{
+		if (!isEnabledByIndex(i)) continue;
+		snprintf(index, sizeof(index), "%u", i);
+		writer.writeFloat("soilmonitor_soil_voltage_volts", getVoltageByIndex(i), "sensor", index);
+	}
+}
+
+/// <summary>
+///  Builds the document of all sensors (the array index is the sensor index), only the selected fields are added.
+/// </summary>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+void SoilSensors::build(const NameList& fields)
+{
 	_doc.clear();
 
 	for (int i = 0; i < MAX_SENSORS; i++)
 	{
 		JsonObject obj = _doc.createNestedObject();
-		obj["Name"]     = getNameByIndex(i);
-		obj["Humidity"] = getHumidityByIndex(i);
-		obj["Voltage"]  = getVoltageByIndex(i);
-		obj["Enabled"]  = isEnabledByIndex(i);
+		if (fields.selects("Name"))     obj["Name"]     = getNameByIndex(i);
+		if (fields.selects("Humidity")) obj["Humidity"] = getHumidityByIndex(i);
+		if (fields.selects("Voltage"))  obj["Voltage"]  = getVoltageByIndex(i);
+		if (fields.selects("Enabled"))  obj["Enabled"]  = isEnabledByIndex(i);
 	}
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
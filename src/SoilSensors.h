@@ -11,6 +11,11 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include "MoistureSensor.h"
+#include "SampleScheduler.h"
+#include "ChangeTracker.h"
+#include "WireFormat.h"
+#include "NameList.h"
+#include "MetricsWriter.h"
 
 /// <summary>
 /// This class implements a list of soil moisture sensors.
@@ -20,6 +25,8 @@ class SoilSensors
 public:
 	static const unsigned short MAX_SENSORS = 6;					// Number of soil moisture sensors
 	static unsigned short PINS[MAX_SENSORS];						// Analog input pins (ADC1)
+	static const float THRESHOLD;									// The default sampling change threshold (mV)
+	static const float DEADBAND;									// The default reporting deadband (mV)
 
 private:
 	static const int CAPACITY =										// The maximum size for the JSON document
@@ -27,6 +34,9 @@ private:
 	6 * JSON_OBJECT_SIZE(4) + 378;
 	StaticJsonDocument<CAPACITY> _doc;								// The static JSON document
 
+	void build(const NameList& fields);								// Builds the document of all sensors
+	void buildByIndex(unsigned short index);						// Builds the document of a single sensor
+
 	static const unsigned short ADC1_CH0 = A0;						// GPIO36 ESP32 pin 14
 	static const unsigned short ADC1_CH3 = A3;						// GPIO39 ESP32 pin 13
 	static const unsigned short ADC1_CH6 = A6;						// GPIO34 ESP32 pin 12
@@ -52,6 +62,9 @@ private:
 		MoistureSensor(SoilSensors::PINS[5], "Sensor 6") 			// Instance of moisture sensor 6
 	};
 
+	SampleScheduler _schedulers[MAX_SENSORS];						// The adaptive sampling schedules
+	ChangeTracker _changes;											// The reported changes (report by exception)
+
 public:
 	SoilSensors();													// Default constructor
 
@@ -63,14 +76,31 @@ public:
 	void enableByIndex(unsigned short index, bool enabled = true);	// Sets the enabled flag
 	float getWetValueByIndex(unsigned short index);					// Returns the wet sensor value
 	float getDryValueByIndex(unsigned short index);					// Returns the dry sensor value
+	String getFilterByIndex(unsigned short index);					// Returns the filter chain of a sensor
+	bool setFilterByIndex(unsigned short index, String chain);		// Sets the filter chain of a sensor
+	uint16_t getMinIntervalByIndex(unsigned short index);			// Returns the minimum sampling interval (sec)
+	uint16_t getMaxIntervalByIndex(unsigned short index);			// Returns the maximum sampling interval (sec)
+	float getThresholdByIndex(unsigned short index);				// Returns the sampling change threshold (mV)
+	void setSamplingByIndex(unsigned short index,					// Sets the sampling intervals (sec) and
+		uint16_t min, uint16_t max, float threshold);				// the change threshold (mV)
+	float getDeadbandByIndex(unsigned short index);					// Returns the reporting deadband (mV)
+	uint16_t getMaxSilenceByIndex(unsigned short index);			// Returns the maximum silence interval (sec)
+	void setReportingByIndex(unsigned short index,					// Sets the reporting deadband (mV) and
+		float deadband, uint16_t maxSilence);						// the maximum silence interval (sec)
+	uint32_t getVersionByIndex(unsigned short index);				// Returns the reported version of a sensor
+	bool isChangedByIndex(unsigned short index, uint32_t since);	// Returns true if reported after the version
 	bool isEnabledByIndex(unsigned short index);					// Returns the enabled flag
 	int getValueByIndex(unsigned short index);						// Returns the raw sensor value (mV)
 	float getVoltageByIndex(unsigned short index);					// Returns the sensor voltage (V)
 	int getHumidityByIndex(unsigned short index);					// Returns the humidity sensor value (%)
 
 	void begin();													// Initializes all sensors
-	void update();													// Updates all sensors
+	void update(bool all = false);									// Updates the due (or all) sensors
 
 	String serializeByIndex(unsigned short index);					// Return a string serialization (JSON)
-	String serialize();												// Return a string serialization (JSON)
+	String serialize(const NameList& fields = NameList());			// Return a string serialization (JSON)
+	void serializeByIndex(unsigned short index, WireFormat& writer);	// Writes a sensor (CBOR, MessagePack)
+	void serialize(WireFormat& writer,								// Writes all sensors (CBOR, MessagePack)
+		const NameList& fields = NameList());
+	void writeMetrics(MetricsWriter& writer);						// Writes the sensor metrics (Prometheus)
 };
\ No newline at end of file
@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "SoilSettings.h"
 
 /// <summary>
@@ -16,7 +17,7 @@
 SoilSettings::SoilSettings(SoilSensors* sensors) :
 	_sensors(sensors)
 {
-	Log.trace("SoilSettings::SoilSettings()" CR);
+	LOG_TRACE("SoilSettings::SoilSettings()" CR);
 
 	for (unsigned short i = 0; i < MAX_SENSORS; i++)
 	{
@@ -25,6 +26,12 @@ SoilSettings::SoilSettings(SoilSensors* sensors) :
 		WetValues[i] = _sensors->getWetValueByIndex(i);
 		DryValues[i] = _sensors->getDryValueByIndex(i);
 		Enabled[i] = _sensors->isEnabledByIndex(i);
+		Filters[i] = _sensors->getFilterByIndex(i);
+		MinIntervals[i] = _sensors->getMinIntervalByIndex(i);
+		MaxIntervals[i] = _sensors->getMaxIntervalByIndex(i);
+		Thresholds[i] = _sensors->getThresholdByIndex(i);
+		Deadbands[i] = _sensors->getDeadbandByIndex(i);
+		MaxSilences[i] = _sensors->getMaxSilenceByIndex(i);
 	}
 }
 
@@ -36,7 +43,7 @@ SoilSettings::SoilSettings(SoilSensors* sensors) :
 /// <returns>True if successful</returns>
 bool SoilSettings::deserializeByIndex(unsigned short index, String json)
 {
-	Log.trace("SoilSettings::deserializeByIndex()" CR);
+	LOG_TRACE("SoilSettings::deserializeByIndex()" CR);
 
 	if (json.length() > 0)
 	{
@@ -46,7 +53,7 @@ bool SoilSettings::deserializeByIndex(unsigned short index, String json)
 
 			if (err)
 			{
-				Log.error("SoilSettings::deserializeByIndex() Deserialize JSON failed with code %s", err.c_str());
+				LOG_ERROR("SoilSettings::deserializeByIndex() Deserialize JSON failed with code %s", err.c_str());
 				return false;
 			}
 
@@ -54,18 +61,35 @@ bool SoilSettings::deserializeByIndex(unsigned short index, String json)
 			WetValues[index] = _doc["Wet"]     | WetValues[index];
 			DryValues[index] = _doc["Dry"]     | DryValues[index];
 			Enabled[index]   = _doc["Enabled"] | Enabled[index];
+			Filters[index]   = _doc["Filter"]  | Filters[index];
+			MinIntervals[index] = _doc["MinInterval"] | MinIntervals[index];
+			MaxIntervals[index] = _doc["MaxInterval"] | MaxIntervals[index];
+			Thresholds[index]   = _doc["Threshold"]   | Thresholds[index];
+			Deadbands[index]    = _doc["Deadband"]    | Deadbands[index];
+			MaxSilences[index]  = _doc["MaxSilence"]  | MaxSilences[index];
 
 			_sensors->setDataByIndex(index, Names[index], WetValues[index], DryValues[index], Enabled[index]);
+			_sensors->setSamplingByIndex(index, MinIntervals[index], MaxIntervals[index], Thresholds[index]);
+			MinIntervals[index] = _sensors->getMinIntervalByIndex(index);
+			MaxIntervals[index] = _sensors->getMaxIntervalByIndex(index);
+			Thresholds[index]   = _sensors->getThresholdByIndex(index);
+			_sensors->setReportingByIndex(index, Deadbands[index], MaxSilences[index]);
+			Deadbands[index]    = _sensors->getDeadbandByIndex(index);
+
+			if (!_sensors->setFilterByIndex(index, Filters[index]))
+			{
+				Filters[index] = _sensors->getFilterByIndex(index);
+			}
 
 			return true;
 		}
 		else
 		{
-			Log.error("SoilSettings::deserializeByIndex() Soil Sensor not found" CR);
+			LOG_ERROR("SoilSettings::deserializeByIndex() Soil Sensor not found" CR);
 		}
 	}
 
-	Log.warning("SoilSettings::deserializeByIndex() Invalid JSON string" CR);
+	LOG_WARNING("SoilSettings::deserializeByIndex() Invalid JSON string" CR);
 	return false;
 }
 
@@ -77,7 +101,7 @@ bool SoilSettings::deserializeByIndex(unsigned short index, String json)
 /// <returns>True if successful</returns>
 bool SoilSettings::deserialize(String json)
 {
-	Log.trace("SoilSettings::deserialize()" CR);
+	LOG_TRACE("SoilSettings::deserialize()" CR);
 
 	if (json.length() > 0)
 	{
@@ -85,7 +109,7 @@ bool SoilSettings::deserialize(String json)
 
 		if (err)
 		{
-			Log.error("SoilSettings::deserialize() Deserialize JSON failed with code %s", err.c_str());
+			LOG_ERROR("SoilSettings::deserialize() Deserialize JSON failed with code %s", err.c_str());
 			return false;
 		}
 
@@ -97,14 +121,31 @@ bool SoilSettings::deserialize(String json)
 			WetValues[i] = obj["Wet"]     | WetValues[i];
 			DryValues[i] = obj["Dry"]     | DryValues[i];
 			Enabled[i]   = obj["Enabled"] | Enabled[i];
+			Filters[i]   = obj["Filter"]  | Filters[i];
+			MinIntervals[i] = obj["MinInterval"] | MinIntervals[i];
+			MaxIntervals[i] = obj["MaxInterval"] | MaxIntervals[i];
+			Thresholds[i]   = obj["Threshold"]   | Thresholds[i];
+			Deadbands[i]    = obj["Deadband"]    | Deadbands[i];
+			MaxSilences[i]  = obj["MaxSilence"]  | MaxSilences[i];
 
 			_sensors->setDataByIndex(i, Names[i], WetValues[i], DryValues[i], Enabled[i]);
+			_sensors->setSamplingByIndex(i, MinIntervals[i], MaxIntervals[i], Thresholds[i]);
+			MinIntervals[i] = _sensors->getMinIntervalByIndex(i);
+			MaxIntervals[i] = _sensors->getMaxIntervalByIndex(i);
+			Thresholds[i]   = _sensors->getThresholdByIndex(i);
+			_sensors->setReportingByIndex(i, Deadbands[i], MaxSilences[i]);
+			Deadbands[i]    = _sensors->getDeadbandByIndex(i);
+
+			if (!_sensors->setFilterByIndex(i, Filters[i]))
+			{
+				Filters[i] = _sensors->getFilterByIndex(i);
+			}
 		}
 
 		return true;
 	}
 
-	Log.warning("SoilSettings::deserialize() Invalid JSON string" CR);
+	LOG_WARNING("SoilSettings::deserialize() Invalid JSON string" CR);
 	return false;
 }
 
@@ -115,9 +156,33 @@ bool SoilSettings::deserialize(String json)
 /// <returns>The JSON string</returns>
 String SoilSettings::serializeByIndex(unsigned short index)
 {
-	Log.trace("SoilSettings::serializeByIndex()" CR);
+	LOG_TRACE("SoilSettings::serializeByIndex()" CR);
 	String json;
-	
+
+	buildByIndex(index);
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes a single sensor in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void SoilSettings::serializeByIndex(unsigned short index, WireFormat& writer)
+{
+	LOG_TRACE("SoilSettings::serializeByIndex()" CR);
+
+	buildByIndex(index);
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of a single sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+void SoilSettings::buildByIndex(unsigned short index)
+{
 	_doc.clear();
 
 	if (index < MAX_SENSORS)
@@ -127,14 +192,17 @@ String SoilSettings::serializeByIndex(unsigned short index)
 		_doc["Wet"]     = WetValues[index];
 		_doc["Dry"]     = DryValues[index];
 		_doc["Enabled"] = Enabled[index];
+		_doc["Filter"]  = Filters[index];
+		_doc["MinInterval"] = MinIntervals[index];
+		_doc["MaxInterval"] = MaxIntervals[index];
+		_doc["Threshold"]   = Thresholds[index];
+		_doc["Deadband"]    = Deadbands[index];
+		_doc["MaxSilence"]  = MaxSilences[index];
 	}
 	else
 	{
-		Log.error("SoilSettings::serializeByIndex() Soil Sensor not found" CR);
+		LOG_ERROR("SoilSettings::serializeByIndex() Soil Sensor not found" CR);
 	}
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
 
 /// <summary>
@@ -143,9 +211,31 @@ String SoilSettings::serializeByIndex(unsigned short index)
 /// <returns>The JSON string</returns>
 String SoilSettings::serialize()
 {
-	Log.trace("SoilSettings::serialize()" CR);
+	LOG_TRACE("SoilSettings::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes all sensors in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void SoilSettings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("SoilSettings::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of all sensors.
+/// </summary>
+void SoilSettings::build()
+{
 	_doc.clear();
 
 	for (int i = 0; i < MAX_SENSORS; i++)
@@ -156,8 +246,11 @@ String SoilSettings::serialize()
 		obj["Wet"]     = WetValues[i];
 		obj["Dry"]     = DryValues[i];
 		obj["Enabled"] = Enabled[i];
+		obj["Filter"]  = Filters[i];
+		obj["MinInterval"] = MinIntervals[i];
+		obj["MaxInterval"] = MaxIntervals[i];
+		obj["Threshold"]   = Thresholds[i];
+		obj["Deadband"]    = Deadbands[i];
+		obj["MaxSilence"]  = MaxSilences[i];
 	}
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
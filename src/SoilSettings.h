@@ -22,8 +22,10 @@ private:
 	
 	static const int CAPACITY =									// The maximum size for the JSON document
 		JSON_ARRAY_SIZE(6) +
-	6 * JSON_OBJECT_SIZE(4) + 324;
+	6 * JSON_OBJECT_SIZE(11) + 324 + 6 * 56 + 6 * 54;
 	StaticJsonDocument<CAPACITY> _doc;							// The static JSON document
+	void build();												// Builds the document of all sensors
+	void buildByIndex(unsigned short index);					// Builds the document of a single sensor
 
 	SoilSensors* _sensors;										// Pointer to soil moisture sensors
 
@@ -35,9 +37,17 @@ public:
 	float WetValues[MAX_SENSORS];								// The sensor wet values
 	float DryValues[MAX_SENSORS];								// The sensor dry values
 	bool Enabled[MAX_SENSORS];									// The sensor enabled flags
+	String Filters[MAX_SENSORS];								// The sensor filter chains (e.g. "hampel:7,exp:10")
+	uint16_t MinIntervals[MAX_SENSORS];							// The minimum sampling intervals (sec)
+	uint16_t MaxIntervals[MAX_SENSORS];							// The maximum sampling intervals (sec)
+	float Thresholds[MAX_SENSORS];								// The sampling change thresholds (mV)
+	float Deadbands[MAX_SENSORS];								// The reporting deadbands (mV)
+	uint16_t MaxSilences[MAX_SENSORS];							// The maximum reporting silence intervals (sec)
 
 	bool deserializeByIndex(unsigned short index, String json);	// Read a JSON string and updates the sensor fields
 	bool deserialize(String json);								// Read a JSON string and updates the fields
 	String serializeByIndex(unsigned short index);				// Return a string serialization (JSON)
 	String serialize();											// Return a string serialization (JSON)
+	void serializeByIndex(unsigned short index, WireFormat& writer);	// Writes a sensor (CBOR, MessagePack)
+	void serialize(WireFormat& writer);							// Writes all sensors (CBOR, MessagePack)
 };
@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "esp_wifi.h"
 #include "StaInfo.h"
 
@@ -26,7 +27,7 @@ StaInfo::StaInfo(WiFiClass wifi) :
 	BSSID(wifi.BSSIDstr()),
 	MAC(wifi.macAddress())
 {
-	Log.trace("StaInfo::StaInfo()" CR);
+	LOG_TRACE("StaInfo::StaInfo()" CR);
 
 	wifi_config_t config;
 	esp_wifi_get_config(WIFI_IF_STA, &config);
@@ -41,9 +42,31 @@ StaInfo::StaInfo(WiFiClass wifi) :
 /// <returns>The JSON string</returns>
 String StaInfo::serialize()
 {
-	Log.trace("StaInfo::serialize()" CR);
+	LOG_TRACE("StaInfo::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void StaInfo::serialize(WireFormat& writer)
+{
+	LOG_TRACE("StaInfo::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void StaInfo::build()
+{
 	_doc.clear();
 	_doc["Active"]    = Active;
 	_doc["SSID"]      = SSID;
@@ -57,8 +80,4 @@ String StaInfo::serialize()
 	_doc["RSSI"]      = RSSI;
 	_doc["BSSID"]     = BSSID;
 	_doc["MAC"]       = MAC;
-
-	serializeJsonPretty(_doc, json);
-
-	return json;
 }
@@ -11,6 +11,7 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <WiFi.h>
+#include "WireFormat.h"
 
 /// <summary>
 /// This class holds the actual WiFi station connection data.
@@ -21,6 +22,7 @@ private:
 	static const int CAPACITY =								// The maximum size for the JSON document
 		JSON_OBJECT_SIZE(12) + 325;	
 	StaticJsonDocument<CAPACITY> _doc;						// The static JSON document
+	void build();											// Builds the document
 
 public:
 	StaInfo(WiFiClass wifi);								// Constructor using WiFi instance to initialize fields
@@ -39,4 +41,5 @@ public:
 	String MAC;												// The MAC address
 
 	String serialize();										// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);						// Writes a binary serialization (CBOR, MessagePack)
 };
\ No newline at end of file
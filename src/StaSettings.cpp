@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "StaSettings.h"
 
 /// <summary>
@@ -24,7 +25,7 @@ StaSettings::StaSettings() :
 	DNS1(""),
 	DNS2("")
 {
-	Log.trace("StaSettings::StaSettings()" CR);
+	LOG_TRACE("StaSettings::StaSettings()" CR);
 }
 
 /// <summary>
@@ -34,7 +35,7 @@ StaSettings::StaSettings() :
 /// <returns>True if successful</returns>
 bool StaSettings::deserialize(String json)
 {
-	Log.trace("StaSettings::deserialize()" CR);
+	LOG_TRACE("StaSettings::deserialize()" CR);
 
 	if (json.length() > 0)
 	{
@@ -42,7 +43,7 @@ bool StaSettings::deserialize(String json)
 
 		if (err)
 		{
-			Log.error("StaSettings::deserialize() Deserialize JSON failed with code %s", err.c_str());
+			LOG_ERROR("StaSettings::deserialize() Deserialize JSON failed with code %s", err.c_str());
 			return false;
 		}
 
@@ -59,7 +60,7 @@ bool StaSettings::deserialize(String json)
 		return true;
 	}
 
-	Log.warning("StaSettings::deserialize() Invalid JSON string" CR);
+	LOG_WARNING("StaSettings::deserialize() Invalid JSON string" CR);
 	return false;
 }
 
@@ -69,9 +70,31 @@ bool StaSettings::deserialize(String json)
 /// <returns>The JSON string</returns>
 String StaSettings::serialize()
 {
-	Log.trace("StaSettings::serialize()" CR);
+	LOG_TRACE("StaSettings::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the class instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void StaSettings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("StaSettings::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the class instance.
+/// </summary>
+void StaSettings::build()
+{
 	_doc.clear();
 	_doc["SSID"]     = SSID;
 	_doc["PASS"]     = PASS;
@@ -82,9 +105,6 @@ String StaSettings::serialize()
 	_doc["Subnet"]   = Subnet;
 	_doc["DNS1"]     = DNS1;
 	_doc["DNS2"]     = DNS2;
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
 
 /// <summary>
@@ -92,7 +112,7 @@ String StaSettings::serialize()
 /// </summary>
 void StaSettings::reset()
 {
-	Log.trace("StaSettings::reset()" CR);
+	LOG_TRACE("StaSettings::reset()" CR);
 
 	SSID = "";
 	PASS = "";
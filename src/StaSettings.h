@@ -10,6 +10,7 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "WireFormat.h"
 
 /// <summary>
 /// This class holds the WiFi STA station connection configuration data.
@@ -23,6 +24,7 @@ private:
 	static const int CAPACITY = 					// The maximum size for the JSON document
 		JSON_OBJECT_SIZE(9) + 268;
 	StaticJsonDocument<CAPACITY> _doc;				// The static JSON document
+	void build();									// Builds the document
 
 public:
 	StaSettings();									// Default constructor
@@ -39,5 +41,6 @@ public:
 
 	bool deserialize(String json);					// Read a JSON string and updates the fields.
 	String serialize();								// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);				// Writes a binary serialization (CBOR, MessagePack)
 	void reset();									// Resets all settings
 };
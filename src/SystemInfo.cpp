@@ -6,7 +6,9 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include <esp_timer.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "SystemInfo.h"
 
 /// <summary>
@@ -14,9 +16,12 @@
 /// </summary>
 /// <param name="commander">Pointer to commander instance</param>
 SystemInfo::SystemInfo() :
-	Software(SOFTWARE_VERSION)
+	_boot(),
+	_phases(0),
+	Software(SOFTWARE_VERSION),
+	FastBoot(false)
 {
-	Log.trace("SystemInfo::SystemInfo()" CR);
+	LOG_TRACE("SystemInfo::SystemInfo()" CR);
 
 	ChipRevision = ESP.getChipRevision();
 	CpuFreqMHz = ESP.getCpuFreqMHz();
@@ -46,9 +51,31 @@ SystemInfo::SystemInfo() :
 /// <returns>The JSON string</returns>
 String SystemInfo::serialize()
 {
-	Log.trace("SystemInfo::serialize()" CR);
+	LOG_TRACE("SystemInfo::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes the SystemInfoClass instance in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void SystemInfo::serialize(WireFormat& writer)
+{
+	LOG_TRACE("SystemInfo::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of the SystemInfoClass instance.
+/// </summary>
+void SystemInfo::build()
+{
 	_doc.clear();
 	_doc["ChipRevision"]    = ChipRevision;
 	_doc["CpuFreqMHz"]      = CpuFreqMHz;
@@ -56,16 +83,46 @@ String SystemInfo::serialize()
 	_doc["FlashChipSize"]   = FlashChipSize;
 	_doc["HeapSize"]        = HeapSize;
 	_doc["FreeHeap"]        = FreeHeap;
+	_doc["MinFreeHeap"]     = MinFreeHeap;
+	_doc["MaxAllocHeap"]    = MaxAllocHeap;
+	_doc["Fragmentation"]   = Fragmentation;
 	_doc["SketchSize"]      = SketchSize;
 	_doc["FreeSketchSpace"] = FreeSketchSpace;
 	_doc["SketchMD5"]       = SketchMD5;
 	_doc["SdkVersion"]      = SdkVersion;
 	_doc["ChipID"]          = ChipID;
 	_doc["Software"]        = Software;
+	_doc["FastBoot"]        = FastBoot;
 
-	serializeJsonPretty(_doc, json);
+	// The boot phases (msec since reset).
+	JsonObject boot = _doc.createNestedObject("Boot");
 
-	return json;
+	for (uint8_t i = 0; i < getBootPhases(); i++)
+	{
+		if (_boot[i].Name != NULL)
+		{
+			boot[_boot[i].Name] = _boot[i].Time;
+		}
+	}
+
+	// The allocation counters per subsystem (the net heap change only without the allocation hook).
+	JsonObject allocations = _doc.createNestedObject("Allocations");
+
+	for (uint8_t i = 0; i < HeapMonitor::SUBSYSTEM_COUNT; i++)
+	{
+		const HeapMonitor::Counters& counters = HeapMonitor::getCounters(i);
+		JsonObject subsystem = allocations.createNestedObject(HeapMonitor::getSubsystemName(i));
+		subsystem["Calls"]  = counters.Calls;
+
+		if (HeapMonitor::isCounting())
+		{
+			subsystem["Allocs"] = counters.Allocs;
+			subsystem["Frees"]  = counters.Frees;
+			subsystem["Bytes"]  = counters.Bytes;
+		}
+
+		subsystem["Net"]    = counters.Net;
+	}
 }
 
 /// <summary>
@@ -75,16 +132,59 @@ void SystemInfo::init()
 {
 	HeapSize = ESP.getHeapSize() / 1000;
 	FreeHeap = ESP.getFreeHeap() / 1000;
+	MinFreeHeap = ESP.getMinFreeHeap() / 1000;
+	MaxAllocHeap = ESP.getMaxAllocHeap() / 1000;
+	Fragmentation = HeapMonitor::getFragmentation();
 	SketchSize = ESP.getSketchSize() / 1000;
 	FreeSketchSpace = ESP.getFreeSketchSpace() / 1000;
 	SketchMD5 = ESP.getSketchMD5();
 }
 
 /// <summary>
-///  Updates dynamic values.
+///  Updates dynamic values (and the heap trend).
 /// </summary>
 void SystemInfo::update()
 {
 	HeapSize = ESP.getHeapSize() / 1000;
 	FreeHeap = ESP.getFreeHeap() / 1000;
+	MinFreeHeap = ESP.getMinFreeHeap() / 1000;
+	MaxAllocHeap = ESP.getMaxAllocHeap() / 1000;
+	Fragmentation = HeapMonitor::getFragmentation();
+	HeapMonitor::update();
+}
+
+/// <summary>
+///  Records the completion time (msec since reset) of a boot phase.
+///  Note that phases may be added from a background task (e.g. Bluetooth).
+/// </summary>
+/// <param name="name">The phase name (string literal)</param>
+void SystemInfo::addBootPhase(const char* name)
+{
+	uint32_t time = (uint32_t)(esp_timer_get_time() / 1000);
+	uint8_t index = __atomic_fetch_add(&_phases, 1, __ATOMIC_RELAXED);
+
+	if (index < MAX_BOOT_PHASES)
+	{
+		_boot[index].Time = time;
+		_boot[index].Name = name;
+	}
+}
+
+/// <summary>
+///  Returns the number of recorded boot phases.
+/// </summary>
+/// <returns>The number of boot phases</returns>
+uint8_t SystemInfo::getBootPhases()
+{
+	return (_phases < MAX_BOOT_PHASES) ? _phases : MAX_BOOT_PHASES;
+}
+
+/// <summary>
+///  Returns the boot phase at the specified index.
+/// </summary>
+/// <param name="index">The boot phase index</param>
+/// <returns>The boot phase</returns>
+const SystemInfo::BootPhase& SystemInfo::getBootPhase(uint8_t index)
+{
+	return _boot[(index < MAX_BOOT_PHASES) ? index : 0];
 }
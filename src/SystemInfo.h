@@ -11,6 +11,9 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 
+#include "HeapMonitor.h"
+#include "WireFormat.h"
+
 /// <summary>
 /// This class holds the current system data.
 /// Note that if this class is instanciated before the sketch information is available 
@@ -18,10 +21,25 @@
 /// </summary>
 class SystemInfo
 {
+public:
+	static const uint8_t MAX_BOOT_PHASES = 12;		// The maximum number of boot phases
+
+	struct BootPhase
+	{
+		const char* Name;					// The phase name (string literal)
+		uint32_t Time;						// The time (msec since reset) the phase has been completed
+	};
+
 private:
 	static const int CAPACITY = 			// The maximum size for the JSON document
-		JSON_OBJECT_SIZE(12) + 247;
+		JSON_OBJECT_SIZE(18) + JSON_OBJECT_SIZE(HeapMonitor::SUBSYSTEM_COUNT) +
+		JSON_OBJECT_SIZE(MAX_BOOT_PHASES) +
+		HeapMonitor::SUBSYSTEM_COUNT * JSON_OBJECT_SIZE(5) + 247;
 	StaticJsonDocument<CAPACITY> _doc;		// The static JSON document
+	BootPhase _boot[MAX_BOOT_PHASES];		// The boot phases
+	uint8_t _phases;						// The number of boot phases
+
+	void build();							// Builds the document
 
 public:
 	static char* SOFTWARE_VERSION;			// The software versionstring with date (see .ino)
@@ -34,14 +52,22 @@ public:
 	int FlashChipSize;						// The flash chip size in kB
 	int HeapSize;							// The total heap size in kB
 	int FreeHeap;							// The amount of free heap kB
+	int MinFreeHeap;						// The minimum amount of free heap ever kB
+	int MaxAllocHeap;						// The largest free heap block kB
+	int Fragmentation;						// The heap fragmentation (100 - largest block / free heap in %)
 	int SketchSize;							// The sketch size in kB
 	int FreeSketchSpace;					// The free sketch space in kB
 	String SketchMD5;						// The MD5 of the current sketch
 	String SdkVersion;						// The espressif SDK version
 	String ChipID;							// Board identifier (MAC address)
 	String Software;						// Software version and date
+	bool FastBoot;							// True if started in fast boot mode
 
 	String serialize();						// Return a string serialization (JSON)
+	void serialize(WireFormat& writer);		// Writes a binary serialization (CBOR, MessagePack)
 	void init();							// Initializes selected values
 	void update();							// Updates dynamic values
+	void addBootPhase(const char* name);	// Records the completion time of a boot phase
+	uint8_t getBootPhases();				// Returns the number of boot phases
+	const BootPhase& getBootPhase(uint8_t index);	// Returns the boot phase at the specified index
 };
@@ -7,15 +7,28 @@
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
 #include <math.h>
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "TempSensors.h"
 
+/// <summary>
+/// The default sampling change threshold (C, four steps of the 12 bit resolution).
+/// </summary>
+const float TempSensors::THRESHOLD = 0.25;
+
+/// <summary>
+/// The default reporting deadband (C).
+/// </summary>
+const float TempSensors::DEADBAND = 0.1;
+
 /// <summary>
 ///  Constructor.
 /// </summary>
 TempSensors::TempSensors()
 {
-	Log.trace("TempSensors::TempSensors()" CR);
+	LOG_TRACE("TempSensors::TempSensors()" CR);
+	setSampling(SampleScheduler::MIN_INTERVAL, SampleScheduler::MAX_INTERVAL, THRESHOLD);
+	setReporting(DEADBAND, ChangeTracker::MAX_SILENCE);
 }
 
 /// <summary>
@@ -24,8 +37,10 @@ TempSensors::TempSensors()
 /// <param name="pin">GPIO pin</param>
 TempSensors::TempSensors(unsigned short pin)
 {
-	Log.trace("TempSensors::TempSensors()" CR);
+	LOG_TRACE("TempSensors::TempSensors()" CR);
 	setPin(pin);
+	setSampling(SampleScheduler::MIN_INTERVAL, SampleScheduler::MAX_INTERVAL, THRESHOLD);
+	setReporting(DEADBAND, ChangeTracker::MAX_SILENCE);
 }
 
 /// <summary>
@@ -34,7 +49,7 @@ TempSensors::TempSensors(unsigned short pin)
 /// <param name="index"></param>
 void TempSensors::initialize(unsigned short index)
 {
-	Log.trace("TempSensors::initialize()" CR);
+	LOG_TRACE("TempSensors::initialize()" CR);
 
 	DeviceAddress address;
 	String hex = String();
@@ -87,7 +102,7 @@ String TempSensors::convert(DeviceAddress address)
 /// <returns>The OneWire Pin</returns>
 unsigned short TempSensors::getPin()
 {
-	Log.trace("TempSensors::getPin()" CR);
+	LOG_TRACE("TempSensors::getPin()" CR);
 	return _pin;
 }
 
@@ -97,7 +112,7 @@ unsigned short TempSensors::getPin()
 /// <param name="pin">The GPIO pin</param>
 void TempSensors::setPin(unsigned short pin)
 {
-	Log.trace("TempSensors::setPin()" CR);
+	LOG_TRACE("TempSensors::setPin()" CR);
 	_pin = pin;
 	_oneWire.begin(pin);
 }
@@ -110,7 +125,7 @@ void TempSensors::setPin(unsigned short pin)
 /// <returns>The sensor name</returns>
 String TempSensors::getNameByIndex(unsigned short index)
 {
-	Log.trace("TempSensors::getNameByIndex()" CR);
+	LOG_TRACE("TempSensors::getNameByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -118,7 +133,7 @@ String TempSensors::getNameByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("TempSensors::getNameByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSensors::getNameByIndex() Temp Sensor not found" CR);
 	}
 
 	return String();
@@ -131,7 +146,7 @@ String TempSensors::getNameByIndex(unsigned short index)
 /// <param name="name">The sensor name</param>
 void TempSensors::setNameByIndex(unsigned short index, String name)
 {
-	Log.trace("TempSensors::setNameByIndex()" CR);
+	LOG_TRACE("TempSensors::setNameByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -139,7 +154,7 @@ void TempSensors::setNameByIndex(unsigned short index, String name)
 	}
 	else
 	{
-		Log.error("TempSensors::setNameByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSensors::setNameByIndex() Temp Sensor not found" CR);
 	}
 }
 
@@ -151,7 +166,7 @@ void TempSensors::setNameByIndex(unsigned short index, String name)
 /// <returns>The sensor address</returns>
 String TempSensors::getAddressByIndex(unsigned short index)
 {
-	Log.trace("TempSensors::getAddressByIndex()" CR);
+	LOG_TRACE("TempSensors::getAddressByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -159,7 +174,7 @@ String TempSensors::getAddressByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("TempSensors::getAddressByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSensors::getAddressByIndex() Temp Sensor not found" CR);
 	}
 
 	return String();
@@ -173,7 +188,7 @@ String TempSensors::getAddressByIndex(unsigned short index)
 /// <returns>The sensor precision</returns>
 int TempSensors::getResolutionByIndex(unsigned short index)
 {
-	Log.trace("TempSensors::getResolutionByIndex()" CR);
+	LOG_TRACE("TempSensors::getResolutionByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -181,7 +196,7 @@ int TempSensors::getResolutionByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("TempSensors::getResolutionByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSensors::getResolutionByIndex() Temp Sensor not found" CR);
 	}
 
 	return 0;
@@ -194,7 +209,7 @@ int TempSensors::getResolutionByIndex(unsigned short index)
 /// <returns>True if connected</returns>
 bool TempSensors::isConnectedByIndex(unsigned short index)
 {
-	Log.trace("TempSensors::isConnectedByIndex()" CR);
+	LOG_TRACE("TempSensors::isConnectedByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -202,7 +217,7 @@ bool TempSensors::isConnectedByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("TempSensors::isConnectedByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSensors::isConnectedByIndex() Temp Sensor not found" CR);
 	}
 
 	return false;
@@ -215,7 +230,7 @@ bool TempSensors::isConnectedByIndex(unsigned short index)
 /// <returns>The temperature value</returns>
 float TempSensors::getTempCByIndex(unsigned short index)
 {
-	Log.trace("TempSensors::getTempCByIndex()" CR);
+	LOG_TRACE("TempSensors::getTempCByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -223,7 +238,7 @@ float TempSensors::getTempCByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("TempSensors::getTempCByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSensors::getTempCByIndex() Temp Sensor not found" CR);
 	}
 
 	return DEVICE_DISCONNECTED_C;
@@ -236,7 +251,7 @@ float TempSensors::getTempCByIndex(unsigned short index)
 /// <returns>The temperature value</returns>
 float TempSensors::getTempFByIndex(unsigned short index)
 {
-	Log.trace("TempSensors::getTempFByIndex()" CR);
+	LOG_TRACE("TempSensors::getTempFByIndex()" CR);
 
 	if (index < MAX_SENSORS)
 	{
@@ -244,18 +259,150 @@ float TempSensors::getTempFByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("TempSensors::getTempFByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSensors::getTempFByIndex() Temp Sensor not found" CR);
 	}
 
 	return DEVICE_DISCONNECTED_F;
 }
 
+/// <summary>
+///  Returns the minimum sampling interval (sec).
+/// </summary>
+/// <returns>The minimum interval</returns>
+uint16_t TempSensors::getMinInterval()
+{
+	LOG_TRACE("TempSensors::getMinInterval()" CR);
+	return _schedulers[0].getMinInterval();
+}
+
+/// <summary>
+///  Returns the maximum sampling interval (sec).
+/// </summary>
+/// <returns>The maximum interval</returns>
+uint16_t TempSensors::getMaxInterval()
+{
+	LOG_TRACE("TempSensors::getMaxInterval()" CR);
+	return _schedulers[0].getMaxInterval();
+}
+
+/// <summary>
+///  Returns the sampling change threshold (C).
+/// </summary>
+/// <returns>The change threshold</returns>
+float TempSensors::getThreshold()
+{
+	LOG_TRACE("TempSensors::getThreshold()" CR);
+	return _schedulers[0].getThreshold();
+}
+
+/// <summary>
+///  Sets the adaptive sampling of all sensors (see SampleScheduler). The sensors share the OneWire bus
+///  (a single conversion for all sensors), so the settings are common, the schedules are kept per sensor.
+///  The intervals are limited to 1..3600 sec, the schedules are restarted if the intervals change.
+/// </summary>
+/// <param name="min">The minimum interval (sec)</param>
+/// <param name="max">The maximum interval (sec)</param>
+/// <param name="threshold">The change threshold (C)</param>
+void TempSensors::setSampling(uint16_t min, uint16_t max, float threshold)
+{
+	LOG_TRACE("TempSensors::setSampling()" CR);
+
+	for (int i = 0; i < MAX_SENSORS; i++)
+	{
+		if ((_schedulers[i].getMinInterval() != min) || (_schedulers[i].getMaxInterval() != max))
+		{
+			_schedulers[i].setIntervals(min, max);
+		}
+
+		_schedulers[i].setThreshold(threshold);
+	}
+}
+
+/// <summary>
+///  Returns the reporting deadband (C).
+/// </summary>
+/// <returns>The deadband</returns>
+float TempSensors::getDeadband()
+{
+	LOG_TRACE("TempSensors::getDeadband()" CR);
+	return _changes.getDeadband(0);
+}
+
+/// <summary>
+///  Returns the maximum silence interval (sec).
+/// </summary>
+/// <returns>The maximum silence interval</returns>
+uint16_t TempSensors::getMaxSilence()
+{
+	LOG_TRACE("TempSensors::getMaxSilence()" CR);
+	return _changes.getMaxSilence(0);
+}
+
+/// <summary>
+///  Sets the report by exception parameters of all sensors (see ChangeTracker).
+/// </summary>
+/// <param name="deadband">The deadband (C)</param>
+/// <param name="maxSilence">The maximum silence interval (sec, 0: no heartbeat)</param>
+void TempSensors::setReporting(float deadband, uint16_t maxSilence)
+{
+	LOG_TRACE("TempSensors::setReporting()" CR);
+
+	for (int i = 0; i < MAX_SENSORS; i++)
+	{
+		_changes.setDeadband(i, deadband);
+		_changes.setMaxSilence(i, maxSilence);
+	}
+}
+
+/// <summary>
+///  Returns the reported version of the specified sensor (0: not reported).
+/// </summary>
+/// <param name="index">Sensor index</param>
+/// <returns>The version</returns>
+uint32_t TempSensors::getVersionByIndex(unsigned short index)
+{
+	LOG_TRACE("TempSensors::getVersionByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _changes.getVersion(index);
+	}
+	else
+	{
+		LOG_ERROR("TempSensors::getVersionByIndex() Temp Sensor not found" CR);
+	}
+
+	return 0;
+}
+
+/// <summary>
+///  Returns true if the specified sensor has been reported after the version.
+/// </summary>
+/// <param name="index">Sensor index</param>
+/// <param name="since">The version seen by the consumer</param>
+/// <returns>True if changed</returns>
+bool TempSensors::isChangedByIndex(unsigned short index, uint32_t since)
+{
+	LOG_TRACE("TempSensors::isChangedByIndex()" CR);
+
+	if (index < MAX_SENSORS)
+	{
+		return _changes.isChanged(index, since);
+	}
+	else
+	{
+		LOG_ERROR("TempSensors::isChangedByIndex() Temp Sensor not found" CR);
+	}
+
+	return false;
+}
+
 /// <summary>
 ///  Initializes all temperature sensors (bus initialization).
 /// </summary>
 void TempSensors::begin()
 {
-	Log.trace("TempSensors::begin()" CR);
+	LOG_TRACE("TempSensors::begin()" CR);
 
 	_sensors.begin();
 	_sensors.setResolution(GLOBAL_RESOLUTION);
@@ -265,28 +412,51 @@ void TempSensors::begin()
 	for (int i = 0; i < MAX_SENSORS; i++)
 	{
 		initialize(i);
+		_schedulers[i].reset();
 	}
+
+	_changes.reset();
 }
 
 /// <summary>
-///  Updates temperatures (and connection state) on all sensors.
+///  Updates temperatures (and connection state) on the sensors which are due (adaptive sampling, see
+///  SampleScheduler). The conversion on the OneWire bus is requested only if at least one sensor is due.
+///  The changes are reported by exception (see ChangeTracker), the heartbeat is checked on every update.
 /// </summary>
-void TempSensors::update()
+/// <param name="all">Update all sensors (ignore the schedule)</param>
+void TempSensors::update(bool all)
 {
-	_sensors.requestTemperatures();
+	uint32_t now = millis();
+	bool due = all;
 
-	for (int i = 0; i < MAX_SENSORS; i++)
+	for (int i = 0; (i < MAX_SENSORS) && !due; i++)
 	{
-		_tempC[i] = _sensors.getTempCByIndex(i);
+		due = _schedulers[i].isDue(now);
+	}
 
-		if (_tempC[i] == DEVICE_DISCONNECTED_C)
-		{
-			_connected[i] == false;
-		}
-		else
+	if (due)
+	{
+		_sensors.requestTemperatures();
+	}
+
+	for (int i = 0; i < MAX_SENSORS; i++)
+	{
+		if (all || (due && _schedulers[i].isDue(now)))
 		{
-			_connected[i] == true;
+			_tempC[i] = _sensors.getTempCByIndex(i);
+			_schedulers[i].sample(now, _tempC[i]);
+
+			if (_tempC[i] == DEVICE_DISCONNECTED_C)
+			{
+				_connected[i] = false;
+			}
+			else
+			{
+				_connected[i] = true;
+			}
 		}
+
+		_changes.update(i, _tempC[i], now);
 	}
 }
 
@@ -296,8 +466,33 @@ void TempSensors::update()
 /// <returns>The JSON string</returns>
 String TempSensors::serializeByIndex(unsigned short index)
 {
-	Log.trace("TempSensors::serializeByIndex()" CR);
+	LOG_TRACE("TempSensors::serializeByIndex()" CR);
 	String json;
+
+	buildByIndex(index);
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes a single temperature sensor in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void TempSensors::serializeByIndex(unsigned short index, WireFormat& writer)
+{
+	LOG_TRACE("TempSensors::serializeByIndex()" CR);
+
+	buildByIndex(index);
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of a single temperature sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+void TempSensors::buildByIndex(unsigned short index)
+{
 	_doc.clear();
 
 	if (index < MAX_SENSORS)
@@ -311,34 +506,82 @@ String TempSensors::serializeByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("TempSensors::serializeByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSensors::serializeByIndex() Temp Sensor not found" CR);
 	}
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
 
 /// <summary>
 ///  Serialize the TemperatureSensors instance to a JSON string.
 /// </summary>
+/// <param name="fields">The selected fields (empty: all fields)</param>
 /// <returns>The JSON string</returns>
-String TempSensors::serialize()
+String TempSensors::serialize(const NameList& fields)
 {
-	Log.trace("TempSensors::serialize()" CR);
+	LOG_TRACE("TempSensors::serialize()" CR);
 	String json;
+
+	build(fields);
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes all sensors in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+void TempSensors::serialize(WireFormat& writer, const NameList& fields)
+{
+	LOG_TRACE("TempSensors::serialize()" CR);
+
+	build(fields);
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Writes the metrics of the temperature sensors (temperature of the connected sensors, connection state of all
+///  sensors). The sensor index is used as label, the names are available in /meta.
+/// </summary>
+/// <param name="writer">The metrics writer (e.g. HTTP response)</param>
+void TempSensors::writeMetrics(MetricsWriter& writer)
+{
+	LOG_TRACE("TempSensors::writeMetrics()" CR);
+	char index[4];
+
+	writer.writeFamily("soilmonitor_temp_connected", "gauge", "Temperature sensor connected (1) or not (0).");
+
+	for (unsigned short i = 0; i < MAX_SENSORS; i++)
+	{
+		snprintf(index, sizeof(index), "%u", i);
+		writer.writeInt("soilmonitor_temp_connected", isConnectedByIndex(i) ? 1 : 0, "sensor", index);
+	}
+
+	writer.writeFamily("soilmonitor_temp_celsius", "gauge", "Temperature.");
+
+	for (unsigned short i = 0; i < MAX_SENSORS; i++)
+	{
+		if (!isConnectedByIndex(i)) continue;
+		snprintf(index, sizeof(index), "%u", i);
+		writer.writeFloat("soilmonitor_temp_celsius", getTempCByIndex(i), "sensor", index);
+	}
+}
+
+/// <summary>
+///  Builds the document of all sensors (the array index is the sensor index), only the selected fields are added.
+/// </summary>
+/// <param name="fields">The selected fields (empty: all fields)</param>
+void TempSensors::build(const NameList& fields)
+{
 	_doc.clear();
 
 	for (int i = 0; i < MAX_SENSORS; i++)
 	{
 		JsonObject obj = _doc.createNestedObject();
-		obj["Name"]      = getNameByIndex(i);
-		obj["Address"]   = getAddressByIndex(i);
-		obj["Connected"] = isConnectedByIndex(i);
-		obj["Resolution"] = getResolutionByIndex(i);
-		obj["TempC"]     = getTempCByIndex(i);
-		obj["TempF"]     = getTempFByIndex(i);
+		if (fields.selects("Name"))       obj["Name"]       = getNameByIndex(i);
+		if (fields.selects("Address"))    obj["Address"]    = getAddressByIndex(i);
+		if (fields.selects("Connected"))  obj["Connected"]  = isConnectedByIndex(i);
+		if (fields.selects("Resolution")) obj["Resolution"] = getResolutionByIndex(i);
+		if (fields.selects("TempC"))      obj["TempC"]      = getTempCByIndex(i);
+		if (fields.selects("TempF"))      obj["TempF"]      = getTempFByIndex(i);
 	}
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
@@ -12,6 +12,11 @@
 #include <ArduinoJson.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
+#include "SampleScheduler.h"
+#include "ChangeTracker.h"
+#include "WireFormat.h"
+#include "NameList.h"
+#include "MetricsWriter.h"
 
 /// <summary>
 /// This class implements a list of temperature sensors.
@@ -21,6 +26,8 @@ class TempSensors
 public:
 	static const unsigned short MAX_SENSORS = 6;				// Maximum number of temperature sensors
 	static const unsigned short ONE_WIRE_BUS = 4;				// GPIO04 ESP32 pin 5 (default)
+	static const float THRESHOLD;								// The default sampling change threshold (C)
+	static const float DEADBAND;								// The default reporting deadband (C)
 
 private:
 	static const int CAPACITY = 								// The maximum size for the JSON document		
@@ -29,6 +36,9 @@ private:
 	5 * JSON_OBJECT_SIZE(6) + 565;
 	StaticJsonDocument<CAPACITY> _doc;							// The static JSON document
 
+	void build(const NameList& fields);							// Builds the document of all sensors
+	void buildByIndex(unsigned short index);					// Builds the document of a single sensor
+
 	const int MAX_NAME_LEN = 32;								// The maximum length for the sensor name
 	const int GLOBAL_RESOLUTION = 12;							// The sensor resolution settings (global)
 
@@ -81,6 +91,9 @@ private:
 		false
 	};
 
+	SampleScheduler _schedulers[MAX_SENSORS];					// The adaptive sampling schedules
+	ChangeTracker _changes;										// The reported changes (report by exception)
+
 	void initialize(unsigned short index);						// Initializes sensor address and connection status
 	String convert(DeviceAddress address);						// Returns the device address as a HEX String
 public:
@@ -96,11 +109,25 @@ public:
 	bool isConnectedByIndex(unsigned short index);				// Returns true if sensor is connected
 	float getTempCByIndex(unsigned short index);				// Returns the temperature value in Celsius
 	float getTempFByIndex(unsigned short index);				// Returns the temperature value in Farenheit
+	uint16_t getMinInterval();									// Returns the minimum sampling interval (sec)
+	uint16_t getMaxInterval();									// Returns the maximum sampling interval (sec)
+	float getThreshold();										// Returns the sampling change threshold (C)
+	void setSampling(uint16_t min, uint16_t max,				// Sets the sampling intervals (sec) and
+		float threshold);										// the change threshold (C) of all sensors
+	float getDeadband();										// Returns the reporting deadband (C)
+	uint16_t getMaxSilence();									// Returns the maximum silence interval (sec)
+	void setReporting(float deadband, uint16_t maxSilence);		// Sets the reporting deadband and maximum silence
+	uint32_t getVersionByIndex(unsigned short index);			// Returns the reported version of a sensor
+	bool isChangedByIndex(unsigned short index, uint32_t since);// Returns true if reported after the version
 
 	void begin();												// Initializes all sensors
-	void update();												// Updates temperatures on all sensors
+	void update(bool all = false);								// Updates temperatures on the due (or all) sensors
 
 	String serializeByIndex(unsigned short index);				// Return a sensor string serialization (JSON)
-	String serialize();											// Return a string serialization (JSON)
+	String serialize(const NameList& fields = NameList());		// Return a string serialization (JSON)
+	void serializeByIndex(unsigned short index, WireFormat& writer);	// Writes a sensor (CBOR, MessagePack)
+	void serialize(WireFormat& writer,							// Writes all sensors (CBOR, MessagePack)
+		const NameList& fields = NameList());
+	void writeMetrics(MetricsWriter& writer);					// Writes the sensor metrics (Prometheus)
 };
 
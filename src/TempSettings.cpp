@@ -6,7 +6,8 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
+#include "JsonWire.h"
 #include "TempSettings.h"
 
 /// <summary>
@@ -16,8 +17,13 @@
 TempSettings::TempSettings(TempSensors* sensors) :
 	_sensors(sensors)
 {
-	Log.trace("TempSettings::TempSettings()" CR);
+	LOG_TRACE("TempSettings::TempSettings()" CR);
 	Pin = _sensors->getPin();
+	MinInterval = _sensors->getMinInterval();
+	MaxInterval = _sensors->getMaxInterval();
+	Threshold = _sensors->getThreshold();
+	Deadband = _sensors->getDeadband();
+	MaxSilence = _sensors->getMaxSilence();
 
 	for (unsigned short i = 0; i < MAX_SENSORS; i++)
 	{
@@ -33,7 +39,7 @@ TempSettings::TempSettings(TempSensors* sensors) :
 /// <returns>True if successful</returns>
 bool TempSettings::deserializeByIndex(unsigned short index, String json)
 {
-	Log.trace("TempSettings::deserializeByIndex()" CR);
+	LOG_TRACE("TempSettings::deserializeByIndex()" CR);
 
 	if (json.length() > 0)
 	{
@@ -43,7 +49,7 @@ bool TempSettings::deserializeByIndex(unsigned short index, String json)
 
 			if (err)
 			{
-				Log.error("TempSettings::deserializeByIndex() Deserialize JSON failed with code %s", err.c_str());
+				LOG_ERROR("TempSettings::deserializeByIndex() Deserialize JSON failed with code %s", err.c_str());
 				return false;
 			}
 
@@ -58,11 +64,11 @@ bool TempSettings::deserializeByIndex(unsigned short index, String json)
 		}
 		else
 		{
-			Log.error("TempSettings::deserializeByIndex() Temp Sensor not found" CR);
+			LOG_ERROR("TempSettings::deserializeByIndex() Temp Sensor not found" CR);
 		}
 	}
 
-	Log.warning("TempSettings::deserializeByIndex() Invalid JSON string" CR);
+	LOG_WARNING("TempSettings::deserializeByIndex() Invalid JSON string" CR);
 	return false;
 }
 
@@ -73,7 +79,7 @@ bool TempSettings::deserializeByIndex(unsigned short index, String json)
 /// <returns>True if successful</returns>
 bool TempSettings::deserialize(String json)
 {
-	Log.trace("TempSettings::deserialize()" CR);
+	LOG_TRACE("TempSettings::deserialize()" CR);
 
 	if (json.length() > 0)
 	{
@@ -81,13 +87,26 @@ bool TempSettings::deserialize(String json)
 
 		if (err)
 		{
-			Log.error("TempSettings::deserialize() Deserialize JSON failed with code %s", err.c_str());
+			LOG_ERROR("TempSettings::deserialize() Deserialize JSON failed with code %s", err.c_str());
 			return false;
 		}
 
 		Pin = _doc["Pin"] | Pin;
 		_sensors->setPin(Pin);
 
+		MinInterval = _doc["MinInterval"] | MinInterval;
+		MaxInterval = _doc["MaxInterval"] | MaxInterval;
+		Threshold   = _doc["Threshold"]   | Threshold;
+		_sensors->setSampling(MinInterval, MaxInterval, Threshold);
+		MinInterval = _sensors->getMinInterval();
+		MaxInterval = _sensors->getMaxInterval();
+		Threshold   = _sensors->getThreshold();
+
+		Deadband   = _doc["Deadband"]   | Deadband;
+		MaxSilence = _doc["MaxSilence"] | MaxSilence;
+		_sensors->setReporting(Deadband, MaxSilence);
+		Deadband   = _sensors->getDeadband();
+
 		for (int i = 0; i < MAX_SENSORS; i++)
 		{
 			JsonObject obj = _doc["Sensors"][i];
@@ -98,7 +117,7 @@ bool TempSettings::deserialize(String json)
 		return true;
 	}
 
-	Log.warning("TempSettings::deserialize() Invalid JSON string" CR);
+	LOG_WARNING("TempSettings::deserialize() Invalid JSON string" CR);
 	return false;
 }
 
@@ -109,9 +128,33 @@ bool TempSettings::deserialize(String json)
 /// <returns>The JSON string</returns>
 String TempSettings::serializeByIndex(unsigned short index)
 {
-	Log.trace("TempSettings::serializeByIndex()" CR);
+	LOG_TRACE("TempSettings::serializeByIndex()" CR);
 	String json;
 
+	buildByIndex(index);
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes a single sensor in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void TempSettings::serializeByIndex(unsigned short index, WireFormat& writer)
+{
+	LOG_TRACE("TempSettings::serializeByIndex()" CR);
+
+	buildByIndex(index);
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of a single sensor.
+/// </summary>
+/// <param name="index">Sensor index (0..5)</param>
+void TempSettings::buildByIndex(unsigned short index)
+{
 	_doc.clear();
 
 	if (index < MAX_SENSORS)
@@ -120,11 +163,8 @@ String TempSettings::serializeByIndex(unsigned short index)
 	}
 	else
 	{
-		Log.error("TempSettings::serializeByIndex() Temp Sensor not found" CR);
+		LOG_ERROR("TempSettings::serializeByIndex() Temp Sensor not found" CR);
 	}
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
 
 /// <summary>
@@ -133,11 +173,38 @@ String TempSettings::serializeByIndex(unsigned short index)
 /// <returns>The JSON string</returns>
 String TempSettings::serialize()
 {
-	Log.trace("TempSettings::serialize()" CR);
+	LOG_TRACE("TempSettings::serialize()" CR);
 	String json;
 
+	build();
+	serializeJsonPretty(_doc, json);
+	return json;
+}
+
+/// <summary>
+///  Writes all sensors in a binary format (same structure as the JSON string).
+/// </summary>
+/// <param name="writer">The binary writer (CBOR or MessagePack)</param>
+void TempSettings::serialize(WireFormat& writer)
+{
+	LOG_TRACE("TempSettings::serialize()" CR);
+
+	build();
+	JsonWire::write(_doc.as<JsonVariant>(), writer);
+}
+
+/// <summary>
+///  Builds the document of all sensors.
+/// </summary>
+void TempSettings::build()
+{
 	_doc.clear();
 	_doc["Pin"] = Pin;
+	_doc["MinInterval"] = MinInterval;
+	_doc["MaxInterval"] = MaxInterval;
+	_doc["Threshold"]   = Threshold;
+	_doc["Deadband"]    = Deadband;
+	_doc["MaxSilence"]  = MaxSilence;
 
 	JsonArray array = _doc.createNestedArray("Sensors");
 
@@ -146,7 +213,4 @@ String TempSettings::serialize()
 		JsonObject obj = array.createNestedObject();
 		obj["Name"] = Names[i];
 	}
-
-	serializeJsonPretty(_doc, json);
-	return json;
 }
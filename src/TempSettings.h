@@ -23,8 +23,10 @@ private:
 	static const int CAPACITY =									// The maximum size for the JSON document
 		JSON_ARRAY_SIZE(6) +
 	6 * JSON_OBJECT_SIZE(1) +
-		JSON_OBJECT_SIZE(2) + 240;
+		JSON_OBJECT_SIZE(7) + 240 + 54;
 	StaticJsonDocument<CAPACITY> _doc;							// The static JSON document
+	void build();												// Builds the document of all sensors
+	void buildByIndex(unsigned short index);					// Builds the document of a single sensor
 
 	TempSensors* _sensors;										// Pointer to temperature sensors
 
@@ -32,10 +34,17 @@ public:
 	TempSettings(TempSensors* sensors);							// Constructor using sensors to initialize settings
 
 	unsigned short Pin;											// The OneWire input pin
+	uint16_t MinInterval;										// The minimum sampling interval (sec)
+	uint16_t MaxInterval;										// The maximum sampling interval (sec)
+	float Threshold;											// The sampling change threshold (C)
+	float Deadband;												// The reporting deadband (C)
+	uint16_t MaxSilence;										// The maximum reporting silence interval (sec)
 	String Names[MAX_SENSORS];									// The sensor names
 
 	bool deserializeByIndex(unsigned short index, String json);	// Read a JSON string and updates the sensor fields
 	bool deserialize(String json);								// Read a JSON string and updates the fields
 	String serializeByIndex(unsigned short index);				// Return a string serialization (JSON)
 	String serialize();											// Return a string serialization (JSON)
+	void serializeByIndex(unsigned short index, WireFormat& writer);	// Writes a sensor (CBOR, MessagePack)
+	void serialize(WireFormat& writer);							// Writes all sensors (CBOR, MessagePack)
 };
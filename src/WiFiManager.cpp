@@ -6,116 +6,226 @@
 //   Licensed under the MIT license. See the LICENSE file in the project root for more information.
 // </license>
 // --------------------------------------------------------------------------------------------------------------------
-#include <ArduinoLog.h>
+#include "Logger.h"
 #include "time.h"
+#include <tcpip_adapter.h>
+#include <lwip/dhcp.h>
 #include "ApInfo.h"
 #include "WiFiManager.h"
 
+/// <summary>
+///  The instance receiving the WiFi events.
+/// </summary>
+WiFiManager* WiFiManager::_instance = NULL;
+
+/// <summary>
+///  The last good connection. The RTC memory is not initialized on a reset (ESP.restart), so the cache survives a
+///  restart. After a power cycle the content is random, it is rejected by the magic number and the checksum.
+/// </summary>
+RTC_NOINIT_ATTR WiFiManager::Cache WiFiManager::_cache;
+
 /// <summary>
 ///  Constructor setting a reference to a settings instance.
 /// </summary>
 /// <param name="settings">Pointer to settings instance</param>
 WiFiManager::WiFiManager(Settings* settings) :
-	_settings(settings)
+	_settings(settings),
+	_numberAP(0),
+	_scanTime(0),
+	_scanValid(false),
+	_scanning(false),
+	_scanRequested(false),
+	_state(STATE_IDLE),
+	_started(0),
+	_backoff(MIN_BACKOFF),
+	_delay(0),
+	_attempts(0),
+	_fallback(false),
+	_timeSet(false),
+	_fast(false),
+	_cachedConfig(false),
+	_cacheUsed(false),
+	_leasePending(false),
+	_leaseStart(0),
+	_leaseRenew(0),
+	_leaseUpdated(0),
+	_connectStart(0),
+	_connectTime(0),
+	_disconnects(0),
+	_reason(0),
+	_apStarted(false),
+	_handled(0)
 {
-	Log.trace("WiFiManager::WiFiManager()" CR);
+	LOG_TRACE("WiFiManager::WiFiManager()" CR);
 }
 
 /// <summary>
-///  Scan the WiFi network for access points.
+///  Request an async scan of the WiFi network for access points. The scan is started (in loop)
+///  only if the cached results are stale, the existing connections are kept alive.
 /// </summary>
-/// <returns>Number of access points found</returns>
-unsigned short WiFiManager::scan()
+/// <param name="force">True to start a scan even if the cached results are valid</param>
+/// <returns>True if a new scan has been requested</returns>
+bool WiFiManager::scan(bool force)
 {
-	Log.trace("WiFiManager::scan()" CR);
-
-	_numberAP = 0;
-	WiFi.mode(WIFI_OFF);
+	LOG_TRACE("WiFiManager::scan()" CR);
 
-	if (wait4Mode(WIFI_STA))
+	if (_scanning || _scanRequested || (!force && isScanValid()))
 	{
-		_numberAP = WiFi.scanNetworks();
+		return false;
 	}
 
-	return _numberAP;
+	_scanRequested = true;
+	return true;
+}
+
+/// <summary>
+///  Returns true if a scan is pending or running.
+/// </summary>
+/// <returns>True if scanning</returns>
+bool WiFiManager::isScanning()
+{
+	return _scanning || _scanRequested;
+}
+
+/// <summary>
+///  Returns true if the cached scan results are not stale.
+/// </summary>
+/// <returns>True if valid</returns>
+bool WiFiManager::isScanValid()
+{
+	return _scanValid && (getScanAge() < SCAN_MAX_AGE);
+}
+
+/// <summary>
+///  Returns the age (msec) of the cached scan results.
+/// </summary>
+/// <returns>The age (msec)</returns>
+uint32_t WiFiManager::getScanAge()
+{
+	return _scanValid ? millis() - _scanTime : 0;
+}
+
+/// <summary>
+///  Returns the number of cached scan results.
+/// </summary>
+/// <returns>Number of access points found</returns>
+unsigned short WiFiManager::getNumberAP()
+{
+	return _scanValid ? _numberAP : 0;
 }
 
 /// <summary>
-///  Returns the AP data at the specified index.
+///  Returns the AP data at the specified index (from the cached scan results).
 /// </summary>
 /// <param name="index">Network item index</param>
 /// <returns>Access point info</returns>
 WiFiManager::AccessPoint WiFiManager::getAP(unsigned short index)
 {
-	Log.trace("WiFiManager::getAP()" CR);
+	LOG_TRACE("WiFiManager::getAP()" CR);
 	WiFiManager::AccessPoint ap;
 
-	if ((_numberAP > 0) && (index < _numberAP))
+	if (index < getNumberAP())
 	{
-		ap.SSID = WiFi.SSID(index);
-		ap.RSSI = WiFi.RSSI(index);
-		ap.Channel = WiFi.channel(index);
-
-		switch (WiFi.encryptionType(index))
-		{
-		case WIFI_AUTH_OPEN: ap.Encryption = String("Open"); break;
-		case WIFI_AUTH_WEP: ap.Encryption = String("WEP"); break;
-		case WIFI_AUTH_WPA_PSK: ap.Encryption = String("WPA_PSK"); break;
-		case WIFI_AUTH_WPA2_PSK: ap.Encryption = String("WPA2_PSK"); break;
-		case WIFI_AUTH_WPA_WPA2_PSK: ap.Encryption = String("WPA_WPA2_PSK"); break;
-		case WIFI_AUTH_WPA2_ENTERPRISE: ap.Encryption = String("WPA2_ENTERPRISE"); break;
-		}
+		ap.SSID = String(_networks[index].SSID);
+		ap.RSSI = _networks[index].RSSI;
+		ap.Channel = _networks[index].Channel;
+		ap.Encryption = String(getEncryption(_networks[index].Encryption));
 	}
 	
 	return ap;
 }
 
 /// <summary>
-///  Attempt to connect to WiFi network or create access point.
+///  Returns the cached scan result at the specified index (NULL if not available).
+/// </summary>
+/// <param name="index">Network item index</param>
+/// <returns>Pointer to the cached scan result</returns>
+const WiFiManager::Network* WiFiManager::getNetwork(unsigned short index)
+{
+	return (index < getNumberAP()) ? &_networks[index] : NULL;
+}
+
+/// <summary>
+///  Returns the encryption name.
+/// </summary>
+/// <param name="type">The encryption type (wifi_auth_mode_t)</param>
+/// <returns>The encryption name</returns>
+const char* WiFiManager::getEncryption(uint8_t type)
+{
+	switch (type)
+	{
+	case WIFI_AUTH_OPEN: return "Open";
+	case WIFI_AUTH_WEP: return "WEP";
+	case WIFI_AUTH_WPA_PSK: return "WPA_PSK";
+	case WIFI_AUTH_WPA2_PSK: return "WPA2_PSK";
+	case WIFI_AUTH_WPA_WPA2_PSK: return "WPA_WPA2_PSK";
+	case WIFI_AUTH_WPA2_ENTERPRISE: return "WPA2_ENTERPRISE";
+	default: return "";
+	}
+}
+
+/// <summary>
+///  Start to connect to WiFi network or create access point. This function does not block,
+///  the connection is completed by calling loop().
 /// </summary>
 /// <returns>True if successful</returns>
 bool WiFiManager::connect()
 {
-	Log.trace("WiFiManager::connect()" CR);
+	LOG_TRACE("WiFiManager::connect()" CR);
 
 	if (_settings != NULL)
 	{
-		if (connectAP())
+		// Register the event handler (once), the reconnects are handled by the state machine.
+		if (_instance == NULL)
 		{
-			if (_settings->ApSettings.Backup)
-			{
-				return createAP();
-			}
-
-			return true;
+			_instance = this;
+			WiFi.onEvent(&WiFiManager::onEvent);
 		}
-		else
+
+		WiFi.setAutoReconnect(false);
+
+		_attempts = 0;
+		_backoff = MIN_BACKOFF;
+		_fallback = ApInfo::Active && !_settings->ApSettings.Backup;
+		_fast = loadCache();
+		_connectStart = millis();
+
+		// Access point only (no WiFi network defined).
+		if (_settings->StaSettings.SSID == "")
 		{
+			enter(STATE_AP_ONLY);
 			return createAP();
 		}
+
+		if (_settings->ApSettings.Backup)
+		{
+			createAP();
+		}
+
+		return connectAP();
 	}
 
 	return false;
 }
 
 /// <summary>
-///  Create a WiFi access point.
+///  Create a WiFi access point. The station interface is kept if a WiFi network is defined.
 /// </summary>
 /// <returns>True if successful</returns>
 bool WiFiManager::createAP()
 {
-	Log.trace("WiFiManager::createAP()" CR);
+	LOG_TRACE("WiFiManager::createAP()" CR);
 	bool ok = false;
 	wifi_mode_t mode = WIFI_AP;
 
 	if (_settings != NULL)
 	{
-		if (_settings->ApSettings.Backup)
+		if (_settings->StaSettings.SSID != "")
 		{
 			mode = WIFI_AP_STA;
 		}
 
-		if (wait4Mode(mode))
+		if (setMode(mode))
 		{
 			if (_settings->ApSettings.Custom)
 			{
@@ -153,156 +263,602 @@ bool WiFiManager::createAP()
 				ok = WiFi.softAP(_settings->ApSettings.SSID.c_str());
 			}
 
-			delay(100);
-
-			if (ok)
-			{
-				ok = WiFi.softAPsetHostname(_settings->ApSettings.Hostname.c_str());
-			}
+			// Note that the hostname is set (in loop) when the access point has been started.
 		}
 	}
 
+	if (ok)
+	{
+		LOG_NOTICE("WiFi access point '%s' created" CR, _settings->ApSettings.SSID.c_str());
+	}
+
 	ApInfo::Active = ok;
 	return ok;
 }
 
 /// <summary>
-///  Connect to a WiFi access point.
+///  Start a connection to a WiFi access point (completed by calling loop()).
 /// </summary>
 /// <returns>True if successful</returns>
 bool WiFiManager::connectAP()
 {
-	Log.trace("WiFiManager::connectAP()" CR);
-	bool ok = false;
-	wifi_mode_t mode = WIFI_STA;
+	LOG_TRACE("WiFiManager::connectAP()" CR);
 
-	if (_settings != NULL)
+	if ((_settings != NULL) && setMode(getStaMode()) && beginSTA())
 	{
-		if (_settings->ApSettings.Backup)
+		return true;
+	}
+
+	fail();
+	return false;
+}
+
+/// <summary>
+///  Disconnect WiFi.
+/// </summary>
+void WiFiManager::disconnect()
+{
+	LOG_TRACE("WiFiManager::disconnect()" CR);
+	WiFi.disconnect();
+	enter(STATE_IDLE);
+}
+
+/// <summary>
+///  Advance the connection state machine. This function is called from the main loop and never blocks.
+/// </summary>
+void WiFiManager::loop()
+{
+	// Set the access point hostname (after the access point has been started).
+	if (_apStarted)
+	{
+		_apStarted = false;
+		WiFi.softAPsetHostname(_settings->ApSettings.Hostname.c_str());
+	}
+
+	updateScan();
+
+	uint32_t disconnects = _disconnects;
+	bool disconnected = (disconnects != _handled);
+	_handled = disconnects;
+
+	switch (_state)
+	{
+	case STATE_CONNECTING:
+		if (WiFi.status() == WL_CONNECTED)
 		{
-			mode = WIFI_AP_STA;
+			_connectTime = millis() - _connectStart;
+			LOG_NOTICE("WiFi connected to '%s' (%s) in %u msec%s" CR,
+				_settings->StaSettings.SSID.c_str(), WiFi.localIP().toString().c_str(),
+				_connectTime, _fast ? " (fast)" : "");
+
+			// The cache is never refreshed from the cached IP configuration (kept until the lease is due).
+			if (!_cachedConfig)
+			{
+				saveCache();
+			}
+
+			_leaseUpdated = millis();
+			_attempts = 0;
+			_backoff = MIN_BACKOFF;
+
+			// Init the time if connected to WiFi access point.
+			if (!_timeSet)
+			{
+				configTime(3600, 0, "pool.ntp.org");
+				_timeSet = true;
+			}
+
+			if (_fallback)
+			{
+				stopAP();
+			}
+
+			enter(STATE_CONNECTED);
+		}
+		else if (disconnected || (millis() - _started >= (_fast ? FAST_TIMEOUT : CONNECT_TIMEOUT)))
+		{
+			fail();
 		}
 
-		if (wait4Mode(mode))
+		break;
+
+	case STATE_CONNECTED:
+		if (disconnected || (WiFi.status() != WL_CONNECTED))
 		{
-			ok = WiFi.setHostname(_settings->StaSettings.Hostname.c_str());
+			LOG_WARNING("WiFi connection lost (reason %u)" CR, _reason);
+			_fast = false;
+			_leasePending = false;
+			_connectStart = millis();
+			_delay = MIN_BACKOFF;
+			enter(STATE_BACKOFF);
+		}
+		else
+		{
+			updateLease();
+		}
 
-			if (ok)
+		break;
+
+	case STATE_BACKOFF:
+		if (!_scanning && (millis() - _started >= _delay))
+		{
+			if (!beginSTA())
 			{
-				// Check if WiFi network SSID is defined and try to connect.
-				if (_settings->StaSettings.SSID != "")
-				{
-					// Using DHCP for the connection.
-					if (_settings->StaSettings.DHCP)
-					{
-						// attempt to connect to Wifi network:
-						if (_settings->StaSettings.PASS != "")
-						{
-							WiFi.begin(_settings->StaSettings.SSID.c_str(), _settings->StaSettings.PASS.c_str());
-						}
-						else
-						{
-							WiFi.begin(_settings->StaSettings.SSID.c_str());
-						}
-
-						ok = wait4WiFi();
-					}
-					else
-					{
-						IPAddress address;
-						IPAddress gateway;
-						IPAddress subnet;
-						IPAddress dns1;
-						IPAddress dns2;
-
-						bool addressOK = address.fromString(_settings->StaSettings.Address);
-						bool gatewayOK = gateway.fromString(_settings->StaSettings.Gateway);
-						bool subnetOK = subnet.fromString(_settings->StaSettings.Subnet);
-						bool dns1OK = dns1.fromString(_settings->StaSettings.DNS1);
-						bool dns2OK = dns2.fromString(_settings->StaSettings.DNS2);
-
-						if (addressOK && gatewayOK && subnetOK)
-						{
-							if (dns1OK && dns2OK)
-							{
-								WiFi.config(address, gateway, subnet, dns1, dns2);
-							}
-							else if (dns1OK)
-							{
-								WiFi.config(address, gateway, subnet, dns1);
-							}
-							else
-							{
-								WiFi.config(address, gateway, subnet);
-							}
-
-							if (_settings->StaSettings.PASS != "")
-							{
-								WiFi.begin(_settings->StaSettings.SSID.c_str(), _settings->StaSettings.PASS.c_str());
-							}
-							else
-							{
-								WiFi.begin(_settings->StaSettings.SSID.c_str());
-							}
-
-							ok = wait4WiFi();
-						}
-					}
-				}
+				fail();
 			}
 		}
+
+		break;
+
+	default:
+		break;
 	}
+}
 
-	// Init and get the time if connected to WiFi access point.
-	if (ok)
+/// <summary>
+///  Returns the connection state.
+/// </summary>
+/// <returns>The connection state</returns>
+WiFiManager::State WiFiManager::getState()
+{
+	return _state;
+}
+
+/// <summary>
+///  Returns the connection state name.
+/// </summary>
+/// <returns>The connection state name</returns>
+const char* WiFiManager::getStateName()
+{
+	switch (_state)
 	{
-		configTime(3600, 0, "pool.ntp.org");
+	case STATE_IDLE: return "Idle";
+	case STATE_CONNECTING: return "Connecting";
+	case STATE_CONNECTED: return "Connected";
+	case STATE_BACKOFF: return "Backoff";
+	case STATE_AP_ONLY: return "AP only";
+	default: return "Unknown";
 	}
+}
 
-	return ok;
+/// <summary>
+///  Returns the number of failed connection attempts (since the last connection).
+/// </summary>
+/// <returns>The number of failed attempts</returns>
+uint16_t WiFiManager::getAttempts()
+{
+	return _attempts;
 }
 
 /// <summary>
-///  Disconnect WiFi.
+///  Returns the time (msec) needed for the last connection.
 /// </summary>
-void WiFiManager::disconnect()
+/// <returns>The connection time</returns>
+uint32_t WiFiManager::getConnectTime()
 {
-	Log.trace("WiFiManager::disconnect()" CR);
-	WiFi.disconnect();
+	return _connectTime;
+}
+
+/// <summary>
+///  Returns true if the actual connection has been established using the cache.
+/// </summary>
+/// <returns>True if connected using the cache</returns>
+bool WiFiManager::isFastConnect()
+{
+	return _fast && (_state == STATE_CONNECTED);
+}
+
+/// <summary>
+///  Returns the last disconnect reason (wifi_err_reason_t).
+/// </summary>
+/// <returns>The disconnect reason</returns>
+uint8_t WiFiManager::getReason()
+{
+	return _reason;
+}
+
+/// <summary>
+///  The WiFi event handler. Note that this function is called from the event task,
+///  only the event counters and flags are updated here (the state machine runs in loop()).
+///  Disconnects caused by WiFi.disconnect() (reason ASSOC_LEAVE) are ignored.
+/// </summary>
+/// <param name="event">The event id</param>
+/// <param name="info">The event info</param>
+void WiFiManager::onEvent(system_event_id_t event, system_event_info_t info)
+{
+	if (_instance == NULL)
+	{
+		return;
+	}
+
+	switch (event)
+	{
+	case SYSTEM_EVENT_STA_DISCONNECTED:
+		_instance->_reason = info.disconnected.reason;
+
+		if (info.disconnected.reason != WIFI_REASON_ASSOC_LEAVE)
+		{
+			_instance->_disconnects++;
+		}
+
+		break;
+
+	case SYSTEM_EVENT_AP_START:
+		_instance->_apStarted = true;
+		break;
+
+	default:
+		break;
+	}
 }
 
 /// <summary>
-/// Try to change the WiFi mode (MODE_AP, MODE_STA, MODE_AP_STA).
-/// After every try wait for 50 msec.
+///  Change the WiFi mode (WIFI_AP, WIFI_STA, WIFI_AP_STA).
 /// </summary>
 /// <param name="mode">The wifi mode</param>
-/// <param name="count">The number of tries</param>
 /// <returns>True if sucessful</returns>
-bool WiFiManager::wait4Mode(wifi_mode_t mode, int count)
+bool WiFiManager::setMode(wifi_mode_t mode)
 {
-	WiFi.mode(mode);
-
-	while ((WiFi.getMode() != mode) && (--count > 0))
+	if (WiFi.getMode() != mode)
 	{
-		delay(50);
+		WiFi.mode(mode);
 	}
 
 	return (WiFi.getMode() == mode);
 }
 
 /// <summary>
-/// Try to connect to WiFi (returns true if the WiFi status == WL_CONNECTED).
-/// After every try wait for 500 msec.
+///  Returns the WiFi mode used for the station connection (keeping an active access point).
 /// </summary>
-/// <param name="count">The number of tries</param>
-/// <returns>True if sucessful</returns>
-bool WiFiManager::wait4WiFi(int count)
+/// <returns>The wifi mode</returns>
+wifi_mode_t WiFiManager::getStaMode()
+{
+	return (ApInfo::Active || _settings->ApSettings.Backup) ? WIFI_AP_STA : WIFI_STA;
+}
+
+/// <summary>
+///  Start a station connection attempt (hostname, static IP configuration, begin).
+/// </summary>
+/// <returns>True if the connection attempt has been started</returns>
+bool WiFiManager::beginSTA()
+{
+	LOG_TRACE("WiFiManager::beginSTA()" CR);
+
+	if (_settings->StaSettings.SSID == "")
+	{
+		return false;
+	}
+
+	if (!WiFi.setHostname(_settings->StaSettings.Hostname.c_str()))
+	{
+		return false;
+	}
+
+	// Use a static IP configuration (if not using DHCP).
+	if (!_settings->StaSettings.DHCP)
+	{
+		IPAddress address;
+		IPAddress gateway;
+		IPAddress subnet;
+		IPAddress dns1;
+		IPAddress dns2;
+
+		bool addressOK = address.fromString(_settings->StaSettings.Address);
+		bool gatewayOK = gateway.fromString(_settings->StaSettings.Gateway);
+		bool subnetOK = subnet.fromString(_settings->StaSettings.Subnet);
+		bool dns1OK = dns1.fromString(_settings->StaSettings.DNS1);
+		bool dns2OK = dns2.fromString(_settings->StaSettings.DNS2);
+
+		if (!addressOK || !gatewayOK || !subnetOK)
+		{
+			return false;
+		}
+
+		if (dns1OK && dns2OK)
+		{
+			WiFi.config(address, gateway, subnet, dns1, dns2);
+		}
+		else if (dns1OK)
+		{
+			WiFi.config(address, gateway, subnet, dns1);
+		}
+		else
+		{
+			WiFi.config(address, gateway, subnet);
+		}
+	}
+	// Reuse the cached IP configuration (skipping DHCP until the lease is due, once per restart).
+	else if (_fast && !_cacheUsed && (_cache.Renew > LEASE_MARGIN))
+	{
+		WiFi.config(IPAddress(_cache.Address), IPAddress(_cache.Gateway), IPAddress(_cache.Subnet),
+			IPAddress(_cache.DNS1), IPAddress(_cache.DNS2));
+		_cachedConfig = true;
+		_cacheUsed = true;
+		_leaseStart = millis();
+		_leaseRenew = _cache.Renew;
+	}
+	// Restart DHCP (after using the cached IP configuration).
+	else if (_cachedConfig)
+	{
+		WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+		_cachedConfig = false;
+	}
+
+	const char* pass = (_settings->StaSettings.PASS != "") ? _settings->StaSettings.PASS.c_str() : NULL;
+
+	// Directed connect using the cached channel and BSSID (no scan).
+	if (_fast)
+	{
+		WiFi.begin(_settings->StaSettings.SSID.c_str(), pass, _cache.Channel, _cache.BSSID);
+	}
+	else
+	{
+		WiFi.begin(_settings->StaSettings.SSID.c_str(), pass);
+	}
+
+	_handled = _disconnects;
+	enter(STATE_CONNECTING);
+	return true;
+}
+
+/// <summary>
+///  Handle a failed connection attempt. The access point is created as a fallback,
+///  and the next attempt is delayed using an exponential backoff (with jitter).
+/// </summary>
+void WiFiManager::fail()
+{
+	// The fast connection failed, retry immediately using the full connection (scan, DHCP).
+	if (_fast)
+	{
+		LOG_NOTICE("WiFi fast connect failed (reason %u)" CR, _reason);
+		WiFi.disconnect();
+		clearCache();
+		_fast = false;
+
+		if (beginSTA())
+		{
+			return;
+		}
+	}
+
+	_attempts++;
+	LOG_WARNING("WiFi connection failed (attempt %u, reason %u)" CR, _attempts, _reason);
+
+	WiFi.disconnect();
+
+	if (!ApInfo::Active && (_settings != NULL))
+	{
+		_fallback = !_settings->ApSettings.Backup;
+		createAP();
+	}
+
+	_delay = _backoff + random(_backoff / 4 + 1);
+	_backoff = (_backoff * 2 > MAX_BACKOFF) ? MAX_BACKOFF : _backoff * 2;
+	enter(STATE_BACKOFF);
+}
+
+/// <summary>
+///  Enter a new state (and remember the time).
+/// </summary>
+/// <param name="state">The new state</param>
+void WiFiManager::enter(State state)
+{
+	_state = state;
+	LOG_TRACE("WiFiManager::enter(%s)" CR, getStateName());
+	_started = millis();
+}
+
+/// <summary>
+///  Remove the fallback access point (the station connection is kept).
+/// </summary>
+void WiFiManager::stopAP()
+{
+	LOG_NOTICE("WiFi access point removed" CR);
+
+	WiFi.softAPdisconnect(true);
+	ApInfo::Active = false;
+	_fallback = false;
+}
+
+/// <summary>
+///  Start the requested async scan or collect the results of a running scan. A scan is not started
+///  during a connection attempt, scanning requires the station interface (enabled if necessary).
+/// </summary>
+void WiFiManager::updateScan()
+{
+	if (_scanning)
+	{
+		int16_t result = WiFi.scanComplete();
+
+		if (result == WIFI_SCAN_RUNNING)
+		{
+			return;
+		}
+
+		_scanning = false;
+
+		if (result < 0)
+		{
+			LOG_WARNING("WiFi scan failed" CR);
+			return;
+		}
+
+		_numberAP = (result < MAX_NETWORKS) ? result : MAX_NETWORKS;
+
+		for (unsigned short i = 0; i < _numberAP; i++)
+		{
+			strncpy(_networks[i].SSID, WiFi.SSID(i).c_str(), sizeof(_networks[i].SSID) - 1);
+			_networks[i].SSID[sizeof(_networks[i].SSID) - 1] = '\0';
+			_networks[i].RSSI = WiFi.RSSI(i);
+			_networks[i].Channel = WiFi.channel(i);
+			_networks[i].Encryption = WiFi.encryptionType(i);
+		}
+
+		WiFi.scanDelete();
+		_scanTime = millis();
+		_scanValid = true;
+		LOG_TRACE("WiFi scan completed (%d networks)" CR, result);
+	}
+	else if (_scanRequested && (_state != STATE_CONNECTING))
+	{
+		_scanRequested = false;
+		wifi_mode_t mode = WiFi.getMode();
+
+		if ((mode == WIFI_AP) || (mode == WIFI_OFF))
+		{
+			setMode((mode == WIFI_AP) ? WIFI_AP_STA : WIFI_STA);
+		}
+
+		_scanning = (WiFi.scanNetworks(true) == WIFI_SCAN_RUNNING);
+
+		if (!_scanning)
+		{
+			LOG_WARNING("WiFi scan not started" CR);
+		}
+	}
+}
+
+/// <summary>
+///  Returns the hash of the station settings (the cache is only used with the same settings).
+/// </summary>
+/// <returns>The hash value</returns>
+uint32_t WiFiManager::getCacheKey()
+{
+	uint32_t key = hash(_settings->StaSettings.SSID.c_str(), _settings->StaSettings.SSID.length());
+	key = hash(_settings->StaSettings.PASS.c_str(), _settings->StaSettings.PASS.length(), key);
+	key = hash(&_settings->StaSettings.DHCP, sizeof(_settings->StaSettings.DHCP), key);
+	return hash(_settings->StaSettings.Address.c_str(), _settings->StaSettings.Address.length(), key);
+}
+
+/// <summary>
+///  Returns true if the cache is valid (magic, checksum, and the same station settings).
+/// </summary>
+/// <returns>True if the cache can be used</returns>
+bool WiFiManager::loadCache()
+{
+	return (_settings->StaSettings.SSID != "") &&
+		(_cache.Magic == CACHE_MAGIC) &&
+		(_cache.Checksum == hash(&_cache, offsetof(Cache, Checksum))) &&
+		(_cache.Key == getCacheKey()) &&
+		(_cache.Channel > 0);
+}
+
+/// <summary>
+///  Store the actual connection (BSSID, channel, IP configuration) in the cache.
+/// </summary>
+void WiFiManager::saveCache()
 {
-	//Wait for WiFi to connect
-	while ((WiFi.status() != WL_CONNECTED) && (--count > 0))
+	uint8_t* bssid = WiFi.BSSID();
+
+	if (bssid == NULL)
 	{
-		delay(500);
+		clearCache();
+		return;
 	}
 
-	return (WiFi.status() == WL_CONNECTED);
-}
\ No newline at end of file
+	_cache.Magic = CACHE_MAGIC;
+	_cache.Key = getCacheKey();
+	memcpy(_cache.BSSID, bssid, sizeof(_cache.BSSID));
+	_cache.Channel = WiFi.channel();
+	_cache.Address = WiFi.localIP();
+	_cache.Gateway = WiFi.gatewayIP();
+	_cache.Subnet = WiFi.subnetMask();
+	_cache.DNS1 = WiFi.dnsIP(0);
+	_cache.DNS2 = WiFi.dnsIP(1);
+	_cache.Renew = getRenewTime();
+	_cache.Checksum = hash(&_cache, offsetof(Cache, Checksum));
+}
+
+/// <summary>
+///  Invalidate the cache.
+/// </summary>
+void WiFiManager::clearCache()
+{
+	_cache.Magic = 0;
+}
+
+/// <summary>
+///  Update the lease time left in the cache (every LEASE_UPDATE, so it is valid after a restart). The cached
+///  IP configuration is kept until the cached lease is due for renewal, then DHCP is restarted and the cache is
+///  saved with the new lease (never with the cached address itself).
+/// </summary>
+void WiFiManager::updateLease()
+{
+	uint32_t now = millis();
+
+	if (_cachedConfig)
+	{
+		uint32_t elapsed = (now - _leaseStart) / 1000;
+
+		if (elapsed >= _leaseRenew)
+		{
+			LOG_NOTICE("WiFi cached lease due, restarting DHCP" CR);
+			WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+			_cachedConfig = false;
+			_leasePending = true;
+			_cache.Renew = 0;
+			_cache.Checksum = hash(&_cache, offsetof(Cache, Checksum));
+		}
+		else if (now - _leaseUpdated >= LEASE_UPDATE)
+		{
+			_leaseUpdated = now;
+			_cache.Renew = _leaseRenew - elapsed;
+			_cache.Checksum = hash(&_cache, offsetof(Cache, Checksum));
+		}
+	}
+	else if (_leasePending)
+	{
+		if ((uint32_t)WiFi.localIP() != 0)
+		{
+			LOG_NOTICE("WiFi DHCP lease %s" CR, WiFi.localIP().toString().c_str());
+			_leasePending = false;
+			_leaseUpdated = now;
+			saveCache();
+		}
+	}
+	else if (now - _leaseUpdated >= LEASE_UPDATE)
+	{
+		_leaseUpdated = now;
+		saveCache();
+	}
+}
+
+/// <summary>
+///  Returns the time left until the renewal of the DHCP lease (T1) of the station interface.
+/// </summary>
+/// <returns>The time (sec), 0 if no lease is bound (e.g. static IP configuration)</returns>
+uint32_t WiFiManager::getRenewTime()
+{
+	void* netif = NULL;
+
+	if ((tcpip_adapter_get_netif(TCPIP_ADAPTER_IF_STA, &netif) != ESP_OK) || (netif == NULL))
+	{
+		return 0;
+	}
+
+	struct dhcp* dhcp = netif_dhcp_data((struct netif*)netif);
+
+	return ((dhcp != NULL) && (dhcp->state == DHCP_STATE_BOUND)) ?
+		dhcp->t1_renew_time * DHCP_COARSE_TIMER_SECS : 0;
+}
+
+/// <summary>
+///  Returns the FNV-1a hash of the data.
+/// </summary>
+/// <param name="data">Pointer to the data</param>
+/// <param name="length">The data length</param>
+/// <param name="seed">The initial hash value</param>
+/// <returns>The hash value</returns>
+uint32_t WiFiManager::hash(const void* data, size_t length, uint32_t seed)
+{
+	const uint8_t* p = (const uint8_t*)data;
+	uint32_t value = seed;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		value ^= p[i];
+		value *= 16777619UL;
+	}
+
+	return value;
+}
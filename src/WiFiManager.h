@@ -15,6 +15,12 @@
 
 /// <summary>
 /// This class creates an WiFi access point or connects to an existing WiFi access point.
+/// The connection is handled by a state machine driven by the WiFi events and advanced by loop() (non-blocking).
+/// Failed connection attempts are retried using an exponential backoff, and the access point is created
+/// automatically as a fallback (and removed again when the station is connected unless configured as backup).
+/// The last good connection (BSSID, channel, IP configuration) is kept in RTC memory, after a restart
+/// a directed connection using the cached data is tried first (skipping the scan, and DHCP until the cached
+/// lease is due for renewal).
 /// </summary>
 class WiFiManager
 {
@@ -27,19 +33,124 @@ public:
 		String Encryption;
 	};
 
+	struct Network										// A cached scan result (no allocations)
+	{
+		char SSID[33];									// The network SSID
+		int8_t RSSI;									// The signal strength (dBm)
+		uint8_t Channel;								// The channel
+		uint8_t Encryption;								// The encryption type (wifi_auth_mode_t)
+	};
+
+	enum State
+	{
+		STATE_IDLE,										// Not started (or disconnected)
+		STATE_CONNECTING,								// Waiting for the station connection (IP address)
+		STATE_CONNECTED,								// Station connected
+		STATE_BACKOFF,									// Waiting before the next connection attempt
+		STATE_AP_ONLY									// Access point only (no SSID configured)
+	};
+
+	static const uint32_t CONNECT_TIMEOUT = 10000;		// The timeout (msec) of a single connection attempt
+	static const uint32_t FAST_TIMEOUT = 3000;			// The timeout (msec) of a fast connection attempt (cached)
+	static const uint32_t MIN_BACKOFF = 1000;			// The initial retry delay (msec)
+	static const uint32_t MAX_BACKOFF = 300000;			// The maximum retry delay (msec)
+	static const uint8_t MAX_NETWORKS = 16;				// The maximum number of cached scan results
+	static const uint32_t SCAN_MAX_AGE = 60000;			// The time (msec) the scan results are valid
+
 private:
+	struct Cache										// The last good connection (kept in RTC memory)
+	{
+		uint32_t Magic;									// The magic number (valid cache)
+		uint32_t Key;									// The hash of the station settings used
+		uint8_t BSSID[6];								// The access point BSSID
+		uint8_t Channel;								// The access point channel
+		uint32_t Address;								// The IP address
+		uint32_t Gateway;								// The gateway address
+		uint32_t Subnet;								// The subnet mask
+		uint32_t DNS1;									// The primary domain name server
+		uint32_t DNS2;									// The secondary domain name server
+		uint32_t Renew;									// The time (sec) left until the lease renewal (T1)
+		uint32_t Checksum;								// The checksum of all fields above
+	};
+
+	static const uint32_t CACHE_MAGIC = 0x57694669;		// The cache magic number
+	static const uint32_t LEASE_UPDATE = 60000;			// The interval (msec) the lease time is updated in the cache
+	static const uint32_t LEASE_MARGIN = 60;			// The minimum lease time (sec) left to use the cached address
+	static Cache _cache;								// The cache (not initialized, survives a restart)
+	static WiFiManager* _instance;						// The instance receiving the WiFi events
+
 	Settings* _settings;
 	unsigned short _numberAP;
 
-	bool wait4Mode(wifi_mode_t mode, int count = 10);	// Wait for WiFi mode change
-	bool wait4WiFi(int count = 20);						// Wait for WiFi connection
+	Network _networks[MAX_NETWORKS];					// The cached scan results
+	uint32_t _scanTime;									// The time the scan has been completed
+	bool _scanValid;									// True if the cached scan results are valid
+	bool _scanning;										// True if an async scan is running
+	bool _scanRequested;								// True if a scan should be started
+
+	State _state;										// The connection state
+	uint32_t _started;									// The time the actual state was entered
+	uint32_t _backoff;									// The actual retry delay (msec)
+	uint32_t _delay;									// The retry delay (msec) incl. jitter
+	uint16_t _attempts;									// The number of failed connection attempts
+	bool _fallback;										// True if the access point is created as a fallback
+	bool _timeSet;										// True if the time server has been configured
+	bool _fast;											// True if the actual attempt uses the cache
+	bool _cachedConfig;									// True if the cached IP configuration is applied
+	bool _cacheUsed;									// True if the cached IP configuration has been used
+	bool _leasePending;									// True if DHCP has been restarted (no lease yet)
+	uint32_t _leaseStart;								// The time the cached IP configuration has been applied
+	uint32_t _leaseRenew;								// The time (sec) left until the renewal of the cached lease
+	uint32_t _leaseUpdated;								// The time the lease time has been updated in the cache
+	uint32_t _connectStart;								// The time the connection has been started
+	uint32_t _connectTime;								// The time (msec) needed to connect
+
+	volatile uint32_t _disconnects;						// The number of disconnect events (event task)
+	volatile uint8_t _reason;							// The last disconnect reason (event task)
+	volatile bool _apStarted;							// True if the access point has been started (event task)
+	uint32_t _handled;									// The number of handled disconnect events
+
+	static void onEvent(system_event_id_t event,		// The WiFi event handler (called from the event task)
+		system_event_info_t info);
+
+	bool setMode(wifi_mode_t mode);						// Change the WiFi mode
+	wifi_mode_t getStaMode();							// Returns the WiFi mode for the station connection
+	bool beginSTA();									// Start a station connection attempt
+	void fail();										// Handle a failed connection attempt
+	void enter(State state);							// Enter a new state
+	void stopAP();										// Remove the fallback access point
+	void updateScan();									// Start the requested scan or collect the results
+
+	uint32_t getCacheKey();								// Returns the hash of the station settings
+	bool loadCache();									// Returns true if the cache is valid
+	void saveCache();									// Store the actual connection in the cache
+	void clearCache();									// Invalidate the cache
+	void updateLease();									// Update the lease time in the cache (restart DHCP if due)
+	uint32_t getRenewTime();							// Returns the time (sec) left until the lease renewal
+	static uint32_t hash(const void* data,				// Returns the FNV-1a hash of the data
+		size_t length, uint32_t seed = 2166136261UL);
+
 public:
 	WiFiManager(Settings* settings);					// Constructor using a pointer to a settings instance
 
-	unsigned short scan();								// Scan the WiFi network for access points
+	bool scan(bool force = false);						// Request an async scan (if the results are stale)
+	bool isScanning();									// Returns true if a scan is pending or running
+	bool isScanValid();									// Returns true if the scan results are not stale
+	uint32_t getScanAge();								// Returns the age (msec) of the scan results
+	unsigned short getNumberAP();						// Returns the number of cached scan results
 	AccessPoint getAP(unsigned short index);			// Returns the AP data at the specified index (after scan)
-	bool connect();										// Attempt to connect to WiFi network or create access point
+	const Network* getNetwork(unsigned short index);	// Returns the cached scan result at the specified index
+	static const char* getEncryption(uint8_t type);		// Returns the encryption name
+	bool connect();										// Start to connect to WiFi network or create access point
 	bool createAP();									// Create a WiFi access point using id
-	bool connectAP();									// Connect to a WiFi access point
+	bool connectAP();									// Start a connection to a WiFi access point
 	void disconnect();									// Disconnect WiFi
+	void loop();										// Advance the connection state machine
+
+	State getState();									// Returns the connection state
+	const char* getStateName();							// Returns the connection state name
+	uint16_t getAttempts();								// Returns the number of failed connection attempts
+	uint8_t getReason();								// Returns the last disconnect reason
+	uint32_t getConnectTime();							// Returns the time (msec) needed to connect
+	bool isFastConnect();								// Returns true if connected using the cache
 };
\ No newline at end of file
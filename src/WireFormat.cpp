@@ -0,0 +1,363 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WireFormat.cpp" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#include <ctype.h>
+#include <string.h>
+
+#include "WireFormat.h"
+
+/// <summary>
+///  Constructor.
+/// </summary>
+/// <param name="out">The output</param>
+/// <param name="format">The binary format (CBOR or MessagePack)</param>
+WireFormat::WireFormat(Print& out, Format format) : _out(out), _format(format)
+{
+}
+
+/// <summary>
+///  Writes a single byte.
+/// </summary>
+/// <param name="value">The byte</param>
+void WireFormat::writeByte(uint8_t value)
+{
+	_size += _out.write(value);
+}
+
+/// <summary>
+///  Writes the lower bytes of an unsigned value (big endian, network byte order).
+/// </summary>
+/// <param name="value">The value</param>
+/// <param name="count">The number of bytes (1, 2, 4, or 8)</param>
+void WireFormat::writeBytes(uint64_t value, uint8_t count)
+{
+	while (count > 0)
+	{
+		count--;
+		writeByte((uint8_t)(value >> (8 * count)));
+	}
+}
+
+/// <summary>
+///  Writes the head of a CBOR data item (major type and argument in the smallest encoding).
+/// </summary>
+/// <param name="major">The major type (0..7)</param>
+/// <param name="value">The argument (value, length, or count)</param>
+void WireFormat::writeHead(uint8_t major, uint64_t value)
+{
+	major <<= 5;
+
+	if (value < 24)
+	{
+		writeByte(major | (uint8_t)value);
+	}
+	else if (value <= 0xFF)
+	{
+		writeByte(major | 24);
+		writeBytes(value, 1);
+	}
+	else if (value <= 0xFFFF)
+	{
+		writeByte(major | 25);
+		writeBytes(value, 2);
+	}
+	else if (value <= 0xFFFFFFFFUL)
+	{
+		writeByte(major | 26);
+		writeBytes(value, 4);
+	}
+	else
+	{
+		writeByte(major | 27);
+		writeBytes(value, 8);
+	}
+}
+
+/// <summary>
+///  Writes a MessagePack size (fix format below the limit, otherwise the 16 or 32 bit format).
+/// </summary>
+/// <param name="fix">The fix format type (size in the lower bits)</param>
+/// <param name="limit">The limit of the fix format</param>
+/// <param name="code">The 16 bit format type (the 32 bit format type follows)</param>
+/// <param name="size">The size</param>
+void WireFormat::writeSize(uint8_t fix, size_t limit, uint8_t code, size_t size)
+{
+	if (size < limit)
+	{
+		writeByte(fix | (uint8_t)size);
+	}
+	else if (size <= 0xFFFF)
+	{
+		writeByte(code);
+		writeBytes(size, 2);
+	}
+	else
+	{
+		writeByte(code + 1);
+		writeBytes(size, 4);
+	}
+}
+
+/// <summary>
+///  Writes a map header, the specified number of key value pairs (string key first) has to follow.
+/// </summary>
+/// <param name="count">The number of members</param>
+void WireFormat::writeMap(size_t count)
+{
+	if (_format == FORMAT_CBOR)
+	{
+		writeHead(5, count);
+	}
+	else
+	{
+		writeSize(0x80, 16, 0xDE, count);
+	}
+}
+
+/// <summary>
+///  Writes an array header, the specified number of items has to follow.
+/// </summary>
+/// <param name="count">The number of items</param>
+void WireFormat::writeArray(size_t count)
+{
+	if (_format == FORMAT_CBOR)
+	{
+		writeHead(4, count);
+	}
+	else
+	{
+		writeSize(0x90, 16, 0xDC, count);
+	}
+}
+
+/// <summary>
+///  Writes a string (UTF-8, a null pointer is written as an empty string).
+/// </summary>
+/// <param name="value">The string</param>
+void WireFormat::writeString(const char* value)
+{
+	writeString(value, (value != NULL) ? strlen(value) : 0);
+}
+
+/// <summary>
+///  Writes a string of the specified length (UTF-8).
+/// </summary>
+/// <param name="value">The string</param>
+/// <param name="length">The length (bytes)</param>
+void WireFormat::writeString(const char* value, size_t length)
+{
+	if (_format == FORMAT_CBOR)
+	{
+		writeHead(3, length);
+	}
+	else if ((length >= 32) && (length <= 0xFF))
+	{
+		writeByte(0xD9);
+		writeBytes(length, 1);
+	}
+	else
+	{
+		writeSize(0xA0, 32, 0xDA, length);
+	}
+
+	if (length > 0)
+	{
+		_size += _out.write((const uint8_t*)value, length);
+	}
+}
+
+/// <summary>
+///  Writes a signed integer (smallest encoding).
+/// </summary>
+/// <param name="value">The value</param>
+void WireFormat::writeInt(int64_t value)
+{
+	if (value >= 0)
+	{
+		writeUInt((uint64_t)value);
+	}
+	else if (_format == FORMAT_CBOR)
+	{
+		writeHead(1, (uint64_t)(-1 - value));
+	}
+	else if (value >= -32)
+	{
+		writeByte((uint8_t)(int8_t)value);
+	}
+	else if (value >= INT8_MIN)
+	{
+		writeByte(0xD0);
+		writeBytes((uint64_t)value, 1);
+	}
+	else if (value >= INT16_MIN)
+	{
+		writeByte(0xD1);
+		writeBytes((uint64_t)value, 2);
+	}
+	else if (value >= INT32_MIN)
+	{
+		writeByte(0xD2);
+		writeBytes((uint64_t)value, 4);
+	}
+	else
+	{
+		writeByte(0xD3);
+		writeBytes((uint64_t)value, 8);
+	}
+}
+
+/// <summary>
+///  Writes an unsigned integer (smallest encoding).
+/// </summary>
+/// <param name="value">The value</param>
+void WireFormat::writeUInt(uint64_t value)
+{
+	if (_format == FORMAT_CBOR)
+	{
+		writeHead(0, value);
+	}
+	else if (value < 0x80)
+	{
+		writeByte((uint8_t)value);
+	}
+	else if (value <= 0xFF)
+	{
+		writeByte(0xCC);
+		writeBytes(value, 1);
+	}
+	else if (value <= 0xFFFF)
+	{
+		writeByte(0xCD);
+		writeBytes(value, 2);
+	}
+	else if (value <= 0xFFFFFFFFUL)
+	{
+		writeByte(0xCE);
+		writeBytes(value, 4);
+	}
+	else
+	{
+		writeByte(0xCF);
+		writeBytes(value, 8);
+	}
+}
+
+/// <summary>
+///  Writes a floating point number, single precision if the value is represented exactly (e.g. all float
+///  sensor values), otherwise double precision.
+/// </summary>
+/// <param name="value">The value</param>
+void WireFormat::writeFloat(double value)
+{
+	float single = (float)value;
+
+	if ((double)single == value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &single, sizeof(bits));
+		writeByte((_format == FORMAT_CBOR) ? 0xFA : 0xCA);
+		writeBytes(bits, 4);
+	}
+	else
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		writeByte((_format == FORMAT_CBOR) ? 0xFB : 0xCB);
+		writeBytes(bits, 8);
+	}
+}
+
+/// <summary>
+///  Writes a boolean.
+/// </summary>
+/// <param name="value">The value</param>
+void WireFormat::writeBool(bool value)
+{
+	if (_format == FORMAT_CBOR)
+	{
+		writeByte(value ? 0xF5 : 0xF4);
+	}
+	else
+	{
+		writeByte(value ? 0xC3 : 0xC2);
+	}
+}
+
+/// <summary>
+///  Writes a null value.
+/// </summary>
+void WireFormat::writeNull()
+{
+	writeByte((_format == FORMAT_CBOR) ? 0xF6 : 0xC0);
+}
+
+/// <summary>
+///  Returns the position of a token in a text (case insensitive).
+/// </summary>
+/// <param name="text">The text</param>
+/// <param name="token">The token (lower case)</param>
+/// <returns>The position of the token (NULL if not found)</returns>
+const char* WireFormat::find(const char* text, const char* token)
+{
+	size_t length = strlen(token);
+
+	for (; *text != '\0'; text++)
+	{
+		size_t i = 0;
+
+		while ((i < length) && (tolower((unsigned char)text[i]) == token[i])) i++;
+		if (i == length) return text;
+	}
+
+	return NULL;
+}
+
+/// <summary>
+///  Returns the response format accepted by the client (Accept header). The binary formats are only used if the
+///  media type is listed explicitly, the first binary media type wins (quality values are not evaluated).
+///  JSON is returned if the header is missing or lists no binary media type (e.g. "*/*").
+/// </summary>
+/// <param name="accept">The Accept header value (may be NULL)</param>
+/// <returns>The format</returns>
+WireFormat::Format WireFormat::negotiate(const char* accept)
+{
+	if (accept == NULL)
+	{
+		return FORMAT_JSON;
+	}
+
+	const char* cbor = find(accept, "application/cbor");
+	const char* msgpack = find(accept, "application/msgpack");
+
+	if (msgpack == NULL)
+	{
+		msgpack = find(accept, "application/x-msgpack");
+	}
+
+	if ((cbor != NULL) && ((msgpack == NULL) || (cbor < msgpack)))
+	{
+		return FORMAT_CBOR;
+	}
+
+	return (msgpack != NULL) ? FORMAT_MSGPACK : FORMAT_JSON;
+}
+
+/// <summary>
+///  Returns the content type (media type) of a format.
+/// </summary>
+/// <param name="format">The format</param>
+/// <returns>The content type</returns>
+const char* WireFormat::getContentType(Format format)
+{
+	switch (format)
+	{
+	case FORMAT_CBOR:    return "application/cbor";
+	case FORMAT_MSGPACK: return "application/msgpack";
+	default:             return "application/json";
+	}
+}
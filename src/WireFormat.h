@@ -0,0 +1,59 @@
+// --------------------------------------------------------------------------------------------------------------------
+// <copyright file="WireFormat.h" company="DTV-Online">
+//   Copyright(c) 2020 Dr. Peter Trimmel. All rights reserved.
+// </copyright>
+// <license>
+//   Licensed under the MIT license. See the LICENSE file in the project root for more information.
+// </license>
+// --------------------------------------------------------------------------------------------------------------------
+#pragma once
+
+#include <Arduino.h>
+
+/// <summary>
+/// This class implements the compact binary encodings of the JSON data model (CBOR, RFC 8949, and MessagePack)
+/// as a streaming writer, and the selection of the response format from the HTTP Accept header.
+/// Maps and arrays are written with a definite length (the number of members is written first), numbers use the
+/// smallest encoding (floats are written as single precision if no precision is lost). Nothing is buffered,
+/// the encoded bytes are written to the output directly.
+/// </summary>
+class WireFormat
+{
+public:
+	enum Format : uint8_t
+	{
+		FORMAT_JSON,											// JSON (text, default)
+		FORMAT_CBOR,											// CBOR (application/cbor)
+		FORMAT_MSGPACK											// MessagePack (application/msgpack)
+	};
+
+private:
+	Print& _out;												// The output
+	Format _format;												// The binary format (CBOR or MessagePack)
+	size_t _size = 0;											// The number of bytes written
+
+	void writeByte(uint8_t value);								// Writes a single byte
+	void writeBytes(uint64_t value, uint8_t count);				// Writes an unsigned value (big endian)
+	void writeHead(uint8_t major, uint64_t value);				// Writes a CBOR data item head
+	void writeSize(uint8_t fix, size_t limit,					// Writes a MessagePack size (fix, 16 or 32 bit)
+		uint8_t code, size_t size);
+	static const char* find(const char* text,					// Finds a token (case insensitive)
+		const char* token);
+
+public:
+	WireFormat(Print& out, Format format);						// Constructor (binary format)
+
+	void writeMap(size_t count);								// Writes a map header (count members follow)
+	void writeArray(size_t count);								// Writes an array header (count items follow)
+	void writeString(const char* value);						// Writes a string
+	void writeString(const char* value, size_t length);			// Writes a string of the specified length
+	void writeInt(int64_t value);								// Writes a signed integer
+	void writeUInt(uint64_t value);								// Writes an unsigned integer
+	void writeFloat(double value);								// Writes a floating point number
+	void writeBool(bool value);									// Writes a boolean
+	void writeNull();											// Writes a null value
+	size_t getSize() const { return _size; }					// Returns the number of bytes written
+
+	static Format negotiate(const char* accept);				// Returns the format accepted by the client
+	static const char* getContentType(Format format);			// Returns the content type of a format
+};